@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file bench_debugger.cpp
+ * @brief Benchmarks for the hot paths of the debugger.
+ *
+ * All benchmarks are parametrized over the number of qubits (first argument)
+ * and the depth of the generated circuit (second argument). Run the
+ * `run-mqt-debugger-bench` target to store the results as JSON.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "backend/diagnostics.h"
+#include "common.h"
+#include "common/ComplexMathematics.hpp"
+#include "common/parsing/CodePreprocessing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger::bench {
+
+namespace {
+
+/**
+ * @brief A function generating the code of a workload.
+ *
+ * The arguments are the number of qubits and the depth of the circuit.
+ */
+using WorkloadGenerator = std::string (*)(size_t, size_t);
+
+/**
+ * @brief Write a comma-separated list of the given qubits of register `q`.
+ * @param ss The stream to write to.
+ * @param begin The first qubit to write.
+ * @param end The qubit after the last qubit to write.
+ */
+void writeQubits(std::ostringstream& ss, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; i++) {
+    ss << (i == begin ? "" : ", ") << "q[" << i << "]";
+  }
+}
+
+/**
+ * @brief Write the preparation of a GHZ state on the first `numQubits` qubits.
+ * @param ss The stream to write to.
+ * @param numQubits The number of qubits to entangle.
+ * @param skipLast If true, the last qubit is not entangled, so that assertions
+ * on the full register fail.
+ */
+void writeGhz(std::ostringstream& ss, size_t numQubits, bool skipLast = false) {
+  ss << "h q[0];\n";
+  for (size_t i = 1; i < numQubits - (skipLast ? 1 : 0); i++) {
+    ss << "cx q[" << i - 1 << "], q[" << i << "];\n";
+  }
+}
+
+/**
+ * @brief Generate a circuit that repeatedly prepares and checks a GHZ state.
+ * @param numQubits The number of qubits.
+ * @param depth The number of preparation rounds.
+ * @return The generated code.
+ */
+std::string ghzCode(size_t numQubits, size_t depth) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  for (size_t round = 0; round < depth; round++) {
+    writeGhz(ss, numQubits);
+    ss << "assert-ent ";
+    writeQubits(ss, 0, numQubits);
+    ss << ";\nassert-sup q[0];\n";
+    for (size_t i = numQubits - 1; i > 0; i--) {
+      ss << "cx q[" << i - 1 << "], q[" << i << "];\n";
+    }
+    ss << "h q[0];\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Generate a circuit that prepares a GHZ state incorrectly, so that
+ * its entanglement assertions fail.
+ * @param numQubits The number of qubits.
+ * @param depth The number of failing assertions.
+ * @return The generated code.
+ */
+std::string failingGhzCode(size_t numQubits, size_t depth) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  writeGhz(ss, numQubits, true);
+  for (size_t round = 0; round < depth; round++) {
+    ss << "assert-ent ";
+    writeQubits(ss, 0, numQubits);
+    ss << ";\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Generate a circuit that applies the quantum Fourier transform to a
+ * basis state repeatedly.
+ *
+ * The Fourier transform of a basis state is a product state, so sub-states of
+ * the result can be extracted.
+ * @param numQubits The number of qubits.
+ * @param depth The number of applications of the transform.
+ * @return The generated code.
+ */
+std::string qftCode(size_t numQubits, size_t depth) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  for (size_t i = 0; i < numQubits; i += 2) {
+    ss << "x q[" << i << "];\n";
+  }
+  for (size_t round = 0; round < depth; round++) {
+    for (size_t target = numQubits; target-- > 0;) {
+      ss << "h q[" << target << "];\n";
+      for (size_t control = target; control-- > 0;) {
+        const auto distance = target - control;
+        ss << "cp(" << std::numbers::pi / static_cast<double>(1ULL << distance)
+           << ") q[" << control << "], q[" << target << "];\n";
+      }
+    }
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Write a controlled-Z gate between all data qubits of a Grover
+ * circuit.
+ *
+ * The gate is decomposed into Toffoli gates using the ancilla register `a`.
+ * @param ss The stream to write to.
+ * @param numData The number of data qubits. Must be at least 3.
+ */
+void writeMultiControlledZ(std::ostringstream& ss, size_t numData) {
+  ss << "ccx q[0], q[1], a[0];\n";
+  for (size_t i = 2; i < numData - 1; i++) {
+    ss << "ccx q[" << i << "], a[" << i - 2 << "], a[" << i - 1 << "];\n";
+  }
+  ss << "cz a[" << numData - 3 << "], q[" << numData - 1 << "];\n";
+  for (size_t i = numData - 2; i >= 2; i--) {
+    ss << "ccx q[" << i << "], a[" << i - 2 << "], a[" << i - 1 << "];\n";
+  }
+  ss << "ccx q[0], q[1], a[0];\n";
+}
+
+/**
+ * @brief Generate a Grover search for the all-ones state with assertions
+ * after each iteration.
+ *
+ * The oracle and the diffusion operator use `numQubits - 2` ancilla qubits.
+ * @param numQubits The number of data qubits. Values below 3 are raised to 3.
+ * @param depth The number of Grover iterations.
+ * @return The generated code.
+ */
+std::string groverCode(size_t numQubits, size_t depth) {
+  numQubits = std::max<size_t>(numQubits, 3);
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  ss << "qreg a[" << numQubits - 2 << "];\n";
+  for (size_t i = 0; i < numQubits; i++) {
+    ss << "h q[" << i << "];\n";
+  }
+  for (size_t round = 0; round < depth; round++) {
+    writeMultiControlledZ(ss, numQubits);
+    for (size_t i = 0; i < numQubits; i++) {
+      ss << "h q[" << i << "];\nx q[" << i << "];\n";
+    }
+    writeMultiControlledZ(ss, numQubits);
+    for (size_t i = 0; i < numQubits; i++) {
+      ss << "x q[" << i << "];\nh q[" << i << "];\n";
+    }
+    ss << "assert-sup ";
+    writeQubits(ss, 0, numQubits);
+    ss << ";\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief The kinds of assertions that can be benchmarked.
+ */
+enum class AssertionKind : uint8_t {
+  Entanglement,
+  Superposition,
+  StatevectorEquality,
+  CircuitEquality
+};
+
+/**
+ * @brief Generate a GHZ state followed by `depth` assertions of a given kind.
+ * @param kind The kind of assertion.
+ * @param numQubits The number of qubits.
+ * @param depth The number of assertions.
+ * @return The generated code.
+ */
+std::string assertionCode(AssertionKind kind, size_t numQubits, size_t depth) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  writeGhz(ss, numQubits);
+  for (size_t round = 0; round < depth; round++) {
+    switch (kind) {
+    case AssertionKind::Entanglement:
+      ss << "assert-ent ";
+      writeQubits(ss, 0, numQubits);
+      ss << ";";
+      break;
+    case AssertionKind::Superposition:
+      ss << "assert-sup ";
+      writeQubits(ss, 0, numQubits);
+      ss << ";";
+      break;
+    case AssertionKind::StatevectorEquality: {
+      ss << "assert-eq 0.9, ";
+      writeQubits(ss, 0, numQubits);
+      ss << " { 0.70710678";
+      const auto numStates = 1ULL << numQubits;
+      for (size_t i = 1; i < numStates - 1; i++) {
+        ss << ", 0";
+      }
+      ss << ", 0.70710678 }";
+      break;
+    }
+    case AssertionKind::CircuitEquality: {
+      ss << "assert-eq ";
+      writeQubits(ss, 0, numQubits);
+      ss << " { qreg q[" << numQubits << "]; h q[0];";
+      for (size_t i = 1; i < numQubits; i++) {
+        ss << " cx q[" << i - 1 << "], q[" << i << "];";
+      }
+      ss << " }";
+      break;
+    }
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief A simulation state with loaded code that is destroyed automatically.
+ */
+class LoadedState {
+public:
+  /**
+   * @brief Creates a new simulation state and loads the given code.
+   * @param code The code to load.
+   */
+  explicit LoadedState(std::string code) : code(std::move(code)) {
+    createDDSimulationState(&ddState);
+    state = &ddState.interface;
+    loaded = state->loadCode(state, this->code.c_str()).status == LOAD_OK;
+  }
+
+  LoadedState(const LoadedState&) = delete;
+  LoadedState& operator=(const LoadedState&) = delete;
+  LoadedState(LoadedState&&) = delete;
+  LoadedState& operator=(LoadedState&&) = delete;
+
+  ~LoadedState() { destroyDDSimulationState(&ddState); }
+
+  /**
+   * @brief The DD simulation state.
+   */
+  DDSimulationState ddState{};
+
+  /**
+   * @brief The interface of the simulation state.
+   */
+  SimulationState* state = nullptr;
+
+  /**
+   * @brief Whether the code was loaded successfully.
+   */
+  bool loaded = false;
+
+private:
+  /**
+   * @brief The loaded code.
+   */
+  std::string code;
+};
+
+/**
+ * @brief Generate the code for the current benchmark arguments.
+ * @param st The benchmark state.
+ * @param generator The generator of the workload.
+ * @return The generated code.
+ */
+std::string generate(const benchmark::State& st, WorkloadGenerator generator) {
+  return generator(static_cast<size_t>(st.range(0)),
+                   static_cast<size_t>(st.range(1)));
+}
+
+/**
+ * @brief Run the loaded program until it cannot step forward anymore.
+ * @param state The simulation state to run.
+ */
+void stepToEnd(SimulationState* state) {
+  while (state->canStepForward(state)) {
+    state->stepForward(state);
+  }
+}
+
+/**
+ * @brief Get the full state vector of a simulation state.
+ * @param state The simulation state.
+ * @param amplitudes The buffer to store the amplitudes in.
+ * @return The state vector referring to `amplitudes`.
+ */
+Statevector getFullState(SimulationState* state,
+                         std::vector<Complex>& amplitudes) {
+  const auto numQubits = state->getNumQubits(state);
+  amplitudes.resize(1ULL << numQubits);
+  Statevector sv{numQubits, amplitudes.size(), amplitudes.data()};
+  state->getStateVectorFull(state, &sv);
+  return sv;
+}
+
+void bmLoadCode(benchmark::State& st, WorkloadGenerator generator) {
+  const auto code = generate(st, generator);
+  DDSimulationState ddState;
+  createDDSimulationState(&ddState);
+  auto* state = &ddState.interface;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(state->loadCode(state, code.c_str()));
+  }
+  destroyDDSimulationState(&ddState);
+}
+
+void bmPreprocessCode(benchmark::State& st, WorkloadGenerator generator) {
+  const auto code = generate(st, generator);
+  for (auto _ : st) {
+    std::string processed;
+    benchmark::DoNotOptimize(preprocessCode(code, processed));
+  }
+}
+
+void bmStepForward(benchmark::State& st, WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  for (auto _ : st) {
+    st.PauseTiming();
+    state->resetSimulation(state);
+    st.ResumeTiming();
+    stepToEnd(state);
+  }
+  st.SetItemsProcessed(st.iterations() *
+                       static_cast<int64_t>(state->getInstructionCount(state)));
+}
+
+void bmStepBackward(benchmark::State& st, WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  for (auto _ : st) {
+    st.PauseTiming();
+    stepToEnd(state);
+    st.ResumeTiming();
+    while (state->canStepBackward(state)) {
+      state->stepBackward(state);
+    }
+  }
+  st.SetItemsProcessed(st.iterations() *
+                       static_cast<int64_t>(state->getInstructionCount(state)));
+}
+
+void bmRunAll(benchmark::State& st, WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  for (auto _ : st) {
+    st.PauseTiming();
+    state->resetSimulation(state);
+    st.ResumeTiming();
+    size_t failures = 0;
+    state->runAll(state, &failures);
+    benchmark::DoNotOptimize(failures);
+  }
+}
+
+void bmCheckAssertion(benchmark::State& st, AssertionKind kind) {
+  const LoadedState loaded(assertionCode(kind,
+                                         static_cast<size_t>(st.range(0)),
+                                         static_cast<size_t>(st.range(1))));
+  auto* state = loaded.state;
+  for (auto _ : st) {
+    st.PauseTiming();
+    state->resetSimulation(state);
+    st.ResumeTiming();
+    size_t failures = 0;
+    state->runAll(state, &failures);
+    benchmark::DoNotOptimize(failures);
+  }
+  st.SetItemsProcessed(st.iterations() * st.range(1));
+}
+
+void bmGetStateVectorFull(benchmark::State& st) {
+  const LoadedState loaded(generate(st, qftCode));
+  auto* state = loaded.state;
+  stepToEnd(state);
+  std::vector<Complex> amplitudes;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(getFullState(state, amplitudes));
+  }
+}
+
+void bmGetStateVectorSub(benchmark::State& st) {
+  const LoadedState loaded(generate(st, qftCode));
+  auto* state = loaded.state;
+  stepToEnd(state);
+  const auto numQubits = state->getNumQubits(state);
+  std::vector<size_t> qubits;
+  for (size_t i = 0; i < numQubits; i += 2) {
+    qubits.push_back(i);
+  }
+  std::vector<Complex> amplitudes(1ULL << qubits.size());
+  Statevector sv{qubits.size(), amplitudes.size(), amplitudes.data()};
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(
+        state->getStateVectorSub(state, qubits.size(), qubits.data(), &sv));
+  }
+}
+
+void bmPartialTrace(benchmark::State& st) {
+  const LoadedState loaded(generate(st, ghzCode));
+  auto* state = loaded.state;
+  stepToEnd(state);
+  std::vector<Complex> amplitudes;
+  const auto sv = getFullState(state, amplitudes);
+  std::vector<size_t> traceOut;
+  for (size_t i = sv.numQubits / 2; i < sv.numQubits; i++) {
+    traceOut.push_back(i);
+  }
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(getPartialTraceFromStateVector(sv, traceOut));
+  }
+}
+
+void bmCompileSlices(benchmark::State& st, WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  const CompilationSettings settings{.opt = 0, .sliceIndex = 0};
+  for (auto _ : st) {
+    size_t numSlices = 0;
+    const auto size =
+        state->compileSlices(state, nullptr, nullptr, &numSlices, settings);
+    std::vector<char> buffer(size);
+    std::vector<size_t> offsets(numSlices);
+    benchmark::DoNotOptimize(state->compileSlices(
+        state, buffer.data(), offsets.data(), &numSlices, settings));
+  }
+}
+
+void bmDataDependencies(benchmark::State& st, WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  auto* diagnostics = state->getDiagnostics(state);
+  const auto count = state->getInstructionCount(state);
+  std::vector<uint8_t> dependencies(count, 0);
+  for (auto _ : st) {
+    for (size_t i = 0; i < count; i++) {
+      // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+      diagnostics->getDataDependencies(
+          diagnostics, i, true, reinterpret_cast<bool*>(dependencies.data()));
+      // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(count));
+}
+
+void bmPotentialErrorCauses(benchmark::State& st) {
+  const LoadedState loaded(generate(st, failingGhzCode));
+  auto* state = loaded.state;
+  state->runSimulation(state);
+  auto* diagnostics = state->getDiagnostics(state);
+  std::array<ErrorCause, 16> causes{};
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(diagnostics->potentialErrorCauses(
+        diagnostics, causes.data(), causes.size()));
+  }
+}
+
+void bmSuggestAssertionMovements(benchmark::State& st,
+                                 WorkloadGenerator generator) {
+  const LoadedState loaded(generate(st, generator));
+  auto* state = loaded.state;
+  auto* diagnostics = state->getDiagnostics(state);
+  for (auto _ : st) {
+    const auto count = diagnostics->suggestAssertionMovements(
+        diagnostics, nullptr, nullptr, 0);
+    std::vector<size_t> original(count);
+    std::vector<size_t> suggested(count);
+    benchmark::DoNotOptimize(diagnostics->suggestAssertionMovements(
+        diagnostics, original.data(), suggested.data(), count));
+  }
+}
+
+void bmSuggestNewAssertions(benchmark::State& st) {
+  const LoadedState loaded(generate(st, failingGhzCode));
+  auto* state = loaded.state;
+  size_t failures = 0;
+  state->runAll(state, &failures);
+  auto* diagnostics = state->getDiagnostics(state);
+  for (auto _ : st) {
+    const auto count =
+        diagnostics->suggestNewAssertions(diagnostics, nullptr, nullptr, 0);
+    std::vector<size_t> positions(count);
+    std::vector<std::array<char, 256>> assertions(count);
+    std::vector<char*> pointers;
+    pointers.reserve(count);
+    for (auto& assertion : assertions) {
+      pointers.push_back(assertion.data());
+    }
+    benchmark::DoNotOptimize(diagnostics->suggestNewAssertions(
+        diagnostics, positions.data(), pointers.data(), count));
+  }
+}
+
+/**
+ * @brief Register the qubit counts and depths the benchmarks are run with.
+ * @param b The benchmark to configure.
+ */
+void workloadSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"qubits", "depth"})->ArgsProduct({{4, 8, 12}, {1, 4, 16}});
+}
+
+/**
+ * @brief Register smaller sizes for benchmarks whose workloads grow
+ * exponentially in the number of qubits.
+ * @param b The benchmark to configure.
+ */
+void denseWorkloadSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"qubits", "depth"})->ArgsProduct({{4, 8, 10}, {1, 4}});
+}
+
+} // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(bmLoadCode, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmLoadCode, qft, qftCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmLoadCode, grover, groverCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmPreprocessCode, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmPreprocessCode, grover, groverCode)->Apply(workloadSizes);
+
+BENCHMARK_CAPTURE(bmStepForward, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmStepForward, qft, qftCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmStepForward, grover, groverCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmStepBackward, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmStepBackward, qft, qftCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmRunAll, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmRunAll, qft, qftCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmRunAll, grover, groverCode)->Apply(workloadSizes);
+
+BENCHMARK_CAPTURE(bmCheckAssertion, entanglement, AssertionKind::Entanglement)
+    ->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmCheckAssertion, superposition,
+                  AssertionKind::Superposition)
+    ->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmCheckAssertion, statevector_equality,
+                  AssertionKind::StatevectorEquality)
+    ->Apply(denseWorkloadSizes);
+BENCHMARK_CAPTURE(bmCheckAssertion, circuit_equality,
+                  AssertionKind::CircuitEquality)
+    ->Apply(workloadSizes);
+
+BENCHMARK(bmGetStateVectorFull)->Apply(workloadSizes);
+BENCHMARK(bmGetStateVectorSub)->Apply(workloadSizes);
+BENCHMARK(bmPartialTrace)->Apply(denseWorkloadSizes);
+
+BENCHMARK_CAPTURE(bmCompileSlices, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmCompileSlices, grover, groverCode)->Apply(workloadSizes);
+
+BENCHMARK_CAPTURE(bmDataDependencies, ghz, ghzCode)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmDataDependencies, grover, groverCode)
+    ->Apply(workloadSizes);
+BENCHMARK(bmPotentialErrorCauses)->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmSuggestAssertionMovements, ghz, ghzCode)
+    ->Apply(workloadSizes);
+BENCHMARK_CAPTURE(bmSuggestAssertionMovements, grover, groverCode)
+    ->Apply(workloadSizes);
+BENCHMARK(bmSuggestNewAssertions)->Apply(workloadSizes);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-owning-memory)
+
+} // namespace mqt::debugger::bench
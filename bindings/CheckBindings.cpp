@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file CheckBindings.cpp
+ * @brief Implements Python bindings for checking the results of executions of
+ * compiled programs.
+ */
+
+#include "common/ResultChecker.hpp"
+#include "common/ShotEstimator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/pair.h>   // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/string.h> // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/vector.h> // NOLINT(misc-include-cleaner)
+#include <optional>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nb = nanobind;
+using namespace nb::literals;
+using namespace mqt::debugger;
+
+namespace {
+
+/**
+ * @brief The number of characters requested from Python file objects at once.
+ */
+constexpr size_t PYTHON_READ_CHUNK_SIZE = 1ULL << 16U;
+
+/**
+ * @brief A stream buffer that reads from a Python file object in chunks.
+ *
+ * The GIL must be held while the buffer is read.
+ */
+class PythonFileBuffer : public std::streambuf {
+public:
+  /**
+   * @brief Create a new buffer reading from the given file object.
+   * @param file The file object. Its `read` method may return `str` or
+   * `bytes`.
+   */
+  explicit PythonFileBuffer(const nb::object& file) : read(file.attr("read")) {}
+
+protected:
+  int_type underflow() override {
+    const nb::object data = read(PYTHON_READ_CHUNK_SIZE);
+    if (nb::isinstance<nb::bytes>(data)) {
+      const auto bytes = nb::cast<nb::bytes>(data);
+      chunk.assign(bytes.c_str(), bytes.size());
+    } else {
+      chunk = nb::cast<std::string>(data);
+    }
+    if (chunk.empty()) {
+      return traits_type::eof();
+    }
+    setg(chunk.data(), chunk.data(), chunk.data() + chunk.size());
+    return traits_type::to_int_type(chunk.front());
+  }
+
+private:
+  /**
+   * @brief The `read` method of the file object.
+   */
+  nb::object read;
+
+  /**
+   * @brief The chunk of the file that is currently read.
+   */
+  std::string chunk;
+};
+
+/**
+ * @brief An input stream over either a file on disk or a Python file object.
+ */
+struct ResultSource {
+  /**
+   * @brief The buffer reading from a Python file object, if one is used.
+   */
+  std::unique_ptr<PythonFileBuffer> buffer;
+  /**
+   * @brief The stream to read the results from.
+   */
+  std::unique_ptr<std::istream> stream;
+
+  /**
+   * @brief Open a source of results.
+   * @param source A path to the results, or a file object containing them.
+   */
+  explicit ResultSource(const nb::object& source) {
+    if (nb::isinstance<nb::str>(source) || nb::hasattr(source, "__fspath__")) {
+      const auto fspath = nb::module_::import_("os").attr("fspath");
+      const auto path = nb::cast<std::string>(fspath(source));
+      stream = std::make_unique<std::ifstream>(path);
+      if (!*stream) {
+        throw std::invalid_argument("Cannot open result file '" + path +
+                                    "'.");
+      }
+    } else {
+      buffer = std::make_unique<PythonFileBuffer>(source);
+      stream = std::make_unique<std::istream>(buffer.get());
+    }
+  }
+
+  /**
+   * @brief Check whether reading the source requires the GIL.
+   * @return True if a Python file object is read, false otherwise.
+   */
+  [[nodiscard]] bool requiresGil() const { return buffer != nullptr; }
+};
+
+} // namespace
+
+// NOLINTNEXTLINE(misc-use-internal-linkage)
+void bindCheck(nb::module_& m) {
+  m.def(
+      "load_result_counts",
+      [](const nb::object& source,
+         const std::vector<std::vector<std::string>>& registers) {
+        ResultSource input(source);
+        ResultCounts counts;
+        {
+          std::optional<nb::gil_scoped_release> release;
+          if (!input.requiresGil()) {
+            release.emplace();
+          }
+          counts = loadResultCounts(*input.stream, registers);
+        }
+        std::vector<std::vector<size_t>> distributions;
+        distributions.reserve(registers.size());
+        for (size_t i = 0; i < registers.size(); i++) {
+          distributions.emplace_back(
+              counts.counts.begin() +
+                  static_cast<std::ptrdiff_t>(counts.offsets[i]),
+              counts.counts.begin() +
+                  static_cast<std::ptrdiff_t>(counts.offsets[i + 1]));
+        }
+        return std::make_pair(counts.numSamples, std::move(distributions));
+      },
+      "source"_a, "registers"_a,
+      R"(Load the observed counts of the given registers from a results file.
+
+The file contains a JSON list with one object per shot, mapping variable names to their measured values. It is read in a single pass. Variables that are part of multiple registers are only counted for the first of them.
+
+Args:
+    source: The path to the results file, or a file object containing the results.
+    registers: The variables of each register to count.
+
+Returns:
+    The number of shots and, for each register, the counts of all its outcomes. The `j`-th variable of a register corresponds to bit `j` of the outcome.)");
+
+  m.def(
+      "check_assertion_result",
+      [](const std::string& assertion, const std::vector<size_t>& distribution,
+         size_t numSamples, double expectedSuccessProbability, double pValue) {
+        return checkAssertionResult(assertion, distribution, numSamples,
+                                    expectedSuccessProbability, pValue);
+      },
+      "assertion"_a, "distribution"_a, "num_samples"_a,
+      "expected_success_probability"_a, "p_value"_a = 0.05,
+      R"(Check an assertion based on the observed distribution of its register.
+
+Args:
+    assertion: The assertion to check, starting with `{superposition}`, `{zero}`, or the list of expected amplitudes in braces.
+    distribution: The observed counts of all outcomes.
+    num_samples: The number of samples.
+    expected_success_probability: The expected success probability for the program.
+    p_value: The minimum p-value required to accept the assertion.
+
+Returns:
+    True if the assertion is satisfied, False otherwise.)");
+
+  m.def(
+      "check_results",
+      [](const nb::object& source,
+         const std::vector<std::vector<std::string>>& registers,
+         const std::vector<std::string>& assertions,
+         double expectedSuccessProbability, double pValue, size_t maxThreads) {
+        ResultSource input(source);
+        std::vector<bool> results;
+        {
+          std::optional<nb::gil_scoped_release> release;
+          if (!input.requiresGil()) {
+            release.emplace();
+          }
+          results = checkResults(*input.stream, registers, assertions,
+                                 expectedSuccessProbability, pValue,
+                                 maxThreads);
+        }
+        nb::list list;
+        for (const auto result : results) {
+          list.append(result);
+        }
+        return list;
+      },
+      "source"_a, "registers"_a, "assertions"_a,
+      "expected_success_probability"_a, "p_value"_a = 0.05,
+      "max_threads"_a = 0,
+      R"(Check all assertions of a compiled program against a results file.
+
+The results are loaded as by `load_result_counts`, after which the assertions are checked in parallel.
+
+Args:
+    source: The path to the results file, or a file object containing the results.
+    registers: The variables of the register of each assertion.
+    assertions: The assertions to check, one for each register.
+    expected_success_probability: The expected success probability for the program.
+    p_value: The minimum p-value required to accept an assertion.
+    max_threads: The maximum number of threads to use, or 0 to use the number of hardware threads.
+
+Returns:
+    For each assertion, whether it is satisfied.)");
+
+  nb::class_<ShotEstimator>(m, "ShotEstimator")
+      .def(nb::init<>(), "Creates a new `ShotEstimator` with an empty cache.")
+      .def(
+          "estimate",
+          [](ShotEstimator& self, const std::string& assertion,
+             double expectedSuccessProbability, double pValue,
+             size_t numTrials, double accuracy, uint64_t seed,
+             size_t maxThreads) {
+            const nb::gil_scoped_release release;
+            return self.estimate(assertion, expectedSuccessProbability,
+                                 {.pValue = pValue,
+                                  .numTrials = numTrials,
+                                  .accuracy = accuracy,
+                                  .seed = seed,
+                                  .maxThreads = maxThreads});
+          },
+          "assertion"_a, "expected_success_probability"_a,
+          "p_value"_a = 0.05, "num_trials"_a = 1000, "accuracy"_a = 0.95,
+          "seed"_a = 0, "max_threads"_a = 0,
+          R"(Estimate the number of shots required to check an assertion.
+
+For each candidate number of shots, the outcomes of `num_trials` executions are sampled from the expected distribution under noise and checked against the assertion, distributed across threads. The candidate is doubled until enough trials accept the assertion, and the last interval is then bisected for the smallest sufficient candidate. Estimates are cached per assertion and settings.
+
+Args:
+    assertion: The assertion as found in compiled programs, consisting of the variables in parentheses followed by `{superposition}`, `{zero}`, or the list of expected amplitudes in braces.
+    expected_success_probability: The expected success probability for the program.
+    p_value: The minimum p-value required to accept the assertion.
+    num_trials: The number of simulated executions per candidate.
+    accuracy: The share of trials that must accept the assertion.
+    seed: The seed of the random number generators. Estimates are reproducible for a given seed.
+    max_threads: The maximum number of threads to use, or 0 to use the number of hardware threads.
+
+Returns:
+    The estimated number of shots.)")
+      .def("clear_cache", &ShotEstimator::clearCache,
+           "Discard all cached estimates.")
+      .def("get_cache_size", &ShotEstimator::getCacheSize,
+           R"(Get the number of cached estimates.
+
+Returns:
+    The number of cached estimates.)")
+      .doc() = R"(Estimates the number of shots required to check assertions on real devices.
+
+Estimates are cached, so that repeated estimations of the same assertion under the same expected success probability are free.)";
+}
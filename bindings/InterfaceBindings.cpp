@@ -19,17 +19,25 @@
 #include "common.h"
 
 #include <algorithm>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iterator>
+#include <limits>
+#include <map>
 #include <nanobind/nanobind.h>
-#include <nanobind/stl/pair.h>   // NOLINT(misc-include-cleaner)
-#include <nanobind/stl/string.h> // NOLINT(misc-include-cleaner)
-#include <nanobind/stl/vector.h> // NOLINT(misc-include-cleaner)
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/map.h>      // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/optional.h> // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/pair.h>     // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/string.h>   // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/vector.h>   // NOLINT(misc-include-cleaner)
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -54,6 +62,102 @@ void checkOrThrow(Result result) {
   }
 }
 
+/**
+ * @brief A one-dimensional array of amplitudes that is shared with Python
+ * through the buffer protocol without copying.
+ */
+using AmplitudeArray = nb::ndarray<std::complex<double>, nb::ndim<1>,
+                                   nb::c_contig, nb::device::cpu>;
+
+/**
+ * @brief Get an array to write the amplitudes of a state vector into.
+ *
+ * If the caller provides an array, it is used directly. Otherwise, a new array
+ * is allocated, whose memory is owned by the returned Python object.
+ * @param out The array provided by the caller, if any.
+ * @param numStates The number of amplitudes the array has to hold.
+ * @return The array to write the amplitudes into.
+ */
+AmplitudeArray getOutputArray(const std::optional<AmplitudeArray>& out,
+                              size_t numStates) {
+  if (out.has_value()) {
+    if (out->shape(0) != numStates) {
+      throw nb::value_error(
+          ("The output array must hold exactly " + std::to_string(numStates) +
+           " amplitudes")
+              .c_str());
+    }
+    return *out;
+  }
+  auto* data = new std::complex<double>[numStates](); // NOLINT
+  const nb::capsule owner(data, [](void* pointer) noexcept {
+    delete[] static_cast<std::complex<double>*>(pointer); // NOLINT
+  });
+  return AmplitudeArray(data, {numStates}, owner);
+}
+
+/**
+ * @brief View an array of amplitudes as a state vector of the debugging
+ * interface.
+ * @param array The array holding the amplitudes.
+ * @param numQubits The number of qubits of the state vector.
+ * @return The state vector writing into the array.
+ */
+Statevector asStatevector(AmplitudeArray& array, size_t numQubits) {
+  return {.numQubits = numQubits,
+          .numStates = array.shape(0),
+          .amplitudes = reinterpret_cast<Complex*>(array.data())}; // NOLINT
+}
+
+/**
+ * @brief Get the Python progress callbacks of the asynchronous runs, indexed
+ * by simulation state.
+ *
+ * A callback is kept alive until the result of its run is retrieved. The map
+ * is never destroyed, so that no Python object outlives the interpreter.
+ * @return The callbacks.
+ */
+std::unordered_map<SimulationState*, nb::object>& progressCallbacks() {
+  static auto* callbacks =
+      new std::unordered_map<SimulationState*, nb::object>(); // NOLINT
+  return *callbacks;
+}
+
+/**
+ * @brief Forward the progress of an asynchronous run to a Python callback.
+ * @param userData The Python callable to invoke.
+ * @param currentInstruction The instruction the run has reached.
+ * @param failedAssertions The number of assertions that failed so far.
+ */
+void reportProgress(void* userData, size_t currentInstruction,
+                    size_t failedAssertions) {
+  const nb::gil_scoped_acquire acquire;
+  try {
+    nb::handle(static_cast<PyObject*>(userData))(currentInstruction,
+                                                 failedAssertions);
+  } catch (nb::python_error& e) {
+    e.discard_as_unraisable(__func__);
+  }
+}
+
+/**
+ * @brief Start an asynchronous run that reports its progress to an optional
+ * Python callback.
+ * @param self The simulation state to run.
+ * @param callback The Python callable to report progress to, or None.
+ * @param run The interface method that starts the run.
+ */
+void runAsync(SimulationState* self, const nb::object& callback,
+              Result (*run)(SimulationState*, ProgressCallback, void*)) {
+  if (callback.is_none()) {
+    checkOrThrow(run(self, nullptr, nullptr));
+    progressCallbacks().erase(self);
+    return;
+  }
+  checkOrThrow(run(self, reportProgress, callback.ptr()));
+  progressCallbacks()[self] = callback;
+}
+
 } // namespace
 
 /**
@@ -68,6 +172,26 @@ struct StatevectorCPP {
   std::vector<Complex> amplitudes;
 };
 
+/**
+ * @brief A representation of state deltas in C++ style, using std::vector
+ * instead of raw buffers.
+ *
+ * This is used to make the state delta more easily accessible from Python.
+ */
+struct StateDeltaCPP {
+  size_t version = 0;
+  bool complete = false;
+  size_t currentInstruction = 0;
+  bool finished = false;
+  bool assertionFailed = false;
+  bool breakpointHit = false;
+  std::vector<Variable> changedVariables;
+  std::vector<size_t> stackTrace;
+  std::vector<std::pair<size_t, Complex>> changedAmplitudes;
+  bool amplitudesComplete = false;
+  bool amplitudesTruncated = false;
+};
+
 // NOLINTNEXTLINE(misc-use-internal-linkage)
 void bindFramework(nb::module_& m) {
   // Bind the Result enum
@@ -184,6 +308,20 @@ This is always equal to 2^`num_qubits`.)")
               R"(The amplitudes of the state vector.
 
 Contains one element for each of the `num_states` states in the state vector.)")
+      .def_prop_ro(
+          "array",
+          [](StatevectorCPP& self) {
+            return AmplitudeArray(
+                reinterpret_cast<std::complex<double>*>( // NOLINT
+                    self.amplitudes.data()),
+                {self.amplitudes.size()});
+          },
+          nb::rv_policy::reference_internal,
+          R"(The amplitudes of the state vector as an array of complex numbers.
+
+The array shares its memory with the state vector, so that it can be passed to
+NumPy without copying, e.g., using `numpy.asarray`. It stays valid as long as
+the amplitudes of the state vector are not replaced.)")
       .doc() = "Represents a state vector.";
 
   nb::class_<CompilationSettings>(m, "CompilationSettings")
@@ -202,6 +340,73 @@ Args:
       .doc() =
       "The settings that should be used to compile an assertion program.";
 
+  // Bind the ProfilePhase enum
+  nb::enum_<ProfilePhase>(m, "ProfilePhase",
+                          "A phase of executing an instruction.")
+      .value("ProfileSimulation", ProfileSimulation,
+             "Applying the operation of an instruction to the state.")
+      .value("ProfileAssertion", ProfileAssertion, "Evaluating an assertion.")
+      .value("ProfileDiagnostics", ProfileDiagnostics,
+             "Updating the diagnostics after executing an instruction.")
+      .value("ProfileDensification", ProfileDensification,
+             "Writing the state into a dense state vector.")
+      .value("ProfileGarbageCollection", ProfileGarbageCollection,
+             "Collecting unused nodes of the decision diagram package.");
+
+  // Bind the ProfileEntry struct
+  nb::class_<ProfileEntry>(m, "ProfileEntry")
+      .def(nb::init<>())
+      .def_rw("instruction", &ProfileEntry::instruction,
+              "The instruction the counters belong to.")
+      .def_rw("phase", &ProfileEntry::phase,
+              "The phase the counters belong to.")
+      .def_rw("calls", &ProfileEntry::calls,
+              "The number of times the phase was entered.")
+      .def_rw("seconds", &ProfileEntry::seconds,
+              "The wall time spent in the phase in seconds.")
+      .def_rw("nodes_before", &ProfileEntry::nodesBefore,
+              "The number of nodes of the state's decision diagram before "
+              "the phase.")
+      .def_rw("nodes_after", &ProfileEntry::nodesAfter,
+              "The number of nodes of the state's decision diagram after the "
+              "phase.")
+      .def_rw("dense_bytes", &ProfileEntry::denseBytes,
+              "The number of bytes of dense state vectors the phase wrote.")
+      .doc() = R"(The profiling counters of one phase of one instruction.
+
+All counters are summed over all calls of the phase while the instruction was executed.)";
+
+  // Bind the StateDelta struct
+  nb::class_<StateDeltaCPP>(m, "StateDelta")
+      .def(nb::init<>(), "Creates a new `StateDelta` instance.")
+      .def_rw("version", &StateDeltaCPP::version,
+              "The version of the reported state, to be passed to the next "
+              "call.")
+      .def_rw("complete", &StateDeltaCPP::complete,
+              "True if all classical variables are reported because the "
+              "given version was not the one returned by the previous call.")
+      .def_rw("current_instruction", &StateDeltaCPP::currentInstruction,
+              "The instruction that is executed next.")
+      .def_rw("finished", &StateDeltaCPP::finished,
+              "True if the simulation has finished.")
+      .def_rw("assertion_failed", &StateDeltaCPP::assertionFailed,
+              "True if the last step stopped at a failing assertion.")
+      .def_rw("breakpoint_hit", &StateDeltaCPP::breakpointHit,
+              "True if the last step stopped at a breakpoint.")
+      .def_rw("changed_variables", &StateDeltaCPP::changedVariables,
+              "The classical variables whose value changed.")
+      .def_rw("stack_trace", &StateDeltaCPP::stackTrace,
+              "The full stack trace of the simulation.")
+      .def_rw("changed_amplitudes", &StateDeltaCPP::changedAmplitudes,
+              "The indices and values of the changed amplitudes, in ascending "
+              "order of their indices.")
+      .def_rw("amplitudes_complete", &StateDeltaCPP::amplitudesComplete,
+              "True if amplitudes are reported relative to zero, because the "
+              "previous call did not report or keep amplitudes.")
+      .def_rw("amplitudes_truncated", &StateDeltaCPP::amplitudesTruncated,
+              "True if not all changed amplitudes could be reported.")
+      .doc() = R"(The changes of a simulation state since an earlier version.)";
+
   nb::class_<SimulationState>(m, "SimulationState")
       .def(nb::init<>(), "Creates a new `SimulationState` instance.")
       .def(
@@ -218,6 +423,23 @@ Args:
 Args:
     code: The code to load.
 
+Returns:
+    LoadResult: The result of the load operation.)")
+      .def(
+          "reload_code",
+          [](SimulationState* self, const char* code) {
+            return self->reloadCode(self, code);
+          },
+          "code"_a,
+          R"(Replaces the loaded code by an edited version of it.
+
+In contrast to `load_code`, the simulation is not restarted if the edit does not affect the instructions that have already been executed. Instead, it continues from the last reproducible point before the first edited instruction. Breakpoints are kept.
+
+If the new code cannot be loaded, the previously loaded code and the current simulation state are kept. If no code has been loaded yet, this behaves like `load_code`.
+
+Args:
+    code: The edited code to load.
+
 Returns:
     LoadResult: The result of the load operation.)")
       .def(
@@ -305,6 +527,56 @@ stop as soon as possible, but it is not guaranteed to stop immediately.
 If the simulation is not running, then the next call to continue the
 simulation will stop as soon as possible. `step over` and `step out`
 methods, in particular, may still execute the next instruction.)")
+      .def(
+          "run_simulation_async",
+          [](SimulationState* self, const nb::object& callback) {
+            runAsync(self, callback, self->runSimulationAsync);
+          },
+          "callback"_a = nb::none(),
+          R"(Runs the simulation on a worker thread until it finishes, an assertion fails, or a breakpoint is hit.
+
+The method returns as soon as the run was started. Until the run has completed, the state must only be accessed through `pause_simulation`, `is_simulation_running`, and `wait_for_simulation`. Pausing the simulation cancels the run after the current instruction.
+
+Args:
+    callback: A callable that receives the reached instruction and the number of failed assertions at intervals and once more when the run ends. It is called on the worker thread.)")
+      .def(
+          "run_all_async",
+          [](SimulationState* self, const nb::object& callback) {
+            runAsync(self, callback, self->runAllAsync);
+          },
+          "callback"_a = nb::none(),
+          R"(Runs the simulation on a worker thread until it finishes, even if assertions fail.
+
+This behaves like `run_simulation_async`, except that the run continues after failed assertions and breakpoints. Pausing the simulation ends the whole run.
+
+Args:
+    callback: A callable that receives the reached instruction and the number of failed assertions at intervals and once more when the run ends. It is called on the worker thread.)")
+      .def(
+          "is_simulation_running",
+          [](SimulationState* self) { return self->isSimulationRunning(self); },
+          R"(Checks whether an asynchronous run is still in progress.
+
+Returns:
+    True, if an asynchronous run is in progress.)")
+      .def(
+          "wait_for_simulation",
+          [](SimulationState* self) {
+            size_t errors = 0;
+            Result result = OK;
+            {
+              const nb::gil_scoped_release release;
+              result = self->waitForSimulation(self, &errors);
+            }
+            progressCallbacks().erase(self);
+            checkOrThrow(result);
+            return errors;
+          },
+          R"(Waits for the last asynchronous run to complete.
+
+Once this method returned, the state may be accessed again.
+
+Returns:
+    The number of assertions that failed during the run.)")
       .def(
           "can_step_forward",
           [](SimulationState* self) { return self->canStepForward(self); },
@@ -555,10 +827,10 @@ Returns:
           "get_state_vector_full",
           [](SimulationState* self) {
             const size_t numQubits = self->getNumQubits(self);
-            const std::vector<Complex> amplitudes(1 << numQubits);
-            StatevectorCPP result{.numQubits = numQubits,
-                                  .numStates = 1ULL << numQubits,
-                                  .amplitudes = amplitudes};
+            StatevectorCPP result{
+                .numQubits = numQubits,
+                .numStates = 1ULL << numQubits,
+                .amplitudes = std::vector<Complex>(1ULL << numQubits)};
             Statevector output{.numQubits = numQubits,
                                .numStates = result.numStates,
                                .amplitudes = result.amplitudes.data()};
@@ -569,14 +841,40 @@ Returns:
 
 Returns:
     The full state vector of the current simulation state.)")
+      .def(
+          "get_state_vector_range",
+          [](SimulationState* self, size_t start, size_t count) {
+            const size_t numQubits = self->getNumQubits(self);
+            StatevectorCPP result{.numQubits = numQubits,
+                                  .numStates = count,
+                                  .amplitudes = std::vector<Complex>(count)};
+            Statevector output{.numQubits = numQubits,
+                               .numStates = result.numStates,
+                               .amplitudes = result.amplitudes.data()};
+            checkOrThrow(
+                self->getStateVectorRange(self, start, count, &output));
+            return result;
+          },
+          "start"_a, "count"_a,
+          R"(Gets a contiguous range of amplitudes of the full state vector of the simulation at the current time.
+
+This allows large state vectors to be read page by page, so that memory only
+has to be allocated for the requested range.
+
+Args:
+    start: The index of the first amplitude to retrieve.
+    count: The number of amplitudes to retrieve.
+
+Returns:
+    A state vector holding the `count` requested amplitudes, starting with the amplitude at index `start`.)")
       .def(
           "get_state_vector_sub",
           [](SimulationState* self, std::vector<size_t> qubits) {
             const size_t numQubits = qubits.size();
-            const std::vector<Complex> amplitudes(1 << numQubits);
-            StatevectorCPP result{.numQubits = numQubits,
-                                  .numStates = 1ULL << numQubits,
-                                  .amplitudes = amplitudes};
+            StatevectorCPP result{
+                .numQubits = numQubits,
+                .numStates = 1ULL << numQubits,
+                .amplitudes = std::vector<Complex>(1ULL << numQubits)};
             Statevector output{.numQubits = numQubits,
                                .numStates = result.numStates,
                                .amplitudes = result.amplitudes.data()};
@@ -595,6 +893,103 @@ Args:
 
 Returns:
     The sub-state vector of the current simulation state.)")
+      .def(
+          "get_state_vector_full_array",
+          [](SimulationState* self, const std::optional<AmplitudeArray>& out) {
+            const size_t numQubits = self->getNumQubits(self);
+            auto array = getOutputArray(out, 1ULL << numQubits);
+            auto output = asStatevector(array, numQubits);
+            checkOrThrow(self->getStateVectorFull(self, &output));
+            return array;
+          },
+          "out"_a = nb::none(),
+          R"(Gets the full state vector of the simulation at the current time as an array.
+
+The amplitudes are written directly into the memory of the returned array,
+which supports the buffer protocol, so that no Python objects are created for
+the individual amplitudes.
+
+Args:
+    out: An optional contiguous array of `2^n` complex numbers to write the amplitudes into. If not given, a new array is allocated.
+
+Returns:
+    The array containing the amplitudes of the full state vector.)")
+      .def(
+          "get_state_vector_sub_array",
+          [](SimulationState* self, const std::vector<size_t>& qubits,
+             const std::optional<AmplitudeArray>& out) {
+            const size_t numQubits = qubits.size();
+            auto array = getOutputArray(out, 1ULL << numQubits);
+            auto output = asStatevector(array, numQubits);
+            checkOrThrow(self->getStateVectorSub(self, numQubits, qubits.data(),
+                                                 &output));
+            return array;
+          },
+          "qubits"_a, "out"_a = nb::none(),
+          R"(Gets a sub-state of the state vector of the simulation at the current time as an array.
+
+The amplitudes are written directly into the memory of the returned array,
+which supports the buffer protocol, so that no Python objects are created for
+the individual amplitudes.
+
+Args:
+    qubits: The qubits to include in the sub-state.
+    out: An optional contiguous array of `2^k` complex numbers to write the amplitudes into, where `k` is the number of qubits. If not given, a new array is allocated.
+
+Returns:
+    The array containing the amplitudes of the sub-state vector.)")
+      .def(
+          "get_non_zero_amplitudes",
+          [](SimulationState* self, double threshold, size_t maxCount) {
+            std::vector<size_t> indices(maxCount);
+            std::vector<Complex> amplitudes(maxCount);
+            size_t count = 0;
+            checkOrThrow(self->getNonZeroAmplitudes(self, threshold, maxCount,
+                                                    indices.data(),
+                                                    amplitudes.data(), &count));
+            std::vector<std::pair<size_t, Complex>> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+              result.emplace_back(indices[i], amplitudes[i]);
+            }
+            return result;
+          },
+          "threshold"_a, "max_count"_a,
+          R"(Gets the amplitudes of the full state vector whose magnitude exceeds a threshold.
+
+Only the parts of the state that contain such amplitudes are visited, so the
+cost depends on the number of results rather than on the size of the state
+vector.
+
+Args:
+    threshold: The magnitude an amplitude has to exceed to be returned. Use 0 to get all non-zero amplitudes.
+    max_count: The maximum number of amplitudes to return.
+
+Returns:
+    The indices and values of the amplitudes, in ascending order of their indices.)")
+      .def(
+          "get_top_k_amplitudes",
+          [](SimulationState* self, size_t k) {
+            std::vector<size_t> indices(k);
+            std::vector<Complex> amplitudes(k);
+            size_t count = 0;
+            checkOrThrow(self->getTopKAmplitudes(self, k, indices.data(),
+                                                 amplitudes.data(), &count));
+            std::vector<std::pair<size_t, Complex>> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+              result.emplace_back(indices[i], amplitudes[i]);
+            }
+            return result;
+          },
+          "k"_a,
+          R"(Gets the non-zero amplitudes of the full state vector with the largest magnitudes.
+
+Args:
+    k: The maximum number of amplitudes to return.
+
+Returns:
+    The indices and values of the amplitudes, in descending order of their magnitudes.)")
       .def(
           "set_breakpoint",
           [](SimulationState* self, size_t desiredPosition) {
@@ -684,6 +1079,161 @@ Args:
 
 Returns:
     The compiled code.)")
+      .def(
+          "compile_slices",
+          [](SimulationState* self, CompilationSettings& settings) {
+            size_t numSlices = 0;
+            const auto size = self->compileSlices(self, nullptr, nullptr,
+                                                  &numSlices, settings);
+            std::vector<char> buffer(size);
+            std::vector<size_t> offsets(numSlices);
+            self->compileSlices(self, buffer.data(), offsets.data(), nullptr,
+                                settings);
+            std::vector<std::string> slices;
+            slices.reserve(numSlices);
+            for (const auto offset : offsets) {
+              slices.emplace_back(buffer.data() + offset);
+            }
+            return slices;
+          },
+          "settings"_a,
+          R"(Compiles all slices of the given code in a single pass.
+
+The assertions are partitioned into slices only once, which is considerably
+faster than calling `compile` for each slice index.
+
+Args:
+    settings: The settings to use for the compilation. The slice index is ignored.
+
+Returns:
+    The compiled code of each slice, in the order of their slice indices.)")
+      .def(
+          "set_seed",
+          [](SimulationState* self, size_t seed) {
+            checkOrThrow(self->setSeed(self, seed));
+          },
+          "seed"_a,
+          R"(Sets the seed of the random number generator used for measurements.
+
+Args:
+    seed: The seed to use.)")
+      .def(
+          "sample_shots",
+          [](SimulationState* self, size_t shots, size_t seed) {
+            const auto numBits = self->getNumClassicalVariables(self);
+            auto maxOutcomes = shots;
+            if (numBits < std::numeric_limits<size_t>::digits) {
+              maxOutcomes = std::min(maxOutcomes, size_t{1} << numBits);
+            }
+            std::vector<size_t> outcomes(maxOutcomes);
+            std::vector<size_t> counts(maxOutcomes);
+            size_t numOutcomes = 0;
+            checkOrThrow(self->sampleShots(self, shots, seed, outcomes.data(),
+                                           counts.data(), maxOutcomes,
+                                           &numOutcomes));
+            std::map<size_t, size_t> histogram;
+            for (size_t i = 0; i < numOutcomes; i++) {
+              histogram.emplace(outcomes[i], counts[i]);
+            }
+            return histogram;
+          },
+          "shots"_a, "seed"_a,
+          R"(Samples the classical outcomes of multiple executions of the program.
+
+The program is simulated up to each measurement only once. The shots reaching
+a measurement are then split between its outcomes according to their
+probabilities, and each branch continues from the post-measurement state.
+
+Args:
+    shots: The number of executions to sample.
+    seed: The seed of the random number generator used for sampling.
+
+Returns:
+    A mapping from each sampled outcome to its number of shots. Bit i of an
+    outcome holds the value of classical bit i.)")
+      .def(
+          "set_profiling_enabled",
+          [](SimulationState* self, bool enabled) {
+            checkOrThrow(self->setProfilingEnabled(self, enabled));
+          },
+          "enabled"_a,
+          R"(Enables or disables the collection of profiling counters.
+
+While profiling is disabled, no counters are collected and executing
+instructions has no measurable overhead. Enabling profiling discards all
+previously collected counters.
+
+Args:
+    enabled: True to enable profiling, false to disable it.)")
+      .def(
+          "get_profile",
+          [](SimulationState* self) {
+            // The first call only determines the number of entries, so it
+            // fails if there are any.
+            size_t numEntries = 0;
+            self->getProfile(self, nullptr, 0, &numEntries);
+            std::vector<ProfileEntry> entries(numEntries);
+            checkOrThrow(self->getProfile(self, entries.data(), entries.size(),
+                                          &numEntries));
+            return entries;
+          },
+          R"(Gets the profiling counters collected since profiling was enabled.
+
+Returns:
+    One entry for each phase of each instruction that was entered at least once, sorted by instruction and then by phase.)")
+      .def(
+          "get_state_delta",
+          [](SimulationState* self, size_t sinceVersion, size_t maxAmplitudes,
+             double amplitudeTolerance) {
+            size_t stackDepth = 0;
+            checkOrThrow(self->getStackDepth(self, &stackDepth));
+            StateDeltaCPP result;
+            result.changedVariables.resize(
+                self->getNumClassicalVariables(self));
+            result.stackTrace.resize(stackDepth);
+            std::vector<size_t> indices(maxAmplitudes);
+            std::vector<Complex> amplitudes(maxAmplitudes);
+            StateDelta delta{};
+            delta.changedVariables = result.changedVariables.data();
+            delta.maxChangedVariables = result.changedVariables.size();
+            delta.stackTrace = result.stackTrace.data();
+            delta.maxStackDepth = result.stackTrace.size();
+            delta.amplitudeTolerance = amplitudeTolerance;
+            delta.amplitudeIndices = indices.data();
+            delta.amplitudes = amplitudes.data();
+            delta.maxAmplitudes = maxAmplitudes;
+            checkOrThrow(self->getStateDelta(self, sinceVersion, &delta));
+
+            result.version = delta.version;
+            result.complete = delta.complete;
+            result.currentInstruction = delta.currentInstruction;
+            result.finished = delta.finished;
+            result.assertionFailed = delta.assertionFailed;
+            result.breakpointHit = delta.breakpointHit;
+            result.changedVariables.resize(delta.numChangedVariables);
+            result.changedAmplitudes.reserve(delta.numAmplitudes);
+            for (size_t i = 0; i < delta.numAmplitudes; i++) {
+              result.changedAmplitudes.emplace_back(indices[i], amplitudes[i]);
+            }
+            result.amplitudesComplete = delta.amplitudesComplete;
+            result.amplitudesTruncated = delta.amplitudesTruncated;
+            return result;
+          },
+          "since_version"_a = 0, "max_amplitudes"_a = 0,
+          "amplitude_tolerance"_a = 1e-9,
+          R"(Gets the changes of the simulation state since an earlier call.
+
+Each call returns a new version that identifies the reported state. Passing this version to the next call only reports the classical variables and amplitudes that changed in between. For any other version, such as 0, all classical variables and all amplitudes with a magnitude above the tolerance are reported. The current instruction, the stack trace, and whether an assertion or breakpoint stopped the simulation are always reported.
+
+This allows front ends to refresh their view of the state with a single call after each stop.
+
+Args:
+    since_version: The version returned by the previous call, or 0.
+    max_amplitudes: The maximum number of changed amplitudes to report. No amplitudes are reported if this is 0.
+    amplitude_tolerance: The minimum magnitude of the change of an amplitude to be reported.
+
+Returns:
+    The changes of the simulation state.)")
       .doc() = R"(Represents the state of a quantum simulation for debugging.
 
 This is the main class of the `mqt-debugger` library, allowing developers to step through the code and inspect the state of the simulation.)";
@@ -769,6 +1319,42 @@ Args:
 
 Returns:
     A list of instruction indices that are data dependencies of the given instruction.)")
+      .def(
+          "get_data_dependencies_batch",
+          [](Diagnostics* self, const std::vector<size_t>& instructions,
+             bool includeCallers) {
+            const auto count = self->getInstructionCount(self);
+            std::vector<uint8_t> dependencies(instructions.size() * count);
+            // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+            checkOrThrow(self->getDataDependenciesBatch(
+                self, instructions.data(), instructions.size(), includeCallers,
+                reinterpret_cast<bool*>(dependencies.data())));
+            // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+            std::vector<std::vector<size_t>> result(instructions.size());
+            for (size_t i = 0; i < instructions.size(); i++) {
+              for (size_t j = 0; j < count; j++) {
+                if (dependencies[(i * count) + j] != 0) {
+                  result[i].push_back(j);
+                }
+              }
+            }
+            return result;
+          },
+          "instructions"_a, "include_callers"_a = false,
+          R"(Extract all data dependencies for several instructions at once.
+
+The dependencies of each instruction are determined in the same way as by
+`get_data_dependencies`.
+
+This method can be performed without running the program, as it is a static
+analysis method.
+
+Args:
+    instructions: The instructions to extract the data dependencies for.
+    include_callers: True, if the data dependencies should include all possible callers of the containing custom gates. Defaults to False.
+
+Returns:
+    For each given instruction, a list of instruction indices that are its data dependencies.)")
       .def(
           "get_interactions",
           [](Diagnostics* self, size_t beforeInstruction, size_t qubit) {
@@ -804,6 +1390,30 @@ Args:
 
 Returns:
     A list of qubit indices that interact with the given qubit up to the target instruction.)")
+      .def(
+          "get_interaction_components",
+          [](Diagnostics* self, size_t beforeInstruction) {
+            std::vector<size_t> components(self->getNumQubits(self));
+            checkOrThrow(self->getInteractionComponents(
+                self, beforeInstruction, components.data()));
+            return components;
+          },
+          "before_instruction"_a,
+          R"(Extract the groups of interacting qubits up to a specific instruction for all qubits at once.
+
+Each qubit is assigned the smallest qubit index of the group of qubits it
+interacts with, so two qubits interact if and only if they are assigned the
+same value. The interactions are determined in the same way as by
+`get_interactions`.
+
+This method can be performed without running the program, as it is a static
+analysis method.
+
+Args:
+    before_instruction: The instruction to extract the interactions up to (excluding).
+
+Returns:
+    For each qubit, the smallest qubit index of the group of qubits it interacts with.)")
       .def(
           "get_zero_control_instructions",
           [](Diagnostics* self) {
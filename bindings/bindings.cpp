@@ -24,9 +24,11 @@ using namespace nb::literals;
 void bindFramework(nb::module_& m);
 void bindDiagnostics(nb::module_& m);
 void bindBackend(nb::module_& m);
+void bindCheck(nb::module_& m);
 
 NB_MODULE(MQT_DEBUGGER_MODULE_NAME, m) {
   bindDiagnostics(m);
   bindFramework(m);
   bindBackend(m);
+  bindCheck(m);
 }
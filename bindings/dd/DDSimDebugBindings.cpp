@@ -17,24 +17,127 @@
  */
 
 #include "backend/dd/DDSimDebug.hpp"
+#include "backend/dd/DDSimDense.hpp"
 #include "backend/debug.h"
+#include "ir/operations/NonUnitaryOperation.hpp"
+#include "ir/operations/OpType.hpp"
+#include "ir/operations/Operation.hpp"
 #include "nanobind/nanobind.h"
 
+#include <cstddef>
+#include <nanobind/stl/pair.h>   // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/string.h> // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/tuple.h>  // NOLINT(misc-include-cleaner)
+#include <nanobind/stl/vector.h> // NOLINT(misc-include-cleaner)
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 namespace nb = nanobind;
 using namespace nb::literals;
 using namespace mqt::debugger;
 
+namespace {
+
+/**
+ * @brief An operation of a compiled slice, consisting of its name, controls,
+ * targets, parameters, and classical bits.
+ */
+using SliceOperation =
+    std::tuple<std::string, std::vector<size_t>, std::vector<size_t>,
+               std::vector<double>, std::vector<size_t>>;
+
+/**
+ * @brief A compiled slice, consisting of its assertions, its number of qubits
+ * and classical bits, and its operations.
+ */
+using SliceOperations = std::tuple<std::vector<std::string>, size_t, size_t,
+                                   std::vector<SliceOperation>>;
+
+/**
+ * @brief Convert the circuit of a compiled slice into a list of operations.
+ * @param slice The slice to convert.
+ * @return The converted slice.
+ * @throws std::invalid_argument If the circuit contains an operation that
+ * cannot be represented in the list.
+ */
+SliceOperations toSliceOperations(const SliceCircuit& slice) {
+  std::vector<SliceOperation> operations;
+  for (const auto& op : slice.circuit) {
+    if (!op->isStandardOperation() && !op->isNonUnitaryOperation()) {
+      throw std::invalid_argument(
+          "Operation '" + qc::toString(op->getType()) +
+          "' cannot be represented as a slice operation.");
+    }
+    std::vector<size_t> controls;
+    for (const auto& control : op->getControls()) {
+      if (control.type != qc::Control::Type::Pos) {
+        throw std::invalid_argument(
+            "Negative controls cannot be represented as a slice operation.");
+      }
+      controls.push_back(control.qubit);
+    }
+    std::vector<size_t> classics;
+    if (op->isNonUnitaryOperation()) {
+      const auto& bits =
+          dynamic_cast<const qc::NonUnitaryOperation&>(*op).getClassics();
+      classics.assign(bits.begin(), bits.end());
+    }
+    operations.emplace_back(
+        qc::toString(op->getType()), std::move(controls),
+        std::vector<size_t>(op->getTargets().begin(), op->getTargets().end()),
+        op->getParameter(), std::move(classics));
+  }
+  return {slice.assertions, slice.circuit.getNqubits(),
+          slice.circuit.getNcbits(), std::move(operations)};
+}
+
+} // namespace
+
 // NOLINTNEXTLINE(misc-use-internal-linkage)
 void bindBackend(nb::module_& m) {
+  nb::enum_<SimulationBackend>(
+      m, "SimulationBackend",
+      "The backends that can store the state of a DD-based `SimulationState`.")
+      .value("DecisionDiagram", SimulationBackend::DecisionDiagram,
+             "The state is stored as a decision diagram.")
+      .value("Dense", SimulationBackend::Dense,
+             "The state is stored as a flat array of amplitudes.");
+
   m.def(
       "create_ddsim_simulation_state",
-      []() {
+      [](SimulationState* source, SimulationBackend backend) {
         // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
         auto* state = new DDSimulationState();
-        createDDSimulationState(state);
+        createDDSimulationState(state, backend);
+        if (source != nullptr) {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          const auto* ddsim = reinterpret_cast<DDSimulationState*>(source);
+          if (ddsim->ready &&
+              ddsimLoadProgram(state, ddsim->program) == ERROR) {
+            destroyDDSimulationState(state);
+            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+            delete state;
+            throw std::invalid_argument(
+                "The program of the source state cannot be simulated by the "
+                "selected backend.");
+          }
+        }
         return &state->interface;
       },
-      R"(Creates a new `SimulationState` instance using the DD backend for simulation and the OpenQASM language as input format.
+      nb::arg("source").none() = nb::none(),
+      nb::arg("backend") = SimulationBackend::DecisionDiagram,
+      R"(Creates a new `SimulationState` instance using the DD simulator and the OpenQASM language as input format.
+
+If a source state is given, the new state shares the program loaded into it instead of parsing the code again. Both states can then be executed independently.
+
+The backend determines how the quantum state is stored. The dense backend keeps a flat array of amplitudes, which is faster for small, unstructured circuits, and supports programs with up to 28 qubits.
+
+Args:
+    source: A DD-based simulation state whose loaded program should be shared, or `None` to create an empty state.
+    backend: The backend that stores the quantum state.
 
 Returns:
     The created simulation state.)");
@@ -42,6 +145,8 @@ Returns:
   m.def(
       "destroy_ddsim_simulation_state",
       [](SimulationState* state) {
+        // An asynchronous run may still need the GIL to report its progress.
+        const nb::gil_scoped_release release;
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
         destroyDDSimulationState(reinterpret_cast<DDSimulationState*>(state));
       },
@@ -50,4 +155,78 @@ Returns:
 
 Args:
     state: The simulation state to delete.)");
+
+  m.def(
+      "set_dense_memory_budget",
+      [](SimulationState* state, size_t budget) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<DDSimulationState*>(state)->denseMemoryBudget = budget;
+      },
+      "state"_a, "budget"_a,
+      R"(Set the number of bytes that dense buffers of amplitudes of a DD-based `SimulationState` may occupy at the same time.
+
+Operations that would exceed the budget use an algorithm on the decision diagram instead where one exists, and fail otherwise.
+
+Args:
+    state: The simulation state to configure.
+    budget: The budget in bytes.)");
+
+  m.def(
+      "get_dense_memory_usage",
+      [](SimulationState* state) {
+        const auto usage = ddsimGetDenseMemoryUsage(
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            reinterpret_cast<DDSimulationState*>(state));
+        return std::make_pair(usage.current, usage.peak);
+      },
+      "state"_a,
+      R"(Get the memory occupied by the dense buffers of amplitudes of a DD-based `SimulationState`.
+
+Args:
+    state: The simulation state to query.
+
+Returns:
+    The number of bytes occupied right now, including cached buffers, and the largest number of bytes that was occupied at the same time.)");
+
+  m.def(
+      "set_fast_run",
+      [](SimulationState* state, bool enabled) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<DDSimulationState*>(state)->fastRun = enabled;
+      },
+      "state"_a, "enabled"_a,
+      R"(Enable or disable fast-run mode for a DD-based `SimulationState`.
+
+In fast-run mode, running the simulation applies consecutive unitary gates without breakpoints as a single chain of products without intermediate garbage collection. Diagnostics and stepping back behave as if each gate had been stepped over individually.
+
+Args:
+    state: The simulation state to configure.
+    enabled: Whether fast-run mode is enabled.)");
+
+  m.def(
+      "compile_slice_operations",
+      [](SimulationState* state, CompilationSettings settings) {
+        std::vector<SliceOperations> result;
+        {
+          const nb::gil_scoped_release release;
+          const auto slices = ddsimCompileSliceCircuits(
+              // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+              reinterpret_cast<DDSimulationState*>(state), settings);
+          for (const auto& slice : slices) {
+            result.push_back(toSliceOperations(slice));
+          }
+        }
+        return result;
+      },
+      "state"_a, "settings"_a,
+      R"(Compile all slices of the code loaded into a DD-based `SimulationState` into lists of operations.
+
+The operations are taken from the already imported program instead of code, so that the slices do not need to be parsed again. Each slice is equivalent to the code that `compile_slices` produces for it. Operations are given by their name, such as `h`, `x`, or `measure`, their control qubits, target qubits, parameters, and classical bits. The targets of the assertions are measured into single-bit classical registers that follow the registers of the program.
+
+Args:
+    state: The simulation state to compile the slices of.
+    settings: The settings to use for the compilation. The slice index is ignored.
+
+Returns:
+    For each slice, in the order of their slice indices, its assertions in the format of the `// ASSERT:` comments of compiled code, its number of qubits and classical bits, and its operations.)");
 }
@@ -67,6 +67,21 @@ if(BUILD_MQT_DEBUGGER_TESTS)
   list(APPEND FETCH_PACKAGES googletest)
 endif()
 
+if(BUILD_MQT_DEBUGGER_BENCHMARKS)
+  set(BENCHMARK_ENABLE_TESTING
+      OFF
+      CACHE BOOL "Disable testing for Google Benchmark")
+  set(BENCHMARK_ENABLE_INSTALL
+      OFF
+      CACHE BOOL "Disable installation of Google Benchmark")
+  set(GBENCH_VERSION
+      1.9.4
+      CACHE STRING "Google Benchmark version")
+  set(GBENCH_URL https://github.com/google/benchmark/archive/refs/tags/v${GBENCH_VERSION}.tar.gz)
+  FetchContent_Declare(benchmark URL ${GBENCH_URL} FIND_PACKAGE_ARGS ${GBENCH_VERSION})
+  list(APPEND FETCH_PACKAGES benchmark)
+endif()
+
 # Make all declared dependencies available.
 FetchContent_MakeAvailable(${FETCH_PACKAGES})
 
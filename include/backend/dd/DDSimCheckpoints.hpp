@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimCheckpoints.hpp
+ * @brief Provides a store of simulation snapshots that allows the DD simulator
+ * to travel back in time.
+ */
+#pragma once
+
+#include "common.h"
+#include "common/DensityMatrix.hpp"
+#include "dd/Package.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief The default number of steps between two regular checkpoints.
+ */
+constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 32;
+
+/**
+ * @brief The default memory budget of a checkpoint store in bytes.
+ */
+constexpr size_t DEFAULT_CHECKPOINT_MEMORY_BUDGET = 64ULL << 20;
+
+/**
+ * @brief The values of all classical bits of a program, packed into words.
+ *
+ * Classical bit `i` is stored in bit `i % 64` of word `i / 64`.
+ */
+using ClassicalBits = std::vector<uint64_t>;
+
+/**
+ * @brief A snapshot of the simulation state before a given execution step.
+ */
+struct DDSimCheckpoint {
+  /**
+   * @brief The quantum state. The store holds a reference to it.
+   *
+   * For simulation states that use the dense backend, this is a terminal and
+   * the state is stored in `amplitudes` instead.
+   */
+  dd::VectorDD state;
+  /**
+   * @brief The amplitudes of the quantum state if the state is dense, and
+   * empty otherwise.
+   */
+  AmplitudeBuffer amplitudes;
+  /**
+   * @brief The instruction that is executed next.
+   */
+  size_t currentInstruction;
+  /**
+   * @brief The index of the operation that is applied next.
+   */
+  size_t operationIndex;
+  /**
+   * @brief The values of all classical bits.
+   */
+  ClassicalBits classicalBits;
+  /**
+   * @brief The stack of return instructions.
+   */
+  std::vector<size_t> callReturnStack;
+  /**
+   * @brief The elements removed from the stack of return instructions.
+   */
+  std::vector<std::pair<size_t, size_t>> restoreCallReturnStack;
+  /**
+   * @brief The last instruction that failed an assertion.
+   */
+  size_t lastFailedAssertion;
+  /**
+   * @brief The estimated memory held by the checkpoint in bytes.
+   *
+   * This is computed by the store when the checkpoint is captured.
+   */
+  size_t memory;
+};
+
+/**
+ * @brief Stores checkpoints of the simulation state, indexed by the number of
+ * execution steps performed before they were taken.
+ *
+ * Checkpoints are taken at regular intervals and before every step that cannot
+ * be undone by applying an inverse operation. If the estimated memory of all
+ * checkpoints exceeds the budget, checkpoints are evicted so that the
+ * remaining ones stay spread out as evenly as possible. The checkpoint of the
+ * first step is never evicted, so that every step can be restored by
+ * replaying from it.
+ */
+class DDSimCheckpointStore {
+public:
+  /**
+   * @brief Set the number of steps between two regular checkpoints.
+   * @param steps The number of steps, or 0 to only take the checkpoints that
+   * are required for stepping back over non-reversible steps.
+   */
+  void setInterval(size_t steps);
+
+  /**
+   * @brief Get the number of steps between two regular checkpoints.
+   * @return The number of steps.
+   */
+  [[nodiscard]] size_t getInterval() const;
+
+  /**
+   * @brief Set the maximum estimated memory of all checkpoints.
+   *
+   * Checkpoints are evicted immediately if the new budget is exceeded.
+   * @param bytes The memory budget in bytes.
+   * @param package The DD package that holds the checkpointed states.
+   */
+  void setMemoryBudget(size_t bytes, dd::Package& package);
+
+  /**
+   * @brief Get the maximum estimated memory of all checkpoints.
+   * @return The memory budget in bytes.
+   */
+  [[nodiscard]] size_t getMemoryBudget() const;
+
+  /**
+   * @brief Get the estimated memory of all stored checkpoints.
+   * @return The estimated memory in bytes.
+   */
+  [[nodiscard]] size_t getMemoryUsage() const;
+
+  /**
+   * @brief Get the number of stored checkpoints.
+   * @return The number of checkpoints.
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Check whether a checkpoint should be taken before the given step.
+   * @param step The index of the step.
+   * @param irreversible Whether the step cannot be undone by an inverse
+   * operation.
+   * @return True if a checkpoint should be taken, false otherwise.
+   */
+  [[nodiscard]] bool shouldCapture(size_t step, bool irreversible) const;
+
+  /**
+   * @brief Store a checkpoint for the given step.
+   *
+   * An existing checkpoint for the same step is kept. The store takes a
+   * reference to the checkpointed state.
+   * @param step The index of the step.
+   * @param checkpoint The checkpoint to store.
+   * @param package The DD package that holds the checkpointed states.
+   */
+  void capture(size_t step, DDSimCheckpoint checkpoint, dd::Package& package);
+
+  /**
+   * @brief Find the latest checkpoint taken before or at the given step.
+   * @param step The index of the step.
+   * @return The step index and checkpoint, or nullptr if there is none.
+   */
+  [[nodiscard]] const std::pair<const size_t, DDSimCheckpoint>*
+  findLatest(size_t step) const;
+
+  /**
+   * @brief Discard all checkpoints taken at or after the given step.
+   * @param step The index of the first step to discard.
+   * @param package The DD package that holds the checkpointed states.
+   */
+  void discardFrom(size_t step, dd::Package& package);
+
+  /**
+   * @brief Apply a function to the classical bits of all checkpoints.
+   *
+   * This is required when the layout of the classical bits changes.
+   * @param update The function to apply to the classical bits of each
+   * checkpoint.
+   */
+  void updateClassicalBits(const std::function<void(ClassicalBits&)>& update);
+
+  /**
+   * @brief Discard all checkpoints.
+   * @param package The DD package that holds the checkpointed states.
+   */
+  void clear(dd::Package& package);
+
+private:
+  /**
+   * @brief Evict checkpoints until the memory budget is met.
+   * @param package The DD package that holds the checkpointed states.
+   */
+  void enforceBudget(dd::Package& package);
+
+  /**
+   * @brief Remove a checkpoint and release its state.
+   * @param it The position of the checkpoint to remove.
+   * @param package The DD package that holds the checkpointed states.
+   * @return The position following the removed checkpoint.
+   */
+  std::map<size_t, DDSimCheckpoint>::iterator
+  erase(std::map<size_t, DDSimCheckpoint>::iterator it, dd::Package& package);
+
+  /**
+   * @brief The number of steps between two regular checkpoints.
+   */
+  size_t interval = DEFAULT_CHECKPOINT_INTERVAL;
+
+  /**
+   * @brief The maximum estimated memory of all checkpoints in bytes.
+   */
+  size_t memoryBudget = DEFAULT_CHECKPOINT_MEMORY_BUDGET;
+
+  /**
+   * @brief The estimated memory of all stored checkpoints in bytes.
+   */
+  size_t memoryUsage = 0;
+
+  /**
+   * @brief The stored checkpoints, keyed by their step index.
+   */
+  std::map<size_t, DDSimCheckpoint> checkpoints;
+};
+
+} // namespace mqt::debugger
@@ -15,21 +15,34 @@
  */
 #pragma once
 
+#include "DDSimCheckpoints.hpp"
+#include "DDSimDense.hpp"
+#include "DDSimDependencies.hpp"
 #include "DDSimDiagnostics.hpp"
+#include "DDSimInteractions.hpp"
+#include "DDSimProfiler.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "common/DensityMatrix.hpp"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/AssertionTools.hpp"
 #include "dd/Package.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/Operation.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
+#include <random>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -63,6 +76,20 @@ enum InstructionType : uint8_t {
   RETURN
 };
 
+/**
+ * @brief Represents the flags that can be set on an instruction.
+ */
+enum InstructionFlag : uint8_t {
+  /**
+   * @brief The user has set a breakpoint on the instruction.
+   */
+  BREAKPOINT = 1U << 0U,
+  /**
+   * @brief The instruction is a custom gate definition.
+   */
+  FUNCTION_DEFINITION = 1U << 1U
+};
+
 /**
  * @brief Represents a qubit register in the code.
  */
@@ -100,47 +127,304 @@ struct ClassicalRegisterDefinition {
 };
 
 /**
- * @brief The DD-simulator implementation of the `SimulationState` interface.
+ * @brief A classic-controlled condition, compiled to the classical bits it
+ * compares.
  */
-struct DDSimulationState {
+struct CompiledClassicCondition {
   /**
-   * @brief The `SimulationState` interface.
+   * @brief The index of the first classical bit of the condition.
    */
-  SimulationState interface;
+  size_t offset;
   /**
-   * @brief The current instruction during execution.
+   * @brief The number of consecutive classical bits of the condition.
    */
-  size_t currentInstruction;
+  size_t width;
   /**
-   * @brief The code being executed.
+   * @brief The value the bits are compared to, where bit `i` of the value
+   * corresponds to classical bit `offset + i`.
    */
-  std::string code;
+  size_t expectedValue;
+};
+
+/**
+ * @brief Represents the different kinds of qubit references.
+ */
+enum class QubitReferenceKind : uint8_t {
   /**
-   * @brief The code being executed, after preprocessing.
+   * @brief The reference points to a qubit of the global state.
    */
-  std::string processedCode;
+  Qubit,
   /**
-   * @brief Indicates whether the debugger is ready to start simulation.
+   * @brief The reference points to a parameter of the enclosing custom gate.
    */
-  bool ready;
+  Parameter,
+  /**
+   * @brief The reference could not be resolved.
+   */
+  Invalid
+};
 
+/**
+ * @brief A qubit targeted by an instruction, resolved when the code is loaded.
+ */
+struct QubitReference {
   /**
-   * @brief The quantum computation object used for simulation.
+   * @brief The kind of the reference.
+   */
+  QubitReferenceKind kind;
+  /**
+   * @brief The index of the qubit or the position of the parameter.
    */
-  std::unique_ptr<qc::QuantumComputation> qc;
+  size_t index;
+};
+
+/**
+ * @brief The default number of steps between two garbage collections when
+ * collecting every N steps.
+ */
+constexpr size_t DEFAULT_GC_INTERVAL = 64;
+
+/**
+ * @brief The default active memory of the DD package in bytes above which
+ * garbage is collected when collecting over a memory threshold.
+ */
+constexpr size_t DEFAULT_GC_MEMORY_THRESHOLD = 256ULL << 20;
+
+/**
+ * @brief The active memory of the DD package in bytes below which the adaptive
+ * garbage collection never collects.
+ */
+constexpr size_t ADAPTIVE_GC_MIN_MEMORY = 16ULL << 20;
+
+/**
+ * @brief The default number of bytes that dense buffers of amplitudes may
+ * occupy at the same time.
+ *
+ * This allows the full state vector of 28 qubits to be expanded.
+ */
+constexpr size_t DEFAULT_DENSE_MEMORY_BUDGET = 4ULL << 30;
+
+/**
+ * @brief The minimum time between two progress reports of an asynchronous run.
+ */
+constexpr std::chrono::milliseconds ASYNC_PROGRESS_INTERVAL{100};
 
+/**
+ * @brief Represents the different strategies for collecting garbage in the DD
+ * package.
+ */
+enum class GarbageCollectionMode : uint8_t {
   /**
-   * @brief The DD package used for simulation.
+   * @brief Collect garbage once the active memory of the DD package has
+   * doubled since the last collection.
    */
-  std::unique_ptr<dd::Package> dd;
+  Adaptive,
   /**
-   * @brief The iterator pointing to the current instruction in the simulation.
+   * @brief Collect garbage after a fixed number of simulation steps.
    */
-  std::vector<std::unique_ptr<qc::Operation>>::iterator iterator;
+  EveryNSteps,
   /**
-   * @brief The DD vector representing the current simulation state.
+   * @brief Collect garbage whenever the active memory of the DD package
+   * exceeds a fixed threshold.
    */
-  dd::VectorDD simulationState;
+  MemoryThreshold,
+  /**
+   * @brief Only collect garbage when a run of the simulation stops.
+   */
+  WhenPaused
+};
+
+/**
+ * @brief Determines when the DD simulator collects garbage in its DD package.
+ *
+ * Collecting garbage frees unused nodes but also clears the compute tables, so
+ * collecting too often throws away work that the next steps could reuse.
+ */
+struct GarbageCollectionPolicy {
+  /**
+   * @brief The strategy used to decide when to collect garbage.
+   */
+  GarbageCollectionMode mode = GarbageCollectionMode::Adaptive;
+  /**
+   * @brief The number of steps between two collections in `EveryNSteps` mode.
+   */
+  size_t interval = DEFAULT_GC_INTERVAL;
+  /**
+   * @brief The active memory in bytes that triggers a collection in
+   * `MemoryThreshold` mode.
+   */
+  size_t memoryThreshold = DEFAULT_GC_MEMORY_THRESHOLD;
+};
+
+/**
+ * @brief The memory occupied by the dense buffers of amplitudes of a
+ * simulation state.
+ */
+struct DenseMemoryUsage {
+  /**
+   * @brief The number of bytes occupied right now, including cached buffers.
+   */
+  size_t current;
+  /**
+   * @brief The largest number of bytes that was occupied at the same time.
+   */
+  size_t peak;
+  /**
+   * @brief The number of bytes that may be occupied at the same time.
+   */
+  size_t budget;
+};
+
+/**
+ * @brief Views of the current state of a simulation that are memoized until
+ * the state changes.
+ */
+struct StateViewCache {
+  /**
+   * @brief The version of the state the views belong to.
+   */
+  size_t version;
+  /**
+   * @brief The amplitudes of the full state vector, or empty if they were not
+   * computed yet.
+   */
+  AmplitudeBuffer stateVector;
+  /**
+   * @brief The sub-states of subsets of qubits, keyed by the qubits in the
+   * requested order, or `std::nullopt` if the subset is entangled with the
+   * remaining qubits.
+   */
+  std::map<std::vector<size_t>, std::optional<std::vector<Complex>>> subStates;
+  /**
+   * @brief The reduced density matrices of pairs of qubits, keyed by the
+   * lower and the higher qubit index.
+   */
+  std::map<std::pair<size_t, size_t>, DensityMatrix> twoQubitDensityMatrices;
+  /**
+   * @brief The probabilities of measuring 0 and 1 on single qubits.
+   */
+  std::map<size_t, std::pair<double, double>> marginals;
+};
+
+/**
+ * @brief The state of a simulation as reported by the last call to
+ * `getStateDelta`.
+ */
+struct StateDeltaBaseline {
+  /**
+   * @brief The version of the reported state, or 0 if there is none.
+   */
+  size_t version = 0;
+  /**
+   * @brief The number of versions issued so far.
+   *
+   * Versions are never reused, so that a version issued for a previously
+   * loaded program never matches the current one.
+   */
+  size_t issuedVersions = 0;
+  /**
+   * @brief The reported classical bits.
+   */
+  ClassicalBits classicalBits;
+  /**
+   * @brief The version of the quantum state the amplitudes belong to.
+   */
+  size_t stateVersion = 0;
+  /**
+   * @brief The reported amplitudes, or empty if they were not kept.
+   */
+  AmplitudeBuffer amplitudes;
+};
+
+/**
+ * @brief The statistical slices of an assertion program, compiled for one
+ * optimization level.
+ */
+struct CompiledSlices {
+  /**
+   * @brief The optimization level the slices were compiled with.
+   */
+  uint8_t opt;
+  /**
+   * @brief The code of all slices, each followed by a null terminator.
+   */
+  std::string arena;
+  /**
+   * @brief The offset of the first character of each slice in `arena`.
+   */
+  std::vector<size_t> offsets;
+};
+
+/**
+ * @brief A statistical slice of an assertion program, compiled into a
+ * circuit.
+ */
+struct SliceCircuit {
+  /**
+   * @brief The assertions checked by the slice, in the format of the
+   * `// ASSERT:` comments of the compiled code.
+   */
+  std::vector<std::string> assertions;
+  /**
+   * @brief The circuit of the slice.
+   *
+   * The targets of the assertions are measured into single-bit classical
+   * registers that follow the registers of the program.
+   */
+  qc::QuantumComputation circuit;
+};
+
+/**
+ * @brief The matrix DDs of an operation, built once and reused.
+ *
+ * The cache that stores an entry holds a reference to each of its DDs.
+ */
+struct GateDDCacheEntry {
+  /**
+   * @brief The matrix DD applying the operation, if it was built already.
+   */
+  std::optional<dd::MatrixDD> forward;
+  /**
+   * @brief The matrix DD undoing the operation, if it was built already.
+   */
+  std::optional<dd::MatrixDD> inverse;
+};
+
+/**
+ * @brief The dense gates of an operation, prepared once and reused.
+ */
+struct DenseGateCacheEntry {
+  /**
+   * @brief The gate applying the operation, if it was prepared already.
+   */
+  std::optional<DenseGate> forward;
+  /**
+   * @brief The gate undoing the operation, if it was prepared already.
+   */
+  std::optional<DenseGate> inverse;
+};
+
+/**
+ * @brief A parsed assertion program that can be shared by multiple simulation
+ * states.
+ *
+ * A program is immutable once it has been parsed. Any number of
+ * `DDSimulationState` instances, each with its own DD package and execution
+ * cursor, can execute the same program concurrently.
+ */
+struct DDSimProgram {
+  /**
+   * @brief The code being executed.
+   */
+  std::string code;
+  /**
+   * @brief The code being executed, after preprocessing.
+   */
+  std::string processedCode;
+  /**
+   * @brief The quantum computation object used for simulation.
+   */
+  std::unique_ptr<const qc::QuantumComputation> qc;
   /**
    * @brief A vector containing the `InstructionType` of each instruction.
    */
@@ -156,19 +440,23 @@ struct DDSimulationState {
    */
   std::vector<size_t> instructionEnds;
   /**
-   * @brief A vector containing the instruction indices of all function
-   * definitions.
+   * @brief A vector containing the `InstructionFlag`s that the code sets on
+   * each instruction.
+   *
+   * Breakpoints are not part of the program and are never set here.
    */
-  std::set<size_t> functionDefinitions;
+  std::vector<uint8_t> instructionFlags;
   /**
    * @brief A map containing the instruction indices of all assertion, mapped to
    * their `Assertion` objects.
    */
   std::map<size_t, std::unique_ptr<Assertion>> assertionInstructions;
   /**
-   * @brief Maps each instruction to its successor instruction.
+   * @brief A vector containing the successor instruction of each instruction.
+   *
+   * A successor of 0 indicates a return from a custom gate call.
    */
-  std::map<size_t, size_t> successorInstructions;
+  std::vector<size_t> successorInstructions;
   /**
    * @brief A vector containing all qubit registers.
    *
@@ -184,25 +472,23 @@ struct DDSimulationState {
    */
   std::vector<ClassicalRegisterDefinition> classicalRegisters;
   /**
-   * @brief Maps the names of all classical variables to their values.
-   */
-  std::map<std::string, Variable> variables;
-  /**
-   * @brief A vector containing the names of all classical variables.
+   * @brief The names of all classical bits, ordered by their index.
    */
   std::vector<std::unique_ptr<std::string>> variableNames;
   /**
-   * @brief The current stack of previous instructions. Stepping backward pops
-   * this stack.
+   * @brief Maps the names of all classical bits to their index.
    *
-   * The stack will be cleared when a measurement is encountered.
+   * The simulation itself addresses classical bits by index only. This table
+   * is used to look up variables by name through the public interface.
    */
-  std::vector<size_t> previousInstructionStack;
+  std::unordered_map<std::string, size_t> variableIndices;
   /**
-   * @brief The current stack of return instructions. Reaching a `RETURN`
-   * instruction pops this stack.
+   * @brief The compiled condition of each classic-controlled instruction.
+   *
+   * The entries of all other instructions, and of conditions that refer to
+   * unknown bits or to more than 64 bits, are empty.
    */
-  std::vector<size_t> callReturnStack;
+  std::vector<std::optional<CompiledClassicCondition>> classicConditions;
   /**
    * @brief Maps each custom gate call instruction to the substitutions for this
    * call.
@@ -211,11 +497,6 @@ struct DDSimulationState {
    * names of the variables used to call the custom gate.
    */
   std::map<size_t, std::map<std::string, std::string>> callSubstitutions;
-  /**
-   * @brief Saves elements removed from the `callReturnStack` so that they can
-   * be reused when stepping back.
-   */
-  std::vector<std::pair<size_t, size_t>> restoreCallReturnStack;
   /**
    * @brief Maps each instruction index to a vector of its immediate data
    * dependencies.
@@ -231,20 +512,162 @@ struct DDSimulationState {
    * call it.
    */
   std::map<size_t, std::set<size_t>> functionCallers;
-  /**
-   * @brief A set of all breakpoints set by the user.
-   */
-  std::set<size_t> breakpoints;
   /**
    * @brief A vector containing the names of all target qubits for each
    * instruction.
    */
   std::vector<std::vector<std::string>> targetQubits;
+  /**
+   * @brief The target qubits of each instruction, resolved in the scope of the
+   * instruction.
+   *
+   * Full registers are expanded into their individual qubits. For assertions,
+   * the targets of the assertion are used.
+   */
+  std::vector<std::vector<QubitReference>> instructionQubits;
+  /**
+   * @brief The arguments of each custom gate call instruction, resolved in the
+   * scope of the call and ordered like the parameters of the called gate.
+   *
+   * The entries of all other instructions are empty.
+   */
+  std::vector<std::vector<QubitReference>> callArguments;
+  /**
+   * @brief The interactions between qubits caused by the instructions of the
+   * program, used to answer static interaction queries.
+   */
+  DDSimInteractionIndex interactions;
+  /**
+   * @brief The resolved data dependencies of all instructions, used to answer
+   * data dependency queries.
+   */
+  DDSimDependencyIndex dependencies;
+  /**
+   * @brief Object representations of all parsed instructions.
+   */
+  std::vector<Instruction> instructionObjects;
+  /**
+   * @brief The assertions that can be moved closer to the start of the
+   * program, each paired with the earliest instruction it can be moved to.
+   */
+  std::vector<std::pair<size_t, size_t>> assertionsToMove;
+  /**
+   * @brief The commutation information of each instruction, used to check
+   * which assertions it commutes with.
+   */
+  std::vector<CommutationInfo> commutation;
+};
+
+/**
+ * @brief The DD-simulator implementation of the `SimulationState` interface.
+ */
+struct DDSimulationState {
+  /**
+   * @brief The `SimulationState` interface.
+   */
+  SimulationState interface;
+  /**
+   * @brief The current instruction during execution.
+   */
+  size_t currentInstruction;
+  /**
+   * @brief Indicates whether the debugger is ready to start simulation.
+   */
+  bool ready;
+  /**
+   * @brief The program being executed.
+   *
+   * The program may be shared with other simulation states.
+   */
+  std::shared_ptr<const DDSimProgram> program;
+
+  /**
+   * @brief The DD package used for simulation.
+   */
+  std::unique_ptr<dd::Package> dd;
+  /**
+   * @brief The iterator pointing to the current instruction in the simulation.
+   */
+  std::vector<std::unique_ptr<qc::Operation>>::const_iterator iterator;
+  /**
+   * @brief The DD vector representing the current simulation state.
+   *
+   * With the dense backend, the DD is only built from `denseState` when an
+   * algorithm requires it, such as capturing a checkpoint.
+   */
+  dd::VectorDD simulationState;
+  /**
+   * @brief The backend that stores the current simulation state.
+   *
+   * The backend is chosen when the simulation state is created.
+   */
+  SimulationBackend backend;
+  /**
+   * @brief The amplitudes of the current simulation state if the dense
+   * backend is used, and empty otherwise.
+   *
+   * The amplitudes are the state itself rather than a view of it, so they do
+   * not count towards the dense-memory budget.
+   */
+  AmplitudeBuffer denseState;
+  /**
+   * @brief The version of the state that `simulationState` was last built
+   * from if the dense backend is used.
+   */
+  size_t denseStateDDVersion;
+  /**
+   * @brief A vector containing the `InstructionFlag`s set on each instruction.
+   *
+   * This holds the flags of the program together with the breakpoints of this
+   * simulation state. Together with `instructionTypes` and
+   * `successorInstructions` of the program, this forms a flat instruction
+   * table indexed by instruction.
+   */
+  std::vector<uint8_t> instructionFlags;
+  /**
+   * @brief The values of all classical bits, indexed like the bits of the
+   * classical registers of the program.
+   */
+  ClassicalBits classicalBits;
+  /**
+   * @brief The current stack of previous instructions. Stepping backward pops
+   * this stack.
+   *
+   * The size of the stack is the number of execution steps that lead to the
+   * current state.
+   */
+  std::vector<size_t> previousInstructionStack;
+  /**
+   * @brief The current stack of return instructions. Reaching a `RETURN`
+   * instruction pops this stack.
+   */
+  std::vector<size_t> callReturnStack;
+  /**
+   * @brief Saves elements removed from the `callReturnStack` so that they can
+   * be reused when stepping back.
+   */
+  std::vector<std::pair<size_t, size_t>> restoreCallReturnStack;
 
   /**
    * @brief Indicates whether the simulation should be paused.
+   *
+   * The flag may be set from any thread while the simulation is running.
+   */
+  std::atomic<bool> paused;
+
+  /**
+   * @brief The result of the last asynchronous run, if it has not been
+   * retrieved yet.
+   */
+  std::future<Result> asyncRun;
+  /**
+   * @brief The number of assertions that failed during the last asynchronous
+   * run.
+   *
+   * The value is only written by the worker thread and becomes visible once
+   * the result of `asyncRun` is ready.
    */
-  bool paused;
+  size_t asyncFailedAssertions;
 
   /**
    * @brief Stores the last instruction that failed an assertion.
@@ -261,9 +684,159 @@ struct DDSimulationState {
   DDDiagnostics diagnostics;
 
   /**
-   * @brief Object representations of all parsed instructions.
+   * @brief Caches the final states of the reference circuits of circuit
+   * equality assertions.
+   *
+   * The states are keyed by the circuit code and the number of target qubits
+   * of the assertion. The cache is cleared whenever new code is loaded.
    */
-  std::vector<Instruction> instructionObjects;
+  std::map<std::pair<std::string, size_t>, AmplitudeBuffer> referenceStates;
+
+  /**
+   * @brief A scratch buffer for the reshaped amplitudes that sub-states are
+   * extracted from.
+   *
+   * The buffer is kept across calls of `getStateVectorSub`, so that it only
+   * has to be allocated once.
+   */
+  AmplitudeBuffer subStateScratch;
+
+  /**
+   * @brief The version of `simulationState`.
+   *
+   * The version is increased whenever the state changes, be it by applying a
+   * gate, collapsing a measurement, restoring a checkpoint, or changing an
+   * amplitude.
+   */
+  size_t stateVersion;
+  /**
+   * @brief The views of the current state computed so far.
+   *
+   * Consecutive assertions, diagnostics, and state queries at the same step
+   * share these views instead of expanding the state again. The views are
+   * discarded as soon as the state changes. Their amplitudes count towards
+   * the dense-memory budget, and views that do not fit are not memoized.
+   */
+  StateViewCache stateViews;
+  /**
+   * @brief The state reported by the last call to `getStateDelta`.
+   *
+   * The kept amplitudes count towards the dense-memory budget.
+   */
+  StateDeltaBaseline deltaBaseline;
+
+  /**
+   * @brief Caches the statistical slices compiled last.
+   *
+   * All slices are compiled at once on the first request, so that compiling
+   * the slices one by one does not repeat the analysis of the assertions. The
+   * cache is cleared whenever new code is loaded.
+   */
+  std::optional<CompiledSlices> compiledSlices;
+
+  /**
+   * @brief Snapshots of the simulation state used to travel back in time.
+   *
+   * Stepping back over measurements and resets restores these snapshots.
+   */
+  DDSimCheckpointStore checkpoints;
+
+  /**
+   * @brief The profiling counters collected while executing instructions.
+   */
+  DDSimProfiler profiler;
+
+  /**
+   * @brief The measurement outcomes of each execution step that performed a
+   * measurement or reset.
+   *
+   * The outcomes are reused when a step is executed again after travelling
+   * back in time, so that the history stays consistent.
+   */
+  std::map<size_t, std::vector<bool>> measurementOutcomes;
+
+  /**
+   * @brief Indicates whether steps are currently being replayed from a
+   * checkpoint.
+   *
+   * While replaying, assertions are not checked and diagnostics are not
+   * updated, as this already happened when the steps were first executed.
+   */
+  bool replaying;
+
+  /**
+   * @brief Indicates whether runs of gates are fused when running the
+   * simulation.
+   *
+   * In fast-run mode, consecutive instructions that apply unitary gates and
+   * contain no breakpoint are applied as a single chain of products without
+   * intermediate garbage collection. Diagnostics are collected for fused gates
+   * as for single steps. Stepping back over fused gates is unaffected.
+   */
+  bool fastRun;
+
+  /**
+   * @brief Caches the forward and inverse matrix DDs of each operation of the
+   * circuit.
+   *
+   * Entries are built lazily the first time an operation is applied or
+   * undone. The cache is cleared whenever new code is loaded.
+   */
+  std::unordered_map<const qc::Operation*, GateDDCacheEntry> gateCache;
+  /**
+   * @brief Caches the forward and inverse dense gates of each operation of
+   * the circuit if the dense backend is used.
+   *
+   * Entries are built lazily and cleared together with `gateCache`.
+   */
+  std::unordered_map<const qc::Operation*, DenseGateCacheEntry>
+      denseGateCache;
+  /**
+   * @brief The small DD package that the matrices of dense gates are read
+   * from, created when the first dense gate is prepared.
+   */
+  std::unique_ptr<dd::Package> densePackage;
+
+  /**
+   * @brief The policy that determines when garbage is collected.
+   */
+  GarbageCollectionPolicy gcPolicy;
+  /**
+   * @brief The number of simulation steps performed since garbage was last
+   * collected.
+   */
+  size_t stepsSinceGarbageCollection;
+  /**
+   * @brief The active memory of the DD package in bytes right after garbage
+   * was last collected.
+   */
+  size_t memoryAfterGarbageCollection;
+
+  /**
+   * @brief The number of bytes that dense buffers of amplitudes may occupy at
+   * the same time.
+   *
+   * Operations that would exceed the budget use an algorithm on the decision
+   * diagram instead where one exists, and fail otherwise. The budget covers
+   * the buffers allocated by the simulation state itself, including its
+   * caches, but not the buffers passed in by callers.
+   */
+  size_t denseMemoryBudget;
+  /**
+   * @brief The number of bytes occupied by dense buffers that are currently
+   * being used by an operation.
+   */
+  size_t denseMemoryInUse;
+  /**
+   * @brief The largest number of bytes that dense buffers occupied at the same
+   * time.
+   */
+  size_t peakDenseMemory;
+
+  /**
+   * @brief The random number generator used to draw measurement outcomes.
+   */
+  std::mt19937_64 rng;
 };
 
 /**
@@ -280,6 +853,20 @@ Result ddsimInit(SimulationState* self);
  * @return The result of the load operation.
  */
 LoadResult ddsimLoadCode(SimulationState* self, const char* code);
+
+/**
+ * @brief Replaces the loaded code by an edited version of it.
+ *
+ * The new code is compared to the loaded code instruction by instruction. If
+ * the executed part of the simulation only consists of unchanged instructions,
+ * the simulation is rewound to the last step before the first edited
+ * instruction and continues from there with the new program. Checkpoints and
+ * measurement outcomes of the kept steps remain valid.
+ * @param self The instance to load the code into.
+ * @param code The edited code to load.
+ * @return The result of the load operation.
+ */
+LoadResult ddsimReloadCode(SimulationState* self, const char* code);
 /**
  * @brief Steps the simulation forward by one instruction.
  * @param self The instance to step forward.
@@ -292,6 +879,17 @@ Result ddsimStepForward(SimulationState* self);
  * @return The result of the operation.
  */
 Result ddsimStepBackward(SimulationState* self);
+/**
+ * @brief Travels back to the state after the given number of execution steps.
+ *
+ * The latest checkpoint before the target step is restored and the remaining
+ * steps are replayed. Measurements reuse their recorded outcomes.
+ * @param ddsim The instance to travel back in.
+ * @param step The number of execution steps of the target state. Must not be
+ * larger than the current number of steps.
+ * @return The result of the operation.
+ */
+Result ddsimRewindToStep(DDSimulationState* ddsim, size_t step);
 /**
  * @brief Steps the simulation forward by one instruction, skipping over
  * possible custom gate calls.
@@ -366,6 +964,49 @@ Result ddsimResetSimulation(SimulationState* self);
  * @return The result of the operation.
  */
 Result ddsimPauseSimulation(SimulationState* self);
+/**
+ * @brief Runs the simulation on a worker thread until it finishes, an assertion
+ * fails, or a breakpoint is hit.
+ *
+ * The simulation state must not be accessed until the run has completed, except
+ * through `ddsimPauseSimulation`, `ddsimIsSimulationRunning`, and
+ * `ddsimWaitForSimulation`.
+ * @param self The instance to run.
+ * @param callback The callback to report progress to, or nullptr.
+ * @param userData The user data passed to the callback.
+ * @return The result of the operation.
+ */
+Result ddsimRunSimulationAsync(SimulationState* self, ProgressCallback callback,
+                               void* userData);
+/**
+ * @brief Runs the simulation on a worker thread until it finishes, even if
+ * assertions fail.
+ *
+ * The simulation state must not be accessed until the run has completed, except
+ * through `ddsimPauseSimulation`, `ddsimIsSimulationRunning`, and
+ * `ddsimWaitForSimulation`. Pausing ends the whole run.
+ * @param self The instance to run.
+ * @param callback The callback to report progress to, or nullptr.
+ * @param userData The user data passed to the callback.
+ * @return The result of the operation.
+ */
+Result ddsimRunAllAsync(SimulationState* self, ProgressCallback callback,
+                        void* userData);
+/**
+ * @brief Checks whether an asynchronous run is still in progress.
+ * @param self The instance to query.
+ * @return True if an asynchronous run is in progress, false otherwise.
+ */
+bool ddsimIsSimulationRunning(SimulationState* self);
+/**
+ * @brief Waits for the last asynchronous run to complete.
+ * @param self The instance to wait for.
+ * @param failedAssertions Output parameter for the number of assertions that
+ * failed during the run. May be nullptr.
+ * @return The result of the run, or `ERROR` if no run was started since the
+ * last call.
+ */
+Result ddsimWaitForSimulation(SimulationState* self, size_t* failedAssertions);
 /**
  * @brief Checks whether the simulation can step forward.
  *
@@ -560,6 +1201,22 @@ Result ddsimGetQuantumVariableName(SimulationState* self, size_t variableIndex,
  * @return The result of the operation.
  */
 Result ddsimGetStateVectorFull(SimulationState* self, Statevector* output);
+
+/**
+ * @brief Gets a contiguous range of amplitudes of the full state vector of the
+ * simulation at the current time.
+ *
+ * The decision diagram is only descended along the paths that lead into the
+ * requested range.
+ * @param self The instance to query.
+ * @param start The index of the first amplitude to retrieve.
+ * @param count The number of amplitudes to retrieve.
+ * @param output A reference to a `Statevector` instance to store the
+ * amplitudes.
+ * @return The result of the operation.
+ */
+Result ddsimGetStateVectorRange(SimulationState* self, size_t start,
+                                size_t count, Statevector* output);
 /**
  * @brief Gets a sub-state of the state vector of the simulation at the current
  * time.
@@ -580,6 +1237,40 @@ Result ddsimGetStateVectorFull(SimulationState* self, Statevector* output);
 Result ddsimGetStateVectorSub(SimulationState* self, size_t subStateSize,
                               const size_t* qubits, Statevector* output);
 
+/**
+ * @brief Gets the amplitudes of the full state vector whose magnitude exceeds
+ * a threshold.
+ *
+ * The decision diagram is traversed in index order, skipping all edges below
+ * which no amplitude exceeds the threshold.
+ * @param self The instance to query.
+ * @param threshold The magnitude an amplitude has to exceed to be returned.
+ * @param maxCount The size of the `indices` and `amplitudes` buffers.
+ * @param indices A buffer to store the indices of the amplitudes.
+ * @param amplitudes A buffer to store the amplitudes.
+ * @param count A reference to store the number of returned amplitudes.
+ * @return The result of the operation.
+ */
+Result ddsimGetNonZeroAmplitudes(SimulationState* self, double threshold,
+                                 size_t maxCount, size_t* indices,
+                                 Complex* amplitudes, size_t* count);
+
+/**
+ * @brief Gets the non-zero amplitudes of the full state vector with the
+ * largest magnitudes.
+ *
+ * The decision diagram is explored best-first, ordered by the largest
+ * amplitude below each edge.
+ * @param self The instance to query.
+ * @param k The size of the `indices` and `amplitudes` buffers.
+ * @param indices A buffer to store the indices of the amplitudes.
+ * @param amplitudes A buffer to store the amplitudes.
+ * @param count A reference to store the number of returned amplitudes.
+ * @return The result of the operation.
+ */
+Result ddsimGetTopKAmplitudes(SimulationState* self, size_t k, size_t* indices,
+                              Complex* amplitudes, size_t* count);
+
 /**
  * @brief Sets a breakpoint at the desired position in the code.
  *
@@ -649,15 +1340,112 @@ Diagnostics* ddsimGetDiagnostics(SimulationState* self);
 size_t ddsimCompile(SimulationState* self, char* buffer,
                     CompilationSettings settings);
 
+/**
+ * @brief Compiles all slices of the given code in a single pass.
+ * @param self The SimulationState instance from which the original assertion
+ * code should be taken.
+ * @param buffer The buffer that should be filled with the compiled slices, or
+ * NULL to compute the required buffer size.
+ * @param offsets The buffer that should be filled with the offset of each
+ * slice, or NULL.
+ * @param numSlices A reference to store the number of slices, or NULL.
+ * @param settings The settings to use for the compilation.
+ * @return The total size of all compiled slices.
+ */
+size_t ddsimCompileSlices(SimulationState* self, char* buffer, size_t* offsets,
+                          size_t* numSlices, CompilationSettings settings);
+
+/**
+ * @brief Compiles all slices of the loaded code into circuits.
+ *
+ * The circuits are built from the operations of the already imported program
+ * instead of code, so that they do not need to be parsed again. Each circuit
+ * is equivalent to the code that `ddsimCompileSlices` produces for the same
+ * slice.
+ * @param ddsim The simulation state from which the program should be taken.
+ * @param settings The settings to use for the compilation. The slice index is
+ * ignored.
+ * @return The compiled slices, in the order of their slice indices, or an
+ * empty list if no code is loaded.
+ * @throws std::invalid_argument If the target of an assertion cannot be
+ * resolved.
+ */
+std::vector<SliceCircuit>
+ddsimCompileSliceCircuits(DDSimulationState* ddsim,
+                          CompilationSettings settings);
+
+/**
+ * @brief Sets the seed of the random number generator used for measurements.
+ * @param self The instance to configure.
+ * @param seed The seed to use.
+ * @return The result of the operation.
+ */
+Result ddsimSetSeed(SimulationState* self, size_t seed);
+
+/**
+ * @brief Samples the classical outcomes of multiple executions of the program.
+ * @param self The instance to sample from.
+ * @param shots The number of executions to sample.
+ * @param seed The seed of the random number generator used for sampling.
+ * @param outcomes A buffer to store the distinct outcomes.
+ * @param counts A buffer to store the number of shots of each outcome.
+ * @param maxOutcomes The size of the `outcomes` and `counts` buffers.
+ * @param numOutcomes A reference to store the number of distinct outcomes.
+ * @return The result of the operation.
+ */
+Result ddsimSampleShots(SimulationState* self, size_t shots, size_t seed,
+                        size_t* outcomes, size_t* counts, size_t maxOutcomes,
+                        size_t* numOutcomes);
+
+/**
+ * @brief Enables or disables the collection of profiling counters.
+ *
+ * Enabling profiling discards all previously collected counters.
+ * @param self The instance to configure.
+ * @param enabled True to enable profiling, false to disable it.
+ * @return The result of the operation.
+ */
+Result ddsimSetProfilingEnabled(SimulationState* self, bool enabled);
+
+/**
+ * @brief Gets the profiling counters collected since profiling was enabled.
+ * @param self The instance to query.
+ * @param entries A buffer to store the entries.
+ * @param maxEntries The size of the `entries` buffer.
+ * @param numEntries A reference to store the number of entries.
+ * @return The result of the operation.
+ */
+Result ddsimGetProfile(SimulationState* self, ProfileEntry* entries,
+                       size_t maxEntries, size_t* numEntries);
+
+/**
+ * @brief Gets the changes of the simulation state since an earlier call.
+ * @param self The instance to query.
+ * @param sinceVersion The version returned by the previous call, or 0.
+ * @param output The delta to fill.
+ * @return The result of the operation.
+ */
+Result ddsimGetStateDelta(SimulationState* self, size_t sinceVersion,
+                          StateDelta* output);
+
 /**
  * @brief Creates a new `DDSimulationState` instance.
  *
  * This function expects an allocated memory block for the `DDSimulationState`
- * instance.
+ * instance.\n\n
+ *
+ * All backends share the preprocessing of the code, the execution history,
+ * and the diagnostics. The dense backend applies gates directly to a flat
+ * array of amplitudes, which avoids the overhead of decision diagrams for
+ * small, unstructured circuits. It supports programs with up to
+ * `MAX_DENSE_BACKEND_QUBITS` qubits.
  * @param self The instance to create.
+ * @param backend The backend that stores the simulation state.
  * @return The result of the operation.
  */
-Result createDDSimulationState(DDSimulationState* self);
+Result createDDSimulationState(
+    DDSimulationState* self,
+    SimulationBackend backend = SimulationBackend::DecisionDiagram);
 /**
  * @brief Destroys a `DDSimulationState` instance.
  * @param self The instance to destroy.
@@ -665,22 +1453,55 @@ Result createDDSimulationState(DDSimulationState* self);
  */
 Result destroyDDSimulationState(DDSimulationState* self);
 
+/**
+ * @brief Gets the memory occupied by the dense buffers of amplitudes of a
+ * simulation state.
+ * @param ddsim The simulation state to query.
+ * @return The current and peak usage, together with the budget.
+ */
+DenseMemoryUsage ddsimGetDenseMemoryUsage(const DDSimulationState* ddsim);
+
+/**
+ * @brief Parses the given code into a program that can be shared by multiple
+ * simulation states.
+ * @param code The code to parse.
+ * @return The parsed program.
+ * @throws ParsingError If the code is not a valid assertion program.
+ */
+std::shared_ptr<const DDSimProgram> parseDDSimProgram(const char* code);
+
+/**
+ * @brief Loads a parsed program into a simulation state.
+ *
+ * The program is shared instead of copied, so loading it is cheap. States
+ * that share a program keep their own DD package, execution cursor, classical
+ * variables, and breakpoints, so they can be executed independently and
+ * concurrently on different threads. Breakpoints of the simulation state are
+ * kept.
+ * @param ddsim The simulation state to load the program into.
+ * @param program The program to load.
+ * @return The result of the operation.
+ */
+Result ddsimLoadProgram(DDSimulationState* ddsim,
+                        std::shared_ptr<const DDSimProgram> program);
+
 /**
  * @brief Preprocess the code to be executed.
  * @param code The code to preprocess.
- * @param ddsim The simulation state to preprocess the code for.
+ * @param program The program to store the results of the preprocessing in.
  * @return The preprocessed code.
  */
-std::string preprocessAssertionCode(const char* code, DDSimulationState* ddsim);
+std::string preprocessAssertionCode(const char* code, DDSimProgram& program);
 
 /**
  * @brief Checks an assertion against the current state of the simulation.
  * @param ddsim The simulation state to check the assertion against.
+ * @param instruction The instruction of the assertion.
  * @param assertion The assertion to check.
  * @return True if the assertion is satisfied, false otherwise.
  */
-bool checkAssertion(DDSimulationState* ddsim,
-                    std::unique_ptr<Assertion>& assertion);
+bool checkAssertion(DDSimulationState* ddsim, size_t instruction,
+                    const Assertion& assertion);
 
 /**
  * @brief Gets the name of a classical bit by its index.
@@ -751,6 +1572,53 @@ bool isSubStateVectorLegal(const Statevector& full,
 std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
                                             size_t instruction);
 
+/**
+ * @brief Checks whether a flag is set on an instruction.
+ * @param ddsim The simulation state to query.
+ * @param instruction The index of the instruction. May be past the last
+ * instruction, in which case no flags are set.
+ * @param flag The flag to check.
+ * @return True if the flag is set, false otherwise.
+ */
+bool hasInstructionFlag(const DDSimulationState* ddsim, size_t instruction,
+                        InstructionFlag flag);
+
+/**
+ * @brief Resolves a qubit reference to the index of a qubit in the current
+ * call context.
+ *
+ * References to gate parameters are followed through the arguments of the
+ * calls on the call stack, from the innermost call outwards.
+ * @param ddsim The simulation state to query.
+ * @param reference The reference to resolve.
+ * @return The index of the qubit.
+ */
+size_t resolveQubitReference(const DDSimulationState* ddsim,
+                             QubitReference reference);
+
+/**
+ * @brief Gets the indices of the target qubits of an instruction in the
+ * current call context.
+ * @param ddsim The simulation state to query.
+ * @param instruction The instruction index to get the target qubits for.
+ * @return The indices of the target qubits, in the order of
+ * `getTargetVariables`.
+ */
+std::vector<size_t> resolveTargetQubits(const DDSimulationState* ddsim,
+                                        size_t instruction);
+
+/**
+ * @brief Gets the probabilities of measuring 0 and 1 on a qubit in the current
+ * state.
+ *
+ * The probabilities are memoized until the state changes.
+ * @param ddsim The simulation state to query.
+ * @param qubit The index of the qubit.
+ * @return The probabilities of measuring 0 and 1.
+ */
+std::pair<double, double> getQubitProbabilities(DDSimulationState* ddsim,
+                                                size_t qubit);
+
 /**
  * @brief Compiles the given code into a quantum circuit without assertions
  * using statistical slices.
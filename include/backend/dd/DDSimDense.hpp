@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimDense.hpp
+ * @brief Provides the kernels of the dense simulation backend, which stores
+ * the state as a flat array of amplitudes instead of a decision diagram.
+ */
+#pragma once
+
+#include "common.h"
+#include "common/Span.hpp"
+#include "dd/Package.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief The largest number of qubits the dense backend can simulate.
+ *
+ * A state of this size already occupies 4 GiB.
+ */
+constexpr size_t MAX_DENSE_BACKEND_QUBITS = 28;
+
+/**
+ * @brief The minimum number of amplitudes for which the dense kernels are run
+ * in parallel.
+ *
+ * Parallelization requires OpenMP. For smaller states, or without OpenMP, the
+ * kernels run on a single thread.
+ */
+constexpr size_t PARALLEL_DENSE_MIN_AMPLITUDES = 1ULL << 16U;
+
+/**
+ * @brief The largest number of targets a gate applied by the dense backend
+ * may have.
+ */
+constexpr size_t MAX_DENSE_GATE_TARGETS = 3;
+
+/**
+ * @brief The backends that can store the state of a `DDSimulationState`.
+ */
+enum class SimulationBackend : uint8_t {
+  /**
+   * @brief The state is stored as a decision diagram.
+   */
+  DecisionDiagram,
+  /**
+   * @brief The state is stored as a flat array of amplitudes.
+   */
+  Dense
+};
+
+/**
+ * @brief A gate prepared for the application on dense state vectors.
+ */
+struct DenseGate {
+  /**
+   * @brief The target qubits of the gate.
+   *
+   * Bit `i` of the row and column indices of `matrix` corresponds to the
+   * `i`-th target.
+   */
+  std::vector<size_t> targets;
+  /**
+   * @brief The mask of the control qubits of the gate.
+   */
+  size_t controlMask = 0;
+  /**
+   * @brief The values the control qubits need to have for the gate to apply.
+   *
+   * Only bits in `controlMask` are set. Negative controls are cleared.
+   */
+  size_t controlValue = 0;
+  /**
+   * @brief The matrix of the gate on its targets in row-major order.
+   */
+  std::vector<std::complex<double>> matrix;
+};
+
+/**
+ * @brief Prepare an operation for the application on dense state vectors.
+ *
+ * The matrix of the operation on its targets is taken from the matrix DD of
+ * the operation without controls, so that both backends share the same gate
+ * definitions.
+ * @param op The unitary operation to prepare.
+ * @param package A DD package with at least `MAX_DENSE_GATE_TARGETS` qubits,
+ * used to build the matrix DD.
+ * @return The prepared gate.
+ * @throws std::invalid_argument If the operation has more than
+ * `MAX_DENSE_GATE_TARGETS` targets.
+ */
+DenseGate makeDenseGate(const qc::Operation& op, dd::Package& package);
+
+/**
+ * @brief Get the gate that undoes the given gate.
+ * @param gate The gate to invert.
+ * @return The gate with the conjugate transpose of the matrix of `gate`.
+ */
+DenseGate invertDenseGate(const DenseGate& gate);
+
+/**
+ * @brief Apply a gate to a dense state vector in place.
+ *
+ * Only the blocks of amplitudes in which all controls are satisfied are
+ * visited, and each block is updated by a small matrix-vector product.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param gate The gate to apply.
+ */
+void applyDenseGate(const Span<Complex>& amplitudes, const DenseGate& gate);
+
+/**
+ * @brief Get the probabilities of measuring 0 and 1 on a qubit of a dense
+ * state vector.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param qubit The qubit to measure.
+ * @return The probabilities of measuring 0 and 1.
+ */
+std::pair<double, double>
+getDenseQubitProbabilities(const Span<const Complex>& amplitudes,
+                           size_t qubit);
+
+/**
+ * @brief Collapse a qubit of a dense state vector to a measurement outcome.
+ *
+ * The amplitudes of the other outcome are cleared, and the remaining ones are
+ * renormalized.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param qubit The measured qubit.
+ * @param probability The probability of the outcome.
+ * @param measureZero True if the outcome is 0, false if it is 1.
+ */
+void collapseDenseQubit(const Span<Complex>& amplitudes, size_t qubit,
+                        double probability, bool measureZero);
+
+/**
+ * @brief Check whether the given qubits of a dense state vector can be
+ * measured in more than one way.
+ *
+ * Amplitudes with a magnitude of `SUPPORT_TOLERANCE` or less are treated as
+ * zero, as for decision diagrams.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param qubits The indices of the target qubits.
+ * @return True if at least two different bitstrings on the target qubits have
+ * a non-zero probability, false otherwise.
+ */
+bool hasMultipleDenseOutcomes(const Span<const Complex>& amplitudes,
+                              const std::vector<size_t>& qubits);
+
+/**
+ * @brief Find the amplitudes of a dense state vector whose magnitude exceeds
+ * a threshold.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param threshold The magnitude an amplitude has to exceed.
+ * @param maxCount The maximum number of amplitudes to find.
+ * @return The index and value of the first `maxCount` found amplitudes, in
+ * ascending order of their indices.
+ */
+std::vector<std::pair<size_t, Complex>>
+findDenseAmplitudesAbove(const Span<const Complex>& amplitudes,
+                         double threshold, size_t maxCount);
+
+/**
+ * @brief Find the non-zero amplitudes of a dense state vector with the
+ * largest magnitude.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param k The maximum number of amplitudes to find.
+ * @return The index and value of the found amplitudes, in descending order of
+ * their magnitude. Amplitudes of equal magnitude are ordered by index.
+ */
+std::vector<std::pair<size_t, Complex>>
+findLargestDenseAmplitudes(const Span<const Complex>& amplitudes, size_t k);
+
+} // namespace mqt::debugger
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimDependencies.hpp
+ * @brief Provides an index of the data dependencies between the instructions
+ * of a program.
+ */
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief An index of the data dependencies between the instructions of a
+ * program.
+ *
+ * The direct dependencies of each instruction, including the instructions
+ * inside custom gates that are reached through calls, are resolved once and
+ * stored as a flat adjacency array. Queries then only traverse this array,
+ * marking visited instructions in a bitset.
+ */
+class DDSimDependencyIndex {
+public:
+  /**
+   * @brief Build the index.
+   * @param dependencies For each instruction, the instructions it directly
+   * depends on.
+   * @param scopes For each instruction, the custom gate definition that
+   * encloses it, or -1 if it is in the global scope.
+   * @param callers For each custom gate definition, the instructions that call
+   * it.
+   */
+  void build(const std::vector<std::vector<size_t>>& dependencies,
+             std::vector<size_t> scopes,
+             const std::map<size_t, std::set<size_t>>& callers);
+
+  /**
+   * @brief Get the number of instructions in the index.
+   * @return The number of instructions.
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Get all data dependencies of an instruction.
+   *
+   * The instruction itself is also counted as a dependency.
+   * @param instruction The instruction to get the dependencies for.
+   * @param includeCallers True, if the dependencies should include all
+   * possible callers of the custom gates enclosing the instruction.
+   * @return The dependencies of the instruction in no particular order.
+   */
+  [[nodiscard]] std::vector<size_t> getDependencies(size_t instruction,
+                                                    bool includeCallers) const;
+
+private:
+  /**
+   * @brief Get the custom gate definitions whose callers are unknown when
+   * starting the analysis at the given instruction.
+   *
+   * These are the definitions enclosing the instruction, and, transitively,
+   * the definitions enclosing any of their callers.
+   * @param instruction The instruction the analysis starts at.
+   * @return The set of custom gate definitions.
+   */
+  [[nodiscard]] std::set<size_t> getUnknownCallers(size_t instruction) const;
+
+  /**
+   * @brief The position of the first dependency of each instruction in
+   * `edges`, followed by the total number of dependencies.
+   */
+  std::vector<size_t> offsets;
+
+  /**
+   * @brief The direct dependencies of all instructions, stored consecutively.
+   */
+  std::vector<size_t> edges;
+
+  /**
+   * @brief The custom gate definition enclosing each instruction, or -1 if it
+   * is in the global scope.
+   */
+  std::vector<size_t> scopes;
+
+  /**
+   * @brief The instructions that call each custom gate definition.
+   */
+  std::map<size_t, std::vector<size_t>> callers;
+};
+
+} // namespace mqt::debugger
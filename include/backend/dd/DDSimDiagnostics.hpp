@@ -15,16 +15,22 @@
  */
 #pragma once
 
+#include "backend/dd/DDSimInteractions.hpp"
 #include "backend/diagnostics.h"
 #include "common.h"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/AssertionTools.hpp"
 #include "common/parsing/CodePreprocessing.hpp"
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+#include "ir/operations/Operation.hpp"
 
 #include <cstddef>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,6 +93,31 @@ struct InsertEqualityAssertion {
   }
 };
 
+/**
+ * @brief The maximum number of states recorded for lazy control checks.
+ *
+ * Each recorded state is kept alive until it is checked. Once this many states
+ * have been recorded, the pending checks are evaluated right away, so that the
+ * states can be garbage-collected.
+ */
+constexpr size_t MAX_PENDING_CONTROL_STATES = 64;
+
+/**
+ * @brief The states in which the controls of an instruction still have to be
+ * checked.
+ */
+struct PendingControlCheck {
+  /**
+   * @brief The controlled operation applied by the instruction.
+   */
+  const qc::Operation* operation;
+  /**
+   * @brief The distinct states the operation was applied to, keyed by their
+   * root node. The diagnostics hold a reference to each of them.
+   */
+  std::unordered_map<const dd::vNode*, dd::VectorDD> states;
+};
+
 struct DDSimulationState;
 
 /**
@@ -110,6 +141,31 @@ struct DDDiagnostics {
    * @brief The qubits that have been marked as non-zero controls.
    */
   std::map<size_t, std::set<size_t>> nonZeroControls;
+  /**
+   * @brief Indicates whether controls are only checked when zero controls are
+   * queried.
+   *
+   * In lazy mode, stepping forward only records the states that controlled
+   * instructions were applied to. They are checked and released the next time
+   * zero controls or potential error causes are requested, or once
+   * `MAX_PENDING_CONTROL_STATES` states have been recorded. Simulation states
+   * that use the dense backend ignore lazy mode.
+   */
+  bool lazyZeroControls;
+  /**
+   * @brief The control checks recorded in lazy mode that have not been
+   * evaluated yet, keyed by instruction.
+   *
+   * Each recorded state is kept alive until it is checked. Once
+   * `MAX_PENDING_CONTROL_STATES` states have been recorded, the pending checks
+   * are evaluated through `dddiagnosticsEvaluatePendingControls` and the states
+   * are released.
+   */
+  std::map<size_t, PendingControlCheck> pendingControlChecks;
+  /**
+   * @brief The number of states recorded in `pendingControlChecks`.
+   */
+  size_t numPendingControlStates;
 
   /**
    * @brief The actual qubits that each instruction has targeted.
@@ -117,9 +173,10 @@ struct DDDiagnostics {
   std::map<size_t, std::set<std::vector<size_t>>> actualQubits;
 
   /**
-   * @brief Assertions that have been identified to be moved in the program.
+   * @brief The interactions between qubits observed in the simulated
+   * operations, updated whenever an operation targets new qubits.
    */
-  std::vector<std::pair<size_t, size_t>> assertionsToMove;
+  DDSimInteractionTracker interactions;
 
   /**
    * @brief The entanglement assertions that have been identified to be added to
@@ -187,6 +244,31 @@ Result dddiagnosticsGetDataDependencies(Diagnostics* self, size_t instruction,
                                         bool includeCallers,
                                         bool* instructions);
 
+/**
+ * @brief Extract all data dependencies for several instructions at once.
+ *
+ * This method expects a continuous memory block of booleans with `count` rows,
+ * each with size equal to the number of instructions. The row of each
+ * requested instruction is filled in the same way as by
+ * `getDataDependencies`.\n\n
+ *
+ * This method can be performed without running the program, as it is a static
+ * analysis method.\n\n
+ *
+ * @param self The diagnostics instance to query.
+ * @param instructions The instructions to extract the data dependencies for.
+ * @param count The number of instructions.
+ * @param includeCallers True if the data dependencies should include all
+ * possible callers of the containing custom gates.
+ * @param dependencies An array of booleans that will be set to true for each
+ * instruction that is a data dependency of the instruction of its row.
+ * @return The result of the operation.
+ */
+Result dddiagnosticsGetDataDependenciesBatch(Diagnostics* self,
+                                             const size_t* instructions,
+                                             size_t count, bool includeCallers,
+                                             bool* dependencies);
+
 /**
  * @brief Extract all qubits that interact with a given qubit up to a specific
  * instruction.
@@ -215,6 +297,28 @@ Result dddiagnosticsGetDataDependencies(Diagnostics* self, size_t instruction,
 Result dddiagnosticsGetInteractions(Diagnostics* self, size_t beforeInstruction,
                                     size_t qubit, bool* qubitsAreInteracting);
 
+/**
+ * @brief Extract the groups of interacting qubits up to a specific instruction
+ * for all qubits at once.
+ *
+ * This method expects a continuous memory block of integers with size equal to
+ * the number of qubits. Each element represents a qubit and will be set to the
+ * smallest qubit index of the group of qubits it interacts with.\n\n
+ *
+ * This method can be performed without running the program, as it is a static
+ * analysis method.\n\n
+ *
+ * @param self The diagnostics instance to query.
+ * @param beforeInstruction The instruction to extract the interactions up to
+ * (excluding).
+ * @param components An array of qubit indices that will be set to the smallest
+ * qubit of each qubit's group.
+ * @return The result of the operation.
+ */
+Result dddiagnosticsGetInteractionComponents(Diagnostics* self,
+                                             size_t beforeInstruction,
+                                             size_t* components);
+
 /**
  * @brief Extract all controlled gates that have been marked as only having
  * controls with value zero.
@@ -311,12 +415,41 @@ Result destroyDDDiagnostics([[maybe_unused]] DDDiagnostics* self);
 void dddiagnosticsOnStepForward(DDDiagnostics* diagnostics, size_t instruction);
 
 /**
- * @brief Called during code preprocessing after parsing all instructions.
+ * @brief Check whether stepping over an instruction requires its controls to
+ * be checked in the current state.
+ *
+ * Fused runs of gates only need to provide the current state to
+ * `dddiagnosticsOnStepForward` for such instructions.
+ * @param diagnostics The diagnostics instance to query.
+ * @param instruction The instruction that is executed next.
+ * @return True if the instruction applies a controlled gate with controls that
+ * have not yet been found to be non-zero, false otherwise.
+ */
+bool dddiagnosticsNeedsControlCheck(DDDiagnostics* diagnostics,
+                                    size_t instruction);
+
+/**
+ * @brief Evaluate all control checks recorded in lazy mode.
+ *
+ * The recorded states are released afterwards.
  * @param diagnostics The diagnostics instance to update.
+ */
+void dddiagnosticsEvaluatePendingControls(DDDiagnostics* diagnostics);
+
+/**
+ * @brief Find the assertions that can be moved closer to the start of the
+ * program.
+ *
+ * Called during code preprocessing after parsing all instructions. All
+ * assertions are analyzed in a single pass over the program.
  * @param instructions The parsed instructions.
+ * @param commutation The commutation information of each instruction.
+ * @return The instruction index of each movable assertion, paired with the
+ * earliest instruction index it can be moved to.
  */
-void dddiagnosticsOnCodePreprocessing(
-    DDDiagnostics* diagnostics, const std::vector<Instruction>& instructions);
+std::vector<std::pair<size_t, size_t>>
+findAssertionsToMove(const std::vector<Instruction>& instructions,
+                     const std::vector<CommutationInfo>& commutation);
 
 /**
  * @brief Called, whenever an assertion fails to update the diagnostics.
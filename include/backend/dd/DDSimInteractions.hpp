@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimInteractions.hpp
+ * @brief Provides structures that keep track of the qubit interactions of a
+ * program, both statically and while running the DD simulator.
+ */
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief Tracks which qubits have interacted with each other at runtime.
+ *
+ * All qubits that are targeted together by an instruction interact with each
+ * other. Qubits are grouped into connected components of this relation by a
+ * union-find structure that is updated incrementally whenever an instruction
+ * targets a new combination of qubits. Each component also keeps the
+ * combinations that connected it, together with the instructions they were
+ * observed at, so that the interaction graph of a component can be built
+ * without looking at any other instruction.
+ */
+class DDSimInteractionTracker {
+public:
+  /**
+   * @brief Record that an instruction targeted the given qubits together.
+   *
+   * Each combination of qubits should only be recorded once per instruction.
+   * @param instruction The index of the instruction.
+   * @param qubits The qubits targeted by the instruction.
+   */
+  void addInteraction(size_t instruction, const std::vector<size_t>& qubits);
+
+  /**
+   * @brief Check whether two qubits have interacted, directly or indirectly.
+   * @param first The first qubit.
+   * @param second The second qubit.
+   * @return True if both qubits are in the same component, false otherwise.
+   */
+  [[nodiscard]] bool interact(size_t first, size_t second);
+
+  /**
+   * @brief Get the interaction graph of the component of the given qubit.
+   *
+   * For each recorded combination of qubits, the graph contains an edge in
+   * both directions between the qubits at every position and the qubits at
+   * the second position onwards.
+   * @param qubit The qubit to get the interaction graph for.
+   * @return A set of edges (start, end, instruction) between qubits of the
+   * component and the instruction they were taken from.
+   */
+  [[nodiscard]] std::set<std::tuple<size_t, size_t, size_t>>
+  getInteractionTree(size_t qubit);
+
+  /**
+   * @brief Find the unique path between two qubits in the interaction graph,
+   * if it exists.
+   *
+   * The path is searched in the interaction graph of the component of `end`.
+   * @param start The starting qubit.
+   * @param end The ending qubit.
+   * @return The edges of the unique path from `end` back to `start`, or an
+   * empty vector if there is no unique path.
+   */
+  [[nodiscard]] std::vector<std::tuple<size_t, size_t, size_t>>
+  findUniquePath(size_t start, size_t end);
+
+  /**
+   * @brief Remove all recorded interactions.
+   */
+  void clear();
+
+private:
+  /**
+   * @brief Find the representative of the component of a qubit.
+   *
+   * Qubits that have not been seen before are added as singleton components.
+   * @param qubit The qubit to find the representative of.
+   * @return The representative qubit.
+   */
+  size_t findRoot(size_t qubit);
+
+  /**
+   * @brief Merge the components of two qubits.
+   * @param first The first qubit.
+   * @param second The second qubit.
+   */
+  void unite(size_t first, size_t second);
+
+  /**
+   * @brief The parent of each qubit in the union-find forest.
+   */
+  std::vector<size_t> parents;
+
+  /**
+   * @brief The number of qubits in each component, indexed by its
+   * representative.
+   */
+  std::vector<size_t> sizes;
+
+  /**
+   * @brief The recorded combinations of qubits of each component, indexed by
+   * its representative, together with the instruction they were observed at.
+   */
+  std::vector<std::vector<std::pair<size_t, std::vector<size_t>>>>
+      interactions;
+};
+
+/**
+ * @brief An index of the interactions between qubits in a program, which
+ * answers static interaction queries without scanning the program.
+ *
+ * The program is split into scopes that start after each custom gate
+ * definition. Inside each scope, the interactions are merged into a union-find
+ * forest in the order of their instructions, using union by size and no path
+ * compression. Each link stores the instruction it was created at, so that the
+ * forest before any instruction of the scope is obtained by ignoring all later
+ * links. Since the forest has logarithmic depth, each qubit can be resolved
+ * to its component in logarithmic time.
+ */
+class DDSimInteractionIndex {
+public:
+  /**
+   * @brief Start a new scope that contains no interactions.
+   *
+   * Queries for instructions at or after the given one only consider
+   * interactions added after this call.
+   * @param instruction The index of the first instruction of the scope.
+   */
+  void beginScope(size_t instruction);
+
+  /**
+   * @brief Record that an instruction makes the given qubits interact.
+   *
+   * Interactions have to be added in the order of their instructions.
+   * @param instruction The index of the instruction.
+   * @param qubits The qubits targeted by the instruction.
+   */
+  void addInteraction(size_t instruction, const std::vector<size_t>& qubits);
+
+  /**
+   * @brief Check whether two qubits interact before the given instruction.
+   * @param beforeInstruction The instruction to check the interactions up to
+   * (excluding).
+   * @param first The first qubit.
+   * @param second The second qubit.
+   * @return True if both qubits are in the same component, false otherwise.
+   */
+  [[nodiscard]] bool interact(size_t beforeInstruction, size_t first,
+                              size_t second) const;
+
+  /**
+   * @brief Get the components of interacting qubits before the given
+   * instruction.
+   * @param beforeInstruction The instruction to get the components up to
+   * (excluding).
+   * @param numQubits The number of qubits to get the components for.
+   * @return For each qubit, the smallest qubit of its component.
+   */
+  [[nodiscard]] std::vector<size_t> getComponents(size_t beforeInstruction,
+                                                  size_t numQubits) const;
+
+  /**
+   * @brief Remove all scopes and interactions.
+   */
+  void clear();
+
+private:
+  /**
+   * @brief The union-find forest of a single scope.
+   */
+  struct Scope {
+    /**
+     * @brief The index of the first instruction of the scope.
+     */
+    size_t start;
+    /**
+     * @brief The parent of each qubit.
+     */
+    std::vector<size_t> parents;
+    /**
+     * @brief The instruction at which each qubit was linked to its parent.
+     */
+    std::vector<size_t> linkedAt;
+    /**
+     * @brief The number of qubits in each component, indexed by its root.
+     */
+    std::vector<size_t> sizes;
+  };
+
+  /**
+   * @brief Find the scope that contains the given instruction.
+   * @param beforeInstruction The index of the instruction.
+   * @return The scope, or nullptr if there is none.
+   */
+  [[nodiscard]] const Scope* findScope(size_t beforeInstruction) const;
+
+  /**
+   * @brief Find the root of a qubit in a scope before the given instruction.
+   * @param scope The scope to search in.
+   * @param beforeInstruction The instruction to consider the links up to
+   * (excluding).
+   * @param qubit The qubit to find the root of.
+   * @return The root of the qubit.
+   */
+  [[nodiscard]] static size_t findRoot(const Scope& scope,
+                                       size_t beforeInstruction, size_t qubit);
+
+  /**
+   * @brief The scopes of the program, ordered by their first instruction.
+   */
+  std::vector<Scope> scopes;
+};
+
+} // namespace mqt::debugger
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimProfiler.hpp
+ * @brief Provides per-instruction profiling counters for the DD simulator.
+ */
+#pragma once
+
+#include "backend/debug.h"
+#include "dd/Package.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief Collects profiling counters for each phase of each instruction.
+ *
+ * Counters are collected through `Scope` objects that measure the phase they
+ * are alive for. While the profiler is disabled, creating a scope only checks
+ * a flag.
+ */
+class DDSimProfiler {
+public:
+  /**
+   * @brief Measures one phase of an instruction for as long as it is alive.
+   */
+  class Scope {
+  public:
+    /**
+     * @brief Starts measuring a phase of the given instruction.
+     * @param profiler The profiler to record the phase in.
+     * @param instruction The instruction the phase belongs to.
+     * @param phase The phase to measure.
+     * @param state The state whose nodes are counted before and after the
+     * phase.
+     */
+    Scope(DDSimProfiler& profiler, size_t instruction, ProfilePhase phase,
+          const dd::VectorDD& state);
+
+    /**
+     * @brief Starts measuring a phase of the instruction measured by the
+     * innermost enclosing scope.
+     *
+     * Nothing is measured if there is no enclosing scope.
+     * @param profiler The profiler to record the phase in.
+     * @param phase The phase to measure.
+     * @param state The state whose nodes are counted before and after the
+     * phase.
+     */
+    Scope(DDSimProfiler& profiler, ProfilePhase phase,
+          const dd::VectorDD& state);
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+    /**
+     * @brief Stops measuring and records the counters of the phase.
+     */
+    ~Scope();
+
+  private:
+    /**
+     * @brief Start measuring a phase.
+     * @param target The profiler to record the phase in.
+     * @param measuredInstruction The instruction the phase belongs to.
+     * @param measuredPhase The phase to measure.
+     * @param measuredState The state whose nodes are counted.
+     */
+    void begin(DDSimProfiler& target, size_t measuredInstruction,
+               ProfilePhase measuredPhase, const dd::VectorDD& measuredState);
+
+    /**
+     * @brief The profiler to record the phase in, or nullptr if nothing is
+     * measured.
+     */
+    DDSimProfiler* profiler = nullptr;
+    /**
+     * @brief The state whose nodes are counted.
+     */
+    const dd::VectorDD* state = nullptr;
+    /**
+     * @brief The instruction the phase belongs to.
+     */
+    size_t instruction = 0;
+    /**
+     * @brief The measured phase.
+     */
+    ProfilePhase phase = ProfileSimulation;
+    /**
+     * @brief The instruction of the enclosing scope, restored afterwards.
+     */
+    size_t outerInstruction = 0;
+    /**
+     * @brief The phase of the enclosing scope, restored afterwards.
+     */
+    ProfilePhase outerPhase = ProfileSimulation;
+    /**
+     * @brief The time at which the phase started.
+     */
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /**
+   * @brief Enable or disable the collection of counters.
+   *
+   * Enabling the profiler discards all previously collected counters.
+   * @param enable True to enable the profiler, false to disable it.
+   */
+  void setEnabled(bool enable);
+
+  /**
+   * @brief Check whether counters are collected.
+   * @return True if the profiler is enabled, false otherwise.
+   */
+  [[nodiscard]] bool isEnabled() const;
+
+  /**
+   * @brief Record that a dense state vector was written during the innermost
+   * active phase.
+   *
+   * Nothing is recorded if no phase is active.
+   * @param bytes The size of the dense state vector in bytes.
+   */
+  void recordDenseBytes(size_t bytes);
+
+  /**
+   * @brief Get the counters of all phases that were entered at least once.
+   * @return The entries, sorted by instruction and then by phase.
+   */
+  [[nodiscard]] std::vector<ProfileEntry> getEntries() const;
+
+private:
+  /**
+   * @brief The counters of one phase of one instruction.
+   */
+  struct Counters {
+    /**
+     * @brief The number of times the phase was entered.
+     */
+    size_t calls = 0;
+    /**
+     * @brief The wall time spent in the phase in seconds.
+     */
+    double seconds = 0;
+    /**
+     * @brief The summed node counts before the phase.
+     */
+    size_t nodesBefore = 0;
+    /**
+     * @brief The summed node counts after the phase.
+     */
+    size_t nodesAfter = 0;
+    /**
+     * @brief The bytes of dense state vectors written during the phase.
+     */
+    size_t denseBytes = 0;
+  };
+
+  /**
+   * @brief Get the counters of a phase of an instruction, creating them if
+   * necessary.
+   * @param instruction The instruction.
+   * @param phase The phase.
+   * @return The counters.
+   */
+  Counters& at(size_t instruction, ProfilePhase phase);
+
+  /**
+   * @brief Whether counters are collected.
+   */
+  bool enabled = false;
+
+  /**
+   * @brief The counters of each phase, indexed by instruction.
+   */
+  std::vector<std::array<Counters, PROFILE_PHASE_COUNT>> counters;
+
+  /**
+   * @brief The instruction of the innermost active scope, or -1ULL if no
+   * scope is active.
+   */
+  size_t activeInstruction = -1ULL;
+
+  /**
+   * @brief The phase of the innermost active scope.
+   */
+  ProfilePhase activePhase = ProfileSimulation;
+};
+
+} // namespace mqt::debugger
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimTraversal.hpp
+ * @brief Provides algorithms that query the state of the DD simulator by
+ * traversing its decision diagrams directly.
+ */
+#pragma once
+
+#include "common.h"
+#include "common/DensityMatrix.hpp"
+#include "common/Span.hpp"
+#include "dd/Package.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief The minimum number of qubits for which the state vector export is
+ * split across multiple threads.
+ *
+ * For smaller states, the overhead of spawning threads outweighs the gain.
+ */
+constexpr size_t PARALLEL_EXPORT_MIN_QUBITS = 16;
+
+/**
+ * @brief The magnitude below which edge weights are treated as zero when
+ * computing the marginal support of a vector DD.
+ */
+constexpr double SUPPORT_TOLERANCE = 1e-8;
+
+/**
+ * @brief Write all amplitudes represented by a vector DD into a dense buffer.
+ *
+ * The decision diagram is traversed once, writing each amplitude directly into
+ * the output buffer. Sub-diagrams that are reached through multiple edges are
+ * only expanded once; further occurrences are filled by scaling a copy of the
+ * already written block.\n\n
+ *
+ * For states with at least `PARALLEL_EXPORT_MIN_QUBITS` qubits, the index
+ * space is split into disjoint ranges that are filled by separate threads.
+ * @param state The vector DD to export.
+ * @param numQubits The number of qubits represented by the DD.
+ * @param output The buffer to write to. Must hold at least 2^`numQubits`
+ * amplitudes.
+ * @param maxThreads The maximum number of threads to use, or 0 to use the
+ * available hardware concurrency.
+ */
+void exportStateVector(const dd::VectorDD& state, size_t numQubits,
+                       const Span<Complex>& output, size_t maxThreads = 0);
+
+/**
+ * @brief Write a contiguous range of the amplitudes represented by a vector DD
+ * into a dense buffer.
+ *
+ * Only the paths leading to the two ends of the range are descended
+ * partially; all sub-diagrams in between are expanded in index order and all
+ * sub-diagrams outside of the range are skipped. The cost therefore depends on
+ * the size of the range rather than on the size of the state vector.
+ * @param state The vector DD to export.
+ * @param start The index of the first amplitude to write.
+ * @param output The buffer to write to. Its size determines the number of
+ * amplitudes that are written. The range must not exceed the state vector.
+ */
+void exportStateVectorRange(const dd::VectorDD& state, size_t start,
+                            const Span<Complex>& output);
+
+/**
+ * @brief Count the distinct nodes of a vector DD.
+ *
+ * The terminal node is not counted.
+ * @param state The vector DD to count the nodes of.
+ * @return The number of distinct non-terminal nodes.
+ */
+size_t countNodes(const dd::VectorDD& state);
+
+/**
+ * @brief Check whether the given qubits of a vector DD can be measured in more
+ * than one way.
+ *
+ * The marginal support of the target qubits is computed by a single traversal
+ * of the decision diagram. Each node is evaluated at most once, nodes below
+ * the lowest target qubit are never expanded, and the traversal stops as soon
+ * as two distinct bitstrings on the target qubits have been found.\n\n
+ *
+ * Edges with a weight of magnitude `SUPPORT_TOLERANCE` or less are treated as
+ * zero.
+ * @param state The vector DD to check.
+ * @param numQubits The number of qubits represented by the DD.
+ * @param qubits The indices of the target qubits.
+ * @return True if at least two different bitstrings on the target qubits have
+ * a non-zero probability, false otherwise.
+ */
+bool hasMultipleOutcomes(const dd::VectorDD& state, size_t numQubits,
+                         const std::vector<size_t>& qubits);
+
+/**
+ * @brief Compute the reduced density matrix of two qubits of a vector DD
+ * without expanding the DD.
+ *
+ * All other qubits are traced out by a traversal over pairs of nodes, where
+ * each pair is evaluated at most once. The rows and columns of the matrix are
+ * ordered like those of `getTwoQubitDensityMatrix`, that is, the lower of the
+ * two qubits is the least significant bit.
+ * @param state The vector DD to reduce.
+ * @param qubit1 The index of the first qubit to keep.
+ * @param qubit2 The index of the second qubit to keep.
+ * @return The 4x4 reduced density matrix.
+ */
+DensityMatrix computeTwoQubitDensityMatrix(const dd::VectorDD& state,
+                                          size_t qubit1, size_t qubit2);
+
+/**
+ * @brief Find the amplitudes of a vector DD whose magnitude exceeds a
+ * threshold.
+ *
+ * The largest magnitude below each node is computed once. The traversal then
+ * skips every edge below which no amplitude exceeds the threshold, so that
+ * every visited node leads to at least one result and the cost depends on the
+ * number of results instead of the size of the state vector.
+ * @param state The vector DD to search.
+ * @param threshold The magnitude an amplitude has to exceed.
+ * @param maxCount The maximum number of amplitudes to find.
+ * @return The index and value of the first `maxCount` found amplitudes, in
+ * ascending order of their indices.
+ */
+std::vector<std::pair<size_t, Complex>>
+findAmplitudesAbove(const dd::VectorDD& state, double threshold,
+                    size_t maxCount);
+
+/**
+ * @brief Find the non-zero amplitudes of a vector DD with the largest
+ * magnitude.
+ *
+ * The DD is explored best-first, always expanding the branch that contains
+ * the largest remaining amplitude, so only the paths towards the results and
+ * their immediate siblings are visited.
+ * @param state The vector DD to search.
+ * @param k The maximum number of amplitudes to find.
+ * @return The index and value of the found amplitudes, in descending order of
+ * their magnitude. Amplitudes of equal magnitude are ordered by index.
+ */
+std::vector<std::pair<size_t, Complex>>
+findLargestAmplitudes(const dd::VectorDD& state, size_t k);
+
+/**
+ * @brief Compute the similarity between the sub-state of the given qubits of
+ * a vector DD and a target state without expanding the DD.
+ *
+ * This is only possible if the target qubits form a contiguous block of DD
+ * levels that is separable from the remaining qubits. In that case, all paths
+ * above the block lead to a single node at its highest level, and all paths
+ * through the block lead to a single node right below it. The similarity is
+ * then the magnitude of the inner product between this sub-diagram and a DD of
+ * the target state composed with the part below the block.\n\n
+ *
+ * As for dense sub-states, the amplitudes of the target state are ordered by
+ * ascending qubit index.
+ * @param dd The package the vector DD belongs to.
+ * @param state The vector DD to compare.
+ * @param numQubits The number of qubits represented by the DD.
+ * @param qubits The indices of the target qubits.
+ * @param target The target state of the sub-state.
+ * @return The similarity, or an empty optional if the sub-state cannot be
+ * compared on the DD.
+ */
+std::optional<double>
+computeSubStateSimilarity(dd::Package& dd, const dd::VectorDD& state,
+                          size_t numQubits, const std::vector<size_t>& qubits,
+                          const Statevector& target);
+
+} // namespace mqt::debugger
@@ -25,6 +25,183 @@
 extern "C" {
 #endif
 
+/**
+ * @brief The phases of executing an instruction that are profiled separately.
+ *
+ * Phases may be nested, e.g., an assertion may densify the state. The time of
+ * a phase includes the time of the phases nested inside of it.
+ */
+typedef enum {
+  /**
+   * @brief Applying the operation of an instruction to the state.
+   */
+  ProfileSimulation,
+  /**
+   * @brief Evaluating an assertion.
+   */
+  ProfileAssertion,
+  /**
+   * @brief Updating the diagnostics after executing an instruction.
+   */
+  ProfileDiagnostics,
+  /**
+   * @brief Writing the state into a dense state vector.
+   */
+  ProfileDensification,
+  /**
+   * @brief Collecting unused nodes of the decision diagram package.
+   */
+  ProfileGarbageCollection,
+} ProfilePhase;
+
+/**
+ * @brief The number of distinct profiling phases.
+ */
+#define PROFILE_PHASE_COUNT 5
+
+/**
+ * @brief The profiling counters of one phase of one instruction.
+ *
+ * All counters are summed over all calls of the phase while the instruction
+ * was executed.
+ */
+typedef struct {
+  /**
+   * @brief The instruction the counters belong to.
+   */
+  size_t instruction;
+  /**
+   * @brief The phase the counters belong to.
+   */
+  ProfilePhase phase;
+  /**
+   * @brief The number of times the phase was entered.
+   */
+  size_t calls;
+  /**
+   * @brief The wall time spent in the phase in seconds.
+   */
+  double seconds;
+  /**
+   * @brief The number of nodes of the state's decision diagram before the
+   * phase.
+   */
+  size_t nodesBefore;
+  /**
+   * @brief The number of nodes of the state's decision diagram after the
+   * phase.
+   */
+  size_t nodesAfter;
+  /**
+   * @brief The number of bytes of dense state vectors the phase wrote.
+   */
+  size_t denseBytes;
+} ProfileEntry;
+
+/**
+ * @brief The changes of a simulation state since an earlier version, as
+ * reported by `getStateDelta`.
+ *
+ * The caller provides the buffers and sets their sizes and the amplitude
+ * tolerance. All other fields are set by `getStateDelta`.
+ */
+typedef struct {
+  /**
+   * @brief The version of the reported state, to be passed to the next call.
+   */
+  size_t version;
+  /**
+   * @brief True if all classical variables are reported because the given
+   * version was not the one returned by the previous call.
+   */
+  bool complete;
+  /**
+   * @brief The instruction that is executed next.
+   */
+  size_t currentInstruction;
+  /**
+   * @brief True if the simulation has finished.
+   */
+  bool finished;
+  /**
+   * @brief True if the last step stopped at a failing assertion.
+   */
+  bool assertionFailed;
+  /**
+   * @brief True if the last step stopped at a breakpoint.
+   */
+  bool breakpointHit;
+  /**
+   * @brief A buffer to store the classical variables whose value changed.
+   */
+  Variable* changedVariables;
+  /**
+   * @brief The size of the `changedVariables` buffer.
+   */
+  size_t maxChangedVariables;
+  /**
+   * @brief The number of classical variables whose value changed. It is set
+   * even if the buffer is too small.
+   */
+  size_t numChangedVariables;
+  /**
+   * @brief A buffer to store the innermost frames of the stack trace, as
+   * returned by `getStackTrace`.
+   */
+  size_t* stackTrace;
+  /**
+   * @brief The size of the `stackTrace` buffer.
+   */
+  size_t maxStackDepth;
+  /**
+   * @brief The depth of the stack, which may exceed `maxStackDepth`.
+   */
+  size_t stackDepth;
+  /**
+   * @brief The minimum magnitude of the change of an amplitude to be
+   * reported.
+   */
+  double amplitudeTolerance;
+  /**
+   * @brief A buffer to store the indices of the changed amplitudes.
+   */
+  size_t* amplitudeIndices;
+  /**
+   * @brief A buffer to store the values of the changed amplitudes.
+   */
+  Complex* amplitudes;
+  /**
+   * @brief The size of the `amplitudeIndices` and `amplitudes` buffers. No
+   * amplitudes are reported if this is 0.
+   */
+  size_t maxAmplitudes;
+  /**
+   * @brief The number of reported amplitudes.
+   */
+  size_t numAmplitudes;
+  /**
+   * @brief True if amplitudes are reported relative to zero, because the
+   * previous call did not keep the amplitudes it reported.
+   */
+  bool amplitudesComplete;
+  /**
+   * @brief True if not all changed amplitudes could be reported, because
+   * the buffers are too small or the state vector does not fit into memory.
+   */
+  bool amplitudesTruncated;
+} StateDelta;
+
+/**
+ * @brief A callback that reports the progress of an asynchronous run.
+ *
+ * The callback is invoked on the worker thread that executes the run.
+ * @param userData The user data passed when the run was started.
+ * @param currentInstruction The instruction the run has reached.
+ * @param failedAssertions The number of assertions that failed so far.
+ */
+typedef void (*ProgressCallback)(void* userData, size_t currentInstruction,
+                                 size_t failedAssertions);
+
 /**
  * @brief A C-style interface for the debugging and simulation interface.
  *
@@ -54,6 +231,23 @@ struct SimulationStateStruct {
    */
   LoadResult (*loadCode)(SimulationState* self, const char* code);
 
+  /**
+   * @brief Replaces the loaded code by an edited version of it.
+   *
+   * In contrast to `loadCode`, the simulation is not restarted if the edit
+   * does not affect the instructions that have already been executed. Instead,
+   * it continues from the last reproducible point before the first edited
+   * instruction. Breakpoints are kept.\n\n
+   *
+   * If the new code cannot be loaded, the previously loaded code and the
+   * current simulation state are kept. If no code has been loaded yet, this
+   * behaves like `loadCode`.
+   * @param self The instance to load the code into.
+   * @param code The edited code to load.
+   * @return The result of the load operation.
+   */
+  LoadResult (*reloadCode)(SimulationState* self, const char* code);
+
   /**
    * @brief Steps the simulation forward by one instruction.
    * @param self The instance to step forward.
@@ -152,6 +346,61 @@ struct SimulationStateStruct {
    */
   Result (*pauseSimulation)(SimulationState* self);
 
+  /**
+   * @brief Runs the simulation on a worker thread until it finishes, an
+   * assertion fails, or a breakpoint is hit.
+   *
+   * The method returns as soon as the run was started. Until the run has
+   * completed, the instance must only be accessed through `pauseSimulation`,
+   * `isSimulationRunning`, and `waitForSimulation`. Pausing the simulation
+   * cancels the run after the current instruction.\n\n
+   *
+   * Progress is reported to the callback at intervals and once more when the
+   * run ends.
+   * @param self The instance to run.
+   * @param callback The callback to report progress to, or nullptr.
+   * @param userData The user data passed to the callback.
+   * @return The result of the operation. `ERROR` if the simulation cannot step
+   * forward or another run is still in progress.
+   */
+  Result (*runSimulationAsync)(SimulationState* self, ProgressCallback callback,
+                               void* userData);
+
+  /**
+   * @brief Runs the simulation on a worker thread until it finishes, even if
+   * assertions fail.
+   *
+   * This behaves like `runSimulationAsync`, except that the run continues
+   * after failed assertions and breakpoints. Pausing the simulation ends the
+   * whole run.
+   * @param self The instance to run.
+   * @param callback The callback to report progress to, or nullptr.
+   * @param userData The user data passed to the callback.
+   * @return The result of the operation. `ERROR` if the simulation has not
+   * been set up or another run is still in progress.
+   */
+  Result (*runAllAsync)(SimulationState* self, ProgressCallback callback,
+                        void* userData);
+
+  /**
+   * @brief Checks whether an asynchronous run is still in progress.
+   * @param self The instance to query.
+   * @return True if an asynchronous run is in progress, false otherwise.
+   */
+  bool (*isSimulationRunning)(SimulationState* self);
+
+  /**
+   * @brief Waits for the last asynchronous run to complete.
+   *
+   * Once this method returned, the instance may be accessed again.
+   * @param self The instance to wait for.
+   * @param failedAssertions Output parameter for the number of assertions
+   * that failed during the run. May be nullptr.
+   * @return The result of the run, or `ERROR` if no run was started since the
+   * last call.
+   */
+  Result (*waitForSimulation)(SimulationState* self, size_t* failedAssertions);
+
   /**
    * @brief Indicates whether the simulation can step forward.
    *
@@ -192,6 +441,7 @@ struct SimulationStateStruct {
    * current number of qubits. Implementations are expected to renormalize the
    * remaining amplitudes so that the state vector stays normalized and to
    * reject invalid bitstrings or amplitudes that violate normalization.
+   * The bitstring lists the qubits from the highest to the lowest index.
    *
    * @param self The instance to query.
    * @param basisState The bitstring identifying the basis state to update.
@@ -354,6 +604,25 @@ struct SimulationStateStruct {
    */
   Result (*getStateVectorFull)(SimulationState* self, Statevector* output);
 
+  /**
+   * @brief Gets a contiguous range of amplitudes of the full state vector of
+   * the simulation at the current time.
+   *
+   * This allows large state vectors to be read page by page, so that memory
+   * only has to be allocated for the requested range. The state vector is
+   * expected to be allocated with space for at least `count` amplitudes before
+   * calling this method. The amplitude with index `start` is written to the
+   * first entry.
+   * @param self The instance to query.
+   * @param start The index of the first amplitude to retrieve.
+   * @param count The number of amplitudes to retrieve.
+   * @param output A reference to a `Statevector` instance to store the
+   * amplitudes.
+   * @return The result of the operation.
+   */
+  Result (*getStateVectorRange)(SimulationState* self, size_t start,
+                                size_t count, Statevector* output);
+
   /**
    * @brief Gets a sub-state of the state vector of the simulation at the
    * current time.
@@ -374,6 +643,51 @@ struct SimulationStateStruct {
   Result (*getStateVectorSub)(SimulationState* self, size_t subStateSize,
                               const size_t* qubits, Statevector* output);
 
+  /**
+   * @brief Gets the amplitudes of the full state vector whose magnitude
+   * exceeds a threshold.
+   *
+   * Only the parts of the state that contain such amplitudes are visited, so
+   * the cost depends on the number of results rather than on the size of the
+   * state vector. The amplitudes are returned in ascending order of their
+   * indices.
+   * \n\n
+   *
+   * Passing a threshold of 0 returns all non-zero amplitudes.
+   *
+   * @param self The instance to query.
+   * @param threshold The magnitude an amplitude has to exceed to be returned.
+   * @param maxCount The size of the `indices` and `amplitudes` buffers. At
+   * most this many amplitudes are returned.
+   * @param indices A buffer to store the indices of the amplitudes.
+   * @param amplitudes A buffer to store the amplitudes.
+   * @param count A reference to store the number of returned amplitudes.
+   * @return The result of the operation.
+   */
+  Result (*getNonZeroAmplitudes)(SimulationState* self, double threshold,
+                                 size_t maxCount, size_t* indices,
+                                 Complex* amplitudes, size_t* count);
+
+  /**
+   * @brief Gets the non-zero amplitudes of the full state vector with the
+   * largest magnitudes.
+   *
+   * The state is explored in the order of the largest amplitude each of its
+   * parts contains, so the cost depends on `k` rather than on the size of the
+   * state vector. The amplitudes are returned in descending order of their
+   * magnitude.
+   *
+   * @param self The instance to query.
+   * @param k The size of the `indices` and `amplitudes` buffers. At most this
+   * many amplitudes are returned.
+   * @param indices A buffer to store the indices of the amplitudes.
+   * @param amplitudes A buffer to store the amplitudes.
+   * @param count A reference to store the number of returned amplitudes.
+   * @return The result of the operation.
+   */
+  Result (*getTopKAmplitudes)(SimulationState* self, size_t k, size_t* indices,
+                              Complex* amplitudes, size_t* count);
+
   /**
    * @brief Sets a breakpoint at the desired position in the code.
    *
@@ -445,6 +759,119 @@ struct SimulationStateStruct {
    */
   size_t (*compile)(SimulationState* self, char* buffer,
                     CompilationSettings settings);
+
+  /**
+   * @brief Compiles all slices of the given code in a single pass.
+   *
+   * The compiled slices are written into `buffer` one after the other, each
+   * followed by a null terminator. Slice `i` is the code that `compile` returns
+   * for the slice index `i`. The `sliceIndex` of `settings` is ignored.
+   * @param self The SimulationState instance from which the original assertion
+   * code should be taken.
+   * @param buffer The buffer that should be filled with the compiled slices, or
+   * NULL to compute the required buffer size.
+   * @param offsets The buffer that should be filled with the offset of the
+   * first character of each slice in `buffer`, or NULL. Must be able to hold
+   * `numSlices` entries.
+   * @param numSlices A reference to store the number of slices, or NULL.
+   * @param settings The settings to use for the compilation.
+   * @return The total size of all compiled slices, including their null
+   * terminators.
+   */
+  size_t (*compileSlices)(SimulationState* self, char* buffer, size_t* offsets,
+                          size_t* numSlices, CompilationSettings settings);
+
+  /**
+   * @brief Sets the seed of the random number generator used for measurements.
+   *
+   * Measurements performed after setting the seed are reproducible.
+   * @param self The instance to configure.
+   * @param seed The seed to use.
+   * @return The result of the operation.
+   */
+  Result (*setSeed)(SimulationState* self, size_t seed);
+
+  /**
+   * @brief Samples the classical outcomes of multiple executions of the
+   * program.
+   *
+   * The program is executed from the start, independently of the current
+   * simulation. Each part of the program is simulated once for every
+   * combination of preceding measurement outcomes, and the shots are split
+   * between the outcomes of each measurement according to their
+   * probabilities. Assertions are not checked.
+   * \n\n
+   *
+   * Each outcome is encoded as an integer, in which bit `i` is the value of the
+   * `i`-th classical bit. There are at most `min(shots, 2^n)` distinct
+   * outcomes for `n` classical bits. The outcomes are sorted in ascending
+   * order.
+   *
+   * @param self The instance to sample from.
+   * @param shots The number of executions to sample.
+   * @param seed The seed of the random number generator used for sampling.
+   * @param outcomes A buffer to store the distinct outcomes.
+   * @param counts A buffer to store the number of shots of each outcome.
+   * @param maxOutcomes The size of the `outcomes` and `counts` buffers.
+   * @param numOutcomes A reference to store the number of distinct outcomes.
+   * It is set even if the buffers are too small.
+   * @return The result of the operation. Fails if the buffers are too small or
+   * the program uses more classical bits than fit into a `size_t`.
+   */
+  Result (*sampleShots)(SimulationState* self, size_t shots, size_t seed,
+                        size_t* outcomes, size_t* counts, size_t maxOutcomes,
+                        size_t* numOutcomes);
+
+  /**
+   * @brief Enables or disables the collection of profiling counters.
+   *
+   * While profiling is disabled, no counters are collected and executing
+   * instructions has no measurable overhead. Enabling profiling discards all
+   * previously collected counters.
+   * @param self The instance to configure.
+   * @param enabled True to enable profiling, false to disable it.
+   * @return The result of the operation.
+   */
+  Result (*setProfilingEnabled)(SimulationState* self, bool enabled);
+
+  /**
+   * @brief Gets the profiling counters collected since profiling was enabled.
+   *
+   * One entry is returned for each phase of each instruction that was entered
+   * at least once. The entries are sorted by instruction and then by phase.
+   * @param self The instance to query.
+   * @param entries A buffer to store the entries.
+   * @param maxEntries The size of the `entries` buffer.
+   * @param numEntries A reference to store the number of entries. It is set
+   * even if the buffer is too small.
+   * @return The result of the operation. Fails if the buffer is too small.
+   */
+  Result (*getProfile)(SimulationState* self, ProfileEntry* entries,
+                       size_t maxEntries, size_t* numEntries);
+
+  /**
+   * @brief Gets the changes of the simulation state since an earlier call.
+   *
+   * Each successful call returns a new version that identifies the reported
+   * state. Passing this version to the next call only reports the classical
+   * variables and amplitudes that changed in between. For any other version,
+   * such as 0, all classical variables and all amplitudes with a magnitude
+   * above the tolerance are reported. The current instruction, the stack trace,
+   * and whether an assertion or breakpoint stopped the simulation are always
+   * reported.
+   * \n\n
+   *
+   * Changed amplitudes are reported in ascending order of their indices, up to
+   * the size of the buffers. This allows front ends to refresh their view of
+   * the state with a single call after each stop.
+   * @param self The instance to query.
+   * @param sinceVersion The version returned by the previous call, or 0.
+   * @param output The delta to fill.
+   * @return The result of the operation. Fails if the buffer of the classical
+   * variables is too small, in which case the version is not consumed.
+   */
+  Result (*getStateDelta)(SimulationState* self, size_t sinceVersion,
+                          StateDelta* output);
 };
 
 #ifdef __cplusplus
@@ -121,6 +121,30 @@ struct DiagnosticsStruct {
   Result (*getDataDependencies)(Diagnostics* self, size_t instruction,
                                 bool includeCallers, bool* instructions);
 
+  /**
+   * @brief Extract all data dependencies for several instructions at once.
+   *
+   * This method expects a continuous memory block of booleans with `count`
+   * rows, each with size equal to the number of instructions. The row of each
+   * requested instruction is filled in the same way as by
+   * `getDataDependencies`.\n\n
+   *
+   * This method can be performed without running the program, as it is a static
+   * analysis method.\n\n
+   *
+   * @param self The diagnostics instance to query.
+   * @param instructions The instructions to extract the data dependencies for.
+   * @param count The number of instructions.
+   * @param includeCallers True, if the data dependencies should include all
+   * possible callers of the containing custom gates.
+   * @param dependencies An array of booleans that will be set to true for each
+   * instruction that is a data dependency of the instruction of its row.
+   * @return The result of the operation.
+   */
+  Result (*getDataDependenciesBatch)(Diagnostics* self,
+                                     const size_t* instructions, size_t count,
+                                     bool includeCallers, bool* dependencies);
+
   /**
    * @brief Extract all qubits that interact with a given qubit up to a specific
    * instruction.
@@ -149,6 +173,32 @@ struct DiagnosticsStruct {
   Result (*getInteractions)(Diagnostics* self, size_t beforeInstruction,
                             size_t qubit, bool* qubitsAreInteracting);
 
+  /**
+   * @brief Extract the groups of interacting qubits up to a specific
+   * instruction for all qubits at once.
+   *
+   * This method expects a continuous memory block of integers with size equal
+   * to the number of qubits. Each element represents a qubit and will be set to
+   * the smallest qubit index of the group of qubits it interacts with. Two
+   * qubits interact if and only if they are assigned the same value.\n\n
+   *
+   * The interactions are determined in the same way as by
+   * `getInteractions`.\n\n
+   *
+   * This method can be performed without running the program, as it is a static
+   * analysis method.\n\n
+   *
+   * @param self The diagnostics instance to query.
+   * @param beforeInstruction The instruction to extract the interactions up to
+   * (excluding).
+   * @param components An array of qubit indices that will be set to the
+   * smallest qubit of each qubit's group.
+   * @return The result of the operation.
+   */
+  Result (*getInteractionComponents)(Diagnostics* self,
+                                     size_t beforeInstruction,
+                                     size_t* components);
+
   /**
    * @brief Extract all controlled gates that have been marked as only having
    * controls with value zero.
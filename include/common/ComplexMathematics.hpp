@@ -16,8 +16,8 @@
 #pragma once
 
 #include "common.h"
+#include "common/DensityMatrix.hpp"
 
-#include <Eigen/Dense>
 #include <cstddef>
 #include <string>
 #include <vector>
@@ -64,8 +64,35 @@ Complex complexConjugate(const Complex& c);
  * @param qubit2 The second qubit to check.
  * @return True if the qubits are entangled, false otherwise.
  */
-bool areQubitsEntangled(std::vector<std::vector<Complex>>& densityMatrix,
-                        size_t qubit1, size_t qubit2);
+bool areQubitsEntangled(const DensityMatrix& densityMatrix, size_t qubit1,
+                        size_t qubit2);
+
+/**
+ * @brief Check if two qubits are entangled in a given state vector.
+ *
+ * Instead of constructing the full density matrix, this computes the two-qubit
+ * reduced density matrix of the given qubits directly from the amplitudes and
+ * then checks whether the shared information is greater than 0.
+ * @param sv The state vector to check for entanglement.
+ * @param qubit1 The first qubit to check.
+ * @param qubit2 The second qubit to check.
+ * @return True if the qubits are entangled, false otherwise.
+ */
+bool areQubitsEntangled(const Statevector& sv, size_t qubit1, size_t qubit2);
+
+/**
+ * @brief Compute the reduced density matrix of two qubits of a state vector.
+ *
+ * All other qubits are traced out. This requires a single pass over the
+ * amplitudes. In the resulting 4x4 matrix, the qubit with the lower index is
+ * represented by the least significant bit.
+ * @param sv The state vector to compute the reduced density matrix of.
+ * @param qubit1 The first qubit to keep.
+ * @param qubit2 The second qubit to keep.
+ * @return The computed reduced density matrix.
+ */
+DensityMatrix getTwoQubitDensityMatrix(const Statevector& sv, size_t qubit1,
+                                       size_t qubit2);
 
 /**
  * @brief Translate a given statevector to a density matrix.
@@ -73,13 +100,14 @@ bool areQubitsEntangled(std::vector<std::vector<Complex>>& densityMatrix,
  * @param sv The statevector to translate.
  * @return The computed density matrix.
  */
-std::vector<std::vector<Complex>> toDensityMatrix(const Statevector& sv);
+DensityMatrix toDensityMatrix(const Statevector& sv);
 
 /**
  * @brief Check if the partial trace of a given state vector is pure.
  *
  * This is true if and only if the trace of the square of the traced out density
- * matrix is equal to 1.
+ * matrix is equal to 1. It is computed from the Schmidt coefficients of the
+ * state vector, so that the reduced density matrix is never built.
  * @param sv The state vector to check.
  * @param traceOut The indices of the qubits to trace out.
  * @return True if the partial trace is pure, false otherwise.
@@ -87,6 +115,18 @@ std::vector<std::vector<Complex>> toDensityMatrix(const Statevector& sv);
 bool partialTraceIsPure(const Statevector& sv,
                         const std::vector<size_t>& traceOut);
 
+/**
+ * @brief Check if the partial trace of a given state vector is pure.
+ * @param sv The state vector to check.
+ * @param traceOut The indices of the qubits to trace out.
+ * @param scratch A buffer for the reshaped amplitudes. It is resized as
+ * required, so that it can be reused across calls.
+ * @return True if the partial trace is pure, false otherwise.
+ */
+bool partialTraceIsPure(const Statevector& sv,
+                        const std::vector<size_t>& traceOut,
+                        AmplitudeBuffer& scratch);
+
 /**
  * @brief Gets the partial state vector by tracing out individual qubits from
  * the full state vector.
@@ -94,20 +134,65 @@ bool partialTraceIsPure(const Statevector& sv,
  * @param traceOut The indices of the qubits to trace out.
  * @return The partial state vector.
  */
-std::vector<std::vector<Complex>>
+DensityMatrix
 getPartialTraceFromStateVector(const Statevector& sv,
                                const std::vector<size_t>& traceOut);
 
 /**
- * @brief Convert a given vector-of-vectors matrix to an Eigen3 matrix.
- * @param matrix The vector-of-vectors matrix to convert.
- * @return A new Eigen3 matrix.
+ * @brief The Schmidt decomposition of a state vector with respect to a
+ * bipartition of its qubits.
  */
-Eigen::MatrixXcd // NOLINT
-toEigenMatrix(const std::vector<std::vector<Complex>>& matrix);
+struct SchmidtDecomposition {
+  /**
+   * @brief The Schmidt coefficients in descending order.
+   */
+  std::vector<double> coefficients;
+
+  /**
+   * @brief The amplitudes of the state of the kept qubits that belongs to the
+   * largest Schmidt coefficient.
+   *
+   * If the state vector is separable with respect to the bipartition, this is
+   * the sub-state of the kept qubits. Its global phase is chosen such that the
+   * first amplitude of maximal magnitude is real and positive.
+   */
+  std::vector<Complex> subState;
+};
+
+/**
+ * @brief Compute the Schmidt decomposition of a state vector.
+ *
+ * The amplitudes are reshaped into a 2^k x 2^(n-k) matrix with one row for
+ * each assignment of the k kept qubits, which is then decomposed by a singular
+ * value decomposition. In contrast to the reduced density matrix, this never
+ * requires more memory than the state vector itself.
+ * @param sv The state vector to decompose.
+ * @param qubits The indices of the qubits to keep. The amplitudes of the
+ * sub-state are ordered by ascending qubit index.
+ * @param scratch A buffer for the reshaped amplitudes. It is resized as
+ * required, so that it can be reused across calls.
+ * @return The computed Schmidt decomposition.
+ */
+SchmidtDecomposition getSchmidtDecomposition(const Statevector& sv,
+                                             const std::vector<size_t>& qubits,
+                                             AmplitudeBuffer& scratch);
+
+/**
+ * @brief Check whether a Schmidt decomposition belongs to a state vector that
+ * is separable with respect to its bipartition.
+ *
+ * This is true if and only if the sum of the fourth powers of the Schmidt
+ * coefficients, which is the purity of both reduced states, is equal to 1.
+ * @param decomposition The Schmidt decomposition to check.
+ * @return True if the state vector is separable, false otherwise.
+ */
+bool isSeparable(const SchmidtDecomposition& decomposition);
 
 /**
  * @brief Compute the amplitudes of a given state vector's sub-state.
+ *
+ * The sub-state is extracted from the Schmidt decomposition of the state
+ * vector.
  * @param sv The state vector to compute the sub-state from.
  * @param qubits The indices of the qubits to include in the sub-state.
  * @return The computed sub-state vector amplitudes.
@@ -116,6 +201,19 @@ std::vector<Complex>
 getSubStateVectorAmplitudes(const Statevector& sv,
                             const std::vector<size_t>& qubits);
 
+/**
+ * @brief Compute the amplitudes of a given state vector's sub-state.
+ * @param sv The state vector to compute the sub-state from.
+ * @param qubits The indices of the qubits to include in the sub-state.
+ * @param scratch A buffer for the reshaped amplitudes. It is resized as
+ * required, so that it can be reused across calls.
+ * @return The computed sub-state vector amplitudes.
+ */
+std::vector<Complex>
+getSubStateVectorAmplitudes(const Statevector& sv,
+                            const std::vector<size_t>& qubits,
+                            AmplitudeBuffer& scratch);
+
 /**
  * @brief Generate a string representation of a complex number.
  * @param c The complex number.
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DensityMatrix.hpp
+ * @brief Provides contiguous, aligned storage for amplitudes and density
+ * matrices.
+ *
+ * The buffers store complex numbers as interleaved real and imaginary parts,
+ * which is the layout of `std::complex<double>`. Therefore, they can be viewed
+ * as Eigen3 matrices without copying, so that Eigen's vectorized kernels can
+ * be applied to them directly.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <Eigen/Dense>
+#include <complex>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace mqt::debugger {
+
+static_assert(sizeof(Complex) == sizeof(std::complex<double>) &&
+                  alignof(Complex) == alignof(std::complex<double>),
+              "Complex must be layout-compatible with std::complex<double>");
+
+/**
+ * @brief The alignment in bytes of all amplitude and density-matrix buffers.
+ *
+ * This is sufficient for the widest vector registers used by Eigen3.
+ */
+constexpr size_t BUFFER_ALIGNMENT = 64;
+
+/**
+ * @brief An allocator that aligns all allocations to `BUFFER_ALIGNMENT` bytes.
+ * @tparam T The type of the allocated elements.
+ */
+template <typename T> class AlignedAllocator {
+public:
+  /**
+   * @brief The type of the allocated elements.
+   */
+  using value_type = T;
+
+  AlignedAllocator() = default;
+
+  /**
+   * @brief Constructs a new allocator from an allocator for another type.
+   */
+  template <typename U>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  AlignedAllocator(const AlignedAllocator<U>& /*other*/) noexcept {}
+
+  /**
+   * @brief Allocates aligned storage for the given number of elements.
+   * @param count The number of elements to allocate storage for.
+   * @return A pointer to the allocated storage.
+   */
+  T* allocate(size_t count) {
+    return static_cast<T*>(::operator new(
+        count * sizeof(T), std::align_val_t{BUFFER_ALIGNMENT}));
+  }
+
+  /**
+   * @brief Frees storage previously allocated by `allocate`.
+   * @param pointer The pointer to the storage to free.
+   */
+  void deallocate(T* pointer, size_t /*count*/) noexcept {
+    ::operator delete(pointer, std::align_val_t{BUFFER_ALIGNMENT});
+  }
+
+  /**
+   * @brief Compares two allocators. All instances are interchangeable.
+   * @return Always true.
+   */
+  template <typename U>
+  bool operator==(const AlignedAllocator<U>& /*other*/) const noexcept {
+    return true;
+  }
+};
+
+/**
+ * @brief A contiguous, aligned buffer of amplitudes.
+ */
+using AmplitudeBuffer = std::vector<Complex, AlignedAllocator<Complex>>;
+
+/**
+ * @brief The Eigen3 type used to view density matrices.
+ */
+using EigenDensityMatrix =
+    Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic,
+                  Eigen::RowMajor>;
+
+/**
+ * @brief The Eigen3 type used to view amplitude buffers.
+ */
+using EigenAmplitudes = Eigen::Matrix<std::complex<double>, Eigen::Dynamic, 1>;
+
+/**
+ * @brief A square complex matrix stored in a single row-major buffer.
+ */
+class DensityMatrix {
+public:
+  /**
+   * @brief Constructs a new zero matrix.
+   * @param dimension The number of rows and columns of the matrix.
+   */
+  explicit DensityMatrix(size_t dimension)
+      : matrixDimension(dimension), entries(dimension * dimension, {0, 0}) {}
+
+  /**
+   * @brief Accesses the entry at the given position.
+   * @param row The row of the entry.
+   * @param col The column of the entry.
+   * @return The entry at the given position.
+   */
+  Complex& operator()(size_t row, size_t col) {
+    return entries[(row * matrixDimension) + col];
+  }
+
+  /**
+   * @brief Accesses the entry at the given position.
+   * @param row The row of the entry.
+   * @param col The column of the entry.
+   * @return The entry at the given position.
+   */
+  const Complex& operator()(size_t row, size_t col) const {
+    return entries[(row * matrixDimension) + col];
+  }
+
+  /**
+   * @brief Returns the number of rows and columns of the matrix.
+   * @return The dimension of the matrix.
+   */
+  [[nodiscard]] size_t dimension() const { return matrixDimension; }
+
+  /**
+   * @brief Views the matrix as an Eigen3 matrix without copying.
+   * @return A mutable Eigen3 view of the matrix.
+   */
+  Eigen::Map<EigenDensityMatrix> asEigen() {
+    return {reinterpret_cast<std::complex<double>*>( // NOLINT
+                entries.data()),
+            static_cast<Eigen::Index>(matrixDimension),
+            static_cast<Eigen::Index>(matrixDimension)};
+  }
+
+  /**
+   * @brief Views the matrix as an Eigen3 matrix without copying.
+   * @return A read-only Eigen3 view of the matrix.
+   */
+  [[nodiscard]] Eigen::Map<const EigenDensityMatrix> asEigen() const {
+    return {reinterpret_cast<const std::complex<double>*>( // NOLINT
+                entries.data()),
+            static_cast<Eigen::Index>(matrixDimension),
+            static_cast<Eigen::Index>(matrixDimension)};
+  }
+
+private:
+  /**
+   * @brief The number of rows and columns of the matrix.
+   */
+  size_t matrixDimension;
+
+  /**
+   * @brief The entries of the matrix in row-major order.
+   */
+  AmplitudeBuffer entries;
+};
+
+/**
+ * @brief Views a range of amplitudes as an Eigen3 vector without copying.
+ * @param amplitudes The first amplitude of the range.
+ * @param count The number of amplitudes in the range.
+ * @return A read-only Eigen3 view of the amplitudes.
+ */
+inline Eigen::Map<const EigenAmplitudes>
+asEigenVector(const Complex* amplitudes, size_t count) {
+  return {reinterpret_cast<const std::complex<double>*>(amplitudes), // NOLINT
+          static_cast<Eigen::Index>(count)};
+}
+
+} // namespace mqt::debugger
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file ResultChecker.hpp
+ * @brief Provides methods to check the results of executions of compiled
+ * programs against their assertions.
+ *
+ * These methods are the native counterpart of the Python module
+ * `mqt.debugger.check.result_checker` and follow the same statistics.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+/**
+ * @brief The observed counts of all assertion registers over several shots.
+ */
+struct ResultCounts {
+  /**
+   * @brief The number of shots in the results.
+   */
+  size_t numSamples = 0;
+  /**
+   * @brief The counts of all registers, stored one after the other.
+   *
+   * The counts of register `i` start at `offsets[i]`. A register of `n`
+   * variables has `2^n` counts, where the `j`-th variable of the register
+   * corresponds to bit `j` of the index.
+   */
+  std::vector<size_t> counts;
+  /**
+   * @brief The offsets of the registers in `counts`.
+   *
+   * The list contains one more element than there are registers, so that the
+   * counts of register `i` end at `offsets[i + 1]`.
+   */
+  std::vector<size_t> offsets;
+};
+
+/**
+ * @brief Load the counts of the given registers from a stream of results.
+ *
+ * The stream contains a JSON list with one object per shot, mapping variable
+ * names to their measured values. The stream is read in a single pass, so
+ * the list is never held in memory. A variable that is part of multiple
+ * registers is only counted for the first of them. Variables that are not
+ * part of any register are ignored.
+ * @param input The stream to read the results from.
+ * @param registers The variables of each register to count.
+ * @return The counts of the registers.
+ * @throws std::invalid_argument If the stream is not a valid list of results.
+ */
+ResultCounts
+loadResultCounts(std::istream& input,
+                 const std::vector<std::vector<std::string>>& registers);
+
+/**
+ * @brief Parse the expected distribution of an equality assertion.
+ * @param assertion The assertion, starting with the list of expected values
+ * in braces.
+ * @return The expected values, normalized to sum up to one.
+ * @throws std::invalid_argument If the assertion cannot be parsed.
+ */
+std::vector<double> parseExpectedProbabilities(const std::string& assertion);
+
+/**
+ * @brief Compute the Cressie-Read power divergence between observed and
+ * expected counts.
+ *
+ * Bins with an expected count of zero are removed before the statistic is
+ * computed, and bins with small expected counts are merged.
+ * @param observed The observed counts.
+ * @param expected The expected counts.
+ * @param power The power of the divergence.
+ * @return The statistic and its p-value, or (0, 0) if a value was observed
+ * for a bin with an expected count of zero.
+ */
+std::pair<double, double>
+checkPowerDivergence(const std::vector<double>& observed,
+                     const std::vector<double>& expected,
+                     double power = 2.0 / 3.0);
+
+/**
+ * @brief Check if a distribution is equal to the expected distribution under
+ * noise.
+ * @param distribution The observed counts.
+ * @param expectedProbabilities The expected probabilities without noise.
+ * @param numSamples The number of samples.
+ * @param expectedSuccessProbability The expected success probability of the
+ * program.
+ * @param pValue The minimum p-value required to accept the distribution.
+ * @param scale True to scale the distribution to 100 samples.
+ * @return True if the distribution is equal to the expected one, false
+ * otherwise.
+ */
+bool distributionEqualUnderNoise(
+    const std::vector<size_t>& distribution,
+    const std::vector<double>& expectedProbabilities, size_t numSamples,
+    double expectedSuccessProbability, double pValue = 0.05,
+    bool scale = true);
+
+/**
+ * @brief Check an assertion based on the observed distribution of its
+ * register.
+ * @param assertion The assertion to check, starting with `{superposition}`,
+ * `{zero}`, or the list of expected amplitudes in braces.
+ * @param distribution The observed counts.
+ * @param numSamples The number of samples.
+ * @param expectedSuccessProbability The expected success probability of the
+ * program.
+ * @param pValue The minimum p-value required to accept the assertion.
+ * @return True if the assertion is satisfied, false otherwise.
+ * @throws std::invalid_argument If the assertion cannot be parsed.
+ */
+bool checkAssertionResult(const std::string& assertion,
+                          const std::vector<size_t>& distribution,
+                          size_t numSamples, double expectedSuccessProbability,
+                          double pValue = 0.05);
+
+/**
+ * @brief Check all assertions against a stream of results.
+ *
+ * The results are loaded with `loadResultCounts`, after which the assertions
+ * are checked in parallel.
+ * @param input The stream to read the results from.
+ * @param registers The variables of the register of each assertion.
+ * @param assertions The assertions to check, one for each register.
+ * @param expectedSuccessProbability The expected success probability of the
+ * program.
+ * @param pValue The minimum p-value required to accept an assertion.
+ * @param maxThreads The maximum number of threads to use, or 0 to use the
+ * number of hardware threads.
+ * @return For each assertion, whether it is satisfied.
+ * @throws std::invalid_argument If the results or an assertion cannot be
+ * parsed.
+ */
+std::vector<bool>
+checkResults(std::istream& input,
+             const std::vector<std::vector<std::string>>& registers,
+             const std::vector<std::string>& assertions,
+             double expectedSuccessProbability, double pValue = 0.05,
+             size_t maxThreads = 0);
+
+} // namespace mqt::debugger
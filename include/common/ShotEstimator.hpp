@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file ShotEstimator.hpp
+ * @brief Provides a Monte-Carlo estimation of the number of shots required to
+ * check assertions on real devices.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace mqt::debugger {
+
+/**
+ * @brief The largest number of shots the estimation searches before it gives
+ * up.
+ */
+constexpr size_t MAX_ESTIMATED_SHOTS = 1ULL << 40U;
+
+/**
+ * @brief The settings of a shot estimation.
+ */
+struct ShotEstimationSettings {
+  /**
+   * @brief The minimum p-value required to accept an assertion.
+   */
+  double pValue = 0.05;
+  /**
+   * @brief The number of simulated executions per candidate number of shots.
+   */
+  size_t numTrials = 1000;
+  /**
+   * @brief The share of trials that must accept the assertion.
+   */
+  double accuracy = 0.95;
+  /**
+   * @brief The seed of the random number generators.
+   *
+   * The estimation is deterministic for a given seed, independent of the
+   * number of threads.
+   */
+  uint64_t seed = 0;
+  /**
+   * @brief The maximum number of threads to use, or 0 to use the number of
+   * hardware threads.
+   */
+  size_t maxThreads = 0;
+};
+
+/**
+ * @brief Estimates the number of shots required to check assertions.
+ *
+ * For a candidate number of shots, the outcomes of each trial are sampled
+ * from the expected distribution under noise and checked against the
+ * assertion. The smallest candidate for which enough trials accept the
+ * assertion is searched by repeatedly doubling the candidate and then
+ * bisecting the last interval. Candidates are multiples of five samples per
+ * outcome.
+ *
+ * Estimates are cached, so that repeated estimations of the same assertion
+ * under the same expected success probability are free.
+ */
+class ShotEstimator {
+public:
+  /**
+   * @brief Estimate the number of shots required to check an assertion.
+   * @param assertion The assertion as found in compiled programs, consisting
+   * of the variables in parentheses followed by `{superposition}`, `{zero}`,
+   * or the list of expected amplitudes in braces.
+   * @param expectedSuccessProbability The expected success probability of the
+   * program.
+   * @param settings The settings of the estimation.
+   * @return The estimated number of shots.
+   * @throws std::invalid_argument If the assertion cannot be parsed.
+   * @throws std::runtime_error If the accuracy cannot be reached with
+   * `MAX_ESTIMATED_SHOTS` shots.
+   */
+  size_t estimate(const std::string& assertion,
+                  double expectedSuccessProbability,
+                  const ShotEstimationSettings& settings = {});
+
+  /**
+   * @brief Discard all cached estimates.
+   */
+  void clearCache();
+
+  /**
+   * @brief Get the number of cached estimates.
+   * @return The number of cached estimates.
+   */
+  [[nodiscard]] size_t getCacheSize();
+
+private:
+  /**
+   * @brief Identifies an estimate by the checked assertion, its number of
+   * variables, the expected success probability, and the settings except for
+   * the number of threads.
+   */
+  using CacheKey =
+      std::tuple<std::string, size_t, double, double, size_t, double, uint64_t>;
+
+  /**
+   * @brief Guards the cache, so that estimations can run concurrently.
+   */
+  std::mutex mutex;
+
+  /**
+   * @brief The cached estimates.
+   */
+  std::map<CacheKey, size_t> cache;
+};
+
+} // namespace mqt::debugger
@@ -13,76 +13,199 @@
 #include "AssertionParsing.hpp"
 #include "CodePreprocessing.hpp"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
 namespace mqt::debugger {
 
 /**
- * @brief Define a general commutation rule.
+ * @brief The possible results of a commutation check.
  *
- * @param name The name of the commutation rule.
- * @param expression The expression that performs the check.
+ * Can be either `Commutes`, `DoesNotCommute`, or `Unknown`.
  */
-#define COMMUTATION_RULE_GENERAL(name, expression)                             \
-  COMMUTATION_RULE_TEMPLATE(Assertion, name, expression)
+enum class CommutationResult : uint8_t {
+  /**
+   * @brief Indicates that the instructions commute with certainty.
+   */
+  Commutes,
+  /**
+   * @brief Indicates that the instructions do not commute with certainty.
+   */
+  DoesNotCommute,
+  /**
+   * @brief Indicates that it cannot be said with certainty whether the
+   * instructions commute or not.
+   */
+  Unknown,
+};
 
 /**
- * @brief Define a commutation rule for entanglement assertions.
- *
- * @param name The name of the commutation rule.
- * @param expression The expression that performs the check.
+ * @brief The number of different assertion types.
  */
-#define COMMUTATION_RULE_ENT(name, expression)                                 \
-  COMMUTATION_RULE_TEMPLATE(EntanglementAssertion, name, expression)
+constexpr size_t ASSERTION_TYPE_COUNT = 4;
 
 /**
- * @brief Define a commutation rule for superposition assertions.
- *
- * @param name The name of the commutation rule.
- * @param expression The expression that performs the check.
+ * @brief The kinds of gates that are distinguished by the commutation rules.
  */
-#define COMMUTATION_RULE_SUP(name, expression)                                 \
-  COMMUTATION_RULE_TEMPLATE(SuperpositionAssertion, name, expression)
+enum class GateKind : uint8_t {
+  /**
+   * @brief A barrier instruction.
+   */
+  Barrier,
+  /**
+   * @brief One of the Pauli gates `x`, `y`, and `z`.
+   */
+  Pauli,
+  /**
+   * @brief One of the phase gates `s`, `t`, `sdg`, and `tdg`.
+   */
+  Phase,
+  /**
+   * @brief Any other gate.
+   */
+  Other,
+};
+
+/**
+ * @brief The number of different gate kinds.
+ */
+constexpr size_t GATE_KIND_COUNT = 4;
+
+/**
+ * @brief Get the kind of a gate from its name.
+ * @param name The name of the gate.
+ * @return The kind of the gate.
+ */
+constexpr GateKind getGateKind(std::string_view name) {
+  if (name == "barrier") {
+    return GateKind::Barrier;
+  }
+  if (name == "x" || name == "y" || name == "z") {
+    return GateKind::Pauli;
+  }
+  if (name == "s" || name == "t" || name == "sdg" || name == "tdg") {
+    return GateKind::Phase;
+  }
+  return GateKind::Other;
+}
 
 /**
- * @brief Define a template for commutation rules.
+ * @brief The commutation rules between gates and the assertions whose targets
+ * they act on, indexed by gate kind and assertion type.
  *
- * @param type The type of assertion to check.
- * @param name The name of the commutation rule.
- * @param expression The expression that performs the check.
+ * `Unknown` entries are decided by the number of targets of the gate.
  */
-#define COMMUTATION_RULE_TEMPLATE(type, name, expression)                      \
-  const auto name = [](const type* assertion,                                  \
-                       const std::string& instructionName,                     \
-                       const std::vector<std::string>& arguments) {            \
-    (void)assertion;                                                           \
-    (void)instructionName;                                                     \
-    (void)arguments;                                                           \
-    return expression;                                                         \
+constexpr std::array<std::array<CommutationResult, ASSERTION_TYPE_COUNT>,
+                     GATE_KIND_COUNT>
+    COMMUTATION_RULES = {{
+        // Barrier instructions will not remove or create entanglement or
+        // superposition.
+        {CommutationResult::Commutes, CommutationResult::Commutes,
+         CommutationResult::Commutes, CommutationResult::Commutes},
+        // Pauli gates will not remove or create superposition.
+        {CommutationResult::Unknown, CommutationResult::Commutes,
+         CommutationResult::DoesNotCommute, CommutationResult::DoesNotCommute},
+        // `S` and `T` gates will not remove or create superposition.
+        {CommutationResult::Unknown, CommutationResult::Commutes,
+         CommutationResult::DoesNotCommute, CommutationResult::DoesNotCommute},
+        // Equality assertions are not commutative with dependent operations,
+        // as any dependent operation will (likely) change the state of the
+        // qubits.
+        {CommutationResult::Unknown, CommutationResult::DoesNotCommute,
+         CommutationResult::DoesNotCommute, CommutationResult::DoesNotCommute},
+    }};
+
+/**
+ * @brief Check if a gate commutes with an assertion whose targets it acts on.
+ * @param kind The kind of the gate.
+ * @param targetCount The number of targets of the gate.
+ * @param type The type of the assertion.
+ * @return True if the gate commutes with the assertion, false otherwise.
+ */
+constexpr bool doesGateCommute(GateKind kind, size_t targetCount,
+                               AssertionType type) {
+  const auto result =
+      COMMUTATION_RULES[static_cast<size_t>(kind)][static_cast<size_t>(type)];
+  if (result != CommutationResult::Unknown) {
+    return result == CommutationResult::Commutes;
   }
+  // 1-qubit gates will not remove or create entanglement.
+  return type == AssertionType::Entanglement && targetCount < 2;
+}
 
 /**
- * @brief The possible results of a commutation check.
+ * @brief The ways in which an instruction can commute with assertions.
+ */
+enum class CommutationKind : uint8_t {
+  /**
+   * @brief The instruction commutes with all assertions.
+   */
+  Always,
+  /**
+   * @brief The instruction commutes with no assertion.
+   */
+  Never,
+  /**
+   * @brief The instruction declares a register and commutes with all
+   * assertions that do not target it.
+   */
+  Declaration,
+  /**
+   * @brief The instruction commutes with the assertions of the types given by
+   * `CommutationInfo::commutes`, regardless of their targets.
+   */
+  Untargeted,
+  /**
+   * @brief The instruction commutes with all assertions that do not share a
+   * target with it, and with the assertions of the types given by
+   * `CommutationInfo::commutes` otherwise.
+   */
+  Targeted,
+};
+
+/**
+ * @brief Describes which assertions an instruction commutes with.
  *
- * Can be either `Commutes`, `DoesNotCommute`, or `Unknown`.
+ * This is computed once per instruction, so that commutation checks do not
+ * have to parse the instruction again.
  */
-enum class CommutationResult : uint8_t {
+struct CommutationInfo {
   /**
-   * @brief Indicates that the instructions commute with certainty.
+   * @brief The way in which the instruction commutes with assertions.
    */
-  Commutes,
+  CommutationKind kind;
   /**
-   * @brief Indicates that the instructions do not commute with certainty.
+   * @brief Whether the instruction commutes with assertions of each type,
+   * indexed by the assertion type.
    */
-  DoesNotCommute,
+  std::array<bool, ASSERTION_TYPE_COUNT> commutes;
   /**
-   * @brief Indicates that it cannot be said with certainty whether the
-   * instructions commute or not.
+   * @brief The name of the declared register for variable declarations.
    */
-  Unknown,
+  std::string declaredRegister;
 };
 
+/**
+ * @brief Determine which assertions an instruction commutes with.
+ * @param instruction The instruction to analyze.
+ * @return The commutation information of the instruction.
+ */
+CommutationInfo getCommutationInfo(const Instruction& instruction);
+
+/**
+ * @brief Check if an assertion commutes with an instruction.
+ * @param assertion The assertion to check.
+ * @param instruction The instruction to check.
+ * @param info The commutation information of the instruction.
+ * @return True if the assertion commutes with the instruction, false otherwise.
+ */
+bool doesCommute(const Assertion& assertion, const Instruction& instruction,
+                 const CommutationInfo& info);
+
 /**
  * @brief Check if an assertion commutes with an instruction.
  * @param assertion The assertion to check.
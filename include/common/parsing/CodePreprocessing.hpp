@@ -274,7 +274,7 @@ std::vector<Instruction> preprocessCode(const std::string& code,
 std::vector<Instruction>
 preprocessCode(const std::string& code, size_t startIndex,
                size_t initialCodeOffset,
-               const std::vector<std::string>& functionNames,
+               const std::set<std::string>& functionNames,
                std::map<std::string, size_t>& definedRegisters,
                const std::vector<std::string>& shadowedRegisters,
                std::string& processedCode);
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace mqt::debugger {
@@ -27,6 +28,14 @@ namespace mqt::debugger {
  */
 std::string trim(const std::string& str);
 
+/**
+ * @brief Removes leading and trailing whitespace from a string without
+ * copying it.
+ * @param str The string to trim.
+ * @return A view of the trimmed part of the string.
+ */
+std::string_view trimView(std::string_view str);
+
 /**
  * @brief Splits a string into a vector of strings based on a delimiter.
  * @param text The text to split.
@@ -20,14 +20,26 @@ from .pydebugger import (
     ErrorCauseType,
     LoadResult,
     LoadResultStatus,
+    ProfileEntry,
+    ProfilePhase,
     Result,
+    ShotEstimator,
+    SimulationBackend,
     SimulationState,
+    StateDelta,
     Statevector,
     Variable,
     VariableType,
     VariableValue,
+    check_assertion_result,
+    check_results,
+    compile_slice_operations,
     create_ddsim_simulation_state,
     destroy_ddsim_simulation_state,
+    get_dense_memory_usage,
+    load_result_counts,
+    set_dense_memory_budget,
+    set_fast_run,
 )
 
 __all__ = [
@@ -38,15 +50,27 @@ __all__ = [
     "ErrorCauseType",
     "LoadResult",
     "LoadResultStatus",
+    "ProfileEntry",
+    "ProfilePhase",
     "Result",
+    "ShotEstimator",
+    "SimulationBackend",
     "SimulationState",
+    "StateDelta",
     "Statevector",
     "Variable",
     "VariableType",
     "VariableValue",
     "__version__",
     "check",
+    "check_assertion_result",
+    "check_results",
+    "compile_slice_operations",
     "create_ddsim_simulation_state",
     "dap",
     "destroy_ddsim_simulation_state",
+    "get_dense_memory_usage",
+    "load_result_counts",
+    "set_dense_memory_budget",
+    "set_fast_run",
 ]
@@ -10,13 +10,13 @@
 
 from __future__ import annotations
 
-import json
 import math
 import operator
 from dataclasses import dataclass
-from pathlib import Path
 from typing import TYPE_CHECKING
 
+import mqt.debugger as dbg
+
 missing_optionals: list[str] = []
 try:
     from scipy.stats import chi2
@@ -26,6 +26,7 @@ except ImportError:
 if TYPE_CHECKING:
     from collections.abc import Sequence
     from io import TextIOWrapper
+    from pathlib import Path
 
     from .calibration import Calibration
 
@@ -52,27 +53,8 @@ class Result:
         Returns:
             Result: The result of the quantum program.
         """
-        if isinstance(path, Path):
-            with path.open("r") as f:
-                data = json.load(f)
-        else:
-            data = json.load(path)
-        filled_distribution = {key: [0 for _ in range(2 ** len(key))] for key in distributions}
-        for entry in data:
-            indices = dict.fromkeys(distributions, 0)
-            for key in entry:
-                val = int(entry[key])
-                if val == 0:
-                    continue
-                parent_distribution_list = [x for x in distributions if key in x]
-                if not parent_distribution_list:
-                    continue
-                parent_distribution = parent_distribution_list[0]
-                index = parent_distribution.index(key)
-                indices[parent_distribution] += 2**index
-            for key, value in indices.items():
-                filled_distribution[key][value] += 1
-        return Result(len(data), filled_distribution)
+        num_samples, counts = dbg.load_result_counts(path, distributions)
+        return Result(num_samples, dict(zip(distributions, counts, strict=True)))
 
 
 def distribution_equal_under_noise(
@@ -354,23 +336,20 @@ def check_result(
         bool: True if all assertions are satisfied, False otherwise.
     """
     lines = compiled_code.splitlines()
-    distributions: list[tuple[str, ...]] = []
     assertions: dict[tuple[str, ...], str] = {}
     for line in lines:
         if not line.startswith("// ASSERT:"):
             break
         var_list = tuple(line.split("(")[1].split(")")[0].split(","))
-        distributions.append(var_list)
         assertions[var_list] = f"{{{line.split('{')[1]}"
-    result = Result.load(result_path, distributions)
-
     expected_success_probability = calibration.get_expected_success_probability(compiled_code)
+    # The results are streamed, binned, and checked natively.
+    results = dbg.check_results(
+        result_path, list(assertions), list(assertions.values()), expected_success_probability, p_value
+    )
 
     ok = True
-    for key, value in assertions.items():
-        res = check_assertion(
-            value, result.distribution[key], result.num_samples, expected_success_probability, p_value=p_value
-        )
+    for key, res in zip(assertions, results, strict=True):
         if not silent:
             if not res:
                 print(f"{COLOR_RED}Assertion {key} failed.{COLOR_RESET}")  # noqa: T201
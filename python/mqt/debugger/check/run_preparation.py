@@ -10,14 +10,12 @@
 
 from __future__ import annotations
 
-import random
+import functools
 from pathlib import Path
 from typing import TYPE_CHECKING
 
 import mqt.debugger as dbg
 
-from . import result_checker
-
 if TYPE_CHECKING:
     from .calibration import Calibration
 
@@ -49,21 +47,11 @@ def start_compilation(code: Path, output_dir: Path) -> None:
         if load_result.status != dbg.LoadResultStatus.OK:
             message = load_result.message or "Error loading code"
             raise RuntimeError(message)
-        i = 0
-        compiled_any = False
-        while True:
-            i += 1
-            settings = dbg.CompilationSettings(
-                opt=0,
-                slice_index=i - 1,
-            )
-            compiled = state.compile(settings)
-            if not compiled:
-                break
-            compiled_any = True
+        slices = state.compile_slices(dbg.CompilationSettings(opt=0))
+        for i, compiled in enumerate(slices, start=1):
             with (output_dir / f"slice_{i}.qasm").open("w") as f:
                 f.write(compiled)
-        if not compiled_any:
+        if not slices:
             msg = "No compiled slices produced; check input code for validity."
             raise RuntimeError(msg)
     finally:
@@ -73,25 +61,14 @@ def start_compilation(code: Path, output_dir: Path) -> None:
 # -------------------------
 
 
-def sample_distribution(expected_distribution_under_noise: list[float], num_samples: int) -> list[int]:
-    """Sample from a given distribution.
-
-    Args:
-        expected_distribution_under_noise (list[float]): The expected distribution under noise.
-        num_samples (int): The number of samples to take.
+@functools.cache
+def _get_shot_estimator() -> dbg.ShotEstimator:
+    """Get the estimator shared by all estimations, so that its cache persists between them.
 
     Returns:
-        list[int]: The sampled distribution.
+        dbg.ShotEstimator: The shared estimator.
     """
-    samples: list[int] = [0 for _ in expected_distribution_under_noise]
-    for _ in range(num_samples):
-        rnd = random.random()  # noqa: S311
-        for i, likelihood in enumerate(expected_distribution_under_noise):
-            if rnd < likelihood:
-                samples[i] += 1
-                break
-            rnd -= likelihood
-    return samples
+    return dbg.ShotEstimator()
 
 
 def estimate_required_shots_for_assertion(
@@ -100,60 +77,34 @@ def estimate_required_shots_for_assertion(
     p_value: float = 0.05,
     num_trials: int = 1000,
     accuracy: float = 0.95,
+    seed: int = 0,
 ) -> int:
     """Estimate the required shots for a given assertion.
 
+    The estimation runs natively and its results are cached, so repeated estimations of the same assertion
+    under an unchanged calibration are free.
+
     Args:
         assertion (str): The assertion to estimate the required shots for.
         expected_success_probability (float): The expected success probability.
         p_value (float, optional): The p-value required to accept the assertion. Defaults to 0.05.
         num_trials (int, optional): The number of trials that should be checked. Defaults to 1000.
         accuracy (float, optional): The desired accuracy to decide on a number of shots. Defaults to 0.95.
+        seed (int, optional): The seed for sampling the trials. Defaults to 0.
 
     Returns:
         int: The estimated number of shots required for the assertion.
     """
-    expected_distribution: list[float] = []
-    num_variables = assertion.split("(")[1].split(")", maxsplit=1)[0].count(",") + 1
-    if "{zero}" in assertion:
-        expected_distribution = [0.0] * 2**num_variables
-        expected_distribution[0] = 1.0
-    elif "{superposition}" in assertion:
-        # superposition assertions should detect any superposition, but here we just consider the uniform one.
-        expected_distribution = [1.0 / 2**num_variables] * 2**num_variables
-    else:
-        expected_distribution = [float(x) for x in assertion.split("{")[1].split("}", maxsplit=1)[0].split(",")]
-        norm = sum(expected_distribution)
-        expected_distribution = [x / norm for x in expected_distribution]
-
-    expected_with_noise = [
-        expected_success_probability * x + (1 - expected_success_probability) / len(expected_distribution)
-        for x in expected_distribution
-    ]
-    num_samples = len(expected_distribution) * 5
-    assertion_string = assertion[assertion.index("{") :]
-
-    all_samples = [[0 for _ in expected_distribution] for _ in range(num_trials)]
-    previous_samples = 0
-
-    while True:
-        correct = 0
-        for i in range(num_trials):
-            new_samples = sample_distribution(expected_with_noise, num_samples - previous_samples)
-            all_samples[i] = [a + b for a, b in zip(all_samples[i], new_samples, strict=False)]
-            if result_checker.check_assertion(
-                assertion_string, all_samples[i], num_samples, expected_success_probability, p_value
-            ):
-                correct += 1
-        reported_accuracy = correct / num_trials
-        previous_samples = num_samples
-        if reported_accuracy >= accuracy:
-            return num_samples
-        num_samples += len(expected_distribution) * 5
+    return _get_shot_estimator().estimate(assertion, expected_success_probability, p_value, num_trials, accuracy, seed)
 
 
 def estimate_required_shots(
-    program: str, calibration: Calibration, p_value: float = 0.05, num_trials: int = 1000, accuracy: float = 0.95
+    program: str,
+    calibration: Calibration,
+    p_value: float = 0.05,
+    num_trials: int = 1000,
+    accuracy: float = 0.95,
+    seed: int = 0,
 ) -> int:
     """Estimate the required shots for a given program.
 
@@ -163,6 +114,7 @@ def estimate_required_shots(
         p_value (float, optional): The p-value required to accept an assertion. Defaults to 0.05.
         num_trials (int, optional): The number of trials that should be checked. Defaults to 1000.
         accuracy (float, optional): The desired accuracy to select a number of shots. Defaults to 0.95.
+        seed (int, optional): The seed for sampling the trials. Defaults to 0.
 
     Returns:
         int: The estimated number of shots required for the program.
@@ -170,7 +122,7 @@ def estimate_required_shots(
     expected_success_probability = calibration.get_expected_success_probability(program)
     assertions = extract_assertions_from_code(program)
     required_shots = [
-        estimate_required_shots_for_assertion(a, expected_success_probability, p_value, num_trials, accuracy)
+        estimate_required_shots_for_assertion(a, expected_success_probability, p_value, num_trials, accuracy, seed)
         for a in assertions
     ]
     return max(required_shots)
@@ -182,6 +134,7 @@ def estimate_required_shots_from_path(
     p_value: float = 0.05,
     num_trials: int = 1000,
     accuracy: float = 0.95,
+    seed: int = 0,
 ) -> int:
     """Estimate the required number of shots for a program given by a path to a program file.
 
@@ -191,10 +144,11 @@ def estimate_required_shots_from_path(
         p_value (float, optional): The p-value required to accept an assertion. Defaults to 0.05.
         num_trials (int, optional): The number of trials to check. Defaults to 1000.
         accuracy (float, optional): The desired accuracy to select a number of shots. Defaults to 0.95.
+        seed (int, optional): The seed for sampling the trials. Defaults to 0.
 
     Returns:
         int: The estimated number of shots required for the program.
     """
     compiled_program = Path(compiled_program)
     program = compiled_program.read_text()
-    return estimate_required_shots(program, calibration, p_value, num_trials, accuracy)
+    return estimate_required_shots(program, calibration, p_value, num_trials, accuracy, seed)
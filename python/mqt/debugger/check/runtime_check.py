@@ -57,6 +57,9 @@ def main() -> None:
     sub_checker.add_argument(
         "--accuracy", type=float, help="The desired accuracy to report a sample count.", default=0.95
     )
+    sub_checker.add_argument(
+        "--seed", type=int, help="The seed for sampling the trials. Estimates are reproducible for a seed.", default=0
+    )
 
     args = parser.parse_args()
 
@@ -74,6 +77,6 @@ def main() -> None:
         result_checker.check_result(compiled_code, args.results, calibration_data, p_value=args.p)
     elif args.mode == "shots":
         result = run_preparation.estimate_required_shots_from_path(
-            args.slice, calibration_data, args.p, args.trials, args.accuracy
+            args.slice, calibration_data, args.p, args.trials, args.accuracy, args.seed
         )
         print(f"Estimated required shots: {result}")  # noqa: T201
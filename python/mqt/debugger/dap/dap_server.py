@@ -74,6 +74,10 @@ supported_messages: list[type[Request]] = [
 ]
 
 
+_RUN_POLL_INTERVAL = 0.1
+"""The time in seconds between two checks whether an asynchronous run completed."""
+
+
 def send_message(msg: str, client: socket.socket) -> None:
     """Send a message to the client according to the DAP messaging protocol.
 
@@ -100,6 +104,7 @@ class DAPServer:
     exception_breakpoints: list[str]
     lines_start_at_one: bool
     columns_start_at_one: bool
+    async_run_active: bool
 
     def __init__(self, host: str = "127.0.0.1", port: int = 4711) -> None:
         """Create a new DAP server instance.
@@ -118,6 +123,7 @@ class DAPServer:
         self.source_file = {"name": "", "path": ""}
         self.source_code = ""
         self._prevent_exit = False
+        self.async_run_active = False
 
     def start(self) -> None:
         """Start the DAP server and listen for one connection."""
@@ -151,7 +157,17 @@ class DAPServer:
         message_str = ""
         while True:
             if not message_str or not data_str:
-                data = connection.recv(1024)
+                # While a run is in progress, poll for its completion between
+                # requests, so that the server stays responsive.
+                connection.settimeout(_RUN_POLL_INTERVAL if self.async_run_active else None)
+                try:
+                    data = connection.recv(1024)
+                except TimeoutError:
+                    if not self.simulation_state.is_simulation_running():
+                        self.finish_async_run(connection)
+                    continue
+                finally:
+                    connection.settimeout(None)
                 data_str += data.decode()
             first_end = data_str.find("Content-Length:", 1)
             if first_end != -1:
@@ -167,6 +183,12 @@ class DAPServer:
             if not parts or not data:
                 break
             payload = json.loads(parts[-1])
+            if self.async_run_active and payload.get("command") != "pause":
+                # Any request other than pausing needs the state, so the run
+                # has to complete first.
+                if payload.get("command") in {"disconnect", "terminate"}:
+                    self.simulation_state.pause_simulation()
+                self.finish_async_run(connection)
             result, cmd = self.handle_command(payload)
             result_payload = json.dumps(result)
             send_message(result_payload, connection)
@@ -207,46 +229,31 @@ class DAPServer:
                 )
                 event_payload = json.dumps(e.encode())
                 send_message(event_payload, connection)
-            if isinstance(
-                cmd,
-                (
-                    mqt.debugger.dap.messages.NextDAPMessage,
-                    mqt.debugger.dap.messages.StepBackDAPMessage,
-                    mqt.debugger.dap.messages.StepInDAPMessage,
-                    mqt.debugger.dap.messages.StepOutDAPMessage,
-                    mqt.debugger.dap.messages.ContinueDAPMessage,
-                    mqt.debugger.dap.messages.ReverseContinueDAPMessage,
-                    mqt.debugger.dap.messages.RestartFrameDAPMessage,
-                ),
-            ) or (
+            if (
                 isinstance(
                     cmd,
                     (
-                        mqt.debugger.dap.messages.LaunchDAPMessage,
-                        mqt.debugger.dap.messages.RestartDAPMessage,
+                        mqt.debugger.dap.messages.NextDAPMessage,
+                        mqt.debugger.dap.messages.StepBackDAPMessage,
+                        mqt.debugger.dap.messages.StepInDAPMessage,
+                        mqt.debugger.dap.messages.StepOutDAPMessage,
+                        mqt.debugger.dap.messages.ContinueDAPMessage,
+                        mqt.debugger.dap.messages.ReverseContinueDAPMessage,
+                        mqt.debugger.dap.messages.RestartFrameDAPMessage,
                     ),
                 )
-                and not cmd.stop_on_entry
-            ):
-                event = (
-                    mqt.debugger.dap.messages.StopReason.EXCEPTION
-                    if self.simulation_state.did_assertion_fail()
-                    else mqt.debugger.dap.messages.StopReason.BREAKPOINT_INSTRUCTION
-                    if self.simulation_state.was_breakpoint_hit()
-                    else mqt.debugger.dap.messages.StopReason.STEP
-                )
-                message = (
-                    "An assertion failed"
-                    if self.simulation_state.did_assertion_fail()
-                    else "Stopped at breakpoint"
-                    if self.simulation_state.was_breakpoint_hit()
-                    else "Stopped after step"
+                or (
+                    isinstance(
+                        cmd,
+                        (
+                            mqt.debugger.dap.messages.LaunchDAPMessage,
+                            mqt.debugger.dap.messages.RestartDAPMessage,
+                        ),
+                    )
+                    and not cmd.stop_on_entry
                 )
-                e = mqt.debugger.dap.messages.StoppedDAPEvent(event, message)
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-                if self.simulation_state.did_assertion_fail():
-                    self.handle_assertion_fail(connection)
+            ) and not self.async_run_active:
+                self.send_stopped_event(connection)
             if isinstance(cmd, mqt.debugger.dap.messages.TerminateDAPMessage):
                 e = mqt.debugger.dap.messages.TerminatedDAPEvent()
                 event_payload = json.dumps(e.encode())
@@ -255,6 +262,9 @@ class DAPServer:
                 event_payload = json.dumps(e.encode())
                 send_message(event_payload, connection)
             if isinstance(cmd, mqt.debugger.dap.messages.PauseDAPMessage):
+                if self.async_run_active:
+                    self.simulation_state.wait_for_simulation()
+                    self.async_run_active = False
                 e = mqt.debugger.dap.messages.StoppedDAPEvent(
                     mqt.debugger.dap.messages.StopReason.PAUSE, "Stopped after pause"
                 )
@@ -272,7 +282,45 @@ class DAPServer:
                     pass
                 finally:
                     self.pending_highlights = []
-            self.regular_checks(connection)
+            if not self.async_run_active:
+                self.regular_checks(connection)
+
+    def send_stopped_event(self, connection: socket.socket) -> None:
+        """Send the event that reports why the execution stopped.
+
+        Args:
+            connection: The client socket.
+        """
+        event = (
+            mqt.debugger.dap.messages.StopReason.EXCEPTION
+            if self.simulation_state.did_assertion_fail()
+            else mqt.debugger.dap.messages.StopReason.BREAKPOINT_INSTRUCTION
+            if self.simulation_state.was_breakpoint_hit()
+            else mqt.debugger.dap.messages.StopReason.STEP
+        )
+        message = (
+            "An assertion failed"
+            if self.simulation_state.did_assertion_fail()
+            else "Stopped at breakpoint"
+            if self.simulation_state.was_breakpoint_hit()
+            else "Stopped after step"
+        )
+        e = mqt.debugger.dap.messages.StoppedDAPEvent(event, message)
+        event_payload = json.dumps(e.encode())
+        send_message(event_payload, connection)
+        if self.simulation_state.did_assertion_fail():
+            self.handle_assertion_fail(connection)
+
+    def finish_async_run(self, connection: socket.socket) -> None:
+        """Wait for the asynchronous run to complete and report where it stopped.
+
+        Args:
+            connection: The client socket.
+        """
+        self.simulation_state.wait_for_simulation()
+        self.async_run_active = False
+        self.send_stopped_event(connection)
+        self.regular_checks(connection)
 
     def regular_checks(self, connection: socket.socket) -> None:
         """Perform regular checks and send events to the client if necessary.
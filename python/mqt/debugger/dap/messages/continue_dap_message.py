@@ -43,7 +43,8 @@ class ContinueDAPMessage(DAPMessage):
         Returns:
             dict[str, Any]: The response to the request.
         """
-        server.simulation_state.run_simulation()
+        server.simulation_state.run_simulation_async()
+        server.async_run_active = True
         d = super().handle(server)
         d["body"] = {}
         return d
@@ -151,12 +151,14 @@ def _get_quantum_state_variables(server: DAPServer, start: int, count: int, filt
     start_index = max(0, min(start, total_states))
     requested_count = total_states - start_index if count == 0 else count
     end_index = min(start_index + requested_count, total_states)
-    for i in range(start_index, end_index):
+    # Only the requested page is retrieved, so memory is bounded by its size.
+    page = server.simulation_state.get_state_vector_range(start_index, end_index - start_index)
+    for i, amplitude in enumerate(page.amplitudes, start=start_index):
         bitstring = format(i, f"0{num_q}b")
         result.append({
             "name": f"|{bitstring}>",
             "evaluateName": f"|{bitstring}>",
-            "value": str(server.simulation_state.get_amplitude_bitstring(bitstring)),
+            "value": str(amplitude),
             "type": "complex",
             "variablesReference": 0,
         })
@@ -7,8 +7,11 @@
 # Licensed under the MIT License
 
 import enum
-from collections.abc import Sequence
-from typing import overload
+import os
+from collections.abc import Callable, Sequence
+from typing import IO, Annotated, overload
+
+from numpy.typing import ArrayLike
 
 class ErrorCauseType(enum.Enum):
     """The type of a potential error cause."""
@@ -89,6 +92,23 @@ class Diagnostics:
             A list of instruction indices that are data dependencies of the given instruction.
         """
 
+    def get_data_dependencies_batch(self, instructions: list[int], include_callers: bool = False) -> list[list[int]]:
+        """Extract all data dependencies for several instructions at once.
+
+        The dependencies of each instruction are determined in the same way as by
+        `get_data_dependencies`.
+
+        This method can be performed without running the program, as it is a static
+        analysis method.
+
+        Args:
+            instructions: The instructions to extract the data dependencies for.
+            include_callers: True, if the data dependencies should include all possible callers of the containing custom gates. Defaults to False.
+
+        Returns:
+            For each given instruction, a list of instruction indices that are its data dependencies.
+        """
+
     def get_interactions(self, before_instruction: int, qubit: int) -> list[int]:
         """Extract all qubits that interact with a given qubit up to a specific instruction.
 
@@ -109,6 +129,24 @@ class Diagnostics:
             A list of qubit indices that interact with the given qubit up to the target instruction.
         """
 
+    def get_interaction_components(self, before_instruction: int) -> list[int]:
+        """Extract the groups of interacting qubits up to a specific instruction for all qubits at once.
+
+        Each qubit is assigned the smallest qubit index of the group of qubits it
+        interacts with, so two qubits interact if and only if they are assigned the
+        same value. The interactions are determined in the same way as by
+        `get_interactions`.
+
+        This method can be performed without running the program, as it is a static
+        analysis method.
+
+        Args:
+            before_instruction: The instruction to extract the interactions up to (excluding).
+
+        Returns:
+            For each qubit, the smallest qubit index of the group of qubits it interacts with.
+        """
+
     def get_zero_control_instructions(self) -> list[int]:
         """Extract all controlled gates that have been marked as only having controls with value zero.
 
@@ -323,6 +361,14 @@ class Statevector:
 
     @amplitudes.setter
     def amplitudes(self, arg: Sequence[Complex], /) -> None: ...
+    @property
+    def array(self) -> Annotated[ArrayLike, dict(dtype="complex128", shape=(None,), order="C", device="cpu")]:
+        """The amplitudes of the state vector as an array of complex numbers.
+
+        The array shares its memory with the state vector, so that it can be passed to
+        NumPy without copying, e.g., using `numpy.asarray`. It stays valid as long as
+        the amplitudes of the state vector are not replaced.
+        """
 
 class CompilationSettings:
     """The settings that should be used to compile an assertion program."""
@@ -348,6 +394,145 @@ class CompilationSettings:
     @slice_index.setter
     def slice_index(self, arg: int, /) -> None: ...
 
+class ProfilePhase(enum.Enum):
+    """A phase of executing an instruction."""
+
+    ProfileSimulation = 0
+    """Applying the operation of an instruction to the state."""
+
+    ProfileAssertion = 1
+    """Evaluating an assertion."""
+
+    ProfileDiagnostics = 2
+    """Updating the diagnostics after executing an instruction."""
+
+    ProfileDensification = 3
+    """Writing the state into a dense state vector."""
+
+    ProfileGarbageCollection = 4
+    """Collecting unused nodes of the decision diagram package."""
+
+class ProfileEntry:
+    """The profiling counters of one phase of one instruction.
+
+    All counters are summed over all calls of the phase while the instruction was executed.
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def instruction(self) -> int:
+        """The instruction the counters belong to."""
+
+    @instruction.setter
+    def instruction(self, arg: int, /) -> None: ...
+    @property
+    def phase(self) -> ProfilePhase:
+        """The phase the counters belong to."""
+
+    @phase.setter
+    def phase(self, arg: ProfilePhase, /) -> None: ...
+    @property
+    def calls(self) -> int:
+        """The number of times the phase was entered."""
+
+    @calls.setter
+    def calls(self, arg: int, /) -> None: ...
+    @property
+    def seconds(self) -> float:
+        """The wall time spent in the phase in seconds."""
+
+    @seconds.setter
+    def seconds(self, arg: float, /) -> None: ...
+    @property
+    def nodes_before(self) -> int:
+        """The number of nodes of the state's decision diagram before the phase."""
+
+    @nodes_before.setter
+    def nodes_before(self, arg: int, /) -> None: ...
+    @property
+    def nodes_after(self) -> int:
+        """The number of nodes of the state's decision diagram after the phase."""
+
+    @nodes_after.setter
+    def nodes_after(self, arg: int, /) -> None: ...
+    @property
+    def dense_bytes(self) -> int:
+        """The number of bytes of dense state vectors the phase wrote."""
+
+    @dense_bytes.setter
+    def dense_bytes(self, arg: int, /) -> None: ...
+
+class StateDelta:
+    """The changes of a simulation state since an earlier version."""
+
+    def __init__(self) -> None: ...
+    @property
+    def version(self) -> int:
+        """The version of the reported state, to be passed to the next call."""
+
+    @version.setter
+    def version(self, arg: int, /) -> None: ...
+    @property
+    def complete(self) -> bool:
+        """True if all classical variables are reported because the given version was not the one returned by the previous call."""
+
+    @complete.setter
+    def complete(self, arg: bool, /) -> None: ...
+    @property
+    def current_instruction(self) -> int:
+        """The instruction that is executed next."""
+
+    @current_instruction.setter
+    def current_instruction(self, arg: int, /) -> None: ...
+    @property
+    def finished(self) -> bool:
+        """True if the simulation has finished."""
+
+    @finished.setter
+    def finished(self, arg: bool, /) -> None: ...
+    @property
+    def assertion_failed(self) -> bool:
+        """True if the last step stopped at a failing assertion."""
+
+    @assertion_failed.setter
+    def assertion_failed(self, arg: bool, /) -> None: ...
+    @property
+    def breakpoint_hit(self) -> bool:
+        """True if the last step stopped at a breakpoint."""
+
+    @breakpoint_hit.setter
+    def breakpoint_hit(self, arg: bool, /) -> None: ...
+    @property
+    def changed_variables(self) -> list[Variable]:
+        """The classical variables whose value changed."""
+
+    @changed_variables.setter
+    def changed_variables(self, arg: list[Variable], /) -> None: ...
+    @property
+    def stack_trace(self) -> list[int]:
+        """The full stack trace of the simulation."""
+
+    @stack_trace.setter
+    def stack_trace(self, arg: list[int], /) -> None: ...
+    @property
+    def changed_amplitudes(self) -> list[tuple[int, Complex]]:
+        """The indices and values of the changed amplitudes, in ascending order of their indices."""
+
+    @changed_amplitudes.setter
+    def changed_amplitudes(self, arg: list[tuple[int, Complex]], /) -> None: ...
+    @property
+    def amplitudes_complete(self) -> bool:
+        """True if amplitudes are reported relative to zero, because the previous call did not report or keep amplitudes."""
+
+    @amplitudes_complete.setter
+    def amplitudes_complete(self, arg: bool, /) -> None: ...
+    @property
+    def amplitudes_truncated(self) -> bool:
+        """True if not all changed amplitudes could be reported."""
+
+    @amplitudes_truncated.setter
+    def amplitudes_truncated(self, arg: bool, /) -> None: ...
+
 class SimulationState:
     """Represents the state of a quantum simulation for debugging.
 
@@ -370,6 +555,23 @@ class SimulationState:
             LoadResult: The result of the load operation.
         """
 
+    def reload_code(self, code: str) -> LoadResult:
+        """Replaces the loaded code by an edited version of it.
+
+        In contrast to `load_code`, the simulation is not restarted if the edit does not affect the instructions that
+        have already been executed. Instead, it continues from the last reproducible point before the first edited
+        instruction. Breakpoints are kept.
+
+        If the new code cannot be loaded, the previously loaded code and the current simulation state are kept. If no
+        code has been loaded yet, this behaves like `load_code`.
+
+        Args:
+            code: The edited code to load.
+
+        Returns:
+            LoadResult: The result of the load operation.
+        """
+
     def step_forward(self) -> None:
         """Steps the simulation forward by one instruction."""
 
@@ -423,6 +625,40 @@ class SimulationState:
         methods, in particular, may still execute the next instruction.
         """
 
+    def run_simulation_async(self, callback: Callable[[int, int], None] | None = None) -> None:
+        """Runs the simulation on a worker thread until it finishes, an assertion fails, or a breakpoint is hit.
+
+        The method returns as soon as the run was started. Until the run has completed, the state must only be accessed through `pause_simulation`, `is_simulation_running`, and `wait_for_simulation`. Pausing the simulation cancels the run after the current instruction.
+
+        Args:
+            callback: A callable that receives the reached instruction and the number of failed assertions at intervals and once more when the run ends. It is called on the worker thread.
+        """
+
+    def run_all_async(self, callback: Callable[[int, int], None] | None = None) -> None:
+        """Runs the simulation on a worker thread until it finishes, even if assertions fail.
+
+        This behaves like `run_simulation_async`, except that the run continues after failed assertions and breakpoints. Pausing the simulation ends the whole run.
+
+        Args:
+            callback: A callable that receives the reached instruction and the number of failed assertions at intervals and once more when the run ends. It is called on the worker thread.
+        """
+
+    def is_simulation_running(self) -> bool:
+        """Checks whether an asynchronous run is still in progress.
+
+        Returns:
+            True, if an asynchronous run is in progress.
+        """
+
+    def wait_for_simulation(self) -> int:
+        """Waits for the last asynchronous run to complete.
+
+        Once this method returned, the state may be accessed again.
+
+        Returns:
+            The number of assertions that failed during the run.
+        """
+
     def can_step_forward(self) -> bool:
         """Indicates whether the simulation can step forward.
 
@@ -608,6 +844,20 @@ class SimulationState:
             The full state vector of the current simulation state.
         """
 
+    def get_state_vector_range(self, start: int, count: int) -> Statevector:
+        """Gets a contiguous range of amplitudes of the full state vector of the simulation at the current time.
+
+        This allows large state vectors to be read page by page, so that memory only
+        has to be allocated for the requested range.
+
+        Args:
+            start: The index of the first amplitude to retrieve.
+            count: The number of amplitudes to retrieve.
+
+        Returns:
+            A state vector holding the `count` requested amplitudes, starting with the amplitude at index `start`.
+        """
+
     def get_state_vector_sub(self, qubits: Sequence[int]) -> Statevector:
         """Gets a sub-state of the state vector of the simulation at the current time.
 
@@ -621,6 +871,67 @@ class SimulationState:
             The sub-state vector of the current simulation state.
         """
 
+    def get_state_vector_full_array(
+        self,
+        out: Annotated[ArrayLike, dict(dtype="complex128", shape=(None,), order="C", device="cpu")] | None = None,
+    ) -> Annotated[ArrayLike, dict(dtype="complex128", shape=(None,), order="C", device="cpu")]:
+        """Gets the full state vector of the simulation at the current time as an array.
+
+        The amplitudes are written directly into the memory of the returned array,
+        which supports the buffer protocol, so that no Python objects are created for
+        the individual amplitudes.
+
+        Args:
+            out: An optional contiguous array of `2^n` complex numbers to write the amplitudes into. If not given, a new array is allocated.
+
+        Returns:
+            The array containing the amplitudes of the full state vector.
+        """
+
+    def get_state_vector_sub_array(
+        self,
+        qubits: Sequence[int],
+        out: Annotated[ArrayLike, dict(dtype="complex128", shape=(None,), order="C", device="cpu")] | None = None,
+    ) -> Annotated[ArrayLike, dict(dtype="complex128", shape=(None,), order="C", device="cpu")]:
+        """Gets a sub-state of the state vector of the simulation at the current time as an array.
+
+        The amplitudes are written directly into the memory of the returned array,
+        which supports the buffer protocol, so that no Python objects are created for
+        the individual amplitudes.
+
+        Args:
+            qubits: The qubits to include in the sub-state.
+            out: An optional contiguous array of `2^k` complex numbers to write the amplitudes into, where `k` is the number of qubits. If not given, a new array is allocated.
+
+        Returns:
+            The array containing the amplitudes of the sub-state vector.
+        """
+
+    def get_non_zero_amplitudes(self, threshold: float, max_count: int) -> list[tuple[int, Complex]]:
+        """Gets the amplitudes of the full state vector whose magnitude exceeds a threshold.
+
+        Only the parts of the state that contain such amplitudes are visited, so the
+        cost depends on the number of results rather than on the size of the state
+        vector.
+
+        Args:
+            threshold: The magnitude an amplitude has to exceed to be returned. Use 0 to get all non-zero amplitudes.
+            max_count: The maximum number of amplitudes to return.
+
+        Returns:
+            The indices and values of the amplitudes, in ascending order of their indices.
+        """
+
+    def get_top_k_amplitudes(self, k: int) -> list[tuple[int, Complex]]:
+        """Gets the non-zero amplitudes of the full state vector with the largest magnitudes.
+
+        Args:
+            k: The maximum number of amplitudes to return.
+
+        Returns:
+            The indices and values of the amplitudes, in descending order of their magnitudes.
+        """
+
     def set_breakpoint(self, desired_position: int) -> int:
         """Sets a breakpoint at the desired position in the code.
 
@@ -677,8 +988,99 @@ class SimulationState:
             The compiled code.
         """
 
-def create_ddsim_simulation_state() -> SimulationState:
-    """Creates a new `SimulationState` instance using the DD backend for simulation and the OpenQASM language as input format.
+    def compile_slices(self, settings: CompilationSettings) -> list[str]:
+        """Compiles all slices of the given code in a single pass.
+
+        The assertions are partitioned into slices only once, which is considerably
+        faster than calling `compile` for each slice index.
+
+        Args:
+            settings: The settings to use for the compilation. The slice index is ignored.
+
+        Returns:
+            The compiled code of each slice, in the order of their slice indices.
+        """
+
+    def set_seed(self, seed: int) -> None:
+        """Sets the seed of the random number generator used for measurements.
+
+        Args:
+            seed: The seed to use.
+        """
+
+    def sample_shots(self, shots: int, seed: int) -> dict[int, int]:
+        """Samples the classical outcomes of multiple executions of the program.
+
+        The program is simulated up to each measurement only once. The shots reaching
+        a measurement are then split between its outcomes according to their
+        probabilities, and each branch continues from the post-measurement state.
+
+        Args:
+            shots: The number of executions to sample.
+            seed: The seed of the random number generator used for sampling.
+
+        Returns:
+            A mapping from each sampled outcome to its number of shots. Bit i of an
+            outcome holds the value of classical bit i.
+        """
+
+    def set_profiling_enabled(self, enabled: bool) -> None:
+        """Enables or disables the collection of profiling counters.
+
+        While profiling is disabled, no counters are collected and executing
+        instructions has no measurable overhead. Enabling profiling discards all
+        previously collected counters.
+
+        Args:
+            enabled: True to enable profiling, false to disable it.
+        """
+
+    def get_profile(self) -> list[ProfileEntry]:
+        """Gets the profiling counters collected since profiling was enabled.
+
+        Returns:
+            One entry for each phase of each instruction that was entered at least once, sorted by instruction and then by phase.
+        """
+
+    def get_state_delta(
+        self, since_version: int = 0, max_amplitudes: int = 0, amplitude_tolerance: float = 1e-09
+    ) -> StateDelta:
+        """Gets the changes of the simulation state since an earlier call.
+
+        Each call returns a new version that identifies the reported state. Passing this version to the next call only reports the classical variables and amplitudes that changed in between. For any other version, such as 0, all classical variables and all amplitudes with a magnitude above the tolerance are reported. The current instruction, the stack trace, and whether an assertion or breakpoint stopped the simulation are always reported.
+
+        This allows front ends to refresh their view of the state with a single call after each stop.
+
+        Args:
+            since_version: The version returned by the previous call, or 0.
+            max_amplitudes: The maximum number of changed amplitudes to report. No amplitudes are reported if this is 0.
+            amplitude_tolerance: The minimum magnitude of the change of an amplitude to be reported.
+
+        Returns:
+            The changes of the simulation state.
+        """
+
+class SimulationBackend(enum.Enum):
+    """The backends that can store the state of a DD-based `SimulationState`."""
+
+    DecisionDiagram = 0
+    """The state is stored as a decision diagram."""
+
+    Dense = 1
+    """The state is stored as a flat array of amplitudes."""
+
+def create_ddsim_simulation_state(
+    source: SimulationState | None = None, backend: SimulationBackend = SimulationBackend.DecisionDiagram
+) -> SimulationState:
+    """Creates a new `SimulationState` instance using the DD simulator and the OpenQASM language as input format.
+
+    If a source state is given, the new state shares the program loaded into it instead of parsing the code again. Both states can then be executed independently.
+
+    The backend determines how the quantum state is stored. The dense backend keeps a flat array of amplitudes, which is faster for small, unstructured circuits, and supports programs with up to 28 qubits.
+
+    Args:
+        source: A DD-based simulation state whose loaded program should be shared, or `None` to create an empty state.
+        backend: The backend that stores the quantum state.
 
     Returns:
         The created simulation state.
@@ -690,3 +1092,153 @@ def destroy_ddsim_simulation_state(state: SimulationState) -> None:
     Args:
         state: The simulation state to delete.
     """
+
+def set_dense_memory_budget(state: SimulationState, budget: int) -> None:
+    """Set the number of bytes that dense buffers of amplitudes of a DD-based `SimulationState` may occupy at the same time.
+
+    Operations that would exceed the budget use an algorithm on the decision diagram instead where one exists, and fail otherwise.
+
+    Args:
+        state: The simulation state to configure.
+        budget: The budget in bytes.
+    """
+
+def get_dense_memory_usage(state: SimulationState) -> tuple[int, int]:
+    """Get the memory occupied by the dense buffers of amplitudes of a DD-based `SimulationState`.
+
+    Args:
+        state: The simulation state to query.
+
+    Returns:
+        The number of bytes occupied right now, including cached buffers, and the largest number of bytes that was occupied at the same time.
+    """
+
+def set_fast_run(state: SimulationState, enabled: bool) -> None:
+    """Enable or disable fast-run mode for a DD-based `SimulationState`.
+
+    In fast-run mode, running the simulation applies consecutive unitary gates without breakpoints as a single chain of products without intermediate garbage collection. Diagnostics and stepping back behave as if each gate had been stepped over individually.
+
+    Args:
+        state: The simulation state to configure.
+        enabled: Whether fast-run mode is enabled.
+    """
+
+def compile_slice_operations(
+    state: SimulationState, settings: CompilationSettings
+) -> list[tuple[list[str], int, int, list[tuple[str, list[int], list[int], list[float], list[int]]]]]:
+    """Compile all slices of the code loaded into a DD-based `SimulationState` into lists of operations.
+
+    The operations are taken from the already imported program instead of code, so that the slices do not need to be parsed again. Each slice is equivalent to the code that `compile_slices` produces for it. Operations are given by their name, such as `h`, `x`, or `measure`, their control qubits, target qubits, parameters, and classical bits. The targets of the assertions are measured into single-bit classical registers that follow the registers of the program.
+
+    Args:
+        state: The simulation state to compile the slices of.
+        settings: The settings to use for the compilation. The slice index is ignored.
+
+    Returns:
+        For each slice, in the order of their slice indices, its assertions in the format of the `// ASSERT:` comments of compiled code, its number of qubits and classical bits, and its operations.
+    """
+
+def load_result_counts(
+    source: str | os.PathLike[str] | IO[str] | IO[bytes], registers: Sequence[Sequence[str]]
+) -> tuple[int, list[list[int]]]:
+    """Load the observed counts of the given registers from a results file.
+
+    The file contains a JSON list with one object per shot, mapping variable names to their measured values. It is read in a single pass. Variables that are part of multiple registers are only counted for the first of them.
+
+    Args:
+        source: The path to the results file, or a file object containing the results.
+        registers: The variables of each register to count.
+
+    Returns:
+        The number of shots and, for each register, the counts of all its outcomes. The `j`-th variable of a register corresponds to bit `j` of the outcome.
+    """
+
+def check_assertion_result(
+    assertion: str,
+    distribution: Sequence[int],
+    num_samples: int,
+    expected_success_probability: float,
+    p_value: float = 0.05,
+) -> bool:
+    """Check an assertion based on the observed distribution of its register.
+
+    Args:
+        assertion: The assertion to check, starting with `{superposition}`, `{zero}`, or the list of expected amplitudes in braces.
+        distribution: The observed counts of all outcomes.
+        num_samples: The number of samples.
+        expected_success_probability: The expected success probability for the program.
+        p_value: The minimum p-value required to accept the assertion.
+
+    Returns:
+        True if the assertion is satisfied, False otherwise.
+    """
+
+def check_results(
+    source: str | os.PathLike[str] | IO[str] | IO[bytes],
+    registers: Sequence[Sequence[str]],
+    assertions: Sequence[str],
+    expected_success_probability: float,
+    p_value: float = 0.05,
+    max_threads: int = 0,
+) -> list[bool]:
+    """Check all assertions of a compiled program against a results file.
+
+    The results are loaded as by `load_result_counts`, after which the assertions are checked in parallel.
+
+    Args:
+        source: The path to the results file, or a file object containing the results.
+        registers: The variables of the register of each assertion.
+        assertions: The assertions to check, one for each register.
+        expected_success_probability: The expected success probability for the program.
+        p_value: The minimum p-value required to accept an assertion.
+        max_threads: The maximum number of threads to use, or 0 to use the number of hardware threads.
+
+    Returns:
+        For each assertion, whether it is satisfied.
+    """
+
+class ShotEstimator:
+    """Estimates the number of shots required to check assertions on real devices.
+
+    Estimates are cached, so that repeated estimations of the same assertion under the same expected success probability are free.
+    """
+
+    def __init__(self) -> None:
+        """Creates a new `ShotEstimator` with an empty cache."""
+
+    def estimate(
+        self,
+        assertion: str,
+        expected_success_probability: float,
+        p_value: float = 0.05,
+        num_trials: int = 1000,
+        accuracy: float = 0.95,
+        seed: int = 0,
+        max_threads: int = 0,
+    ) -> int:
+        """Estimate the number of shots required to check an assertion.
+
+        For each candidate number of shots, the outcomes of `num_trials` executions are sampled from the expected distribution under noise and checked against the assertion, distributed across threads. The candidate is doubled until enough trials accept the assertion, and the last interval is then bisected for the smallest sufficient candidate. Estimates are cached per assertion and settings.
+
+        Args:
+            assertion: The assertion as found in compiled programs, consisting of the variables in parentheses followed by `{superposition}`, `{zero}`, or the list of expected amplitudes in braces.
+            expected_success_probability: The expected success probability for the program.
+            p_value: The minimum p-value required to accept the assertion.
+            num_trials: The number of simulated executions per candidate.
+            accuracy: The share of trials that must accept the assertion.
+            seed: The seed of the random number generators. Estimates are reproducible for a given seed.
+            max_threads: The maximum number of threads to use, or 0 to use the number of hardware threads.
+
+        Returns:
+            The estimated number of shots.
+        """
+
+    def clear_cache(self) -> None:
+        """Discard all cached estimates."""
+
+    def get_cache_size(self) -> int:
+        """Get the number of cached estimates.
+
+        Returns:
+            The number of cached estimates.
+        """
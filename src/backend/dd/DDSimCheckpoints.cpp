@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimCheckpoints.cpp
+ * @brief Implementation of DDSimCheckpoints.hpp
+ */
+
+#include "backend/dd/DDSimCheckpoints.hpp"
+
+#include "backend/dd/DDSimTraversal.hpp"
+#include "common.h"
+#include "common/DensityMatrix.hpp"
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <utility>
+
+namespace mqt::debugger {
+
+namespace {
+
+/**
+ * @brief Estimate the memory held by a checkpoint.
+ *
+ * The estimate assumes that none of the nodes of the checkpointed state are
+ * shared with other states, so it is an upper bound.
+ * @param checkpoint The checkpoint to estimate the memory of.
+ * @return The estimated memory in bytes.
+ */
+size_t estimateMemory(const DDSimCheckpoint& checkpoint) {
+  size_t memory = sizeof(DDSimCheckpoint);
+  memory += countNodes(checkpoint.state) * sizeof(dd::vNode);
+  memory += checkpoint.amplitudes.capacity() * sizeof(Complex);
+  memory += checkpoint.classicalBits.capacity() * sizeof(uint64_t);
+  memory += checkpoint.callReturnStack.capacity() * sizeof(size_t);
+  memory += checkpoint.restoreCallReturnStack.capacity() *
+            sizeof(std::pair<size_t, size_t>);
+  return memory;
+}
+
+} // namespace
+
+void DDSimCheckpointStore::setInterval(size_t steps) { interval = steps; }
+
+size_t DDSimCheckpointStore::getInterval() const { return interval; }
+
+void DDSimCheckpointStore::setMemoryBudget(size_t bytes,
+                                           dd::Package& package) {
+  memoryBudget = bytes;
+  enforceBudget(package);
+}
+
+size_t DDSimCheckpointStore::getMemoryBudget() const { return memoryBudget; }
+
+size_t DDSimCheckpointStore::getMemoryUsage() const { return memoryUsage; }
+
+size_t DDSimCheckpointStore::size() const { return checkpoints.size(); }
+
+bool DDSimCheckpointStore::shouldCapture(size_t step, bool irreversible) const {
+  if (checkpoints.contains(step)) {
+    return false;
+  }
+  return step == 0 || irreversible || (interval != 0 && step % interval == 0);
+}
+
+void DDSimCheckpointStore::capture(size_t step, DDSimCheckpoint checkpoint,
+                                   dd::Package& package) {
+  if (checkpoints.contains(step)) {
+    return;
+  }
+  checkpoint.memory = estimateMemory(checkpoint);
+  package.incRef(checkpoint.state);
+  memoryUsage += checkpoint.memory;
+  checkpoints.emplace(step, std::move(checkpoint));
+  enforceBudget(package);
+}
+
+const std::pair<const size_t, DDSimCheckpoint>*
+DDSimCheckpointStore::findLatest(size_t step) const {
+  auto it = checkpoints.upper_bound(step);
+  if (it == checkpoints.begin()) {
+    return nullptr;
+  }
+  return &*std::prev(it);
+}
+
+void DDSimCheckpointStore::discardFrom(size_t step, dd::Package& package) {
+  auto it = checkpoints.lower_bound(step);
+  while (it != checkpoints.end()) {
+    it = erase(it, package);
+  }
+}
+
+void DDSimCheckpointStore::updateClassicalBits(
+    const std::function<void(ClassicalBits&)>& update) {
+  for (auto& [step, checkpoint] : checkpoints) {
+    memoryUsage -= checkpoint.memory;
+    update(checkpoint.classicalBits);
+    checkpoint.memory = estimateMemory(checkpoint);
+    memoryUsage += checkpoint.memory;
+  }
+}
+
+void DDSimCheckpointStore::clear(dd::Package& package) {
+  discardFrom(0, package);
+}
+
+void DDSimCheckpointStore::enforceBudget(dd::Package& package) {
+  // The first checkpoint is never evicted. Of all others, evict the one that
+  // leaves the smallest gap between its neighbours, so that the remaining
+  // checkpoints stay spread out over the whole history. The latest checkpoint
+  // is only evicted if no other one is left.
+  while (memoryUsage > memoryBudget && checkpoints.size() > 1) {
+    auto victim = checkpoints.end();
+    size_t smallestGap = -1ULL;
+    for (auto it = std::next(checkpoints.begin()); it != checkpoints.end();
+         it++) {
+      const auto next = std::next(it);
+      const auto gap = next == checkpoints.end()
+                           ? -1ULL
+                           : next->first - std::prev(it)->first;
+      if (gap <= smallestGap) {
+        smallestGap = gap;
+        victim = it;
+      }
+    }
+    erase(victim, package);
+  }
+}
+
+std::map<size_t, DDSimCheckpoint>::iterator
+DDSimCheckpointStore::erase(std::map<size_t, DDSimCheckpoint>::iterator it,
+                            dd::Package& package) {
+  package.decRef(it->second.state);
+  memoryUsage -= it->second.memory;
+  return checkpoints.erase(it);
+}
+
+} // namespace mqt::debugger
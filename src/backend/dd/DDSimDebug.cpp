@@ -15,12 +15,16 @@
 
 #include "backend/dd/DDSimDebug.hpp"
 
+#include "backend/dd/DDSimDense.hpp"
 #include "backend/dd/DDSimDiagnostics.hpp"
+#include "backend/dd/DDSimProfiler.hpp"
+#include "backend/dd/DDSimTraversal.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "circuit_optimizer/CircuitOptimizer.hpp"
 #include "common.h"
 #include "common/ComplexMathematics.hpp"
+#include "common/DensityMatrix.hpp"
 #include "common/Span.hpp"
 #include "common/parsing/AssertionParsing.hpp"
 #include "common/parsing/AssertionTools.hpp"
@@ -31,7 +35,10 @@
 #include "dd/Operations.hpp"
 #include "dd/Package.hpp"
 #include "dd/StateGeneration.hpp"
+#include "dd/statistics/PackageStatistics.hpp"
 #include "ir/Definitions.hpp"
+#include "ir/Permutation.hpp"
+#include "ir/QuantumComputation.hpp"
 #include "ir/Register.hpp"
 #include "ir/operations/IfElseOperation.hpp"
 #include "ir/operations/OpType.hpp"
@@ -39,13 +46,18 @@
 
 #include <Eigen/Dense>
 #include <algorithm>
+#include <bit>
 #include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <exception>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <numeric>
@@ -96,516 +108,2389 @@ struct DDSimulationStateGuard {
 };
 
 /**
- * @brief Evaluate a classic-controlled condition from the original code.
+ * @brief Get the number of amplitudes of a dense state vector.
+ * @param numQubits The number of qubits of the state vector.
+ * @return The number of amplitudes, or the largest `size_t` if they cannot be
+ * counted in a `size_t`.
+ */
+size_t getNumAmplitudes(size_t numQubits) {
+  return numQubits < std::numeric_limits<size_t>::digits
+             ? 1ULL << numQubits
+             : std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief Get the number of bytes occupied by the dense buffers that a
+ * simulation state keeps between operations.
  * @param ddsim The simulation state.
- * @param instructionIndex The instruction index to inspect.
- * @return The evaluated condition, or std::nullopt if it cannot be evaluated.
+ * @return The number of bytes.
  */
-std::optional<bool> evaluateClassicConditionFromCode(DDSimulationState* ddsim,
-                                                     size_t instructionIndex) {
-  if (instructionIndex >= ddsim->instructionObjects.size()) {
-    return std::nullopt;
+size_t getRetainedDenseMemory(const DDSimulationState* ddsim) {
+  size_t bytes = ddsim->subStateScratch.capacity() * sizeof(Complex);
+  for (const auto& [key, amplitudes] : ddsim->referenceStates) {
+    bytes += amplitudes.capacity() * sizeof(Complex);
   }
-  const auto& code = ddsim->instructionObjects[instructionIndex].code;
-  const auto parsed = parseClassicConditionFromCode(code);
-  if (!parsed.has_value()) {
-    return std::nullopt;
+  bytes += ddsim->deltaBaseline.amplitudes.capacity() * sizeof(Complex);
+  const auto& views = ddsim->stateViews;
+  bytes += views.stateVector.capacity() * sizeof(Complex);
+  for (const auto& [qubits, subState] : views.subStates) {
+    if (subState.has_value()) {
+      bytes += subState->capacity() * sizeof(Complex);
+    }
   }
+  return bytes;
+}
 
-  size_t registerValue = 0;
-  if (parsed->bitIndex.has_value()) {
-    const auto bitName = parsed->registerName + "[" +
-                         std::to_string(parsed->bitIndex.value()) + "]";
-    const auto& value = ddsim->variables[bitName].value.boolValue;
-    registerValue = value ? 1ULL : 0ULL;
-  } else {
-    const auto regIt = std::ranges::find_if(
-        ddsim->classicalRegisters, [&parsed](const auto& reg) {
-          return reg.name == parsed->registerName;
-        });
-    if (regIt == ddsim->classicalRegisters.end()) {
-      return std::nullopt;
+/**
+ * @brief Check whether dense buffers of the given size fit into the remaining
+ * dense-memory budget of a simulation state.
+ * @param ddsim The simulation state.
+ * @param numAmplitudes The number of amplitudes of the buffers.
+ * @return True if the buffers fit into the budget, false otherwise.
+ */
+bool fitsDenseMemoryBudget(const DDSimulationState* ddsim,
+                           size_t numAmplitudes) {
+  const auto used = ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim);
+  const auto budget = ddsim->denseMemoryBudget;
+  return used <= budget && numAmplitudes <= (budget - used) / sizeof(Complex);
+}
+
+/**
+ * @brief Accounts dense buffers of amplitudes against the dense-memory budget
+ * of a simulation state for as long as it is alive.
+ */
+class DenseMemoryReservation {
+public:
+  /**
+   * @brief Try to reserve memory for dense buffers of the given size.
+   *
+   * Nothing is reserved if the buffers do not fit into the budget.
+   * @param ddsim The simulation state to reserve the memory in.
+   * @param numAmplitudes The number of amplitudes of the buffers.
+   */
+  DenseMemoryReservation(DDSimulationState* ddsim, size_t numAmplitudes)
+      : ddsim(ddsim) {
+    if (!fitsDenseMemoryBudget(ddsim, numAmplitudes)) {
+      return;
     }
-    for (size_t i = 0; i < regIt->size; i++) {
-      const auto name = getClassicalBitName(ddsim, regIt->index + i);
-      const auto& value = ddsim->variables[name].value.boolValue;
-      registerValue |= (value ? 1ULL : 0ULL) << i;
+    bytes = numAmplitudes * sizeof(Complex);
+    ddsim->denseMemoryInUse += bytes;
+    ddsim->peakDenseMemory =
+        std::max(ddsim->peakDenseMemory,
+                 ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim));
+    granted = true;
+  }
+
+  DenseMemoryReservation(const DenseMemoryReservation&) = delete;
+  DenseMemoryReservation& operator=(const DenseMemoryReservation&) = delete;
+
+  ~DenseMemoryReservation() {
+    if (granted) {
+      ddsim->denseMemoryInUse -= bytes;
     }
   }
 
-  return registerValue == parsed->expectedValue;
+  /**
+   * @brief Check whether the memory was reserved.
+   * @return True if the buffers fit into the budget, false otherwise.
+   */
+  [[nodiscard]] bool isGranted() const { return granted; }
+
+private:
+  /**
+   * @brief The simulation state the memory is reserved in.
+   */
+  DDSimulationState* ddsim;
+  /**
+   * @brief The number of reserved bytes.
+   */
+  size_t bytes = 0;
+  /**
+   * @brief Whether the memory was reserved.
+   */
+  bool granted = false;
+};
+
+/**
+ * @brief Get the number of amplitudes of the dense buffers that extracting a
+ * sub-state requires.
+ *
+ * This covers the full state vector, the growth of the scratch buffer of the
+ * simulation state, and the sub-state itself.
+ * @param ddsim The simulation state.
+ * @param subStateSize The number of qubits of the sub-state.
+ * @return The number of amplitudes.
+ */
+size_t getSubStateDenseAmplitudes(const DDSimulationState* ddsim,
+                                  size_t subStateSize) {
+  const auto numStates = getNumAmplitudes(ddsim->program->qc->getNqubits());
+  // None of the three buffers is larger than the full state vector.
+  if (numStates > std::numeric_limits<size_t>::max() / 3) {
+    return std::numeric_limits<size_t>::max();
+  }
+  const auto fullState = ddsim->backend != SimulationBackend::Dense &&
+                                 ddsim->stateViews.stateVector.empty()
+                             ? numStates
+                             : 0;
+  const auto scratchGrowth =
+      numStates - std::min(numStates, ddsim->subStateScratch.capacity());
+  return fullState + scratchGrowth +
+         std::min(numStates, getNumAmplitudes(subStateSize));
 }
 
 /**
- * @brief Generate a random number between 0 and 1.
+ * @brief Get the views of the current state of a simulation.
  *
- * This number is used for measurements.
- * @return A random number between 0 and 1.
+ * Views that belong to a previous version of the state are discarded, and so
+ * are all views if they no longer fit into the dense-memory budget.
+ * @param ddsim The simulation state.
+ * @return The views of the current state.
  */
-double generateRandomNumber() {
-  std::random_device
-      rd; // Will be used to obtain a seed for the random number engine
-  std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
-  std::uniform_real_distribution<> dis(0.0, 1.0);
+StateViewCache& getStateViews(DDSimulationState* ddsim) {
+  auto& views = ddsim->stateViews;
+  if (views.version != ddsim->stateVersion ||
+      ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim) >
+          ddsim->denseMemoryBudget) {
+    views = StateViewCache{};
+    views.version = ddsim->stateVersion;
+  }
+  return views;
+}
 
-  return dis(gen);
+/**
+ * @brief Record that the current state of a simulation changed.
+ *
+ * The views of the previous state are released right away, so that their
+ * memory is available to the next operation.
+ * @param ddsim The simulation state.
+ */
+void markStateChanged(DDSimulationState* ddsim) {
+  ddsim->stateVersion++;
+  getStateViews(ddsim);
 }
 
 /**
- * @brief Handles all actions that need to be performed when resetting the
- * simulation state.
+ * @brief Check whether a simulation state uses the dense backend.
+ * @param ddsim The simulation state.
+ * @return True if the state is stored as a flat array of amplitudes.
+ */
+bool usesDenseBackend(const DDSimulationState* ddsim) {
+  return ddsim->backend == SimulationBackend::Dense;
+}
+
+/**
+ * @brief Get the amplitudes of the current state of a simulation that uses
+ * the dense backend.
+ * @param ddsim The simulation state.
+ * @return The amplitudes of the state.
+ */
+Span<Complex> getDenseState(DDSimulationState* ddsim) {
+  return {ddsim->denseState.data(), ddsim->denseState.size()};
+}
+
+/**
+ * @brief Record that the amplitudes of a simulation that uses the dense
+ * backend changed.
  *
- * This occurs when the reset method is called or when new code is loaded.
- * @param ddsim The `DDSimulationState` to reset.
+ * The DD built from the previous amplitudes is released right away.
+ * @param ddsim The simulation state.
  */
-void resetSimulationState(DDSimulationState* ddsim) {
-  if (ddsim->simulationState.p != nullptr) {
+void markDenseStateChanged(DDSimulationState* ddsim) {
+  if (!ddsim->simulationState.isTerminal()) {
     ddsim->dd->decRef(ddsim->simulationState);
   }
-  ddsim->simulationState =
-      dd::makeZeroState(ddsim->qc->getNqubits(), *(ddsim->dd));
-  ddsim->dd->incRef(ddsim->simulationState);
-  ddsim->paused = false;
+  ddsim->simulationState = dd::vEdge::zero();
+  markStateChanged(ddsim);
 }
 
 /**
- * @brief For a given value, extract the bits at the given indices of its binary
- * representation.
- * @param indices The indices of the bits to extract.
- * @param value The value to extract the bits from.
- * @return The extracted bits.
+ * @brief Get the current state of a simulation as a decision diagram.
+ *
+ * With the dense backend, the DD is built from the amplitudes the first time
+ * it is requested for a version of the state.
+ * @param ddsim The simulation state.
+ * @return The DD of the current state.
  */
-std::vector<bool> extractBits(const std::vector<size_t>& indices,
-                              size_t value) {
-  std::vector<bool> result(indices.size());
-  for (size_t i = 0; i < indices.size(); i++) {
-    result[i] = (((value >> indices[i]) & 1) == 1);
+const dd::VectorDD& getStateDD(DDSimulationState* ddsim) {
+  if (!usesDenseBackend(ddsim) ||
+      ddsim->denseStateDDVersion == ddsim->stateVersion) {
+    return ddsim->simulationState;
   }
-  return result;
+  dd::CVec amplitudes(ddsim->denseState.size());
+  std::ranges::transform(ddsim->denseState, amplitudes.begin(),
+                         [](const Complex& amplitude) {
+                           return std::complex<dd::fp>{amplitude.real,
+                                                       amplitude.imaginary};
+                         });
+  const auto state = dd::makeStateFromVector(amplitudes, *ddsim->dd);
+  ddsim->dd->incRef(state);
+  if (!ddsim->simulationState.isTerminal()) {
+    ddsim->dd->decRef(ddsim->simulationState);
+  }
+  ddsim->simulationState = state;
+  ddsim->denseStateDDVersion = ddsim->stateVersion;
+  return ddsim->simulationState;
 }
 
 /**
- * Checks the given entanglement assertion on the given state.
+ * @brief Get the memoized amplitudes of the full current state vector,
+ * expanding the state if they were not computed yet.
+ *
+ * With the dense backend, these are the amplitudes of the state itself.
  * @param ddsim The simulation state.
- * @param assertion The entanglement assertion to check.
- * @return True if the assertion is satisfied, false otherwise.
+ * @return The amplitudes, or nullptr if they do not fit into the dense-memory
+ * budget.
  */
-bool checkAssertionEntangled(
-    DDSimulationState* ddsim,
-    std::unique_ptr<EntanglementAssertion>& assertion) {
+AmplitudeBuffer* getCachedStateVector(DDSimulationState* ddsim) {
+  if (usesDenseBackend(ddsim)) {
+    return &ddsim->denseState;
+  }
+  auto& views = getStateViews(ddsim);
+  if (!views.stateVector.empty()) {
+    return &views.stateVector;
+  }
+  const auto numQubits = ddsim->program->qc->getNqubits();
+  const auto numStates = getNumAmplitudes(numQubits);
+  if (!fitsDenseMemoryBudget(ddsim, numStates)) {
+    return nullptr;
+  }
+  const DDSimProfiler::Scope scope(ddsim->profiler, ProfileDensification,
+                                   ddsim->simulationState);
+  ddsim->profiler.recordDenseBytes(numStates * sizeof(Complex));
+  views.stateVector.resize(numStates);
+  const Span<Complex> amplitudes(views.stateVector.data(), numStates);
+  exportStateVector(ddsim->simulationState, numQubits, amplitudes);
+  ddsim->peakDenseMemory =
+      std::max(ddsim->peakDenseMemory,
+               ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim));
+  return &views.stateVector;
+}
+
+/**
+ * @brief Get the memoized reduced density matrix of two qubits of the current
+ * state.
+ *
+ * If the state vector fits into the dense-memory budget, it is expanded once
+ * and shared by all pairs. Otherwise, the matrix is computed on the DD.
+ * @param ddsim The simulation state.
+ * @param qubit1 The index of the first qubit to keep.
+ * @param qubit2 The index of the second qubit to keep.
+ * @return The 4x4 reduced density matrix, with the lower of the two qubits as
+ * the least significant bit.
+ */
+const DensityMatrix& getCachedTwoQubitDensityMatrix(DDSimulationState* ddsim,
+                                                    size_t qubit1,
+                                                    size_t qubit2) {
+  auto& matrices = getStateViews(ddsim).twoQubitDensityMatrices;
+  const std::pair<size_t, size_t> key = std::minmax(qubit1, qubit2);
+  const auto found = matrices.find(key);
+  if (found != matrices.end()) {
+    return found->second;
+  }
+  auto* amplitudes = getCachedStateVector(ddsim);
+  if (amplitudes == nullptr) {
+    return matrices
+        .emplace(key, computeTwoQubitDensityMatrix(ddsim->simulationState,
+                                                   key.first, key.second))
+        .first->second;
+  }
   Statevector sv;
-  sv.numQubits = ddsim->interface.getNumQubits(&ddsim->interface);
-  sv.numStates = 1 << sv.numQubits;
-  std::vector<Complex> amplitudes(sv.numStates);
-  sv.amplitudes = amplitudes.data();
-  ddsim->interface.getStateVectorFull(&ddsim->interface, &sv);
+  sv.numQubits = ddsim->program->qc->getNqubits();
+  sv.numStates = amplitudes->size();
+  sv.amplitudes = amplitudes->data();
+  return matrices
+      .emplace(key, getTwoQubitDensityMatrix(sv, key.first, key.second))
+      .first->second;
+}
+
+/**
+ * @brief The number of classical bits stored in each word of `ClassicalBits`.
+ */
+constexpr size_t CLASSICAL_BITS_PER_WORD =
+    std::numeric_limits<uint64_t>::digits;
 
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
+/**
+ * @brief Get the number of words required to store the classical bits of a
+ * program.
+ * @param program The program to inspect.
+ * @return The number of words.
+ */
+size_t getClassicalBitWords(const DDSimProgram& program) {
+  const auto numBits = program.variableNames.size();
+  return (numBits + CLASSICAL_BITS_PER_WORD - 1) / CLASSICAL_BITS_PER_WORD;
+}
+
+/**
+ * @brief Read a single classical bit.
+ * @param bits The classical bits.
+ * @param index The index of the bit to read.
+ * @return The value of the bit, or false if it is not stored.
+ */
+bool getClassicalBit(const ClassicalBits& bits, size_t index) {
+  const auto word = index / CLASSICAL_BITS_PER_WORD;
+  if (word >= bits.size()) {
+    return false;
   }
+  return ((bits[word] >> (index % CLASSICAL_BITS_PER_WORD)) & 1U) != 0;
+}
 
-  std::vector<std::vector<Complex>> densityMatrix(
-      sv.numStates, std::vector<Complex>(sv.numStates, {0, 0}));
-  for (size_t i = 0; i < sv.numStates; i++) {
-    for (size_t j = 0; j < sv.numStates; j++) {
-      densityMatrix[i][j] =
-          complexMultiplication(amplitudes[i], complexConjugate(amplitudes[j]));
-    }
+/**
+ * @brief Write a single classical bit.
+ * @param bits The classical bits.
+ * @param index The index of the bit to write.
+ * @param value The value to write.
+ */
+void setClassicalBit(ClassicalBits& bits, size_t index, bool value) {
+  const auto word = index / CLASSICAL_BITS_PER_WORD;
+  if (word >= bits.size()) {
+    bits.resize(word + 1, 0);
+  }
+  const auto mask = 1ULL << (index % CLASSICAL_BITS_PER_WORD);
+  if (value) {
+    bits[word] |= mask;
+  } else {
+    bits[word] &= ~mask;
   }
+}
 
-  for (const auto i : qubits) {
-    for (const auto j : qubits) {
-      if (i == j) {
-        continue;
-      }
-      if (!areQubitsEntangled(densityMatrix, i, j)) {
-        return false;
-      }
-    }
+/**
+ * @brief Read consecutive classical bits as a single integer.
+ * @param bits The classical bits.
+ * @param offset The index of the first bit to read.
+ * @param width The number of bits to read. Must not exceed 64.
+ * @return The value of the bits, where bit `i` holds classical bit
+ * `offset + i`.
+ */
+size_t readClassicalBits(const ClassicalBits& bits, size_t offset,
+                         size_t width) {
+  if (width == 0) {
+    return 0;
   }
-  return true;
+  const auto word = offset / CLASSICAL_BITS_PER_WORD;
+  const auto shift = offset % CLASSICAL_BITS_PER_WORD;
+  uint64_t value = word < bits.size() ? bits[word] >> shift : 0;
+  if (shift != 0 && shift + width > CLASSICAL_BITS_PER_WORD &&
+      word + 1 < bits.size()) {
+    value |= bits[word + 1] << (CLASSICAL_BITS_PER_WORD - shift);
+  }
+  if (width < CLASSICAL_BITS_PER_WORD) {
+    value &= (1ULL << width) - 1;
+  }
+  return value;
 }
 
 /**
- * Checks the given superposition assertion on the given state.
- * @param ddsim The simulation state.
- * @param assertion The superposition assertion to check.
- * @return True if the assertion is satisfied, false otherwise.
+ * @brief Look up the index of a classical bit by its name.
+ * @param program The program that declares the bit.
+ * @param name The name of the bit.
+ * @return The index of the bit, or std::nullopt if there is no such bit.
  */
-bool checkAssertionSuperposition(
-    DDSimulationState* ddsim,
-    std::unique_ptr<SuperpositionAssertion>& assertion) {
-  std::vector<size_t> qubits;
-
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
-  }
-
-  Complex result;
-  bool firstFound = false;
-  std::vector<bool> bitstring;
-  for (size_t i = 0;
-       i < 1ULL << ddsim->interface.getNumQubits(&ddsim->interface); i++) {
-    ddsim->interface.getAmplitudeIndex(&ddsim->interface, i, &result);
-    if (complexMagnitude(result) > 0.00000001) {
-      if (!firstFound) {
-        firstFound = true;
-        bitstring = extractBits(qubits, i);
-      } else {
-        const std::vector<bool> compareBitstring = extractBits(qubits, i);
-        if (bitstring != compareBitstring) {
-          return true;
-        }
+std::optional<size_t> findClassicalVariable(const DDSimProgram& program,
+                                            const std::string& name) {
+  const auto found = program.variableIndices.find(name);
+  if (found == program.variableIndices.end()) {
+    return std::nullopt;
+  }
+  return found->second;
+}
+
+/**
+ * @brief Compile the conditions of all classic-controlled instructions of a
+ * program to the classical bits they compare.
+ * @param program The program to compile the conditions of.
+ */
+void buildClassicConditions(DDSimProgram& program) {
+  program.classicConditions.assign(program.instructionObjects.size(),
+                                   std::nullopt);
+  for (size_t i = 0; i < program.instructionObjects.size(); i++) {
+    const auto parsed =
+        parseClassicConditionFromCode(program.instructionObjects[i].code);
+    if (!parsed.has_value()) {
+      continue;
+    }
+    const auto reg = std::ranges::find_if(
+        program.classicalRegisters,
+        [&parsed](const auto& r) { return r.name == parsed->registerName; });
+    if (reg == program.classicalRegisters.end()) {
+      continue;
+    }
+    if (parsed->bitIndex.has_value()) {
+      if (parsed->bitIndex.value() >= reg->size) {
+        continue;
       }
+      program.classicConditions[i] = CompiledClassicCondition{
+          .offset = reg->index + parsed->bitIndex.value(),
+          .width = 1,
+          .expectedValue = parsed->expectedValue};
+    } else if (reg->size <= CLASSICAL_BITS_PER_WORD) {
+      program.classicConditions[i] =
+          CompiledClassicCondition{.offset = reg->index,
+                                   .width = reg->size,
+                                   .expectedValue = parsed->expectedValue};
     }
   }
-
-  return false;
 }
 
 /**
- * Checks the given statevector-equality assertion on the given state.
+ * @brief Check whether the condition of an if-else operation is met.
+ *
+ * The condition compiled for the instruction is used if there is one.
+ * Otherwise, the condition of the operation itself is evaluated.
  * @param ddsim The simulation state.
- * @param assertion The equality assertion to check.
- * @return True if the assertion is satisfied, false otherwise.
+ * @param op The if-else operation.
+ * @param instruction The instruction the operation belongs to.
+ * @return True if the condition is met, false otherwise.
  */
-bool checkAssertionEqualityStatevector(
-    DDSimulationState* ddsim,
-    std::unique_ptr<StatevectorEqualityAssertion>& assertion) {
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
+bool isClassicConditionMet(const DDSimulationState* ddsim,
+                           const qc::IfElseOperation& op, size_t instruction) {
+  if (op.getComparisonKind() != qc::Eq) {
+    throw std::runtime_error("If-else operations with non-equality "
+                             "comparisons are currently not supported");
   }
-
-  Statevector sv;
-  sv.numQubits = qubits.size();
-  sv.numStates = 1 << sv.numQubits;
-  std::vector<Complex> amplitudes(sv.numStates);
-  sv.amplitudes = amplitudes.data();
-
-  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
-                                         qubits.data(), &sv) == ERROR) {
-    throw std::runtime_error(
-        "Equality assertion on entangled sub-state is not allowed.");
+  const auto& conditions = ddsim->program->classicConditions;
+  if (instruction < conditions.size() && conditions[instruction].has_value()) {
+    const auto& condition = conditions[instruction].value();
+    return readClassicalBits(ddsim->classicalBits, condition.offset,
+                             condition.width) == condition.expectedValue;
   }
+  if (op.getControlBit().has_value()) {
+    const auto value =
+        getClassicalBit(ddsim->classicalBits, op.getControlBit().value());
+    return (value ? 1ULL : 0ULL) == op.getExpectedValueRegister();
+  }
+  const auto& controls = op.getControlRegister();
+  return readClassicalBits(ddsim->classicalBits, controls->getStartIndex(),
+                           controls->getSize()) ==
+         op.getExpectedValueRegister();
+}
 
-  const double similarityThreshold = assertion->getSimilarityThreshold();
-
-  const double similarity = dotProduct(sv, assertion->getTargetStatevector());
+/**
+ * @brief Generate a random number between 0 and 1.
+ *
+ * This number is used for measurements. It is drawn from the random number
+ * generator of the given simulation state, so that seeding the state makes
+ * all measurement outcomes reproducible.
+ * @param ddsim The simulation state.
+ * @return A random number between 0 and 1.
+ */
+double generateRandomNumber(DDSimulationState* ddsim) {
+  std::uniform_real_distribution<> dis(0.0, 1.0);
+  return dis(ddsim->rng);
+}
 
-  return similarity >= similarityThreshold;
+/**
+ * @brief Handles all actions that need to be performed when resetting the
+ * simulation state.
+ *
+ * This occurs when the reset method is called or when new code is loaded.
+ * @param ddsim The `DDSimulationState` to reset.
+ */
+void resetSimulationState(DDSimulationState* ddsim) {
+  ddsim->checkpoints.clear(*ddsim->dd);
+  ddsim->measurementOutcomes.clear();
+  if (ddsim->simulationState.p != nullptr) {
+    ddsim->dd->decRef(ddsim->simulationState);
+  }
+  const auto numQubits = ddsim->program->qc->getNqubits();
+  ddsim->simulationState = dd::makeZeroState(numQubits, *(ddsim->dd));
+  ddsim->dd->incRef(ddsim->simulationState);
+  markStateChanged(ddsim);
+  if (usesDenseBackend(ddsim)) {
+    ddsim->denseState.assign(getNumAmplitudes(numQubits), Complex{0, 0});
+    ddsim->denseState.front() = {1, 0};
+    ddsim->denseStateDDVersion = ddsim->stateVersion;
+  }
+  ddsim->paused = false;
 }
 
 /**
- * Checks the given circuit-equality assertion on the given state.
+ * @brief Get the matrix DD that applies or undoes the given operation.
+ *
+ * The DD is only built the first time it is requested and then taken from the
+ * gate cache of the simulation state.
  * @param ddsim The simulation state.
- * @param assertion The equality assertion to check.
- * @return True if the assertion is satisfied, false otherwise.
+ * @param op The operation to get the DD for.
+ * @param inverse Whether to get the DD that undoes the operation.
+ * @return The requested matrix DD.
  */
-bool checkAssertionEqualityCircuit(
-    DDSimulationState* ddsim,
-    std::unique_ptr<CircuitEqualityAssertion>& assertion) {
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
+dd::MatrixDD getGateDD(DDSimulationState* ddsim, const qc::Operation& op,
+                       bool inverse) {
+  auto& entry = ddsim->gateCache[&op];
+  auto& cached = inverse ? entry.inverse : entry.forward;
+  if (!cached.has_value()) {
+    cached = inverse ? dd::getInverseDD(op, *ddsim->dd)
+                     : dd::getDD(op, *ddsim->dd);
+    ddsim->dd->incRef(*cached);
   }
+  return *cached;
+}
 
-  DDSimulationState secondSimulation;
-  if (createDDSimulationState(&secondSimulation) == ERROR) {
-    throw std::runtime_error(
-        "Failed to initialize simulation for equality assertion.");
+/**
+ * @brief Get the dense gate that applies or undoes the given operation.
+ *
+ * The gate is only prepared the first time it is requested and then taken
+ * from the dense gate cache of the simulation state. The inverse gate is
+ * derived from the forward one.
+ * @param ddsim The simulation state.
+ * @param op The operation to get the gate for.
+ * @param inverse Whether to get the gate that undoes the operation.
+ * @return The requested gate.
+ */
+const DenseGate& getDenseGate(DDSimulationState* ddsim,
+                              const qc::Operation& op, bool inverse) {
+  auto& entry = ddsim->denseGateCache[&op];
+  if (!entry.forward.has_value()) {
+    if (ddsim->densePackage == nullptr) {
+      ddsim->densePackage =
+          std::make_unique<dd::Package>(MAX_DENSE_GATE_TARGETS);
+    }
+    entry.forward = makeDenseGate(op, *ddsim->densePackage);
   }
-  const DDSimulationStateGuard secondSimulationGuard(&secondSimulation);
-  const auto loadResult = secondSimulation.interface.loadCode(
-      &secondSimulation.interface, assertion->getCircuitCode().c_str());
-  if (loadResult.status != LOAD_OK) {
-    const auto* data = std::data(loadResult.message);
-    const std::string_view messageView(
-        data, boundedStrnlen(data, LOAD_RESULT_MESSAGE_MAX));
-    throw std::runtime_error(
-        !messageView.empty()
-            ? std::string(messageView)
-            : "Failed to load circuit for equality assertion.");
+  if (!inverse) {
+    return *entry.forward;
   }
-  if (!secondSimulation.assertionInstructions.empty()) {
-    throw std::runtime_error(
-        "Circuit equality assertions cannot contain nested assertions");
+  if (!entry.inverse.has_value()) {
+    entry.inverse = invertDenseGate(*entry.forward);
   }
-  secondSimulation.interface.runSimulation(&secondSimulation.interface);
-
-  Statevector sv2;
-  sv2.numQubits =
-      secondSimulation.interface.getNumQubits(&secondSimulation.interface);
-  sv2.numStates = 1 << sv2.numQubits;
-  std::vector<Complex> amplitudes2(sv2.numStates);
-  sv2.amplitudes = amplitudes2.data();
-  secondSimulation.interface.getStateVectorFull(&secondSimulation.interface,
-                                                &sv2);
+  return *entry.inverse;
+}
 
-  Statevector sv;
-  sv.numQubits = qubits.size();
-  sv.numStates = 1 << sv.numQubits;
-  std::vector<Complex> amplitudes(sv.numStates);
-  sv.amplitudes = amplitudes.data();
-  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
-                                         qubits.data(), &sv) == ERROR) {
-    throw std::runtime_error(
-        "Equality assertion on entangled sub-state is not allowed.");
+/**
+ * @brief Release all matrix DDs stored in the gate cache.
+ *
+ * The dense gate cache is cleared as well.
+ * @param ddsim The simulation state.
+ */
+void clearGateCache(DDSimulationState* ddsim) {
+  for (const auto& [op, entry] : ddsim->gateCache) {
+    if (entry.forward.has_value()) {
+      ddsim->dd->decRef(*entry.forward);
+    }
+    if (entry.inverse.has_value()) {
+      ddsim->dd->decRef(*entry.inverse);
+    }
   }
+  ddsim->gateCache.clear();
+  ddsim->denseGateCache.clear();
+}
 
-  const double similarityThreshold = assertion->getSimilarityThreshold();
-
-  const double similarity = dotProduct(sv, sv2);
+/**
+ * @brief Get the active memory of the DD package of the simulation state.
+ * @param ddsim The simulation state.
+ * @return The active memory in bytes.
+ */
+size_t getActiveMemory(DDSimulationState* ddsim) {
+  return static_cast<size_t>(dd::computeActiveMemoryMB(*ddsim->dd) * 1024. *
+                             1024.);
+}
 
-  return similarity >= similarityThreshold;
+/**
+ * @brief Collect garbage in the DD package of the simulation state.
+ * @param ddsim The simulation state.
+ */
+void collectGarbage(DDSimulationState* ddsim) {
+  const DDSimProfiler::Scope scope(ddsim->profiler, ProfileGarbageCollection,
+                                   ddsim->simulationState);
+  ddsim->dd->garbageCollect(true);
+  ddsim->stepsSinceGarbageCollection = 0;
+  ddsim->memoryAfterGarbageCollection = getActiveMemory(ddsim);
 }
 
 /**
- * @brief For an instruction that has a child block, extract the valid code from
- * the block's body.
- *
- * Valid code is code that can be passed to the simulation backend. Assertions
- * are removed.
- * @param parent The parent instruction.
- * @param allInstructions All instructions in the program.
- * @return The extracted valid code.
+ * @brief Collect garbage after simulation steps if the policy requires it.
+ * @param ddsim The simulation state.
+ * @param steps The number of steps performed since the last call.
  */
-std::string validCodeFromChildren(const Instruction& parent,
-                                  std::vector<Instruction>& allInstructions) {
-  std::string code = parent.code;
-  if (!parent.block.valid) {
-    return code;
+void collectGarbageAfterSteps(DDSimulationState* ddsim, size_t steps) {
+  ddsim->stepsSinceGarbageCollection += steps;
+  const auto& policy = ddsim->gcPolicy;
+  bool collect = false;
+  switch (policy.mode) {
+  case GarbageCollectionMode::Adaptive:
+    collect = getActiveMemory(ddsim) >=
+              std::max(ADAPTIVE_GC_MIN_MEMORY,
+                       2 * ddsim->memoryAfterGarbageCollection);
+    break;
+  case GarbageCollectionMode::EveryNSteps:
+    collect = ddsim->stepsSinceGarbageCollection >= policy.interval;
+    break;
+  case GarbageCollectionMode::MemoryThreshold:
+    collect = getActiveMemory(ddsim) >= policy.memoryThreshold;
+    break;
+  case GarbageCollectionMode::WhenPaused:
+    break;
   }
-  code += " { ";
-  for (auto child : parent.childInstructions) {
-    const auto& childInstruction = allInstructions[child];
-    if (childInstruction.assertion != nullptr) {
-      continue;
-    }
-    code += validCodeFromChildren(childInstruction, allInstructions);
+  if (collect) {
+    collectGarbage(ddsim);
   }
-  code += " } ";
-  return code;
 }
 
-//----------------------------------------------------------------------------
-
 /**
- * @brief Construct the preamble for a statistical slice equality assertion.
- * @param assertion The assertion to construct the preamble for.
- * @param targetNames The names of the target qubits.
- * @return The constructed preamble.
+ * @brief Collect garbage after a run of the simulation stopped if the policy
+ * requires it.
+ * @param ddsim The simulation state.
  */
-std::string getStatisticalSliceEqualityPreamble(
-    std::unique_ptr<StatevectorEqualityAssertion>& assertion,
-    std::map<std::string, std::string>& targetNames) {
+void collectGarbageOnPause(DDSimulationState* ddsim) {
+  if (ddsim->gcPolicy.mode == GarbageCollectionMode::WhenPaused &&
+      ddsim->stepsSinceGarbageCollection > 0) {
+    collectGarbage(ddsim);
+  }
+}
+
+/**
+ * @brief Check whether an operation cannot be undone by applying its inverse.
+ * @param op The operation to check.
+ * @return True if the operation is a measurement or reset, false otherwise.
+ */
+bool isIrreversible(const qc::Operation& op) {
+  return op.getType() == qc::Measure || op.getType() == qc::Reset;
+}
+
+/**
+ * @brief Store a checkpoint of the current state before the given step.
+ * @param ddsim The simulation state.
+ * @param step The index of the step that is executed next.
+ */
+void captureCheckpoint(DDSimulationState* ddsim, size_t step) {
+  ddsim->checkpoints.capture(
+      step,
+      {.state = usesDenseBackend(ddsim) ? dd::vEdge::zero()
+                                        : ddsim->simulationState,
+       .amplitudes =
+           usesDenseBackend(ddsim) ? ddsim->denseState : AmplitudeBuffer{},
+       .currentInstruction = ddsim->currentInstruction,
+       .operationIndex =
+           static_cast<size_t>(ddsim->iterator - ddsim->program->qc->begin()),
+       .classicalBits = ddsim->classicalBits,
+       .callReturnStack = ddsim->callReturnStack,
+       .restoreCallReturnStack = ddsim->restoreCallReturnStack,
+       .lastFailedAssertion = ddsim->lastFailedAssertion,
+       .memory = 0},
+      *ddsim->dd);
+}
+
+/**
+ * @brief Discard all checkpoints and measurement outcomes from the current
+ * step onwards.
+ *
+ * This is required whenever the current state is modified directly, as the
+ * recorded future no longer matches it.
+ * @param ddsim The simulation state.
+ */
+void discardFutureHistory(DDSimulationState* ddsim) {
+  const auto step = ddsim->previousInstructionStack.size();
+  ddsim->checkpoints.discardFrom(step, *ddsim->dd);
+  ddsim->measurementOutcomes.erase(
+      ddsim->measurementOutcomes.lower_bound(step),
+      ddsim->measurementOutcomes.end());
+}
+
+/**
+ * @brief Determine the outcome of measuring a qubit in the current step.
+ *
+ * If the current step has been executed before, the recorded outcome is
+ * reused. Otherwise, a new outcome is drawn and recorded.
+ * @param ddsim The simulation state.
+ * @param index The index of the measured qubit within the current step.
+ * @param pZero The probability of measuring 0.
+ * @return True if the outcome is 0, false otherwise.
+ */
+bool drawMeasurementOutcome(DDSimulationState* ddsim, size_t index,
+                            double pZero) {
+  auto& outcomes =
+      ddsim->measurementOutcomes[ddsim->previousInstructionStack.size() - 1];
+  if (index < outcomes.size()) {
+    return outcomes[index];
+  }
+  const auto outcome = generateRandomNumber(ddsim) < pZero;
+  outcomes.push_back(outcome);
+  return outcome;
+}
+
+/**
+ * @brief Check whether the current instruction can be fused with its
+ * neighbours.
+ * @param ddsim The simulation state.
+ * @return True if the current instruction applies a unitary, unconditional
+ * gate and does not return from a custom gate on the DD backend, false
+ * otherwise.
+ */
+bool isFusable(DDSimulationState* ddsim) {
+  // The dense backend applies each gate in place, so there is nothing to gain
+  // from fusing them.
+  if (usesDenseBackend(ddsim)) {
+    return false;
+  }
+  const auto instruction = ddsim->currentInstruction;
+  if (instruction >= ddsim->program->instructionTypes.size() ||
+      ddsim->program->instructionTypes[instruction] != SIMULATE) {
+    return false;
+  }
+  if (ddsim->program->successorInstructions[instruction] == 0) {
+    return false;
+  }
+  const auto& op = **ddsim->iterator;
+  return !op.isIfElseOperation() && !isIrreversible(op);
+}
+
+/**
+ * @brief Replace the current state of the simulation by the given state.
+ * @param ddsim The simulation state.
+ * @param state The new state.
+ */
+void setSimulationState(DDSimulationState* ddsim, const dd::VectorDD& state) {
+  ddsim->dd->incRef(state);
+  ddsim->dd->decRef(ddsim->simulationState);
+  ddsim->simulationState = state;
+  markStateChanged(ddsim);
+}
+
+/**
+ * @brief Apply or undo a unitary operation on the current state of the
+ * simulation.
+ * @param ddsim The simulation state.
+ * @param op The operation to apply.
+ * @param inverse Whether to undo the operation instead of applying it.
+ */
+void applyOperation(DDSimulationState* ddsim, const qc::Operation& op,
+                    bool inverse) {
+  if (usesDenseBackend(ddsim)) {
+    applyDenseGate(getDenseState(ddsim), getDenseGate(ddsim, op, inverse));
+    markDenseStateChanged(ddsim);
+    return;
+  }
+  setSimulationState(ddsim,
+                     ddsim->dd->multiply(getGateDD(ddsim, op, inverse),
+                                         ddsim->simulationState));
+}
+
+/**
+ * @brief Collapse a qubit of the current state of the simulation to a
+ * measurement outcome.
+ * @param ddsim The simulation state.
+ * @param qubit The measured qubit.
+ * @param probability The probability of the outcome.
+ * @param measureZero True if the outcome is 0, false if it is 1.
+ */
+void collapseQubit(DDSimulationState* ddsim, size_t qubit, double probability,
+                   bool measureZero) {
+  if (usesDenseBackend(ddsim)) {
+    collapseDenseQubit(getDenseState(ddsim), qubit, probability, measureZero);
+    markDenseStateChanged(ddsim);
+    return;
+  }
+  ddsim->dd->performCollapsingMeasurement(ddsim->simulationState,
+                                          static_cast<dd::Qubit>(qubit),
+                                          probability, measureZero);
+  markStateChanged(ddsim);
+}
+
+/**
+ * @brief Flip a qubit of the current state of the simulation.
+ * @param ddsim The simulation state.
+ * @param qubit The qubit to flip.
+ */
+void flipQubit(DDSimulationState* ddsim, qc::Qubit qubit) {
+  const auto x = qc::StandardOperation(qubit, qc::X);
+  if (usesDenseBackend(ddsim)) {
+    // The operation is temporary, so its gate must not enter the cache.
+    if (ddsim->densePackage == nullptr) {
+      ddsim->densePackage =
+          std::make_unique<dd::Package>(MAX_DENSE_GATE_TARGETS);
+    }
+    applyDenseGate(getDenseState(ddsim),
+                   makeDenseGate(x, *ddsim->densePackage));
+    markDenseStateChanged(ddsim);
+    return;
+  }
+  setSimulationState(ddsim, ddsim->dd->multiply(dd::getDD(x, *ddsim->dd),
+                                                ddsim->simulationState));
+}
+
+/**
+ * @brief Apply a maximal run of fusable instructions in one go.
+ *
+ * The gates of the run are multiplied onto the state one after the other
+ * without updating reference counts or collecting garbage in between. The
+ * instruction history and the diagnostics are updated as if each instruction
+ * had been stepped over individually, so that the run can be undone step by
+ * step. The state is only stored before gates whose controls have to be
+ * checked. The run ends before the first instruction that is not fusable,
+ * after the first instruction that leads to a breakpoint, or after `maxSteps`
+ * instructions.
+ * @param ddsim The simulation state.
+ * @param maxSteps The maximum number of instructions to apply.
+ * @return The number of applied instructions.
+ */
+size_t fastForward(DDSimulationState* ddsim, size_t maxSteps) {
+  if (maxSteps == 0 || !isFusable(ddsim)) {
+    return 0;
+  }
+  ddsim->lastMetBreakpoint = -1ULL;
+  ddsim->lastFailedAssertion = -1ULL;
+  auto state = ddsim->simulationState;
+  size_t count = 0;
+  while (count < maxSteps && isFusable(ddsim)) {
+    const auto instruction = ddsim->currentInstruction;
+    const auto step = ddsim->previousInstructionStack.size();
+    if (ddsim->checkpoints.shouldCapture(step, false)) {
+      setSimulationState(ddsim, state);
+      captureCheckpoint(ddsim, step);
+    }
+    if (!ddsim->replaying) {
+      // Controls are checked in the state the gate is applied to, so it has to
+      // be stored first. All other diagnostics do not depend on the state.
+      if (dddiagnosticsNeedsControlCheck(&ddsim->diagnostics, instruction)) {
+        setSimulationState(ddsim, state);
+      }
+      dddiagnosticsOnStepForward(&ddsim->diagnostics, instruction);
+    }
+    const auto& op = **ddsim->iterator;
+    if (op.getType() != qc::Barrier) {
+      state = ddsim->dd->multiply(getGateDD(ddsim, op, false), state);
+    }
+    ddsim->iterator++;
+    ddsim->previousInstructionStack.emplace_back(instruction);
+    ddsim->currentInstruction =
+        ddsim->program->successorInstructions[instruction];
+    count++;
+    if (hasInstructionFlag(ddsim, ddsim->currentInstruction, BREAKPOINT)) {
+      ddsim->lastMetBreakpoint = ddsim->currentInstruction;
+      break;
+    }
+  }
+  setSimulationState(ddsim, state);
+  collectGarbageAfterSteps(ddsim, count);
+  return count;
+}
+
+/**
+ * @brief Read the values of all classical bits as a single integer.
+ * @param ddsim The simulation state.
+ * @return The classical outcome, where bit i holds the value of classical bit
+ * i.
+ */
+size_t readClassicalOutcome(DDSimulationState* ddsim) {
+  return readClassicalBits(ddsim->classicalBits, 0,
+                           ddsim->program->variableNames.size());
+}
+
+/**
+ * @brief Run the simulation until the next measurement or reset.
+ * @param ddsim The simulation state.
+ * @return True if a measurement or reset is executed next, false if the
+ * program has finished.
+ */
+bool runToNextMeasurement(DDSimulationState* ddsim) {
+  while (!ddsimIsFinished(&ddsim->interface)) {
+    const auto instruction = ddsim->currentInstruction;
+    if (ddsim->program->instructionTypes[instruction] == SIMULATE &&
+        isIrreversible(**ddsim->iterator)) {
+      return true;
+    }
+    if (fastForward(ddsim, -1ULL) == 0 &&
+        ddsimStepForward(&ddsim->interface) == ERROR) {
+      throw std::runtime_error("Failed to simulate the program for sampling.");
+    }
+  }
+  return false;
+}
+
+void sampleFrom(DDSimulationState* ddsim, size_t shots,
+                std::map<size_t, size_t>& histogram);
+
+/**
+ * @brief Distribute shots over the outcomes of the measurement that is
+ * executed next.
+ *
+ * The target qubits are measured one after the other. For each target, the
+ * shots are split binomially between both outcomes according to the
+ * probabilities of the state collapsed by the outcomes of the previous
+ * targets. Once all outcomes are fixed, the measurement is executed with them
+ * and the remaining program is sampled.
+ * @param ddsim The simulation state.
+ * @param shots The number of shots to distribute.
+ * @param step The index of the measurement step.
+ * @param targets The target qubits of the measurement.
+ * @param state The state collapsed by the outcomes fixed so far.
+ * @param outcomes The outcomes fixed so far. True denotes 0.
+ * @param histogram The histogram to add the sampled outcomes to.
+ */
+void sampleMeasurement(DDSimulationState* ddsim, size_t shots, size_t step,
+                       const std::vector<qc::Qubit>& targets,
+                       const dd::VectorDD& state, std::vector<bool>& outcomes,
+                       std::map<size_t, size_t>& histogram) {
+  if (outcomes.size() == targets.size()) {
+    if (ddsimRewindToStep(ddsim, step) == ERROR) {
+      throw std::runtime_error("Failed to restore the state for sampling.");
+    }
+    ddsim->checkpoints.discardFrom(step + 1, *ddsim->dd);
+    ddsim->measurementOutcomes.erase(
+        ddsim->measurementOutcomes.lower_bound(step),
+        ddsim->measurementOutcomes.end());
+    ddsim->measurementOutcomes[step] = outcomes;
+    if (ddsimStepForward(&ddsim->interface) == ERROR) {
+      throw std::runtime_error("Failed to simulate the program for sampling.");
+    }
+    sampleFrom(ddsim, shots, histogram);
+    return;
+  }
+
+  const auto qubit = static_cast<dd::Qubit>(targets[outcomes.size()]);
+  const auto [pZero, pOne] =
+      dd::Package::determineMeasurementProbabilities(state, qubit);
+  const auto total = pZero + pOne;
+  const auto normalizedZero =
+      total > 0 ? std::clamp(pZero / total, 0.0, 1.0) : 1.0;
+  std::binomial_distribution<size_t> split(shots, normalizedZero);
+  const auto zeroShots = split(ddsim->rng);
+
+  for (const auto measureZero : {true, false}) {
+    const auto branchShots = measureZero ? zeroShots : shots - zeroShots;
+    if (branchShots == 0) {
+      continue;
+    }
+    auto collapsed = state;
+    ddsim->dd->incRef(collapsed);
+    ddsim->dd->performCollapsingMeasurement(
+        collapsed, qubit, measureZero ? pZero : pOne, measureZero);
+    outcomes.push_back(measureZero);
+    sampleMeasurement(ddsim, branchShots, step, targets, collapsed, outcomes,
+                      histogram);
+    outcomes.pop_back();
+    ddsim->dd->decRef(collapsed);
+  }
+}
+
+/**
+ * @brief Sample the classical outcomes of the remaining program.
+ *
+ * Each simulated prefix is shared by all shots that reach it. At every
+ * measurement or reset, a checkpoint is taken and the shots are distributed
+ * over the possible outcomes, so that each branch resumes from the memoized
+ * post-measurement state instead of simulating the prefix again.
+ * @param ddsim The simulation state.
+ * @param shots The number of shots to sample.
+ * @param histogram The histogram to add the sampled outcomes to.
+ */
+void sampleFrom(DDSimulationState* ddsim, size_t shots,
+                std::map<size_t, size_t>& histogram) {
+  if (!runToNextMeasurement(ddsim)) {
+    histogram[readClassicalOutcome(ddsim)] += shots;
+    return;
+  }
+  const auto step = ddsim->previousInstructionStack.size();
+  const auto targets = (*ddsim->iterator)->getTargets();
+  captureCheckpoint(ddsim, step);
+  const auto state = getStateDD(ddsim);
+  ddsim->dd->incRef(state);
+  std::vector<bool> outcomes;
+  sampleMeasurement(ddsim, shots, step, targets, state, outcomes, histogram);
+  ddsim->dd->decRef(state);
+}
+
+/**
+ * Checks the given entanglement assertion on the given state.
+ * @param ddsim The simulation state.
+ * @param qubits The indices of the target qubits of the assertion.
+ * @return True if the assertion is satisfied, false otherwise.
+ */
+bool checkAssertionEntangled(DDSimulationState* ddsim,
+                             const std::vector<size_t>& qubits) {
+  // Entanglement is symmetric, so each unordered pair only has to be checked
+  // once.
+  for (size_t i = 0; i < qubits.size(); i++) {
+    for (size_t j = i + 1; j < qubits.size(); j++) {
+      if (qubits[i] == qubits[j]) {
+        continue;
+      }
+      if (!areQubitsEntangled(
+              getCachedTwoQubitDensityMatrix(ddsim, qubits[i], qubits[j]), 0,
+              1)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Checks the given superposition assertion on the given state.
+ * @param ddsim The simulation state.
+ * @param qubits The indices of the target qubits of the assertion.
+ * @return True if the assertion is satisfied, false otherwise.
+ */
+bool checkAssertionSuperposition(DDSimulationState* ddsim,
+                                 const std::vector<size_t>& qubits) {
+  if (usesDenseBackend(ddsim)) {
+    const auto amplitudes = getDenseState(ddsim);
+    return hasMultipleDenseOutcomes({amplitudes.data(), amplitudes.size()},
+                                    qubits);
+  }
+  return hasMultipleOutcomes(
+      ddsim->simulationState,
+      ddsim->interface.getNumQubits(&ddsim->interface), qubits);
+}
+
+/**
+ * Checks the given statevector-equality assertion on the given state.
+ * @param ddsim The simulation state.
+ * @param assertion The equality assertion to check.
+ * @param qubits The indices of the target qubits of the assertion.
+ * @return True if the assertion is satisfied, false otherwise.
+ */
+bool checkAssertionEqualityStatevector(
+    DDSimulationState* ddsim,
+    const StatevectorEqualityAssertion& assertion,
+    const std::vector<size_t>& qubits) {
+  const double similarityThreshold = assertion.getSimilarityThreshold();
+  const auto& target = assertion.getTargetStatevector();
+
+  // Whole registers and separable blocks of qubits are compared on the DD, so
+  // that the state does not have to be expanded. The dense backend extracts
+  // the sub-state from its amplitudes right away.
+  if (!usesDenseBackend(ddsim)) {
+    const auto ddSimilarity = computeSubStateSimilarity(
+        *ddsim->dd, ddsim->simulationState,
+        ddsim->interface.getNumQubits(&ddsim->interface), qubits, target);
+    if (ddSimilarity.has_value()) {
+      return *ddSimilarity >= similarityThreshold;
+    }
+  }
+
+  const auto denseAmplitudes = getSubStateDenseAmplitudes(ddsim, qubits.size());
+  if (!fitsDenseMemoryBudget(ddsim, denseAmplitudes)) {
+    throw std::runtime_error("Equality assertion exceeds the dense memory "
+                             "budget of the simulation state.");
+  }
+  Statevector sv;
+  sv.numQubits = qubits.size();
+  sv.numStates = 1ULL << sv.numQubits;
+  AmplitudeBuffer amplitudes(sv.numStates);
+  sv.amplitudes = amplitudes.data();
+
+  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
+                                         qubits.data(), &sv) == ERROR) {
+    throw std::runtime_error(
+        "Equality assertion on entangled sub-state is not allowed.");
+  }
+
+  const double similarity = dotProduct(sv, target);
+
+  return similarity >= similarityThreshold;
+}
+
+/**
+ * @brief Get the final state of the reference circuit of a circuit equality
+ * assertion.
+ *
+ * The reference circuit is only simulated the first time it is requested.
+ * Afterwards, its state is taken from the cache of the simulation state.
+ * @param ddsim The simulation state.
+ * @param assertion The circuit equality assertion.
+ * @param numTargets The number of target qubits of the assertion.
+ * @return The amplitudes of the reference state.
+ */
+AmplitudeBuffer& getReferenceState(DDSimulationState* ddsim,
+                                   const CircuitEqualityAssertion& assertion,
+                                   size_t numTargets) {
+  auto key = std::make_pair(assertion.getCircuitCode(), numTargets);
+  const auto found = ddsim->referenceStates.find(key);
+  if (found != ddsim->referenceStates.end()) {
+    return found->second;
+  }
+
+  DDSimulationState secondSimulation;
+  if (createDDSimulationState(&secondSimulation, ddsim->backend) == ERROR) {
+    throw std::runtime_error(
+        "Failed to initialize simulation for equality assertion.");
+  }
+  const DDSimulationStateGuard secondSimulationGuard(&secondSimulation);
+  const auto loadResult = secondSimulation.interface.loadCode(
+      &secondSimulation.interface, assertion.getCircuitCode().c_str());
+  if (loadResult.status != LOAD_OK) {
+    const auto* data = std::data(loadResult.message);
+    const std::string_view messageView(
+        data, boundedStrnlen(data, LOAD_RESULT_MESSAGE_MAX));
+    throw std::runtime_error(
+        !messageView.empty()
+            ? std::string(messageView)
+            : "Failed to load circuit for equality assertion.");
+  }
+  if (!secondSimulation.program->assertionInstructions.empty()) {
+    throw std::runtime_error(
+        "Circuit equality assertions cannot contain nested assertions");
+  }
+  secondSimulation.interface.runSimulation(&secondSimulation.interface);
+
+  Statevector sv;
+  sv.numQubits =
+      secondSimulation.interface.getNumQubits(&secondSimulation.interface);
+  sv.numStates = getNumAmplitudes(sv.numQubits);
+  const DenseMemoryReservation reservation(ddsim, sv.numStates);
+  if (!reservation.isGranted()) {
+    throw std::runtime_error(
+        "Reference circuit of equality assertion exceeds the dense memory "
+        "budget of the simulation state.");
+  }
+  AmplitudeBuffer amplitudes(sv.numStates);
+  sv.amplitudes = amplitudes.data();
+  secondSimulation.interface.getStateVectorFull(&secondSimulation.interface,
+                                                &sv);
+  return ddsim->referenceStates.emplace(std::move(key), std::move(amplitudes))
+      .first->second;
+}
+
+/**
+ * Checks the given circuit-equality assertion on the given state.
+ * @param ddsim The simulation state.
+ * @param assertion The equality assertion to check.
+ * @param qubits The indices of the target qubits of the assertion.
+ * @return True if the assertion is satisfied, false otherwise.
+ */
+bool checkAssertionEqualityCircuit(
+    DDSimulationState* ddsim,
+    const CircuitEqualityAssertion& assertion,
+    const std::vector<size_t>& qubits) {
+  auto& reference = getReferenceState(ddsim, assertion, qubits.size());
+  Statevector sv2;
+  sv2.numStates = reference.size();
+  sv2.numQubits = static_cast<size_t>(std::countr_zero(sv2.numStates));
+  sv2.amplitudes = reference.data();
+
+  const double similarityThreshold = assertion.getSimilarityThreshold();
+
+  if (!usesDenseBackend(ddsim)) {
+    const auto ddSimilarity = computeSubStateSimilarity(
+        *ddsim->dd, ddsim->simulationState,
+        ddsim->interface.getNumQubits(&ddsim->interface), qubits, sv2);
+    if (ddSimilarity.has_value()) {
+      return *ddSimilarity >= similarityThreshold;
+    }
+  }
+
+  const auto denseAmplitudes = getSubStateDenseAmplitudes(ddsim, qubits.size());
+  if (!fitsDenseMemoryBudget(ddsim, denseAmplitudes)) {
+    throw std::runtime_error("Equality assertion exceeds the dense memory "
+                             "budget of the simulation state.");
+  }
+  Statevector sv;
+  sv.numQubits = qubits.size();
+  sv.numStates = 1ULL << sv.numQubits;
+  AmplitudeBuffer amplitudes(sv.numStates);
+  sv.amplitudes = amplitudes.data();
+  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
+                                         qubits.data(), &sv) == ERROR) {
+    throw std::runtime_error(
+        "Equality assertion on entangled sub-state is not allowed.");
+  }
+
+  const double similarity = dotProduct(sv, sv2);
+
+  return similarity >= similarityThreshold;
+}
+
+/**
+ * @brief For an instruction that has a child block, extract the valid code from
+ * the block's body.
+ *
+ * Valid code is code that can be passed to the simulation backend. Assertions
+ * are removed.
+ * @param parent The parent instruction.
+ * @param allInstructions All instructions in the program.
+ * @return The extracted valid code.
+ */
+std::string validCodeFromChildren(const Instruction& parent,
+                                  std::vector<Instruction>& allInstructions) {
+  std::string code = parent.code;
+  if (!parent.block.valid) {
+    return code;
+  }
+  code += " { ";
+  for (auto child : parent.childInstructions) {
+    const auto& childInstruction = allInstructions[child];
+    if (childInstruction.assertion != nullptr) {
+      continue;
+    }
+    code += validCodeFromChildren(childInstruction, allInstructions);
+  }
+  code += " } ";
+  return code;
+}
+
+//----------------------------------------------------------------------------
+
+/**
+ * @brief Construct the preamble for a statistical slice equality assertion.
+ * @param assertion The assertion to construct the preamble for.
+ * @param targetNames The names of the target qubits.
+ * @return The constructed preamble.
+ */
+std::string getStatisticalSliceEqualityPreamble(
+    const StatevectorEqualityAssertion& assertion,
+    std::map<std::string, std::string>& targetNames) {
   std::stringstream ss;
-  const auto sv = Span<Complex>(assertion->getTargetStatevector().amplitudes,
-                                assertion->getTargetStatevector().numStates);
+  const auto sv = Span<Complex>(assertion.getTargetStatevector().amplitudes,
+                                assertion.getTargetStatevector().numStates);
+
+  // First target is rather straightforward.
+  ss << "// ASSERT: (";
+  for (size_t i = 0; i < assertion.getTargetQubits().size(); i++) {
+    ss << targetNames[assertion.getTargetQubits()[i]];
+    if (i != assertion.getTargetQubits().size() - 1) {
+      ss << ",";
+    }
+  }
+  ss << ") {";
+  for (size_t i = 0; i < assertion.getTargetStatevector().numStates; i++) {
+    ss << (sv[i].real * sv[i].real) + (sv[i].imaginary * sv[i].imaginary);
+    if (i != assertion.getTargetStatevector().numStates - 1) {
+      ss << ",";
+    }
+  }
+  ss << "} " << assertion.getSimilarityThreshold() << "\n";
+  return ss.str();
+}
+
+/**
+ * @brief Construct the preamble for a statistical slice superposition
+ * assertion.
+ * @param assertion The assertion to construct the preamble for.
+ * @param targetNames The names of the target qubits.
+ * @return The constructed preamble.
+ */
+std::string getStatisticalSliceSuperpositionPreamble(
+    const SuperpositionAssertion& assertion,
+    std::map<std::string, std::string>& targetNames) {
+  std::stringstream ss;
+  // First target is rather straightforward.
+  ss << "// ASSERT: (";
+  for (size_t i = 0; i < assertion.getTargetQubits().size(); i++) {
+    ss << targetNames[assertion.getTargetQubits()[i]];
+    if (i != assertion.getTargetQubits().size() - 1) {
+      ss << ",";
+    }
+  }
+  ss << ") {superposition}\n";
+  return ss.str();
+}
+
+/**
+ * @brief Construct the preamble for an assertion based
+ * on projective measurements.
+ * @param assertion The assertion to construct the preamble for.
+ * @param targetNames The names of the target qubits.
+ * @return The constructed preamble.
+ */
+std::string getProjectiveMeasurementPreamble(
+    const CircuitEqualityAssertion& assertion,
+    std::map<std::string, std::string>& targetNames) {
+  std::stringstream ss;
+  // First target is rather straightforward.
+  ss << "// ASSERT: (";
+  for (size_t i = 0; i < assertion.getTargetQubits().size(); i++) {
+    ss << targetNames[assertion.getTargetQubits()[i]];
+    if (i != assertion.getTargetQubits().size() - 1) {
+      ss << ",";
+    }
+  }
+  ss << ") {zero}\n";
+  return ss.str();
+}
+
+/**
+ * @brief Attempt to cancel an assertion based on all previously encountered
+ * assertions.
+ * @param ddsim The simulation state.
+ * @param newAssertion The index of the new assertion to check.
+ * @return True if the assertion can be cancelled, false otherwise.
+ */
+bool tryCancelAssertion(DDSimulationState* ddsim, size_t newAssertion) {
+  const auto& assertion =
+      ddsim->program->assertionInstructions.at(newAssertion);
+  for (size_t i = newAssertion - 1; i > 0; i--) {
+    if (ddsim->program->instructionTypes[i] != ASSERTION) {
+      if (!doesCommute(*assertion, ddsim->program->instructionObjects[i],
+                       ddsim->program->commutation[i])) {
+        return false;
+      }
+      continue;
+    }
+    const auto& potentialParent = ddsim->program->assertionInstructions.at(i);
+    if (potentialParent->implies(*assertion)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Check whether two given assertions are independent from each other.
+ * @param ddsim The simulation state.
+ * @param previousAssertion The previous assertion to compare to.
+ * @return True if the assertion can be cancelled, false otherwise.
+ */
+bool areAssertionsIndependent(DDSimulationState* ddsim,
+                              size_t previousAssertion, size_t newAssertion) {
+  if (ddsim->program->assertionInstructions.at(previousAssertion)->getType() ==
+      AssertionType::CircuitEquality) {
+    return true;
+  }
+  const auto& next = ddsim->program->assertionInstructions.at(newAssertion);
+
+  const auto nextQubits =
+      std::set(next->getTargetQubits().begin(), next->getTargetQubits().end());
+
+  for (size_t i = previousAssertion + 1; i < newAssertion; i++) {
+    if (ddsim->program->instructionTypes[i] == InstructionType::ASSERTION) {
+      continue;
+    }
+    const auto targets = ddsim->program->targetQubits[i];
+    if (std::ranges::any_of(targets, [&](const auto& target) {
+          return nextQubits.contains(target);
+        })) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Check whether multiple assertions are independent from each other.
+ * @param ddsim The simulation state.
+ * @param previousAssertions The previous assertions to compare to.
+ * @return True if the assertion can be cancelled, false otherwise.
+ */
+bool areAssertionsIndependent(DDSimulationState* ddsim,
+                              std::vector<size_t>& previousAssertions,
+                              size_t newAssertion) {
+  return std::ranges::all_of(previousAssertions, [&](const auto prev) {
+    return areAssertionsIndependent(ddsim, prev, newAssertion);
+  });
+}
+
+void setLoadResultMessage(LoadResult& result, const std::string& message) {
+  result.message[0] = '\0';
+  if (message.empty()) {
+    return;
+  }
+  const auto copyLen = std::min(
+      message.size(), static_cast<size_t>(LOAD_RESULT_MESSAGE_MAX - 1));
+  std::copy_n(message.data(), copyLen, std::begin(result.message));
+  result.message[LOAD_RESULT_MESSAGE_MAX - 1] = '\0';
+}
+
+LoadResult makeLoadResult(LoadResultStatus status, size_t line, size_t column,
+                          const std::string& message) {
+  LoadResult result{};
+  result.status = status;
+  result.line = line;
+  result.column = column;
+  setLoadResultMessage(result, message);
+  return result;
+}
 
-  // First target is rather straightforward.
-  ss << "// ASSERT: (";
-  for (size_t i = 0; i < assertion->getTargetQubits().size(); i++) {
-    ss << targetNames[assertion->getTargetQubits()[i]];
-    if (i != assertion->getTargetQubits().size() - 1) {
-      ss << ",";
+/**
+ * @brief Compile an assertion using projective measurements.
+ * @param ddsim The simulation state.
+ * @param stream The stream to write the compiled assertion to.
+ * @param assertionIndex The index of the compiled assertion.
+ * @param targetNames The names of the target qubits.
+ */
+void compileProjectiveMeasurement(
+    DDSimulationState* ddsim, std::stringstream& stream, size_t assertionIndex,
+    const std::map<std::string, std::string>& targetNames) {
+  const auto& assertion = dynamic_cast<CircuitEqualityAssertion&>(
+      *ddsim->program->assertionInstructions.at(assertionIndex).get());
+
+  std::stringstream codeStream{assertion.getCircuitCode()};
+  auto newQc = qasm3::Importer::import(codeStream);
+
+  newQc.unifyQuantumRegisters("assert_qubit");
+
+  qc::QubitIndexToRegisterMap qubitIndexToRegisterMap{};
+  const auto reg = newQc.getQuantumRegisters().begin()->second;
+  for (qc::Qubit i = 0; i < assertion.getTargetQubits().size(); i++) {
+    const auto& originalVariable = assertion.getTargetQubits()[i];
+    qubitIndexToRegisterMap.try_emplace(i, reg, originalVariable);
+  }
+
+  for (auto& it : std::ranges::reverse_view(newQc)) {
+    const auto inverted = it->getInverted();
+    inverted->dumpOpenQASM2(stream, qubitIndexToRegisterMap, {});
+  }
+
+  for (const auto& [qbit, cbit] : targetNames) {
+    stream << "measure " << qbit << " -> " << cbit << "[0];\n";
+  }
+
+  for (auto& it : newQc) {
+    it->dumpOpenQASM2(stream, qubitIndexToRegisterMap, {});
+  }
+}
+
+/**
+ * @brief Resolve a target of an instruction in the given scope.
+ *
+ * Full registers are expanded into references to each of their qubits.
+ * @param program The program containing the instruction.
+ * @param scope The custom gate definition enclosing the instruction, or -1 for
+ * the global scope.
+ * @param target The target to resolve.
+ * @return The references to the qubits denoted by the target.
+ */
+std::vector<QubitReference> resolveInScope(const DDSimProgram& program,
+                                           size_t scope,
+                                           const std::string& target) {
+  const auto name = removeWhitespace(target);
+  if (scope != -1ULL) {
+    const auto& parameters = program.targetQubits[scope];
+    for (size_t i = 0; i < parameters.size(); i++) {
+      if (removeWhitespace(parameters[i]) == name) {
+        return {{.kind = QubitReferenceKind::Parameter, .index = i}};
+      }
     }
   }
-  ss << ") {";
-  for (size_t i = 0; i < assertion->getTargetStatevector().numStates; i++) {
-    ss << (sv[i].real * sv[i].real) + (sv[i].imaginary * sv[i].imaginary);
-    if (i != assertion->getTargetStatevector().numStates - 1) {
-      ss << ",";
+
+  const auto bracket = name.find('[');
+  const auto registerName = name.substr(0, bracket);
+  const auto found = std::ranges::find_if(
+      program.qubitRegisters,
+      [&registerName](const auto& reg) { return reg.name == registerName; });
+  if (found == program.qubitRegisters.end()) {
+    return {{.kind = QubitReferenceKind::Invalid, .index = 0}};
+  }
+  if (bracket == std::string::npos) {
+    std::vector<QubitReference> result;
+    for (size_t i = 0; i < found->size; i++) {
+      result.push_back(
+          {.kind = QubitReferenceKind::Qubit, .index = found->index + i});
+    }
+    return result;
+  }
+  const auto digits = name.substr(bracket + 1, name.size() - bracket - 2);
+  const auto isIndex =
+      !digits.empty() && name.back() == ']' &&
+      std::ranges::all_of(digits, [](unsigned char c) {
+        return std::isdigit(c) != 0;
+      });
+  const auto index = isIndex ? std::stoul(digits) : found->size;
+  if (index >= found->size) {
+    return {{.kind = QubitReferenceKind::Invalid, .index = 0}};
+  }
+  return {{.kind = QubitReferenceKind::Qubit, .index = found->index + index}};
+}
+
+/**
+ * @brief Resolve the targets of all instructions and the arguments of all
+ * custom gate calls to qubit references.
+ * @param program The program to resolve the references of.
+ */
+void buildQubitResolutionTables(DDSimProgram& program) {
+  const auto count = program.instructionTypes.size();
+  program.instructionQubits.assign(count, {});
+  program.callArguments.assign(count, {});
+
+  size_t scope = -1ULL;
+  for (size_t i = 0; i < count; i++) {
+    if ((program.instructionFlags[i] & FUNCTION_DEFINITION) != 0) {
+      scope = i;
+    }
+
+    const auto foundAssertion = program.assertionInstructions.find(i);
+    const auto& targets = foundAssertion != program.assertionInstructions.end()
+                              ? foundAssertion->second->getTargetQubits()
+                              : program.targetQubits[i];
+    for (const auto& target : targets) {
+      const auto references = resolveInScope(program, scope, target);
+      program.instructionQubits[i].insert(program.instructionQubits[i].end(),
+                                          references.begin(), references.end());
+    }
+
+    if (program.instructionTypes[i] == CALL) {
+      const auto function = program.successorInstructions[i] - 1;
+      const auto& substitution = program.callSubstitutions[i];
+      for (const auto& parameter : program.targetQubits[function]) {
+        const auto argument = substitution.find(parameter);
+        auto references =
+            argument == substitution.end()
+                ? std::vector<QubitReference>{}
+                : resolveInScope(program, scope, argument->second);
+        program.callArguments[i].push_back(
+            references.size() == 1
+                ? references.front()
+                : QubitReference{.kind = QubitReferenceKind::Invalid,
+                                 .index = 0});
+      }
+    }
+
+    if (program.instructionTypes[i] == RETURN) {
+      scope = -1ULL;
+    }
+  }
+}
+
+/**
+ * @brief Build the index of static interactions between qubits.
+ *
+ * Each custom gate definition starts a new scope, as interactions are only
+ * searched back to the closest enclosing definition. The qubit resolution
+ * tables have to be built first.
+ * @param program The program to build the index for.
+ */
+void buildInteractionIndex(DDSimProgram& program) {
+  program.interactions.clear();
+  program.interactions.beginScope(0);
+  for (size_t i = 0; i < program.instructionTypes.size(); i++) {
+    if ((program.instructionFlags[i] & FUNCTION_DEFINITION) != 0) {
+      program.interactions.beginScope(i + 1);
+      continue;
+    }
+    if (program.instructionTypes[i] != SIMULATE &&
+        program.instructionTypes[i] != CALL) {
+      continue;
+    }
+    std::set<size_t> qubits;
+    for (const auto& reference : program.instructionQubits[i]) {
+      if (reference.kind != QubitReferenceKind::Invalid) {
+        qubits.insert(reference.index);
+      }
+    }
+    program.interactions.addInteraction(
+        i, std::vector<size_t>(qubits.begin(), qubits.end()));
+  }
+}
+
+/**
+ * @brief Collect the instructions inside a custom gate that a call depends on
+ * through one of its arguments.
+ *
+ * This is the last instruction of the gate that uses the corresponding
+ * parameter. If that instruction is a call itself, the instructions it depends
+ * on through the parameter are collected as well.
+ * @param program The program containing the call.
+ * @param call The index of the call instruction.
+ * @param argument The index of the argument in the call's argument list.
+ * @param dependencies The vector to add the dependencies to.
+ */
+void collectCallDependencies(const DDSimProgram& program, size_t call,
+                             size_t argument,
+                             std::vector<size_t>& dependencies) {
+  const auto gateStart = program.successorInstructions[call];
+  const auto& parameters = program.targetQubits[gateStart - 1];
+  if (argument >= parameters.size()) {
+    return;
+  }
+  const auto& parameter = parameters[argument];
+  auto instruction = gateStart;
+  while (program.instructionTypes[instruction] != RETURN) {
+    instruction++;
+  }
+  while (instruction >= gateStart) {
+    const auto& targets = program.targetQubits[instruction];
+    const auto found = std::ranges::find(targets, parameter);
+    if (program.instructionTypes[instruction] != RETURN &&
+        found != targets.end()) {
+      dependencies.push_back(instruction);
+      if (program.instructionTypes[instruction] == CALL) {
+        collectCallDependencies(
+            program, instruction,
+            static_cast<size_t>(std::distance(targets.begin(), found)),
+            dependencies);
+      }
+      return;
+    }
+    if (instruction == 0) {
+      return;
+    }
+    instruction--;
+  }
+}
+
+/**
+ * @brief Build the index of data dependencies between instructions.
+ *
+ * Variable declarations are not counted as dependencies.
+ * @param program The program to build the index for.
+ */
+void buildDependencyIndex(DDSimProgram& program) {
+  const auto count = program.instructionTypes.size();
+  std::vector<std::vector<size_t>> dependencies(count);
+  std::vector<size_t> scopes(count);
+  size_t scope = -1ULL;
+  for (size_t i = 0; i < count; i++) {
+    scopes[i] = scope;
+    if ((program.instructionFlags[i] & FUNCTION_DEFINITION) != 0) {
+      scope = i;
+    } else if (program.instructionTypes[i] == RETURN) {
+      scope = -1ULL;
+    }
+
+    const auto found = program.dataDependencies.find(i);
+    if (found == program.dataDependencies.end()) {
+      continue;
+    }
+    for (const auto& [dependency, argument] : found->second) {
+      if (program.instructionTypes[dependency] == NOP) {
+        continue;
+      }
+      dependencies[i].push_back(dependency);
+      if (program.instructionTypes[dependency] == CALL) {
+        collectCallDependencies(program, dependency, argument,
+                                dependencies[i]);
+      }
+    }
+  }
+  program.dependencies.build(dependencies, std::move(scopes),
+                             program.functionCallers);
+}
+
+/**
+ * @brief A statistical slice of an assertion program.
+ */
+struct StatisticalSlice {
+  /**
+   * @brief The instruction indices of the assertions covered by the slice.
+   */
+  std::vector<size_t> assertions;
+  /**
+   * @brief The number of leading assertions whose code is removed from the
+   * program. The slice ends where the last of them was placed.
+   */
+  size_t removedAssertions;
+};
+
+/**
+ * @brief Partition the assertions of the program into statistical slices.
+ *
+ * Each assertion is analysed exactly once. With optimization level 1 or
+ * higher, assertions implied by previous ones are skipped. With level 2 or
+ * higher, consecutive independent assertions share a slice.
+ * @param ddsim The simulation state.
+ * @param opt The optimization level.
+ * @return The slices in the order of their slice index.
+ */
+std::vector<StatisticalSlice>
+partitionStatisticalSlices(DDSimulationState* ddsim, uint8_t opt) {
+  std::vector<StatisticalSlice> slices;
+  std::vector<size_t> assertionsToCover;
+  size_t removedAssertions = 0;
+  for (size_t i = 0; i < ddsim->program->instructionTypes.size(); i++) {
+    if (ddsim->program->instructionTypes[i] != ASSERTION) {
+      continue;
+    }
+    removedAssertions++;
+    if (opt >= 1 && tryCancelAssertion(ddsim, i)) {
+      continue;
+    }
+    if (opt < 2) {
+      slices.push_back({.assertions = {i},
+                        .removedAssertions = removedAssertions});
+      continue;
+    }
+    if (!areAssertionsIndependent(ddsim, assertionsToCover, i)) {
+      slices.push_back({.assertions = std::move(assertionsToCover),
+                        .removedAssertions = removedAssertions});
+      assertionsToCover.clear();
+    }
+    assertionsToCover.emplace_back(i);
+  }
+  if (!assertionsToCover.empty()) {
+    slices.push_back({.assertions = std::move(assertionsToCover),
+                      .removedAssertions = removedAssertions});
+  }
+  return slices;
+}
+
+/**
+ * @brief The names of the classical registers measuring the targets of each
+ * assertion of a slice, by the instruction index of the assertion.
+ */
+using SliceTargetNames = std::map<size_t, std::map<std::string, std::string>>;
+
+/**
+ * @brief Determine the measurement targets required for the assertions of a
+ * statistical slice.
+ * @param ddsim The simulation state.
+ * @param slice The slice to determine the targets of.
+ * @return The names of the classical registers of each target.
+ */
+SliceTargetNames getSliceTargetNames(DDSimulationState* ddsim,
+                                     const StatisticalSlice& slice) {
+  SliceTargetNames assertionTargets;
+  std::set<std::string> assertionTargetsSet;
+  for (const auto foundIndex : slice.assertions) {
+    const auto& assertion =
+        *ddsim->program->assertionInstructions.at(foundIndex);
+    for (const auto& target : assertion.getTargetQubits()) {
+      std::string targetName =
+          "test_" + replaceString(replaceString(target, "]", ""), "[", "");
+      while (assertionTargetsSet.contains(targetName)) {
+        targetName += "_";
+      }
+      assertionTargets[foundIndex][target] = targetName;
+      assertionTargetsSet.insert(targetName);
+    }
+  }
+  return assertionTargets;
+}
+
+/**
+ * @brief Construct the preamble of a statistical slice, consisting of one
+ * `// ASSERT:` line per assertion.
+ * @param ddsim The simulation state.
+ * @param slice The slice to construct the preamble for.
+ * @param assertionTargets The names of the measurement targets.
+ * @return The constructed preamble.
+ */
+std::string getSlicePreamble(DDSimulationState* ddsim,
+                             const StatisticalSlice& slice,
+                             SliceTargetNames& assertionTargets) {
+  std::string preamble;
+  for (const auto foundIndex : slice.assertions) {
+    const auto& assertion =
+        *ddsim->program->assertionInstructions.at(foundIndex);
+    auto& targetNames = assertionTargets[foundIndex];
+    if (assertion.getType() == AssertionType::StatevectorEquality) {
+      preamble += getStatisticalSliceEqualityPreamble(
+          dynamic_cast<const StatevectorEqualityAssertion&>(assertion),
+          targetNames);
+    } else if (assertion.getType() == AssertionType::Superposition) {
+      preamble += getStatisticalSliceSuperpositionPreamble(
+          dynamic_cast<const SuperpositionAssertion&>(assertion), targetNames);
+    } else if (assertion.getType() == AssertionType::CircuitEquality) {
+      preamble += getProjectiveMeasurementPreamble(
+          dynamic_cast<const CircuitEqualityAssertion&>(assertion),
+          targetNames);
+    }
+  }
+  return preamble;
+}
+
+/**
+ * @brief Write the code of a statistical slice.
+ * @param ddsim The simulation state.
+ * @param slice The slice to write.
+ * @param assertions The instruction indices of all assertions.
+ * @param segments The code preceding each assertion, starting after the
+ * previous one.
+ * @param ss The stream to write to.
+ */
+void writeStatisticalSlice(DDSimulationState* ddsim,
+                           const StatisticalSlice& slice,
+                           const std::vector<size_t>& assertions,
+                           const std::vector<std::string_view>& segments,
+                           std::stringstream& ss) {
+  auto assertionTargets = getSliceTargetNames(ddsim, slice);
+  ss << getSlicePreamble(ddsim, slice, assertionTargets);
+
+  // Add the remaining code.
+  for (size_t i = 0; i < slice.removedAssertions; i++) {
+    const auto toSkip = assertions[i];
+    ss << segments[i];
+    if (!assertionTargets.contains(toSkip)) {
+      continue;
+    }
+    // Add the required classical registers.
+    for (const auto& [_, cbit] : assertionTargets[toSkip]) {
+      ss << "creg " << cbit << "[1];\n";
+    }
+    if (ddsim->program->assertionInstructions.at(toSkip)->getType() ==
+        AssertionType::CircuitEquality) {
+      compileProjectiveMeasurement(ddsim, ss, toSkip, assertionTargets[toSkip]);
+    } else {
+      for (const auto& [qbit, cbit] : assertionTargets[toSkip]) {
+        ss << "measure " << qbit << " -> " << cbit << "[0];\n";
+      }
+    }
+  }
+}
+
+/**
+ * @brief Get the statistical slices of the loaded program, compiling all of
+ * them if they are not cached for the given optimization level yet.
+ *
+ * The code between two consecutive assertions is located once and shared by
+ * all slices.
+ * @param ddsim The simulation state.
+ * @param opt The optimization level.
+ * @return The compiled slices.
+ */
+const CompiledSlices& getCompiledSlices(DDSimulationState* ddsim,
+                                        uint8_t opt) {
+  if (ddsim->compiledSlices.has_value() && ddsim->compiledSlices->opt == opt) {
+    return *ddsim->compiledSlices;
+  }
+
+  std::vector<size_t> assertions;
+  std::vector<std::string_view> segments;
+  const std::string_view code = ddsim->program->code;
+  size_t last = 0;
+  for (size_t i = 0; i < ddsim->program->instructionTypes.size(); i++) {
+    if (ddsim->program->instructionTypes[i] != ASSERTION) {
+      continue;
+    }
+    size_t start = 0;
+    size_t end = 0;
+    ddsim->interface.getInstructionPosition(&ddsim->interface, i, &start,
+                                            &end);
+    assertions.push_back(i);
+    segments.push_back(code.substr(last, start - last));
+    last = end + 1;
+    if (last < code.size() && code[last] == '\n') {
+      last++;
+    }
+  }
+
+  CompiledSlices compiled{.opt = opt, .arena = "", .offsets = {}};
+  for (const auto& slice : partitionStatisticalSlices(ddsim, opt)) {
+    std::stringstream ss;
+    writeStatisticalSlice(ddsim, slice, assertions, segments, ss);
+    compiled.offsets.push_back(compiled.arena.size());
+    compiled.arena += ss.str();
+    compiled.arena.push_back('\0');
+  }
+  ddsim->compiledSlices = std::move(compiled);
+  return *ddsim->compiledSlices;
+}
+
+/**
+ * @brief The position of an assertion in the circuit of the program.
+ */
+struct AssertionPlacement {
+  /**
+   * @brief The number of operations executed before the assertion.
+   */
+  size_t operationsBefore;
+  /**
+   * @brief The qubit denoted by each target of the assertion.
+   */
+  std::map<std::string, qc::Qubit> targetQubits;
+};
+
+/**
+ * @brief Place each assertion in the circuit of the program at the point it
+ * is reached for the first time.
+ *
+ * The instructions are followed in execution order, so that the operations of
+ * custom gate calls are counted where they are applied and the targets of
+ * assertions inside custom gates refer to the arguments of the first call.
+ * @param program The program to analyse.
+ * @return The placement of each reached assertion.
+ * @throws std::invalid_argument If the target of an assertion cannot be
+ * resolved.
+ */
+std::map<size_t, AssertionPlacement>
+placeAssertions(const DDSimProgram& program) {
+  std::map<size_t, AssertionPlacement> placements;
+  std::vector<size_t> callStack;
+  size_t operations = 0;
+  size_t instruction = 0;
+  while (instruction < program.instructionTypes.size()) {
+    const auto type = program.instructionTypes[instruction];
+    if (type == SIMULATE) {
+      operations++;
+    } else if (type == ASSERTION && !placements.contains(instruction)) {
+      const auto& names =
+          program.assertionInstructions.at(instruction)->getTargetQubits();
+      const auto& references = program.instructionQubits[instruction];
+      if (references.size() != names.size()) {
+        throw std::invalid_argument(
+            "Assertion targets must denote single qubits.");
+      }
+      auto& placement = placements[instruction];
+      placement.operationsBefore = operations;
+      for (size_t i = 0; i < names.size(); i++) {
+        auto reference = references[i];
+        auto frame = callStack.size();
+        while (reference.kind == QubitReferenceKind::Parameter && frame > 0) {
+          frame--;
+          reference = program.callArguments[callStack[frame]][reference.index];
+        }
+        if (reference.kind != QubitReferenceKind::Qubit) {
+          throw std::invalid_argument("Unknown variable name " + names[i]);
+        }
+        placement.targetQubits[names[i]] =
+            static_cast<qc::Qubit>(reference.index);
+      }
+    }
+    auto next = program.successorInstructions[instruction];
+    if (next == 0) {
+      if (callStack.empty()) {
+        break;
+      }
+      next = callStack.back() + 1;
+      callStack.pop_back();
+    }
+    if (type == CALL) {
+      callStack.push_back(instruction);
+    }
+    instruction = next;
+  }
+  return placements;
+}
+
+/**
+ * @brief Append the measurements checking an assertion to the circuit of a
+ * statistical slice.
+ *
+ * Assertions based on projective measurements are checked by undoing their
+ * circuit before the measurements and applying it again afterwards, in the
+ * same way as in the code of the slice.
+ * @param assertion The assertion to check.
+ * @param circuit The circuit to append the measurements to.
+ * @param placement The placement of the assertion.
+ * @param targetBits The classical bit measuring each target.
+ */
+void appendSliceMeasurements(const Assertion& assertion,
+                             qc::QuantumComputation& circuit,
+                             const AssertionPlacement& placement,
+                             const std::map<std::string, qc::Bit>& targetBits) {
+  if (assertion.getType() != AssertionType::CircuitEquality) {
+    for (const auto& [qbit, cbit] : targetBits) {
+      circuit.measure(placement.targetQubits.at(qbit), cbit);
+    }
+    return;
+  }
+
+  std::stringstream codeStream{
+      dynamic_cast<const CircuitEqualityAssertion&>(assertion)
+          .getCircuitCode()};
+  auto assertionQc = qasm3::Importer::import(codeStream);
+  qc::CircuitOptimizer::flattenOperations(assertionQc, true);
+  qc::Permutation permutation;
+  for (qc::Qubit i = 0; i < assertion.getTargetQubits().size(); i++) {
+    permutation[i] =
+        placement.targetQubits.at(assertion.getTargetQubits()[i]);
+  }
+
+  for (const auto& op : std::ranges::reverse_view(assertionQc)) {
+    auto inverted = op->getInverted();
+    inverted->apply(permutation);
+    circuit.emplace_back(std::move(inverted));
+  }
+  for (const auto& [qbit, cbit] : targetBits) {
+    circuit.measure(placement.targetQubits.at(qbit), cbit);
+  }
+  for (const auto& op : assertionQc) {
+    auto mapped = op->clone();
+    mapped->apply(permutation);
+    circuit.emplace_back(std::move(mapped));
+  }
+}
+
+/**
+ * @brief Build the circuit of a statistical slice from the operations of the
+ * imported program.
+ * @param program The program to build the slice from.
+ * @param slice The slice to build.
+ * @param assertions The instruction indices of all assertions.
+ * @param assertionTargets The names of the measurement targets.
+ * @param placements The placement of each assertion.
+ * @return The circuit of the slice.
+ */
+qc::QuantumComputation
+buildSliceCircuit(const DDSimProgram& program, const StatisticalSlice& slice,
+                  const std::vector<size_t>& assertions,
+                  const SliceTargetNames& assertionTargets,
+                  const std::map<size_t, AssertionPlacement>& placements) {
+  qc::QuantumComputation circuit;
+  for (const auto& reg : program.qubitRegisters) {
+    circuit.addQubitRegister(reg.size, reg.name);
+  }
+  for (const auto& reg : program.classicalRegisters) {
+    circuit.addClassicalRegister(reg.size, reg.name);
+  }
+
+  const auto& operations = *program.qc;
+  const auto numOperations = operations.getNops();
+  size_t next = 0;
+  for (size_t i = 0; i < slice.removedAssertions; i++) {
+    const auto toSkip = assertions[i];
+    const auto found = placements.find(toSkip);
+    const auto end = found == placements.end() ? numOperations
+                                               : found->second.operationsBefore;
+    for (; next < end; next++) {
+      circuit.emplace_back(operations.at(next)->clone());
+    }
+    const auto targets = assertionTargets.find(toSkip);
+    if (targets == assertionTargets.end() || found == placements.end()) {
+      continue;
+    }
+    std::map<std::string, qc::Bit> targetBits;
+    for (const auto& [qbit, cbit] : targets->second) {
+      targetBits[qbit] = static_cast<qc::Bit>(circuit.getNcbits());
+      circuit.addClassicalRegister(1, cbit);
+    }
+    appendSliceMeasurements(*program.assertionInstructions.at(toSkip),
+                            circuit, found->second, targetBits);
+  }
+  return circuit;
+}
+
+/**
+ * @brief Parse the given code and report the outcome as a `LoadResult`.
+ * @param code The code to parse.
+ * @param program The parsed program. Only set if parsing succeeds.
+ * @return The result of the load operation.
+ */
+LoadResult tryParseProgram(const char* code,
+                           std::shared_ptr<const DDSimProgram>& program) {
+  try {
+    program = parseDDSimProgram(code);
+  } catch (const ParsingError& e) {
+    return makeLoadResult(LOAD_PARSE_ERROR, e.line(), e.column(), e.detail());
+  } catch (const std::exception& e) {
+    std::string message = e.what();
+    if (message.empty()) {
+      message = "An error occurred while executing the operation";
     }
+    return makeLoadResult(LOAD_INTERNAL_ERROR, 0, 0, message);
+  } catch (...) {
+    return makeLoadResult(LOAD_INTERNAL_ERROR, 0, 0,
+                          "An error occurred while executing the operation");
+  }
+  return makeLoadResult(LOAD_OK, 0, 0, "");
+}
+
+/**
+ * @brief Check whether the backend of a simulation state can simulate a
+ * program.
+ * @param ddsim The simulation state.
+ * @param program The program to check.
+ * @return A successful result, or an error describing why the program cannot
+ * be simulated.
+ */
+LoadResult checkBackendSupport(const DDSimulationState* ddsim,
+                               const DDSimProgram& program) {
+  if (usesDenseBackend(ddsim) &&
+      program.qc->getNqubits() > MAX_DENSE_BACKEND_QUBITS) {
+    return makeLoadResult(LOAD_INTERNAL_ERROR, 0, 0,
+                          "The dense backend supports at most " +
+                              std::to_string(MAX_DENSE_BACKEND_QUBITS) +
+                              " qubits.");
   }
-  ss << "} " << assertion->getSimilarityThreshold() << "\n";
-  return ss.str();
+  return makeLoadResult(LOAD_OK, 0, 0, "");
 }
 
 /**
- * @brief Construct the preamble for a statistical slice superposition
- * assertion.
- * @param assertion The assertion to construct the preamble for.
- * @param targetNames The names of the target qubits.
- * @return The constructed preamble.
+ * @brief Replace the instruction flags of the simulation state by the flags of
+ * a new program.
+ *
+ * Breakpoints are kept, all other flags are taken from the program.
+ * @param ddsim The simulation state.
+ * @param program The new program.
  */
-std::string getStatisticalSliceSuperpositionPreamble(
-    std::unique_ptr<SuperpositionAssertion>& assertion,
-    std::map<std::string, std::string>& targetNames) {
-  std::stringstream ss;
-  // First target is rather straightforward.
-  ss << "// ASSERT: (";
-  for (size_t i = 0; i < assertion->getTargetQubits().size(); i++) {
-    ss << targetNames[assertion->getTargetQubits()[i]];
-    if (i != assertion->getTargetQubits().size() - 1) {
-      ss << ",";
-    }
+void takeInstructionFlags(DDSimulationState* ddsim,
+                          const DDSimProgram& program) {
+  auto flags = program.instructionFlags;
+  const auto keptFlags = std::min(flags.size(), ddsim->instructionFlags.size());
+  for (size_t i = 0; i < keptFlags; i++) {
+    flags[i] |= static_cast<uint8_t>(ddsim->instructionFlags[i] & BREAKPOINT);
   }
-  ss << ") {superposition}\n";
-  return ss.str();
+  ddsim->instructionFlags = std::move(flags);
 }
 
 /**
- * @brief Construct the preamble for an assertion based
- * on projective measurements.
- * @param assertion The assertion to construct the preamble for.
- * @param targetNames The names of the target qubits.
- * @return The constructed preamble.
+ * @brief Find the first instruction that differs between two programs.
+ * @param previous The previously loaded program.
+ * @param next The new program.
+ * @return The index of the first instruction that differs. If one program is
+ * a prefix of the other, this is the instruction count of the shorter one.
  */
-std::string getProjectiveMeasurementPreamble(
-    std::unique_ptr<CircuitEqualityAssertion>& assertion,
-    std::map<std::string, std::string>& targetNames) {
-  std::stringstream ss;
-  // First target is rather straightforward.
-  ss << "// ASSERT: (";
-  for (size_t i = 0; i < assertion->getTargetQubits().size(); i++) {
-    ss << targetNames[assertion->getTargetQubits()[i]];
-    if (i != assertion->getTargetQubits().size() - 1) {
-      ss << ",";
+size_t findFirstChangedInstruction(const DDSimProgram& previous,
+                                   const DDSimProgram& next) {
+  const auto count = std::min(previous.instructionObjects.size(),
+                              next.instructionObjects.size());
+  for (size_t i = 0; i < count; i++) {
+    if (previous.instructionTypes[i] != next.instructionTypes[i] ||
+        previous.instructionObjects[i].code !=
+            next.instructionObjects[i].code) {
+      return i;
     }
   }
-  ss << ") {zero}\n";
-  return ss.str();
+  return count;
 }
 
 /**
- * @brief Attempt to cancel an assertion based on all previously encountered
- * assertions.
+ * @brief Find the number of executed steps that are not affected by an edit.
+ *
+ * All instructions executed by these steps and the instruction executed next
+ * have to lie before the first changed instruction. The instruction executed
+ * next is required to be unchanged, as it has been determined by the control
+ * flow of the previous program.
  * @param ddsim The simulation state.
- * @param newAssertion The index of the new assertion to check.
- * @return True if the assertion can be cancelled, false otherwise.
+ * @param firstChange The index of the first changed instruction.
+ * @return The number of steps that can be kept.
  */
-bool tryCancelAssertion(DDSimulationState* ddsim, size_t newAssertion) {
-  const auto& assertion = ddsim->assertionInstructions[newAssertion];
-  for (size_t i = newAssertion - 1; i > 0; i--) {
-    if (ddsim->instructionTypes[i] != ASSERTION) {
-      if (!doesCommute(assertion, ddsim->instructionObjects[i])) {
-        return false;
-      }
-      continue;
-    }
-    const auto& potentialParent = ddsim->assertionInstructions[i];
-    if (potentialParent->implies(*assertion)) {
-      return true;
+size_t findReusableSteps(const DDSimulationState* ddsim, size_t firstChange) {
+  const auto& history = ddsim->previousInstructionStack;
+  size_t steps = 0;
+  while (steps < history.size() && history[steps] < firstChange) {
+    steps++;
+  }
+  if (steps == history.size() && ddsim->currentInstruction < firstChange) {
+    return steps;
+  }
+  return steps == 0 ? 0 : steps - 1;
+}
+
+/**
+ * @brief Translate classical bits to the layout of a new program.
+ *
+ * Bits of the previous program keep their values if the new program declares
+ * a bit of the same name, and are dropped otherwise. All other bits of the new
+ * program receive their initial values.
+ * @param bits The classical bits to translate.
+ * @param previous The previously loaded program.
+ * @param next The new program.
+ * @return The translated classical bits.
+ */
+ClassicalBits translateClassicalBits(const ClassicalBits& bits,
+                                     const DDSimProgram& previous,
+                                     const DDSimProgram& next) {
+  ClassicalBits result(getClassicalBitWords(next), 0);
+  for (const auto& [name, index] : previous.variableIndices) {
+    const auto found = next.variableIndices.find(name);
+    if (found != next.variableIndices.end()) {
+      setClassicalBit(result, found->second, getClassicalBit(bits, index));
     }
   }
-  return false;
+  return result;
 }
 
 /**
- * @brief Check whether two given assertions are independent from each other.
+ * @brief Forget the state reported by the last call to `getStateDelta`, so
+ * that the next call reports the complete state.
+ *
+ * Versions that were already issued are not reused.
  * @param ddsim The simulation state.
- * @param previousAssertion The previous assertion to compare to.
- * @return True if the assertion can be cancelled, false otherwise.
  */
-bool areAssertionsIndependent(DDSimulationState* ddsim,
-                              size_t previousAssertion, size_t newAssertion) {
-  if (ddsim->assertionInstructions[previousAssertion]->getType() ==
-      AssertionType::CircuitEquality) {
-    return true;
-  }
-  const auto& next = ddsim->assertionInstructions[newAssertion];
+void discardDeltaBaseline(DDSimulationState* ddsim) {
+  auto& baseline = ddsim->deltaBaseline;
+  baseline.version = 0;
+  baseline.classicalBits.clear();
+  baseline.stateVersion = 0;
+  baseline.amplitudes = AmplitudeBuffer{};
+}
 
-  const auto nextQubits =
-      std::set(next->getTargetQubits().begin(), next->getTargetQubits().end());
+/**
+ * @brief Report the amplitudes that changed since the last call to
+ * `getStateDelta` and keep the current amplitudes for the next call.
+ * @param ddsim The simulation state.
+ * @param complete True if all amplitudes should be reported.
+ * @param output The delta to add the amplitudes to.
+ */
+void reportChangedAmplitudes(DDSimulationState* ddsim, bool complete,
+                             StateDelta& output) {
+  auto& baseline = ddsim->deltaBaseline;
+  const auto* current = getCachedStateVector(ddsim);
+  if (current == nullptr) {
+    output.amplitudesComplete = true;
+    output.amplitudesTruncated = true;
+    baseline.amplitudes = AmplitudeBuffer{};
+    return;
+  }
+  const auto relative =
+      !complete && baseline.amplitudes.size() == current->size();
+  output.amplitudesComplete = !relative;
+  if (relative && baseline.stateVersion == ddsim->stateVersion) {
+    return;
+  }
 
-  for (size_t i = previousAssertion + 1; i < newAssertion; i++) {
-    if (ddsim->instructionTypes[i] == InstructionType::ASSERTION) {
+  const Span<size_t> indices(output.amplitudeIndices, output.maxAmplitudes);
+  const Span<Complex> values(output.amplitudes, output.maxAmplitudes);
+  for (size_t i = 0; i < current->size(); i++) {
+    const auto& amplitude = (*current)[i];
+    auto real = amplitude.real;
+    auto imaginary = amplitude.imaginary;
+    if (relative) {
+      real -= baseline.amplitudes[i].real;
+      imaginary -= baseline.amplitudes[i].imaginary;
+    }
+    if (std::hypot(real, imaginary) <= output.amplitudeTolerance) {
       continue;
     }
-    const auto targets = ddsim->targetQubits[i];
-    if (std::ranges::any_of(targets, [&](const auto& target) {
-          return nextQubits.contains(target);
-        })) {
-      return false;
+    if (output.numAmplitudes == output.maxAmplitudes) {
+      output.amplitudesTruncated = true;
+      break;
     }
+    indices[output.numAmplitudes] = i;
+    values[output.numAmplitudes] = amplitude;
+    output.numAmplitudes++;
   }
 
-  return true;
+  // The previous copy is released first, so that it does not count towards
+  // the budget of the new one.
+  baseline.amplitudes = AmplitudeBuffer{};
+  if (fitsDenseMemoryBudget(ddsim, current->size())) {
+    baseline.amplitudes = *current;
+    ddsim->peakDenseMemory =
+        std::max(ddsim->peakDenseMemory,
+                 ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim));
+  }
+  baseline.stateVersion = ddsim->stateVersion;
 }
 
 /**
- * @brief Check whether multiple assertions are independent from each other.
+ * @brief Continue the current simulation with an edited program.
+ *
+ * The simulation state must not have executed any instruction that differs
+ * between the two programs. The state, history, and kept checkpoints are
+ * carried over, while everything derived from later instructions is dropped.
  * @param ddsim The simulation state.
- * @param previousAssertions The previous assertions to compare to.
- * @return True if the assertion can be cancelled, false otherwise.
+ * @param program The edited program.
  */
-bool areAssertionsIndependent(DDSimulationState* ddsim,
-                              std::vector<size_t>& previousAssertions,
-                              size_t newAssertion) {
-  return std::ranges::all_of(previousAssertions, [&](const auto prev) {
-    return areAssertionsIndependent(ddsim, prev, newAssertion);
-  });
+void continueWithProgram(DDSimulationState* ddsim,
+                         std::shared_ptr<const DDSimProgram> program) {
+  const auto step = ddsim->previousInstructionStack.size();
+  const auto operationIndex = ddsim->iterator - ddsim->program->qc->begin();
+
+  dddiagnosticsEvaluatePendingControls(&ddsim->diagnostics);
+  ddsim->referenceStates.clear();
+  ddsim->compiledSlices.reset();
+  clearGateCache(ddsim);
+  ddsim->checkpoints.discardFrom(step + 1, *ddsim->dd);
+  ddsim->measurementOutcomes.erase(
+      ddsim->measurementOutcomes.lower_bound(step),
+      ddsim->measurementOutcomes.end());
+
+  // Classical bits are matched by name, so they have to be translated before
+  // the previous program is released.
+  const auto& previous = *ddsim->program;
+  ddsim->classicalBits =
+      translateClassicalBits(ddsim->classicalBits, previous, *program);
+  ddsim->checkpoints.updateClassicalBits(
+      [&previous, &program](ClassicalBits& bits) {
+        bits = translateClassicalBits(bits, previous, *program);
+      });
+  takeInstructionFlags(ddsim, *program);
+  ddsim->program = std::move(program);
+  discardDeltaBaseline(ddsim);
+
+  ddsim->iterator = ddsim->program->qc->begin() + operationIndex;
+  ddsim->lastMetBreakpoint = -1ULL;
+  ddsim->paused = false;
 }
 
-void setLoadResultMessage(LoadResult& result, const std::string& message) {
-  result.message[0] = '\0';
-  if (message.empty()) {
-    return;
+/**
+ * @brief Write a list of indexed amplitudes into the given output buffers.
+ * @param found The amplitudes to write.
+ * @param indices A buffer to store the indices of the amplitudes.
+ * @param amplitudes A buffer to store the amplitudes.
+ * @param count A reference to store the number of amplitudes.
+ * @return The result of the operation.
+ */
+Result writeIndexedAmplitudes(
+    const std::vector<std::pair<size_t, Complex>>& found, size_t* indices,
+    Complex* amplitudes, size_t* count) {
+  if (count == nullptr ||
+      (!found.empty() && (indices == nullptr || amplitudes == nullptr))) {
+    return ERROR;
   }
-  const auto copyLen = std::min(
-      message.size(), static_cast<size_t>(LOAD_RESULT_MESSAGE_MAX - 1));
-  std::copy_n(message.data(), copyLen, std::begin(result.message));
-  result.message[LOAD_RESULT_MESSAGE_MAX - 1] = '\0';
-}
-
-LoadResult makeLoadResult(LoadResultStatus status, size_t line, size_t column,
-                          const std::string& message) {
-  LoadResult result{};
-  result.status = status;
-  result.line = line;
-  result.column = column;
-  setLoadResultMessage(result, message);
-  return result;
+  for (size_t i = 0; i < found.size(); i++) {
+    indices[i] = found[i].first;
+    amplitudes[i] = found[i].second;
+  }
+  *count = found.size();
+  return OK;
 }
 
 /**
- * @brief Compile an assertion using projective measurements.
+ * @brief Run the simulation forward until it finishes, is paused, or stops at
+ * a failed assertion or a breakpoint.
  * @param ddsim The simulation state.
- * @param stream The stream to write the compiled assertion to.
- * @param assertionIndex The index of the compiled assertion.
- * @param targetNames The names of the target qubits.
+ * @param onStep Called after each execution step.
+ * @return The result of the run and whether the run was paused.
  */
-void compileProjectiveMeasurement(
-    DDSimulationState* ddsim, std::stringstream& stream, size_t assertionIndex,
-    const std::map<std::string, std::string>& targetNames) {
-  const auto& assertion = dynamic_cast<CircuitEqualityAssertion&>(
-      *ddsim->assertionInstructions[assertionIndex].get());
-
-  std::stringstream codeStream{assertion.getCircuitCode()};
-  auto newQc = qasm3::Importer::import(codeStream);
-
-  newQc.unifyQuantumRegisters("assert_qubit");
-
-  qc::QubitIndexToRegisterMap qubitIndexToRegisterMap{};
-  const auto reg = newQc.getQuantumRegisters().begin()->second;
-  for (qc::Qubit i = 0; i < assertion.getTargetQubits().size(); i++) {
-    const auto& originalVariable = assertion.getTargetQubits()[i];
-    qubitIndexToRegisterMap.try_emplace(i, reg, originalVariable);
-  }
-
-  for (auto& it : std::ranges::reverse_view(newQc)) {
-    auto inverted = it->getInverted();
-    it->dumpOpenQASM2(stream, qubitIndexToRegisterMap, {});
+template <typename OnStep>
+std::pair<Result, bool> runForward(DDSimulationState* ddsim,
+                                   const OnStep& onStep) {
+  auto* self = &ddsim->interface;
+  Result res = OK;
+  bool wasPaused = false;
+  while (!self->isFinished(self)) {
+    if (ddsim->paused.exchange(false)) {
+      wasPaused = true;
+      break;
+    }
+    if (ddsim->fastRun && fastForward(ddsim, -1ULL) > 0) {
+      onStep();
+      if (self->wasBreakpointHit(self)) {
+        break;
+      }
+      continue;
+    }
+    res = self->stepForward(self);
+    if (res != OK) {
+      break;
+    }
+    onStep();
+    if (self->didAssertionFail(self) || self->wasBreakpointHit(self)) {
+      break;
+    }
   }
+  collectGarbageOnPause(ddsim);
+  return {res, wasPaused};
+}
 
-  for (const auto& [qbit, cbit] : targetNames) {
-    stream << "measure " << qbit << " -> " << cbit << "[0];\n";
-  }
+/**
+ * @brief Start an asynchronous run of the simulation on a worker thread.
+ * @param ddsim The simulation state.
+ * @param all True to continue after failed assertions and breakpoints.
+ * @param callback The callback to report progress to, or nullptr.
+ * @param userData The user data passed to the callback.
+ */
+void startAsyncRun(DDSimulationState* ddsim, bool all,
+                   ProgressCallback callback, void* userData) {
+  ddsim->asyncFailedAssertions = 0;
+  ddsim->asyncRun = std::async(std::launch::async, [=]() {
+    auto* self = &ddsim->interface;
+    size_t failed = 0;
+    const auto report = [&]() {
+      if (callback != nullptr) {
+        callback(userData, ddsim->currentInstruction, failed);
+      }
+    };
+    auto lastReport = std::chrono::steady_clock::now();
+    const auto onStep = [&]() {
+      if (callback == nullptr) {
+        return;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (now - lastReport >= ASYNC_PROGRESS_INTERVAL) {
+        lastReport = now;
+        report();
+      }
+    };
 
-  for (auto& it : newQc) {
-    it->dumpOpenQASM2(stream, qubitIndexToRegisterMap, {});
-  }
+    Result result = OK;
+    do {
+      const auto [res, wasPaused] = runForward(ddsim, onStep);
+      result = res;
+      if (result != OK || wasPaused) {
+        break;
+      }
+      if (self->didAssertionFail(self)) {
+        failed++;
+      }
+    } while (all && !self->isFinished(self));
+    ddsim->asyncFailedAssertions = failed;
+    report();
+    return result;
+  });
 }
-
 } // namespace
 
 #pragma clang diagnostic push
-Result createDDSimulationState(DDSimulationState* self) {
+Result createDDSimulationState(DDSimulationState* self,
+                               SimulationBackend backend) {
+  self->backend = backend;
   self->interface.init = ddsimInit;
 
   self->interface.loadCode = ddsimLoadCode;
+  self->interface.reloadCode = ddsimReloadCode;
   self->interface.stepForward = ddsimStepForward;
   self->interface.stepBackward = ddsimStepBackward;
   self->interface.stepOverForward = ddsimStepOverForward;
@@ -617,6 +2502,10 @@ Result createDDSimulationState(DDSimulationState* self) {
   self->interface.runSimulationBackward = ddsimRunSimulationBackward;
   self->interface.resetSimulation = ddsimResetSimulation;
   self->interface.pauseSimulation = ddsimPauseSimulation;
+  self->interface.runSimulationAsync = ddsimRunSimulationAsync;
+  self->interface.runAllAsync = ddsimRunAllAsync;
+  self->interface.isSimulationRunning = ddsimIsSimulationRunning;
+  self->interface.waitForSimulation = ddsimWaitForSimulation;
   self->interface.canStepForward = ddsimCanStepForward;
   self->interface.canStepBackward = ddsimCanStepBackward;
   self->interface.changeClassicalVariableValue =
@@ -636,13 +2525,22 @@ Result createDDSimulationState(DDSimulationState* self) {
   self->interface.getQuantumVariableName = ddsimGetQuantumVariableName;
   self->interface.getClassicalVariableName = ddsimGetClassicalVariableName;
   self->interface.getStateVectorFull = ddsimGetStateVectorFull;
+  self->interface.getStateVectorRange = ddsimGetStateVectorRange;
   self->interface.getStateVectorSub = ddsimGetStateVectorSub;
+  self->interface.getNonZeroAmplitudes = ddsimGetNonZeroAmplitudes;
+  self->interface.getTopKAmplitudes = ddsimGetTopKAmplitudes;
   self->interface.getDiagnostics = ddsimGetDiagnostics;
   self->interface.setBreakpoint = ddsimSetBreakpoint;
   self->interface.clearBreakpoints = ddsimClearBreakpoints;
   self->interface.getStackDepth = ddsimGetStackDepth;
   self->interface.getStackTrace = ddsimGetStackTrace;
   self->interface.compile = ddsimCompile;
+  self->interface.compileSlices = ddsimCompileSlices;
+  self->interface.setSeed = ddsimSetSeed;
+  self->interface.sampleShots = ddsimSampleShots;
+  self->interface.setProfilingEnabled = ddsimSetProfilingEnabled;
+  self->interface.getProfile = ddsimGetProfile;
+  self->interface.getStateDelta = ddsimGetStateDelta;
 
   // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
   return self->interface.init(reinterpret_cast<SimulationState*>(self));
@@ -653,18 +2551,36 @@ Result createDDSimulationState(DDSimulationState* self) {
 Result ddsimInit(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
 
+  auto program = std::make_shared<DDSimProgram>();
+  program->qc = std::make_unique<const qc::QuantumComputation>();
+  ddsim->program = std::move(program);
   ddsim->simulationState.p = nullptr;
-  ddsim->qc = std::make_unique<qc::QuantumComputation>();
   ddsim->dd = std::make_unique<dd::Package>(1);
-  ddsim->iterator = ddsim->qc->begin();
+  ddsim->denseState.clear();
+  ddsim->denseStateDDVersion = 0;
+  ddsim->denseGateCache.clear();
+  ddsim->densePackage.reset();
+  ddsim->iterator = ddsim->program->qc->begin();
   ddsim->currentInstruction = 0;
   ddsim->previousInstructionStack.clear();
   ddsim->callReturnStack.clear();
-  ddsim->callSubstitutions.clear();
   ddsim->restoreCallReturnStack.clear();
-  ddsim->breakpoints.clear();
+  ddsim->instructionFlags.clear();
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
+  ddsim->replaying = false;
+  ddsim->fastRun = false;
+  ddsim->gcPolicy = GarbageCollectionPolicy{};
+  ddsim->stepsSinceGarbageCollection = 0;
+  ddsim->memoryAfterGarbageCollection = 0;
+  ddsim->asyncFailedAssertions = 0;
+  ddsim->denseMemoryBudget = DEFAULT_DENSE_MEMORY_BUDGET;
+  ddsim->denseMemoryInUse = 0;
+  ddsim->peakDenseMemory = 0;
+  ddsim->stateVersion = 0;
+  ddsim->stateViews = StateViewCache{};
+  discardDeltaBaseline(ddsim);
+  ddsim->rng.seed(std::random_device{}());
 
   destroyDDDiagnostics(&ddsim->diagnostics);
   createDDDiagnostics(&ddsim->diagnostics, ddsim);
@@ -678,48 +2594,93 @@ Result ddsimInit(SimulationState* self) {
 
 LoadResult ddsimLoadCode(SimulationState* self, const char* code) {
   auto* ddsim = toDDSimulationState(self);
-  ddsim->currentInstruction = 0;
-  ddsim->previousInstructionStack.clear();
-  ddsim->callReturnStack.clear();
-  ddsim->callSubstitutions.clear();
-  ddsim->restoreCallReturnStack.clear();
   ddsim->ready = false;
-  ddsim->code = code;
-  ddsim->variables.clear();
-  ddsim->variableNames.clear();
-  ddsim->instructionTypes.clear();
-  ddsim->instructionStarts.clear();
-  ddsim->instructionEnds.clear();
-  ddsim->functionDefinitions.clear();
-  ddsim->assertionInstructions.clear();
-  ddsim->successorInstructions.clear();
-  ddsim->classicalRegisters.clear();
-  ddsim->qubitRegisters.clear();
-  ddsim->dataDependencies.clear();
-  ddsim->functionCallers.clear();
-  ddsim->targetQubits.clear();
-  ddsim->instructionObjects.clear();
 
-  try {
-    std::stringstream ss{preprocessAssertionCode(code, ddsim)};
-    const auto imported = qasm3::Importer::import(ss);
-    ddsim->qc = std::make_unique<qc::QuantumComputation>(imported);
-    qc::CircuitOptimizer::flattenOperations(*ddsim->qc, true);
-  } catch (const ParsingError& e) {
-    return makeLoadResult(LOAD_PARSE_ERROR, e.line(), e.column(), e.detail());
-  } catch (const std::exception& e) {
-    std::string message = e.what();
-    if (message.empty()) {
-      message = "An error occurred while executing the operation";
-    }
-    return makeLoadResult(LOAD_INTERNAL_ERROR, 0, 0, message);
-  } catch (...) {
-    return makeLoadResult(LOAD_INTERNAL_ERROR, 0, 0,
-                          "An error occurred while executing the operation");
+  std::shared_ptr<const DDSimProgram> program;
+  const auto result = tryParseProgram(code, program);
+  if (result.status != LOAD_OK) {
+    return result;
+  }
+  if (const auto support = checkBackendSupport(ddsim, *program);
+      support.status != LOAD_OK) {
+    return support;
+  }
+
+  ddsimLoadProgram(ddsim, std::move(program));
+  return result;
+}
+
+LoadResult ddsimReloadCode(SimulationState* self, const char* code) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->ready) {
+    return ddsimLoadCode(self, code);
+  }
+  if (ddsim->program->code == code) {
+    return makeLoadResult(LOAD_OK, 0, 0, "");
+  }
+
+  std::shared_ptr<const DDSimProgram> program;
+  const auto result = tryParseProgram(code, program);
+  if (result.status != LOAD_OK) {
+    return result;
+  }
+  if (const auto support = checkBackendSupport(ddsim, *program);
+      support.status != LOAD_OK) {
+    return support;
+  }
+
+  const auto firstChange =
+      findFirstChangedInstruction(*ddsim->program, *program);
+  const auto steps = findReusableSteps(ddsim, firstChange);
+  const auto reusable =
+      steps > 0 &&
+      program->qc->getNqubits() == ddsim->program->qc->getNqubits() &&
+      (steps == ddsim->previousInstructionStack.size() ||
+       ddsimRewindToStep(ddsim, steps) == OK);
+  if (!reusable) {
+    ddsimLoadProgram(ddsim, std::move(program));
+    return result;
   }
 
-  ddsim->iterator = ddsim->qc->begin();
-  ddsim->dd->resize(ddsim->qc->getNqubits());
+  continueWithProgram(ddsim, std::move(program));
+  return result;
+}
+
+std::shared_ptr<const DDSimProgram> parseDDSimProgram(const char* code) {
+  auto program = std::make_shared<DDSimProgram>();
+  program->code = code;
+  std::stringstream ss{preprocessAssertionCode(code, *program)};
+  const auto imported = qasm3::Importer::import(ss);
+  auto qc = std::make_unique<qc::QuantumComputation>(imported);
+  qc::CircuitOptimizer::flattenOperations(*qc, true);
+  program->qc = std::move(qc);
+  return program;
+}
+
+Result ddsimLoadProgram(DDSimulationState* ddsim,
+                        std::shared_ptr<const DDSimProgram> program) {
+  if (program == nullptr || program->qc == nullptr ||
+      checkBackendSupport(ddsim, *program).status != LOAD_OK) {
+    return ERROR;
+  }
+  dddiagnosticsEvaluatePendingControls(&ddsim->diagnostics);
+  ddsim->currentInstruction = 0;
+  ddsim->previousInstructionStack.clear();
+  ddsim->callReturnStack.clear();
+  ddsim->restoreCallReturnStack.clear();
+  ddsim->referenceStates.clear();
+  ddsim->compiledSlices.reset();
+  ddsim->checkpoints.clear(*ddsim->dd);
+  ddsim->measurementOutcomes.clear();
+  clearGateCache(ddsim);
+
+  takeInstructionFlags(ddsim, *program);
+  ddsim->classicalBits.assign(getClassicalBitWords(*program), 0);
+  discardDeltaBaseline(ddsim);
+  ddsim->program = std::move(program);
+
+  ddsim->iterator = ddsim->program->qc->begin();
+  ddsim->dd->resize(ddsim->program->qc->getNqubits());
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
 
@@ -727,7 +2688,7 @@ LoadResult ddsimLoadCode(SimulationState* self, const char* code) {
 
   ddsim->ready = true;
 
-  return makeLoadResult(LOAD_OK, 0, 0, "");
+  return OK;
 }
 
 Result ddsimChangeClassicalVariableValue(SimulationState* self,
@@ -739,30 +2700,19 @@ Result ddsimChangeClassicalVariableValue(SimulationState* self,
     return ERROR;
   }
   auto* ddsim = toDDSimulationState(self);
-  const auto it = ddsim->variables.find(variableName);
-  if (it == ddsim->variables.end()) {
+  const auto found =
+      ddsim->program == nullptr
+          ? std::optional<size_t>{}
+          : findClassicalVariable(*ddsim->program, variableName);
+  if (!found.has_value()) {
     std::cerr
         << "ddsimChangeClassicalVariableValue: no classical variable named '"
         << variableName << "'.\n";
     return ERROR;
   }
-  auto& var = it->second;
-  switch (var.type) {
-  case VariableType::VarBool:
-    var.value.boolValue = value->boolValue;
-    break;
-  case VariableType::VarInt:
-    var.value.intValue = value->intValue;
-    break;
-  case VariableType::VarFloat:
-    var.value.floatValue = value->floatValue;
-    break;
-  default:
-    std::cerr
-        << "ddsimChangeClassicalVariableValue: unsupported variable type for '"
-        << variableName << "'.\n";
-    return ERROR;
-  }
+  // All classical variables are bits of classical registers.
+  setClassicalBit(ddsim->classicalBits, found.value(), value->boolValue);
+  discardFutureHistory(ddsim);
   return OK;
 }
 
@@ -773,7 +2723,7 @@ Result ddsimChangeAmplitudeValue(SimulationState* self, const char* basisState,
     return ERROR;
   }
   auto* ddsim = toDDSimulationState(self);
-  const auto numQubits = ddsim->qc->getNqubits();
+  const auto numQubits = ddsim->program->qc->getNqubits();
   const std::string state{basisState};
   if (state.size() != numQubits) {
     std::cerr
@@ -786,6 +2736,11 @@ Result ddsimChangeAmplitudeValue(SimulationState* self, const char* basisState,
                  "'0' and '1'.\n";
     return ERROR;
   }
+  if (numQubits > std::numeric_limits<std::size_t>::digits) {
+    std::cerr << "ddsimChangeAmplitudeValue: basisState has more qubits than "
+                 "an amplitude index can address.\n";
+    return ERROR;
+  }
 
   std::size_t index = 0;
   for (const char bit : state) {
@@ -795,22 +2750,26 @@ Result ddsimChangeAmplitudeValue(SimulationState* self, const char* basisState,
     }
   }
 
-  const auto numStates = 1ULL << numQubits;
-  std::vector<Complex> amplitudes(numStates);
-  Statevector sv{numQubits, numStates, amplitudes.data()};
-  if (self->getStateVectorFull(self, &sv) != OK) {
-    return ERROR;
+  // The edit only depends on the current value of the amplitude and on the
+  // norm of the state, so the state never has to be expanded.
+  std::complex<double> previous;
+  double normSquared = 0.0;
+  if (usesDenseBackend(ddsim)) {
+    previous = {ddsim->denseState[index].real,
+                ddsim->denseState[index].imaginary};
+    for (const auto& amp : ddsim->denseState) {
+      normSquared += (amp.real * amp.real) + (amp.imaginary * amp.imaginary);
+    }
+  } else {
+    previous = ddsim->simulationState.getValueByIndex(index);
+    normSquared = std::abs(static_cast<std::complex<double>>(
+        ddsim->dd->innerProduct(ddsim->simulationState,
+                                ddsim->simulationState)));
   }
 
   constexpr double tolerance = 1e-9;
-  double otherNormSquared = 0.0;
-  for (std::size_t i = 0; i < numStates; i++) {
-    if (i == index) {
-      continue;
-    }
-    const auto& amp = amplitudes[i];
-    otherNormSquared += (amp.real * amp.real) + (amp.imaginary * amp.imaginary);
-  }
+  const double otherNormSquared =
+      std::max(0.0, normSquared - std::norm(previous));
 
   const double desiredReal = value->real;
   const double desiredImag = value->imaginary;
@@ -836,41 +2795,58 @@ Result ddsimChangeAmplitudeValue(SimulationState* self, const char* basisState,
                    "negative residual probability mass.\n";
       return ERROR;
     }
-    if (remaining <= tolerance) {
-      scalingFactor = 0.0;
-    } else {
+    if (remaining > tolerance) {
       scalingFactor = std::sqrt(remaining / otherNormSquared);
     }
   }
 
-  amplitudes[index] = *value;
-  if (otherNormSquared > tolerance) {
-    for (std::size_t i = 0; i < numStates; i++) {
-      if (i == index) {
-        continue;
+  if (usesDenseBackend(ddsim)) {
+    if (otherNormSquared > tolerance) {
+      for (auto& amp : ddsim->denseState) {
+        amp.real *= scalingFactor;
+        amp.imaginary *= scalingFactor;
       }
-      amplitudes[i].real *= scalingFactor;
-      amplitudes[i].imaginary *= scalingFactor;
     }
+    ddsim->denseState[index] = *value;
+    markDenseStateChanged(ddsim);
+    discardFutureHistory(ddsim);
+    return OK;
   }
 
-  dd::CVec ddVector;
-  ddVector.reserve(numStates);
-  for (const auto& amp : amplitudes) {
-    ddVector.emplace_back(amp.real, amp.imaginary);
+  // The new state is the scaled old state plus a basis state that corrects
+  // the edited amplitude:
+  // s * |psi> + (value - s * <index|psi>) * |index>.
+  const std::complex<double> desired{desiredReal, desiredImag};
+  if (otherNormSquared <= tolerance) {
+    scalingFactor = 0.0;
   }
-
   try {
-    auto newState = dd::makeStateFromVector(ddVector, *(ddsim->dd));
-    ddsim->dd->incRef(newState);
+    auto& package = *ddsim->dd;
+    std::vector<bool> bits(numQubits);
+    for (size_t qubit = 0; qubit < numQubits; qubit++) {
+      bits[qubit] = ((index >> qubit) & 1U) != 0;
+    }
+    auto correction = dd::makeBasisState(numQubits, bits, package);
+    correction.w = package.cn.lookup(desired - (scalingFactor * previous));
+
+    auto newState = correction;
+    if (scalingFactor != 0.0) {
+      auto scaled = ddsim->simulationState;
+      scaled.w = package.cn.lookup(
+          static_cast<std::complex<double>>(scaled.w) * scalingFactor);
+      newState = package.add(scaled, correction);
+    }
+    package.incRef(newState);
     if (ddsim->simulationState.p != nullptr) {
-      ddsim->dd->decRef(ddsim->simulationState);
+      package.decRef(ddsim->simulationState);
     }
     ddsim->simulationState = newState;
+    markStateChanged(ddsim);
   } catch (const std::exception& e) {
     std::cerr << e.what() << "\n";
     return ERROR;
   }
+  discardFutureHistory(ddsim);
   return OK;
 }
 
@@ -879,7 +2855,7 @@ Result ddsimStepOverForward(SimulationState* self) {
     return ERROR;
   }
   auto* ddsim = toDDSimulationState(self);
-  if (ddsim->instructionTypes[ddsim->currentInstruction] != CALL) {
+  if (ddsim->program->instructionTypes[ddsim->currentInstruction] != CALL) {
     return self->stepForward(self);
   }
 
@@ -887,11 +2863,10 @@ Result ddsimStepOverForward(SimulationState* self) {
   const auto currentInstruction = ddsim->currentInstruction;
   bool done = false;
   while ((res == OK) && !done) {
-    if (ddsim->paused) {
-      ddsim->paused = false;
+    if (ddsim->paused.exchange(false)) {
       return OK;
     }
-    if (ddsim->instructionTypes[ddsim->currentInstruction] == RETURN &&
+    if (ddsim->program->instructionTypes[ddsim->currentInstruction] == RETURN &&
         ddsim->callReturnStack.back() == currentInstruction) {
       done = true;
     }
@@ -909,19 +2884,18 @@ Result ddsimStepOverBackward(SimulationState* self) {
   }
   auto* ddsim = toDDSimulationState(self);
   const auto prev = ddsim->previousInstructionStack.back();
-  if (ddsim->instructionTypes[prev] != RETURN) {
+  if (ddsim->program->instructionTypes[prev] != RETURN) {
     return self->stepBackward(self);
   }
 
   Result res = OK;
   const auto stackSize = ddsim->callReturnStack.size();
   while (res == OK) {
-    if (ddsim->paused) {
-      ddsim->paused = false;
+    if (ddsim->paused.exchange(false)) {
       return OK;
     }
     res = self->stepBackward(self);
-    if (ddsim->instructionTypes[ddsim->currentInstruction] == CALL &&
+    if (ddsim->program->instructionTypes[ddsim->currentInstruction] == CALL &&
         ddsim->callReturnStack.size() == stackSize) {
       break;
     }
@@ -944,8 +2918,7 @@ Result ddsimStepOutForward(SimulationState* self) {
     if (self->didAssertionFail(self) || self->wasBreakpointHit(self)) {
       break;
     }
-    if (ddsim->paused) {
-      ddsim->paused = false;
+    if (ddsim->paused.exchange(false)) {
       return OK;
     }
     if (ddsim->callReturnStack.size() == size - 1) {
@@ -967,8 +2940,7 @@ Result ddsimStepOutBackward(SimulationState* self) {
     if (self->wasBreakpointHit(self)) {
       break;
     }
-    if (ddsim->paused) {
-      ddsim->paused = false;
+    if (ddsim->paused.exchange(false)) {
       return OK;
     }
     if (ddsim->callReturnStack.size() == size - 1) {
@@ -985,8 +2957,21 @@ Result ddsimStepForward(SimulationState* self) {
   }
   ddsim->lastMetBreakpoint = -1ULL;
   const auto currentInstruction = ddsim->currentInstruction;
-  dddiagnosticsOnStepForward(&ddsim->diagnostics, currentInstruction);
-  ddsim->currentInstruction = ddsim->successorInstructions[currentInstruction];
+  const auto step = ddsim->previousInstructionStack.size();
+  const auto irreversible =
+      ddsim->program->instructionTypes[currentInstruction] == SIMULATE &&
+      isIrreversible(**ddsim->iterator);
+  if (ddsim->checkpoints.shouldCapture(step, irreversible)) {
+    captureCheckpoint(ddsim, step);
+  }
+  if (!ddsim->replaying) {
+    const DDSimProfiler::Scope scope(ddsim->profiler, currentInstruction,
+                                     ProfileDiagnostics,
+                                     ddsim->simulationState);
+    dddiagnosticsOnStepForward(&ddsim->diagnostics, currentInstruction);
+  }
+  ddsim->currentInstruction =
+      ddsim->program->successorInstructions[currentInstruction];
 
   if (ddsim->currentInstruction == 0) {
     ddsim->currentInstruction = ddsim->callReturnStack.back() + 1;
@@ -995,11 +2980,11 @@ Result ddsimStepForward(SimulationState* self) {
     ddsim->callReturnStack.pop_back();
   }
 
-  if (ddsim->breakpoints.contains(ddsim->currentInstruction)) {
+  if (hasInstructionFlag(ddsim, ddsim->currentInstruction, BREAKPOINT)) {
     ddsim->lastMetBreakpoint = ddsim->currentInstruction;
   }
 
-  if (ddsim->instructionTypes[currentInstruction] == CALL) {
+  if (ddsim->program->instructionTypes[currentInstruction] == CALL) {
     ddsim->callReturnStack.push_back(currentInstruction);
   }
   ddsim->previousInstructionStack.emplace_back(currentInstruction);
@@ -1008,13 +2993,29 @@ Result ddsimStepForward(SimulationState* self) {
   // - ASSERTION: check the assertion and step back if it fails.
   // - Non-SIMULATE: just step to the next instruction.
   // - SIMULATE: run the corresponding operation on the DD backend.
-  if (ddsim->instructionTypes[currentInstruction] == ASSERTION) {
-    auto& assertion = ddsim->assertionInstructions[currentInstruction];
+  if (ddsim->program->instructionTypes[currentInstruction] == ASSERTION) {
+    if (ddsim->replaying) {
+      return OK;
+    }
+    const auto& assertion =
+        *ddsim->program->assertionInstructions.at(currentInstruction);
     try {
-      const auto failed = !checkAssertion(ddsim, assertion);
+      bool failed = false;
+      {
+        const DDSimProfiler::Scope scope(ddsim->profiler, currentInstruction,
+                                         ProfileAssertion,
+                                         ddsim->simulationState);
+        failed = !checkAssertion(ddsim, currentInstruction, assertion);
+      }
       if (failed && ddsim->lastFailedAssertion != currentInstruction) {
         ddsim->lastFailedAssertion = currentInstruction;
-        dddiagnosticsOnFailedAssertion(&ddsim->diagnostics, currentInstruction);
+        {
+          const DDSimProfiler::Scope scope(ddsim->profiler, currentInstruction,
+                                           ProfileDiagnostics,
+                                           ddsim->simulationState);
+          dddiagnosticsOnFailedAssertion(&ddsim->diagnostics,
+                                         currentInstruction);
+        }
         self->stepBackward(self);
       }
       return OK;
@@ -1025,11 +3026,13 @@ Result ddsimStepForward(SimulationState* self) {
   }
 
   ddsim->lastFailedAssertion = -1ULL;
-  if (ddsim->instructionTypes[currentInstruction] != SIMULATE) {
+  if (ddsim->program->instructionTypes[currentInstruction] != SIMULATE) {
     return OK;
   }
 
-  dd::MatrixDD currDD;
+  const DDSimProfiler::Scope scope(ddsim->profiler, currentInstruction,
+                                   ProfileSimulation, ddsim->simulationState);
+  const qc::Operation* operation = nullptr;
   if ((*ddsim->iterator)->getType() == qc::Measure) {
     // Perform a measurement of the desired qubits, based on the amplitudes of
     // the current state.
@@ -1041,55 +3044,27 @@ Result ddsimStepForward(SimulationState* self) {
       auto qubit = qubitsToMeasure[i];
       auto classicalBit = classicalBits[i];
 
-      auto [pZero, pOne] = dd::Package::determineMeasurementProbabilities(
-          ddsim->simulationState, static_cast<dd::Qubit>(qubit));
-      auto rnd = generateRandomNumber();
-      auto result = rnd < pZero;
-      ddsim->dd->performCollapsingMeasurement(ddsim->simulationState,
-                                              static_cast<dd::Qubit>(qubit),
-                                              result ? pZero : pOne, result);
-      auto name = getClassicalBitName(ddsim, classicalBit);
-      if (ddsim->variables.contains(name)) {
-        VariableValue value;
-        value.boolValue = !result;
-        ddsim->variables[name].value = value;
-      } else {
-        ddsim->variableNames.push_back(std::make_unique<std::string>(name));
-        const Variable newVariable{ddsim->variableNames.back()->data(),
-                                   VariableType::VarBool,
-                                   {!result}};
-        ddsim->variables.insert({name, newVariable});
-      }
+      auto [pZero, pOne] = getQubitProbabilities(ddsim, qubit);
+      auto result = drawMeasurementOutcome(ddsim, i, pZero);
+      collapseQubit(ddsim, qubit, result ? pZero : pOne, result);
+      setClassicalBit(ddsim->classicalBits, classicalBit, !result);
     }
 
     ddsim->iterator++;
-    ddsim->previousInstructionStack
-        .clear(); // after measurements, we can no longer step back.
-    ddsim->restoreCallReturnStack.clear();
     return OK;
   }
   if ((*ddsim->iterator)->getType() == qc::Reset) {
     // Perform the desired qubits. This will first perform a measurement.
     auto qubitsToMeasure = (*ddsim->iterator)->getTargets();
     ddsim->iterator++;
-    ddsim->previousInstructionStack.clear();
-    ddsim->restoreCallReturnStack.clear();
-
-    for (const auto qubit : qubitsToMeasure) {
-      auto [pZero, pOne] = dd::Package::determineMeasurementProbabilities(
-          ddsim->simulationState, static_cast<dd::Qubit>(qubit));
-      auto rnd = generateRandomNumber();
-      auto result = rnd < pZero;
-      ddsim->dd->performCollapsingMeasurement(ddsim->simulationState,
-                                              static_cast<dd::Qubit>(qubit),
-                                              result ? pZero : pOne, result);
+
+    for (size_t i = 0; i < qubitsToMeasure.size(); i++) {
+      const auto qubit = qubitsToMeasure[i];
+      auto [pZero, pOne] = getQubitProbabilities(ddsim, qubit);
+      auto result = drawMeasurementOutcome(ddsim, i, pZero);
+      collapseQubit(ddsim, qubit, result ? pZero : pOne, result);
       if (!result) {
-        const auto x = qc::StandardOperation(qubit, qc::X);
-        auto tmp = ddsim->dd->multiply(dd::getDD(x, *ddsim->dd),
-                                       ddsim->simulationState);
-        ddsim->dd->incRef(tmp);
-        ddsim->dd->decRef(ddsim->simulationState);
-        ddsim->simulationState = tmp;
+        flipQubit(ddsim, qubit);
       }
     }
     return OK;
@@ -1103,55 +3078,22 @@ Result ddsimStepForward(SimulationState* self) {
     // For if-else operations, we need to read the values of the classical
     // register first.
     const auto* op =
-        dynamic_cast<qc::IfElseOperation*>((*ddsim->iterator).get());
-    if (op->getComparisonKind() != qc::Eq) {
-      throw std::runtime_error("If-else operations with non-equality "
-                               "comparisons are currently not supported");
-    }
-    const auto condition =
-        evaluateClassicConditionFromCode(ddsim, currentInstruction);
-    bool conditionMet = false;
-    if (condition.has_value()) {
-      conditionMet = condition.value();
-    } else {
-      const auto& exp = op->getExpectedValueRegister();
-      size_t registerValue = 0;
-      if (op->getControlBit().has_value()) {
-        const auto controlBit = op->getControlBit().value();
-        const auto name = getClassicalBitName(ddsim, controlBit);
-        const auto& value = ddsim->variables[name].value.boolValue;
-        registerValue = value ? 1ULL : 0ULL;
-      } else {
-        const auto& controls = op->getControlRegister();
-        for (size_t i = 0; i < controls->getSize(); i++) {
-          const auto name =
-              getClassicalBitName(ddsim, controls->getStartIndex() + i);
-          const auto& value = ddsim->variables[name].value.boolValue;
-          registerValue |= (value ? 1ULL : 0ULL) << i;
-        }
-      }
-      conditionMet = (registerValue == exp);
-    }
-    if (conditionMet) {
-      auto* thenOp = op->getThenOp();
-      currDD = dd::getDD(*thenOp, *ddsim->dd);
-    } else if (op->getElseOp() != nullptr) {
-      auto* elseOp = op->getElseOp();
-      currDD = dd::getDD(*elseOp, *ddsim->dd);
+        dynamic_cast<qc::IfElseOperation*>((*ddsim->iterator).get());
+    if (isClassicConditionMet(ddsim, *op, currentInstruction)) {
+      operation = op->getThenOp();
     } else {
-      currDD = dd::Package::makeIdent();
+      // Without an else branch, an unmet condition leaves the state as is.
+      operation = op->getElseOp();
     }
   } else {
     // For all other operations, we just take the next gate to apply.
-    currDD = dd::getDD(**ddsim->iterator,
-                       *ddsim->dd); // retrieve the "new" current operation
+    operation = ddsim->iterator->get();
   }
 
-  auto temp = ddsim->dd->multiply(currDD, ddsim->simulationState);
-  ddsim->dd->incRef(temp);
-  ddsim->dd->decRef(ddsim->simulationState);
-  ddsim->simulationState = temp;
-  ddsim->dd->garbageCollect();
+  if (operation != nullptr) {
+    applyOperation(ddsim, *operation, false);
+  }
+  collectGarbageAfterSteps(ddsim, 1);
 
   ddsim->iterator++;
   return OK;
@@ -1163,6 +3105,25 @@ Result ddsimStepBackward(SimulationState* self) {
     return ERROR;
   }
 
+  // Measurements and resets cannot be inverted, so the state before them is
+  // restored from a checkpoint instead.
+  const auto previous = ddsim->previousInstructionStack.back();
+  if (ddsim->program->instructionTypes[previous] == SIMULATE &&
+      isIrreversible(**std::prev(ddsim->iterator))) {
+    const auto lastFailedAssertion = ddsim->lastFailedAssertion;
+    if (ddsimRewindToStep(ddsim, ddsim->previousInstructionStack.size() - 1) ==
+        ERROR) {
+      return ERROR;
+    }
+    if (hasInstructionFlag(ddsim, ddsim->currentInstruction, BREAKPOINT)) {
+      ddsim->lastMetBreakpoint = ddsim->currentInstruction;
+    }
+    if (lastFailedAssertion == ddsim->currentInstruction) {
+      ddsim->lastFailedAssertion = lastFailedAssertion;
+    }
+    return OK;
+  }
+
   ddsim->lastMetBreakpoint = -1ULL;
   if (!ddsim->restoreCallReturnStack.empty() &&
       ddsim->currentInstruction == ddsim->restoreCallReturnStack.back().first) {
@@ -1181,7 +3142,7 @@ Result ddsimStepBackward(SimulationState* self) {
 
   // When going backwards, we still run the instruction that hits the breakpoint
   // because we want to stop *before* it.
-  if (ddsim->breakpoints.contains(ddsim->currentInstruction)) {
+  if (hasInstructionFlag(ddsim, ddsim->currentInstruction, BREAKPOINT)) {
     ddsim->lastMetBreakpoint = ddsim->currentInstruction;
   }
 
@@ -1189,12 +3150,14 @@ Result ddsimStepBackward(SimulationState* self) {
     ddsim->lastFailedAssertion = -1ULL;
   }
 
-  if (ddsim->instructionTypes[ddsim->currentInstruction] != SIMULATE) {
+  if (ddsim->program->instructionTypes[ddsim->currentInstruction] != SIMULATE) {
     return OK;
   }
 
   ddsim->iterator--;
-  dd::MatrixDD currDD;
+  const DDSimProfiler::Scope scope(ddsim->profiler, ddsim->currentInstruction,
+                                   ProfileSimulation, ddsim->simulationState);
+  const qc::Operation* operation = nullptr;
 
   if ((*ddsim->iterator)->getType() == qc::Barrier) {
     return OK;
@@ -1202,58 +3165,63 @@ Result ddsimStepBackward(SimulationState* self) {
   if ((*ddsim->iterator)->isIfElseOperation()) {
     const auto* op =
         dynamic_cast<qc::IfElseOperation*>((*ddsim->iterator).get());
-    if (op->getComparisonKind() != qc::Eq) {
-      throw std::runtime_error("If-else operations with non-equality "
-                               "comparisons are currently not supported");
-    }
-    const auto condition =
-        evaluateClassicConditionFromCode(ddsim, ddsim->currentInstruction);
-    bool conditionMet = false;
-    if (condition.has_value()) {
-      conditionMet = condition.value();
-    } else {
-      const auto& exp = op->getExpectedValueRegister();
-      size_t registerValue = 0;
-      if (op->getControlBit().has_value()) {
-        const auto controlBit = op->getControlBit().value();
-        const auto name = getClassicalBitName(ddsim, controlBit);
-        const auto& value = ddsim->variables[name].value.boolValue;
-        registerValue = value ? 1ULL : 0ULL;
-      } else {
-        const auto& controls = op->getControlRegister();
-        for (size_t i = 0; i < controls->getSize(); i++) {
-          const auto name =
-              getClassicalBitName(ddsim, controls->getStartIndex() + i);
-          const auto& value = ddsim->variables[name].value.boolValue;
-          registerValue |= (value ? 1ULL : 0ULL) << i;
-        }
-      }
-      conditionMet = (registerValue == exp);
-    }
-    if (conditionMet) {
-      auto* thenOp = op->getThenOp();
-      currDD = dd::getInverseDD(*thenOp, *ddsim->dd);
-    } else if (op->getElseOp() != nullptr) {
-      auto* elseOp = op->getElseOp();
-      currDD = dd::getInverseDD(*elseOp, *ddsim->dd);
+    if (isClassicConditionMet(ddsim, *op, ddsim->currentInstruction)) {
+      operation = op->getThenOp();
     } else {
-      currDD = dd::Package::makeIdent();
+      operation = op->getElseOp();
     }
   } else {
-    currDD = dd::getInverseDD(
-        **ddsim->iterator,
-        *ddsim->dd); // get the inverse of the current operation
+    operation = ddsim->iterator->get();
   }
 
-  auto temp = ddsim->dd->multiply(currDD, ddsim->simulationState);
-  ddsim->dd->incRef(temp);
-  ddsim->dd->decRef(ddsim->simulationState);
-  ddsim->simulationState = temp;
-  ddsim->dd->garbageCollect();
+  if (operation != nullptr) {
+    applyOperation(ddsim, *operation, true);
+  }
+  collectGarbageAfterSteps(ddsim, 1);
 
   return OK;
 }
 
+Result ddsimRewindToStep(DDSimulationState* ddsim, size_t step) {
+  if (!ddsim->ready || step > ddsim->previousInstructionStack.size()) {
+    return ERROR;
+  }
+  const auto* entry = ddsim->checkpoints.findLatest(step);
+  if (entry == nullptr) {
+    return ERROR;
+  }
+  const auto& [checkpointStep, checkpoint] = *entry;
+
+  if (usesDenseBackend(ddsim)) {
+    ddsim->denseState = checkpoint.amplitudes;
+    markDenseStateChanged(ddsim);
+  } else {
+    setSimulationState(ddsim, checkpoint.state);
+  }
+  ddsim->currentInstruction = checkpoint.currentInstruction;
+  ddsim->iterator = ddsim->program->qc->begin() +
+                    static_cast<std::ptrdiff_t>(checkpoint.operationIndex);
+  ddsim->classicalBits = checkpoint.classicalBits;
+  ddsim->callReturnStack = checkpoint.callReturnStack;
+  ddsim->restoreCallReturnStack = checkpoint.restoreCallReturnStack;
+  ddsim->lastFailedAssertion = checkpoint.lastFailedAssertion;
+  ddsim->previousInstructionStack.resize(checkpointStep);
+
+  const auto wasReplaying = ddsim->replaying;
+  ddsim->replaying = true;
+  Result result = OK;
+  while (result == OK && ddsim->previousInstructionStack.size() < step) {
+    if (fastForward(ddsim, step - ddsim->previousInstructionStack.size()) ==
+        0) {
+      result = ddsimStepForward(&ddsim->interface);
+    }
+  }
+  ddsim->replaying = wasReplaying;
+  ddsim->lastFailedAssertion = -1ULL;
+  ddsim->lastMetBreakpoint = -1ULL;
+  return result;
+}
+
 Result ddsimRunAll(SimulationState* self, size_t* failedAssertions) {
   auto* ddsim = toDDSimulationState(self);
   if (!ddsim->ready) {
@@ -1280,20 +3248,7 @@ Result ddsimRunSimulation(SimulationState* self) {
   if (!self->canStepForward(self)) {
     return ERROR;
   }
-  while (!self->isFinished(self)) {
-    if (ddsim->paused) {
-      ddsim->paused = false;
-      return OK;
-    }
-    const Result res = self->stepForward(self);
-    if (res != OK) {
-      return res;
-    }
-    if (self->didAssertionFail(self) || self->wasBreakpointHit(self)) {
-      break;
-    }
-  }
-  return OK;
+  return runForward(ddsim, []() {}).first;
 }
 
 Result ddsimRunSimulationBackward(SimulationState* self) {
@@ -1301,20 +3256,21 @@ Result ddsimRunSimulationBackward(SimulationState* self) {
   if (!self->canStepBackward(self)) {
     return ERROR;
   }
+  Result res = OK;
   while (self->canStepBackward(self)) {
-    if (ddsim->paused) {
-      ddsim->paused = false;
-      return OK;
+    if (ddsim->paused.exchange(false)) {
+      break;
     }
-    const Result res = self->stepBackward(self);
+    res = self->stepBackward(self);
     if (res != OK) {
-      return res;
+      break;
     }
     if (self->didAssertionFail(self) || self->wasBreakpointHit(self)) {
       break;
     }
   }
-  return OK;
+  collectGarbageOnPause(ddsim);
+  return res;
 }
 
 Result ddsimResetSimulation(SimulationState* self) {
@@ -1324,7 +3280,7 @@ Result ddsimResetSimulation(SimulationState* self) {
   ddsim->callReturnStack.clear();
   ddsim->restoreCallReturnStack.clear();
 
-  ddsim->iterator = ddsim->qc->begin();
+  ddsim->iterator = ddsim->program->qc->begin();
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
 
@@ -1338,10 +3294,49 @@ Result ddsimPauseSimulation(SimulationState* self) {
   return OK;
 }
 
+Result ddsimRunSimulationAsync(SimulationState* self, ProgressCallback callback,
+                               void* userData) {
+  auto* ddsim = toDDSimulationState(self);
+  if (self->isSimulationRunning(self) || !self->canStepForward(self)) {
+    return ERROR;
+  }
+  startAsyncRun(ddsim, false, callback, userData);
+  return OK;
+}
+
+Result ddsimRunAllAsync(SimulationState* self, ProgressCallback callback,
+                        void* userData) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->ready || self->isSimulationRunning(self)) {
+    return ERROR;
+  }
+  startAsyncRun(ddsim, true, callback, userData);
+  return OK;
+}
+
+bool ddsimIsSimulationRunning(SimulationState* self) {
+  auto* ddsim = toDDSimulationState(self);
+  return ddsim->asyncRun.valid() &&
+         ddsim->asyncRun.wait_for(std::chrono::seconds(0)) !=
+             std::future_status::ready;
+}
+
+Result ddsimWaitForSimulation(SimulationState* self, size_t* failedAssertions) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->asyncRun.valid()) {
+    return ERROR;
+  }
+  const auto result = ddsim->asyncRun.get();
+  if (failedAssertions != nullptr) {
+    *failedAssertions = ddsim->asyncFailedAssertions;
+  }
+  return result;
+}
+
 bool ddsimCanStepForward(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
   return ddsim->ready &&
-         ddsim->currentInstruction < ddsim->instructionTypes.size();
+         ddsim->currentInstruction < ddsim->program->instructionTypes.size();
 }
 
 bool ddsimCanStepBackward(SimulationState* self) {
@@ -1351,7 +3346,7 @@ bool ddsimCanStepBackward(SimulationState* self) {
 
 bool ddsimIsFinished(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  return ddsim->currentInstruction == ddsim->instructionTypes.size();
+  return ddsim->currentInstruction == ddsim->program->instructionTypes.size();
 }
 
 bool ddsimDidAssertionFail(SimulationState* self) {
@@ -1371,28 +3366,28 @@ size_t ddsimGetCurrentInstruction(SimulationState* self) {
 
 size_t ddsimGetInstructionCount(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  return ddsim->instructionTypes.size();
+  return ddsim->program->instructionTypes.size();
 }
 
 Result ddsimGetInstructionPosition(SimulationState* self, size_t instruction,
                                    size_t* start, size_t* end) {
   auto* ddsim = toDDSimulationState(self);
-  if (instruction >= ddsim->instructionStarts.size()) {
+  if (instruction >= ddsim->program->instructionStarts.size()) {
     return ERROR;
   }
-  size_t startIndex = ddsim->instructionStarts[instruction];
-  size_t endIndex = ddsim->instructionEnds[instruction];
+  size_t startIndex = ddsim->program->instructionStarts[instruction];
+  size_t endIndex = ddsim->program->instructionEnds[instruction];
 
-  while (ddsim->processedCode[startIndex] == ' ' ||
-         ddsim->processedCode[startIndex] == '\n' ||
-         ddsim->processedCode[startIndex] == '\r' ||
-         ddsim->processedCode[startIndex] == '\t') {
+  while (ddsim->program->processedCode[startIndex] == ' ' ||
+         ddsim->program->processedCode[startIndex] == '\n' ||
+         ddsim->program->processedCode[startIndex] == '\r' ||
+         ddsim->program->processedCode[startIndex] == '\t') {
     startIndex++;
   }
-  while (ddsim->processedCode[endIndex] == ' ' ||
-         ddsim->processedCode[endIndex] == '\n' ||
-         ddsim->processedCode[endIndex] == '\r' ||
-         ddsim->processedCode[endIndex] == '\t') {
+  while (ddsim->program->processedCode[endIndex] == ' ' ||
+         ddsim->program->processedCode[endIndex] == '\n' ||
+         ddsim->program->processedCode[endIndex] == '\r' ||
+         ddsim->program->processedCode[endIndex] == '\t') {
     endIndex++;
   }
   *start = startIndex;
@@ -1402,12 +3397,19 @@ Result ddsimGetInstructionPosition(SimulationState* self, size_t instruction,
 
 size_t ddsimGetNumQubits(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  return ddsim->qc->getNqubits();
+  return ddsim->program->qc->getNqubits();
 }
 
 Result ddsimGetAmplitudeIndex(SimulationState* self, size_t index,
                               Complex* output) {
   auto* ddsim = toDDSimulationState(self);
+  if (usesDenseBackend(ddsim)) {
+    if (index >= ddsim->denseState.size()) {
+      return ERROR;
+    }
+    *output = ddsim->denseState[index];
+    return OK;
+  }
   auto result = ddsim->simulationState.getValueByIndex(index);
   output->real = result.real();
   output->imaginary = result.imag();
@@ -1419,8 +3421,17 @@ Result ddsimGetAmplitudeBitstring(SimulationState* self, const char* bitstring,
   auto* ddsim = toDDSimulationState(self);
   auto path = std::string(bitstring);
   std::ranges::reverse(path);
-  auto result =
-      ddsim->simulationState.getValueByPath(ddsim->qc->getNqubits(), path);
+  if (usesDenseBackend(ddsim)) {
+    size_t index = 0;
+    for (size_t i = 0; i < path.size(); i++) {
+      if (path[i] == '1') {
+        index |= 1ULL << i;
+      }
+    }
+    return ddsimGetAmplitudeIndex(self, index, output);
+  }
+  auto result = ddsim->simulationState.getValueByPath(
+      ddsim->program->qc->getNqubits(), path);
   output->real = result.real();
   output->imaginary = result.imag();
   return OK;
@@ -1429,25 +3440,32 @@ Result ddsimGetAmplitudeBitstring(SimulationState* self, const char* bitstring,
 Result ddsimGetClassicalVariable(SimulationState* self, const char* name,
                                  Variable* output) {
   auto* ddsim = toDDSimulationState(self);
-  if (ddsim->variables.contains(name)) {
-    *output = ddsim->variables[name];
-    return OK;
+  if (ddsim->program == nullptr) {
+    return ERROR;
   }
-  return ERROR;
+  const auto found = findClassicalVariable(*ddsim->program, name);
+  if (!found.has_value()) {
+    return ERROR;
+  }
+  const auto index = found.value();
+  output->name = ddsim->program->variableNames[index]->data();
+  output->type = VariableType::VarBool;
+  output->value.boolValue = getClassicalBit(ddsim->classicalBits, index);
+  return OK;
 }
 size_t ddsimGetNumClassicalVariables(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  return ddsim->variables.size();
+  return ddsim->program == nullptr ? 0 : ddsim->program->variableNames.size();
 }
 Result ddsimGetClassicalVariableName(SimulationState* self,
                                      size_t variableIndex, char* output) {
   auto* ddsim = toDDSimulationState(self);
 
-  if (variableIndex >= ddsim->variables.size()) {
+  if (variableIndex >= ddsimGetNumClassicalVariables(self)) {
     return ERROR;
   }
 
-  const auto name = getClassicalBitName(ddsim, variableIndex);
+  const auto& name = *ddsim->program->variableNames[variableIndex];
   name.copy(output, name.length());
   return OK;
 }
@@ -1466,10 +3484,41 @@ Result ddsimGetQuantumVariableName(SimulationState* self, size_t variableIndex,
 }
 
 Result ddsimGetStateVectorFull(SimulationState* self, Statevector* output) {
+  auto* ddsim = toDDSimulationState(self);
+  const auto numQubits = ddsim->program->qc->getNqubits();
+  const auto numStates = getNumAmplitudes(numQubits);
+  if (output->numStates < numStates) {
+    return ERROR;
+  }
   const Span<Complex> amplitudes(output->amplitudes, output->numStates);
-  for (size_t i = 0; i < output->numStates; i++) {
-    self->getAmplitudeIndex(self, i, &amplitudes[i]);
+  if (const auto* cached = getCachedStateVector(ddsim); cached != nullptr) {
+    std::ranges::copy(*cached, amplitudes.data());
+    return OK;
+  }
+  // The state does not fit into the dense-memory budget of the simulation
+  // state, so it is only exported into the buffer of the caller.
+  const DDSimProfiler::Scope scope(ddsim->profiler, ProfileDensification,
+                                   ddsim->simulationState);
+  ddsim->profiler.recordDenseBytes(numStates * sizeof(Complex));
+  exportStateVector(ddsim->simulationState, numQubits, amplitudes);
+  return OK;
+}
+
+Result ddsimGetStateVectorRange(SimulationState* self, size_t start,
+                                size_t count, Statevector* output) {
+  auto* ddsim = toDDSimulationState(self);
+  const auto numStates = getNumAmplitudes(ddsim->program->qc->getNqubits());
+  if (output->numStates < count || start > numStates ||
+      count > numStates - start) {
+    return ERROR;
   }
+  const Span<Complex> amplitudes(output->amplitudes, count);
+  if (usesDenseBackend(ddsim)) {
+    std::copy_n(ddsim->denseState.begin() + static_cast<std::ptrdiff_t>(start),
+                count, amplitudes.data());
+    return OK;
+  }
+  exportStateVectorRange(ddsim->simulationState, start, amplitudes);
   return OK;
 }
 
@@ -1491,28 +3540,41 @@ Result ddsimGetStateVectorSub(SimulationState* self, size_t subStateSize,
   }
 
   auto* ddsim = toDDSimulationState(self);
-  Statevector fullState;
-  fullState.numQubits = ddsim->qc->getNqubits();
-  fullState.numStates = 1 << fullState.numQubits;
-  std::vector<Complex> amplitudes(fullState.numStates);
-  const Span<Complex> outAmplitudes(output->amplitudes, output->numStates);
-
   std::vector<size_t> targetQubits(subStateSize);
   for (size_t i = 0; i < subStateSize; i++) {
     targetQubits[i] = qubitsSpan[i];
   }
 
-  fullState.amplitudes = amplitudes.data();
-
-  self->getStateVectorFull(self, &fullState);
+  auto& subStates = getStateViews(ddsim).subStates;
+  auto found = subStates.find(targetQubits);
+  if (found == subStates.end()) {
+    auto* amplitudes = getCachedStateVector(ddsim);
+    const DenseMemoryReservation reservation(
+        ddsim, getSubStateDenseAmplitudes(ddsim, subStateSize));
+    if (amplitudes == nullptr || !reservation.isGranted()) {
+      return ERROR;
+    }
+    Statevector fullState;
+    fullState.numQubits = ddsim->program->qc->getNqubits();
+    fullState.numStates = amplitudes->size();
+    fullState.amplitudes = amplitudes->data();
+
+    auto decomposition = getSchmidtDecomposition(fullState, targetQubits,
+                                                 ddsim->subStateScratch);
+    std::optional<std::vector<Complex>> subState;
+    if (fullState.numQubits == targetQubits.size() ||
+        isSeparable(decomposition)) {
+      subState = std::move(decomposition.subState);
+    }
+    found = subStates.emplace(std::move(targetQubits), std::move(subState))
+                .first;
+  }
 
-  if (fullState.numQubits > targetQubits.size() &&
-      !isSubStateVectorLegal(fullState, targetQubits)) {
+  if (!found->second.has_value()) {
     return ERROR;
   }
-
-  const auto subState = getSubStateVectorAmplitudes(fullState, targetQubits);
-
+  const Span<Complex> outAmplitudes(output->amplitudes, output->numStates);
+  const auto& subState = *found->second;
   for (size_t i = 0; i < subState.size(); i++) {
     outAmplitudes[i] = subState[i];
   }
@@ -1520,6 +3582,39 @@ Result ddsimGetStateVectorSub(SimulationState* self, size_t subStateSize,
   return OK;
 }
 
+Result ddsimGetNonZeroAmplitudes(SimulationState* self, double threshold,
+                                 size_t maxCount, size_t* indices,
+                                 Complex* amplitudes, size_t* count) {
+  auto* ddsim = toDDSimulationState(self);
+  if (threshold < 0) {
+    return ERROR;
+  }
+  if (usesDenseBackend(ddsim)) {
+    return writeIndexedAmplitudes(
+        findDenseAmplitudesAbove(
+            {ddsim->denseState.data(), ddsim->denseState.size()}, threshold,
+            maxCount),
+        indices, amplitudes, count);
+  }
+  return writeIndexedAmplitudes(
+      findAmplitudesAbove(ddsim->simulationState, threshold, maxCount),
+      indices, amplitudes, count);
+}
+
+Result ddsimGetTopKAmplitudes(SimulationState* self, size_t k, size_t* indices,
+                              Complex* amplitudes, size_t* count) {
+  auto* ddsim = toDDSimulationState(self);
+  if (usesDenseBackend(ddsim)) {
+    return writeIndexedAmplitudes(
+        findLargestDenseAmplitudes(
+            {ddsim->denseState.data(), ddsim->denseState.size()}, k),
+        indices, amplitudes, count);
+  }
+  return writeIndexedAmplitudes(
+      findLargestAmplitudes(ddsim->simulationState, k), indices, amplitudes,
+      count);
+}
+
 Diagnostics* ddsimGetDiagnostics(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
   return &ddsim->diagnostics.interface;
@@ -1528,38 +3623,38 @@ Diagnostics* ddsimGetDiagnostics(SimulationState* self) {
 Result ddsimSetBreakpoint(SimulationState* self, size_t desiredPosition,
                           size_t* targetInstruction) {
   auto* ddsim = toDDSimulationState(self);
-  for (auto i = 0ULL; i < ddsim->instructionTypes.size(); i++) {
-    const size_t start = ddsim->instructionStarts[i];
-    const size_t end = ddsim->instructionEnds[i];
+  for (auto i = 0ULL; i < ddsim->program->instructionTypes.size(); i++) {
+    const size_t start = ddsim->program->instructionStarts[i];
+    const size_t end = ddsim->program->instructionEnds[i];
     if (desiredPosition < start) {
       *targetInstruction = i;
-      ddsim->breakpoints.insert(i);
+      ddsim->instructionFlags[i] |= BREAKPOINT;
       return OK;
     }
     if (desiredPosition >= start && desiredPosition <= end) {
-      if (ddsim->functionDefinitions.contains(i)) {
+      if (hasInstructionFlag(ddsim, i, FUNCTION_DEFINITION)) {
         // Breakpoint may be located in a sub-gate of the gate definition.
-        for (auto j = i + 1; j < ddsim->instructionTypes.size(); j++) {
-          const size_t startSub = ddsim->instructionStarts[j];
-          const size_t endSub = ddsim->instructionEnds[j];
+        for (auto j = i + 1; j < ddsim->program->instructionTypes.size(); j++) {
+          const size_t startSub = ddsim->program->instructionStarts[j];
+          const size_t endSub = ddsim->program->instructionEnds[j];
           if (startSub > desiredPosition) {
             break;
           }
           if (endSub >= desiredPosition) {
             *targetInstruction = j;
-            ddsim->breakpoints.insert(j);
+            ddsim->instructionFlags[j] |= BREAKPOINT;
             return OK;
           }
-          if (ddsim->instructionTypes[j] == RETURN) {
+          if (ddsim->program->instructionTypes[j] == RETURN) {
             break;
           }
         }
         *targetInstruction = i;
-        ddsim->breakpoints.insert(i);
+        ddsim->instructionFlags[i] |= BREAKPOINT;
         return OK;
       }
       *targetInstruction = i;
-      ddsim->breakpoints.insert(i);
+      ddsim->instructionFlags[i] |= BREAKPOINT;
       return OK;
     }
   }
@@ -1568,7 +3663,9 @@ Result ddsimSetBreakpoint(SimulationState* self, size_t desiredPosition,
 
 Result ddsimClearBreakpoints(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  ddsim->breakpoints.clear();
+  for (auto& flags : ddsim->instructionFlags) {
+    flags &= static_cast<uint8_t>(~BREAKPOINT);
+  }
   return OK;
 }
 
@@ -1607,12 +3704,219 @@ size_t ddsimCompile(SimulationState* self, char* buffer,
   return compileStatisticalSlice(ddsim, buffer, settings);
 }
 
+size_t ddsimCompileSlices(SimulationState* self, char* buffer, size_t* offsets,
+                          size_t* numSlices, CompilationSettings settings) {
+  auto* ddsim = toDDSimulationState(self);
+  const auto& compiled = getCompiledSlices(ddsim, settings.opt);
+  if (numSlices != nullptr) {
+    *numSlices = compiled.offsets.size();
+  }
+  if (offsets != nullptr) {
+    std::ranges::copy(compiled.offsets, offsets);
+  }
+  if (buffer != nullptr) {
+    std::ranges::copy(compiled.arena, buffer);
+  }
+  return compiled.arena.size();
+}
+
+std::vector<SliceCircuit>
+ddsimCompileSliceCircuits(DDSimulationState* ddsim,
+                          CompilationSettings settings) {
+  if (!ddsim->ready) {
+    return {};
+  }
+  const auto& program = *ddsim->program;
+  std::vector<size_t> assertions;
+  for (size_t i = 0; i < program.instructionTypes.size(); i++) {
+    if (program.instructionTypes[i] == ASSERTION) {
+      assertions.push_back(i);
+    }
+  }
+  const auto placements = placeAssertions(program);
+
+  std::vector<SliceCircuit> slices;
+  for (const auto& slice : partitionStatisticalSlices(ddsim, settings.opt)) {
+    auto assertionTargets = getSliceTargetNames(ddsim, slice);
+    std::vector<std::string> sliceAssertions;
+    std::stringstream preamble{
+        getSlicePreamble(ddsim, slice, assertionTargets)};
+    for (std::string line; std::getline(preamble, line);) {
+      // Strip the leading "// ASSERT: " of each line.
+      sliceAssertions.push_back(line.substr(line.find(':') + 2));
+    }
+    slices.push_back(
+        {.assertions = std::move(sliceAssertions),
+         .circuit = buildSliceCircuit(program, slice, assertions,
+                                      assertionTargets, placements)});
+  }
+  return slices;
+}
+
+Result ddsimSetSeed(SimulationState* self, size_t seed) {
+  auto* ddsim = toDDSimulationState(self);
+  ddsim->rng.seed(seed);
+  return OK;
+}
+
+Result ddsimSampleShots(SimulationState* self, size_t shots, size_t seed,
+                        size_t* outcomes, size_t* counts, size_t maxOutcomes,
+                        size_t* numOutcomes) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->ready || numOutcomes == nullptr) {
+    return ERROR;
+  }
+  size_t numBits = 0;
+  for (const auto& reg : ddsim->program->classicalRegisters) {
+    numBits = std::max(numBits, reg.index + reg.size);
+  }
+  if (numBits > static_cast<size_t>(std::numeric_limits<size_t>::digits)) {
+    return ERROR;
+  }
+
+  std::map<size_t, size_t> histogram;
+  try {
+    DDSimulationState sampler;
+    if (createDDSimulationState(&sampler, ddsim->backend) == ERROR) {
+      return ERROR;
+    }
+    const DDSimulationStateGuard samplerGuard(&sampler);
+    if (ddsimLoadProgram(&sampler, ddsim->program) == ERROR) {
+      return ERROR;
+    }
+    // Assertions and diagnostics do not influence the classical outcomes.
+    sampler.replaying = true;
+    sampler.rng.seed(seed);
+    if (shots > 0) {
+      sampleFrom(&sampler, shots, histogram);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return ERROR;
+  }
+
+  *numOutcomes = histogram.size();
+  if (histogram.empty()) {
+    return OK;
+  }
+  if (histogram.size() > maxOutcomes || outcomes == nullptr ||
+      counts == nullptr) {
+    return ERROR;
+  }
+  const Span<size_t> outcomeSpan(outcomes, maxOutcomes);
+  const Span<size_t> countSpan(counts, maxOutcomes);
+  size_t i = 0;
+  for (const auto& [outcome, count] : histogram) {
+    outcomeSpan[i] = outcome;
+    countSpan[i] = count;
+    i++;
+  }
+  return OK;
+}
+
+Result ddsimSetProfilingEnabled(SimulationState* self, bool enabled) {
+  auto* ddsim = toDDSimulationState(self);
+  ddsim->profiler.setEnabled(enabled);
+  return OK;
+}
+
+Result ddsimGetProfile(SimulationState* self, ProfileEntry* entries,
+                       size_t maxEntries, size_t* numEntries) {
+  auto* ddsim = toDDSimulationState(self);
+  if (numEntries == nullptr) {
+    return ERROR;
+  }
+  const auto profile = ddsim->profiler.getEntries();
+  *numEntries = profile.size();
+  if (profile.empty()) {
+    return OK;
+  }
+  if (profile.size() > maxEntries || entries == nullptr) {
+    return ERROR;
+  }
+  std::ranges::copy(profile, entries);
+  return OK;
+}
+
+Result ddsimGetStateDelta(SimulationState* self, size_t sinceVersion,
+                          StateDelta* output) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->ready || output == nullptr ||
+      (output->maxAmplitudes > 0 && (output->amplitudeIndices == nullptr ||
+                                     output->amplitudes == nullptr))) {
+    return ERROR;
+  }
+  auto& baseline = ddsim->deltaBaseline;
+  const auto complete =
+      baseline.version == 0 || sinceVersion != baseline.version;
+
+  const auto& names = ddsim->program->variableNames;
+  const Span<Variable> variables(output->changedVariables,
+                                 output->maxChangedVariables);
+  output->numChangedVariables = 0;
+  for (size_t i = 0; i < names.size(); i++) {
+    const auto value = getClassicalBit(ddsim->classicalBits, i);
+    if (!complete && value == getClassicalBit(baseline.classicalBits, i)) {
+      continue;
+    }
+    if (output->numChangedVariables < output->maxChangedVariables &&
+        output->changedVariables != nullptr) {
+      auto& variable = variables[output->numChangedVariables];
+      variable.name = names[i]->data();
+      variable.type = VariableType::VarBool;
+      variable.value.boolValue = value;
+    }
+    output->numChangedVariables++;
+  }
+  if (output->numChangedVariables > output->maxChangedVariables ||
+      (output->numChangedVariables > 0 &&
+       output->changedVariables == nullptr)) {
+    return ERROR;
+  }
+
+  output->complete = complete;
+  output->currentInstruction = ddsim->currentInstruction;
+  output->finished = ddsimIsFinished(self);
+  output->assertionFailed = ddsimDidAssertionFail(self);
+  output->breakpointHit = ddsimWasBreakpointHit(self);
+  ddsimGetStackDepth(self, &output->stackDepth);
+  if (output->maxStackDepth > 0 && output->stackTrace != nullptr) {
+    ddsimGetStackTrace(self,
+                       std::min(output->maxStackDepth, output->stackDepth),
+                       output->stackTrace);
+  }
+
+  output->numAmplitudes = 0;
+  output->amplitudesComplete = false;
+  output->amplitudesTruncated = false;
+  if (output->maxAmplitudes > 0) {
+    reportChangedAmplitudes(ddsim, complete, *output);
+  } else {
+    baseline.amplitudes = AmplitudeBuffer{};
+  }
+
+  baseline.classicalBits = ddsim->classicalBits;
+  baseline.version = ++baseline.issuedVersions;
+  output->version = baseline.version;
+  return OK;
+}
+
 Result destroyDDSimulationState(DDSimulationState* self) {
+  if (self->asyncRun.valid()) {
+    self->paused = true;
+    self->asyncRun.wait();
+  }
   self->ready = false;
   destroyDDDiagnostics(&self->diagnostics);
   return OK;
 }
 
+DenseMemoryUsage ddsimGetDenseMemoryUsage(const DDSimulationState* ddsim) {
+  return {.current = ddsim->denseMemoryInUse + getRetainedDenseMemory(ddsim),
+          .peak = ddsim->peakDenseMemory,
+          .budget = ddsim->denseMemoryBudget};
+}
+
 //-----------------------------------------------------------------------------------------
 
 std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
@@ -1621,11 +3925,11 @@ std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
   size_t parentFunction = -1ULL;
   size_t i = instruction;
   while (true) {
-    if (ddsim->functionDefinitions.contains(i)) {
+    if (hasInstructionFlag(ddsim, i, FUNCTION_DEFINITION)) {
       parentFunction = i;
       break;
     }
-    if (ddsim->instructionTypes[i] == RETURN) {
+    if (ddsim->program->instructionTypes[i] == RETURN) {
       break;
     }
     if (i == 0) {
@@ -1635,18 +3939,19 @@ std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
   }
 
   const auto parameters = parentFunction != -1ULL
-                              ? ddsim->targetQubits[parentFunction]
+                              ? ddsim->program->targetQubits[parentFunction]
                               : std::vector<std::string>{};
-  for (const auto& target : ddsim->targetQubits[instruction]) {
+  for (const auto& target : ddsim->program->targetQubits[instruction]) {
     if (std::ranges::find(parameters, target) != parameters.end()) {
       result.push_back(target);
       continue;
     }
-    const auto foundRegister = std::ranges::find_if(
-        ddsim->qubitRegisters, [target](const QubitRegisterDefinition& reg) {
-          return reg.name == target;
-        });
-    if (foundRegister != ddsim->qubitRegisters.end()) {
+    const auto foundRegister =
+        std::ranges::find_if(ddsim->program->qubitRegisters,
+                             [target](const QubitRegisterDefinition& reg) {
+                               return reg.name == target;
+                             });
+    if (foundRegister != ddsim->program->qubitRegisters.end()) {
       for (size_t j = 0; j < foundRegister->size; j++) {
         result.push_back(target + "[" + std::to_string(j) + "]");
       }
@@ -1672,10 +3977,12 @@ size_t variableToQubit(DDSimulationState* ddsim, const std::string& variable) {
 
   for (size_t i = ddsim->callReturnStack.size() - 1; i != -1ULL; i--) {
     const auto call = ddsim->callReturnStack[i];
-    if (!ddsim->callSubstitutions[call].contains(var)) {
+    const auto substitution = ddsim->program->callSubstitutions.find(call);
+    if (substitution == ddsim->program->callSubstitutions.end() ||
+        !substitution->second.contains(var)) {
       continue;
     }
-    var = ddsim->callSubstitutions[call][var];
+    var = substitution->second.at(var);
     if (var.find('[') != std::string::npos) {
       auto parts = splitString(var, '[');
       var = parts[0];
@@ -1683,7 +3990,7 @@ size_t variableToQubit(DDSimulationState* ddsim, const std::string& variable) {
     }
   }
 
-  for (auto& reg : ddsim->qubitRegisters) {
+  for (auto& reg : ddsim->program->qubitRegisters) {
     if (reg.name == var) {
       if (idx >= reg.size) {
         throw std::runtime_error("Index out of bounds");
@@ -1699,13 +4006,12 @@ std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
                                             size_t instruction) {
   size_t sweep = instruction;
   size_t functionDef = -1ULL;
-  while (sweep < ddsim->instructionTypes.size()) {
-    if (std::ranges::find(ddsim->functionDefinitions, sweep) !=
-        ddsim->functionDefinitions.end()) {
+  while (sweep < ddsim->program->instructionTypes.size()) {
+    if (hasInstructionFlag(ddsim, sweep, FUNCTION_DEFINITION)) {
       functionDef = sweep;
       break;
     }
-    if (ddsim->instructionTypes[sweep] == RETURN) {
+    if (ddsim->program->instructionTypes[sweep] == RETURN) {
       break;
     }
     sweep--;
@@ -1718,7 +4024,7 @@ std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
 
   // In a gate-local scope, we have to define qubit indices relative to the
   // gate.
-  const auto& targets = ddsim->targetQubits[functionDef];
+  const auto& targets = ddsim->program->targetQubits[functionDef];
 
   const auto found = std::ranges::find(targets, variable);
   if (found == targets.end()) {
@@ -1729,6 +4035,55 @@ std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
           functionDef};
 }
 
+bool hasInstructionFlag(const DDSimulationState* ddsim, size_t instruction,
+                        InstructionFlag flag) {
+  return instruction < ddsim->instructionFlags.size() &&
+         (ddsim->instructionFlags[instruction] & flag) != 0;
+}
+
+size_t resolveQubitReference(const DDSimulationState* ddsim,
+                             QubitReference reference) {
+  auto frame = ddsim->callReturnStack.size();
+  while (reference.kind == QubitReferenceKind::Parameter && frame > 0) {
+    frame--;
+    const auto& arguments =
+        ddsim->program->callArguments[ddsim->callReturnStack[frame]];
+    reference = arguments[reference.index];
+  }
+  if (reference.kind != QubitReferenceKind::Qubit) {
+    throw std::runtime_error("Unknown variable name");
+  }
+  return reference.index;
+}
+
+std::vector<size_t> resolveTargetQubits(const DDSimulationState* ddsim,
+                                        size_t instruction) {
+  const auto& references = ddsim->program->instructionQubits[instruction];
+  std::vector<size_t> qubits(references.size());
+  std::ranges::transform(references, qubits.begin(),
+                         [ddsim](const QubitReference& reference) {
+                           return resolveQubitReference(ddsim, reference);
+                         });
+  return qubits;
+}
+
+std::pair<double, double> getQubitProbabilities(DDSimulationState* ddsim,
+                                                size_t qubit) {
+  auto& marginals = getStateViews(ddsim).marginals;
+  const auto found = marginals.find(qubit);
+  if (found != marginals.end()) {
+    return found->second;
+  }
+  const auto probabilities =
+      usesDenseBackend(ddsim)
+          ? getDenseQubitProbabilities(
+                {ddsim->denseState.data(), ddsim->denseState.size()}, qubit)
+          : dd::Package::determineMeasurementProbabilities(
+                ddsim->simulationState, static_cast<dd::Qubit>(qubit));
+  marginals.emplace(qubit, probabilities);
+  return probabilities;
+}
+
 bool isSubStateVectorLegal(const Statevector& full,
                            std::vector<size_t>& targetQubits) {
   const auto numQubits = full.numQubits;
@@ -1741,77 +4096,56 @@ bool isSubStateVectorLegal(const Statevector& full,
   return partialTraceIsPure(full, ignored);
 }
 
-bool checkAssertion(DDSimulationState* ddsim,
-                    std::unique_ptr<Assertion>& assertion) {
-  if (assertion->getType() == AssertionType::Entanglement) {
-    std::unique_ptr<EntanglementAssertion> entanglementAssertion(
-        dynamic_cast<EntanglementAssertion*>(assertion.release()));
-    auto result = checkAssertionEntangled(ddsim, entanglementAssertion);
-    assertion = std::move(entanglementAssertion);
-    return result;
+bool checkAssertion(DDSimulationState* ddsim, size_t instruction,
+                    const Assertion& assertion) {
+  const auto qubits = resolveTargetQubits(ddsim, instruction);
+  if (assertion.getType() == AssertionType::Entanglement) {
+    return checkAssertionEntangled(ddsim, qubits);
   }
-  if (assertion->getType() == AssertionType::Superposition) {
-    std::unique_ptr<SuperpositionAssertion> superpositionAssertion(
-        dynamic_cast<SuperpositionAssertion*>(assertion.release()));
-    auto result = checkAssertionSuperposition(ddsim, superpositionAssertion);
-    assertion = std::move(superpositionAssertion);
-    return result;
+  if (assertion.getType() == AssertionType::Superposition) {
+    return checkAssertionSuperposition(ddsim, qubits);
   }
-  if (assertion->getType() == AssertionType::StatevectorEquality) {
-    std::unique_ptr<StatevectorEqualityAssertion> svEqualityAssertion(
-        dynamic_cast<StatevectorEqualityAssertion*>(assertion.release()));
-    auto result = checkAssertionEqualityStatevector(ddsim, svEqualityAssertion);
-    assertion = std::move(svEqualityAssertion);
-    return result;
+  if (assertion.getType() == AssertionType::StatevectorEquality) {
+    return checkAssertionEqualityStatevector(
+        ddsim, dynamic_cast<const StatevectorEqualityAssertion&>(assertion),
+        qubits);
   }
-  if (assertion->getType() == AssertionType::CircuitEquality) {
-    std::unique_ptr<CircuitEqualityAssertion> circuitEqualityAssertion(
-        dynamic_cast<CircuitEqualityAssertion*>(assertion.release()));
-    auto result =
-        checkAssertionEqualityCircuit(ddsim, circuitEqualityAssertion);
-    assertion = std::move(circuitEqualityAssertion);
-    return result;
+  if (assertion.getType() == AssertionType::CircuitEquality) {
+    return checkAssertionEqualityCircuit(
+        ddsim, dynamic_cast<const CircuitEqualityAssertion&>(assertion),
+        qubits);
   }
   throw std::runtime_error("Unknown assertion type");
 }
 
-std::string preprocessAssertionCode(const char* code,
-                                    DDSimulationState* ddsim) {
-
-  auto instructions = preprocessCode(code, ddsim->processedCode);
-  dddiagnosticsOnCodePreprocessing(&ddsim->diagnostics, instructions);
+std::string preprocessAssertionCode(const char* code, DDSimProgram& program) {
+  auto instructions = preprocessCode(code, program.processedCode);
+  program.commutation.reserve(instructions.size());
+  for (const auto& instruction : instructions) {
+    program.commutation.push_back(getCommutationInfo(instruction));
+  }
+  program.assertionsToMove =
+      findAssertionsToMove(instructions, program.commutation);
   std::vector<std::string> correctLines;
-  ddsim->instructionTypes.clear();
-  ddsim->functionDefinitions.clear();
-  ddsim->instructionStarts.clear();
-  ddsim->instructionEnds.clear();
-  ddsim->callSubstitutions.clear();
-  ddsim->classicalRegisters.clear();
-  ddsim->qubitRegisters.clear();
-  ddsim->successorInstructions.clear();
-  ddsim->dataDependencies.clear();
-  ddsim->functionCallers.clear();
-  ddsim->targetQubits.clear();
-  ddsim->instructionObjects.clear();
 
   for (auto& instruction : instructions) {
-    ddsim->targetQubits.push_back(instruction.targets);
-    ddsim->successorInstructions.insert(
-        {instruction.lineNumber, instruction.successorIndex});
-    ddsim->instructionStarts.push_back(instruction.originalCodeStartPosition);
-    ddsim->instructionEnds.push_back(instruction.originalCodeEndPosition);
-    ddsim->dataDependencies.insert({instruction.lineNumber, {}});
+    program.targetQubits.push_back(instruction.targets);
+    program.successorInstructions.push_back(instruction.successorIndex);
+    program.instructionFlags.push_back(0);
+    program.instructionStarts.push_back(instruction.originalCodeStartPosition);
+    program.instructionEnds.push_back(instruction.originalCodeEndPosition);
+    program.dataDependencies.insert({instruction.lineNumber, {}});
     for (const auto& dependency : instruction.dataDependencies) {
-      ddsim->dataDependencies[instruction.lineNumber].emplace_back(
+      program.dataDependencies[instruction.lineNumber].emplace_back(
           dependency.first, dependency.second);
     }
     if (instruction.isFunctionCall) {
       const size_t successorInFunction = instruction.successorIndex;
       const size_t functionIndex = successorInFunction - 1;
-      if (!ddsim->functionCallers.contains(functionIndex)) {
-        ddsim->functionCallers.insert({functionIndex, {}});
+      if (!program.functionCallers.contains(functionIndex)) {
+        program.functionCallers.insert({functionIndex, {}});
       }
-      ddsim->functionCallers[functionIndex].insert(instruction.lineNumber);
+      program.functionCallers[functionIndex].insert(instruction.lineNumber);
     }
 
     // what exactly we do with each instruction depends on its type:
@@ -1825,32 +4159,32 @@ std::string preprocessAssertionCode(const char* code,
     // code because they were already added when the function definition was
     // first encountered.
     if (instruction.code == "RETURN") {
-      ddsim->instructionTypes.push_back(RETURN);
+      program.instructionTypes.push_back(RETURN);
     } else if (instruction.assertion != nullptr) {
-      ddsim->instructionTypes.push_back(ASSERTION);
-      ddsim->assertionInstructions.insert(
+      program.instructionTypes.push_back(ASSERTION);
+      program.assertionInstructions.insert(
           {instruction.lineNumber, std::move(instruction.assertion)});
     } else if (instruction.isFunctionDefinition) {
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(
             validCodeFromChildren(instruction, instructions));
       }
-      ddsim->functionDefinitions.insert(instruction.lineNumber);
-      ddsim->instructionTypes.push_back(NOP);
+      program.instructionFlags.back() |= FUNCTION_DEFINITION;
+      program.instructionTypes.push_back(NOP);
     } else if (instruction.isFunctionCall) {
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(instruction.code);
       }
-      ddsim->callSubstitutions.insert(
+      program.callSubstitutions.insert(
           {instruction.lineNumber, instruction.callSubstitution});
-      ddsim->instructionTypes.push_back(CALL);
+      program.instructionTypes.push_back(CALL);
     } else if (instruction.code.find("OPENQASM 2.0") != std::string::npos ||
                instruction.code.find("OPENQASM 3.0") != std::string::npos ||
                instruction.code.find("include") != std::string::npos) {
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(instruction.code);
       }
-      ddsim->instructionTypes.push_back(NOP);
+      program.instructionTypes.push_back(NOP);
     } else if (instruction.code.find("qreg") != std::string::npos) {
       auto declaration = replaceString(instruction.code, "qreg", "");
       declaration = replaceString(declaration, " ", "");
@@ -1861,18 +4195,18 @@ std::string preprocessAssertionCode(const char* code,
       auto name = parts[0];
       const size_t size = std::stoul(parts[1].substr(0, parts[1].size() - 1));
 
-      const size_t index = ddsim->qubitRegisters.empty()
+      const size_t index = program.qubitRegisters.empty()
                                ? 0
-                               : ddsim->qubitRegisters.back().index +
-                                     ddsim->qubitRegisters.back().size;
+                               : program.qubitRegisters.back().index +
+                                     program.qubitRegisters.back().size;
       const QubitRegisterDefinition reg{
           .name = name, .index = index, .size = size};
-      ddsim->qubitRegisters.push_back(reg);
+      program.qubitRegisters.push_back(reg);
 
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(instruction.code);
       }
-      ddsim->instructionTypes.push_back(NOP);
+      program.instructionTypes.push_back(NOP);
     } else if (instruction.code.find("creg") != std::string::npos) {
       auto declaration = replaceString(instruction.code, "creg", "");
       declaration = replaceString(declaration, " ", "");
@@ -1882,34 +4216,31 @@ std::string preprocessAssertionCode(const char* code,
       auto& name = parts[0];
       const size_t size = std::stoul(parts[1].substr(0, parts[1].size() - 1));
 
-      const size_t index = ddsim->classicalRegisters.empty()
+      const size_t index = program.classicalRegisters.empty()
                                ? 0
-                               : ddsim->classicalRegisters.back().index +
-                                     ddsim->classicalRegisters.back().size;
+                               : program.classicalRegisters.back().index +
+                                     program.classicalRegisters.back().size;
       const ClassicalRegisterDefinition reg{
           .name = removeWhitespace(name), .index = index, .size = size};
-      ddsim->classicalRegisters.push_back(reg);
+      program.classicalRegisters.push_back(reg);
       for (auto i = 0ULL; i < size; i++) {
         const auto variableName =
             removeWhitespace(name) + "[" + std::to_string(i) + "]";
-        ddsim->variableNames.push_back(
+        program.variableIndices.emplace(variableName, index + i);
+        program.variableNames.push_back(
             std::make_unique<std::string>(variableName));
-        const Variable newVariable{ddsim->variableNames.back()->data(),
-                                   VariableType::VarBool,
-                                   {false}};
-        ddsim->variables.insert({newVariable.name, newVariable});
       }
 
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(instruction.code);
       }
-      ddsim->instructionTypes.push_back(NOP);
+      program.instructionTypes.push_back(NOP);
     } else {
       if (!instruction.inFunctionDefinition) {
         correctLines.push_back(
             validCodeFromChildren(instruction, instructions));
       }
-      ddsim->instructionTypes.push_back(SIMULATE);
+      program.instructionTypes.push_back(SIMULATE);
     }
   }
 
@@ -1919,12 +4250,16 @@ std::string preprocessAssertionCode(const char* code,
       [](const std::string& a, const std::string& b) { return a + b; });
 
   std::ranges::move(instructions,
-                    std::back_inserter(ddsim->instructionObjects));
+                    std::back_inserter(program.instructionObjects));
+  buildQubitResolutionTables(program);
+  buildInteractionIndex(program);
+  buildDependencyIndex(program);
+  buildClassicConditions(program);
   return result;
 }
 
 std::string getClassicalBitName(DDSimulationState* ddsim, size_t index) {
-  for (auto& reg : ddsim->classicalRegisters) {
+  for (auto& reg : ddsim->program->classicalRegisters) {
     if (index >= reg.index && index < reg.index + reg.size) {
       return reg.name + "[" + std::to_string(index - reg.index) + "]";
     }
@@ -1933,7 +4268,7 @@ std::string getClassicalBitName(DDSimulationState* ddsim, size_t index) {
 }
 
 std::string getQuantumBitName(DDSimulationState* ddsim, size_t index) {
-  for (auto& reg : ddsim->qubitRegisters) {
+  for (auto& reg : ddsim->program->qubitRegisters) {
     if (index >= reg.index && index < reg.index + reg.size) {
       return reg.name + "[" + std::to_string(index - reg.index) + "]";
     }
@@ -1943,119 +4278,21 @@ std::string getQuantumBitName(DDSimulationState* ddsim, size_t index) {
 
 size_t compileStatisticalSlice(DDSimulationState* ddsim, char* buffer,
                                CompilationSettings settings) {
-  std::vector<size_t> assertionsToSkip;
-  std::vector<size_t> assertionsToCover;
-  auto sliceIndex = settings.sliceIndex;
-  for (size_t i = 0; i < ddsim->instructionTypes.size(); i++) {
-    if (ddsim->instructionTypes[i] != ASSERTION) {
-      continue;
-    }
-    assertionsToSkip.push_back(i);
-    if (settings.opt >= 1 && tryCancelAssertion(ddsim, i)) {
-      continue;
-    }
-
-    if (settings.opt < 2 ||
-        !areAssertionsIndependent(ddsim, assertionsToCover, i)) {
-      if (sliceIndex == 0) {
-        if (settings.opt < 2) {
-          assertionsToCover.emplace_back(i);
-        }
-        break;
-      }
-      sliceIndex--;
-      assertionsToCover.clear();
-    }
-    if (settings.opt >= 2) {
-      assertionsToCover.emplace_back(i);
-    }
-  }
-  if (sliceIndex > 0 || assertionsToCover.empty()) {
+  const auto& compiled = getCompiledSlices(ddsim, settings.opt);
+  if (settings.sliceIndex >= compiled.offsets.size()) {
     return 0;
   }
-
-  std::stringstream ss;
-
-  // Determine the measurement targets required for the assertion.
-  std::map<size_t, std::map<std::string, std::string>> assertionTargets;
-  std::set<std::string> assertionTargetsSet;
-  for (const auto foundIndex : assertionsToCover) {
-    for (const auto& target :
-         ddsim->assertionInstructions[foundIndex]->getTargetQubits()) {
-      std::string targetName =
-          "test_" + replaceString(replaceString(target, "]", ""), "[", "");
-      while (assertionTargetsSet.contains(targetName)) {
-        targetName += "_";
-      }
-      assertionTargets[foundIndex][target] = targetName;
-      assertionTargetsSet.insert(targetName);
-    }
-  }
-
-  // Add the preamble.
-  for (const auto foundIndex : assertionsToCover) {
-    auto& assertion = ddsim->assertionInstructions[foundIndex];
-    if (assertion->getType() == AssertionType::StatevectorEquality) {
-      std::unique_ptr<StatevectorEqualityAssertion> svEqualityAssertion(
-          dynamic_cast<StatevectorEqualityAssertion*>(assertion.release()));
-      ss << getStatisticalSliceEqualityPreamble(svEqualityAssertion,
-                                                assertionTargets[foundIndex]);
-      assertion = std::move(svEqualityAssertion);
-    } else if (assertion->getType() == AssertionType::Superposition) {
-      std::unique_ptr<SuperpositionAssertion> superpositionAssertion(
-          dynamic_cast<SuperpositionAssertion*>(assertion.release()));
-      ss << getStatisticalSliceSuperpositionPreamble(
-          superpositionAssertion, assertionTargets[foundIndex]);
-      assertion = std::move(superpositionAssertion);
-    } else if (assertion->getType() == AssertionType::CircuitEquality) {
-      std::unique_ptr<CircuitEqualityAssertion> circuitEqualityAssertion(
-          dynamic_cast<CircuitEqualityAssertion*>(assertion.release()));
-      ss << getProjectiveMeasurementPreamble(circuitEqualityAssertion,
-                                             assertionTargets[foundIndex]);
-      assertion = std::move(circuitEqualityAssertion);
-    }
-  }
-
-  // Add the remaining code.
-  size_t last = 0;
-  for (const auto toSkip : assertionsToSkip) {
-    size_t start = 0;
-    size_t end = 0;
-    ddsim->interface.getInstructionPosition(&ddsim->interface, toSkip, &start,
-                                            &end);
-    const auto before = ddsim->code.substr(last, start - last);
-    ss << before;
-    last = end + 1;
-    if (ddsim->code[last] == '\n') {
-      last++;
-    }
-    if (assertionTargets.contains(toSkip)) {
-      // Add the required classical registers.
-      for (const auto& [_, cbit] : assertionTargets[toSkip]) {
-        ss << "creg " << cbit << "[1];\n";
-      }
-      if (ddsim->assertionInstructions[toSkip]->getType() ==
-          AssertionType::CircuitEquality) {
-        compileProjectiveMeasurement(ddsim, ss, toSkip,
-                                     assertionTargets[toSkip]);
-      } else {
-        for (const auto& [qbit, cbit] : assertionTargets[toSkip]) {
-          ss << "measure " << qbit << " -> " << cbit << "[0];\n";
-        }
-      }
-    }
-  }
-
-  const auto compiledCode = ss.str();
+  const auto start = compiled.offsets[settings.sliceIndex];
+  const auto size = settings.sliceIndex + 1 < compiled.offsets.size()
+                        ? compiled.offsets[settings.sliceIndex + 1] - start
+                        : compiled.arena.size() - start;
   if (buffer == nullptr) {
-    return compiledCode.length() + 1;
-  }
-  const Span<char> bufferSpan(buffer, compiledCode.length() + 1);
-  for (size_t i = 0; i < compiledCode.length(); i++) {
-    bufferSpan[i] = compiledCode[i];
+    return size;
   }
-  bufferSpan[compiledCode.length()] = '\0';
-  return compiledCode.length() + 1;
+  const Span<char> bufferSpan(buffer, size);
+  std::copy_n(compiled.arena.begin() + static_cast<std::ptrdiff_t>(start),
+              size, bufferSpan.data());
+  return size;
 }
 
 } // namespace mqt::debugger
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimDense.cpp
+ * @brief Implementation of DDSimDense.hpp
+ */
+
+#include "backend/dd/DDSimDense.hpp"
+
+#include "backend/dd/DDSimTraversal.hpp"
+#include "common.h"
+#include "common/Span.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/Definitions.hpp"
+#include "ir/operations/Control.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+namespace {
+
+using Amplitude = std::complex<double>;
+
+/**
+ * @brief Run a kernel for every index below a count, in parallel if requested
+ * and OpenMP is available.
+ * @param count The number of indices.
+ * @param parallel Whether the indices may be distributed over threads.
+ * @param kernel The kernel to run for each index. Runs for different indices
+ * must be independent.
+ */
+template <typename Kernel>
+void forEachIndex(size_t count, [[maybe_unused]] bool parallel,
+                  const Kernel& kernel) {
+  const auto signedCount = static_cast<std::int64_t>(count);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (parallel)
+#endif
+  for (std::int64_t i = 0; i < signedCount; i++) {
+    kernel(static_cast<size_t>(i));
+  }
+}
+
+/**
+ * @brief Insert zero bits into an index at the given positions.
+ * @param index The index to spread out.
+ * @param positions The positions of the zero bits in ascending order.
+ * @return The index with a zero bit at each of the positions.
+ */
+size_t insertZeroBits(size_t index, const std::vector<size_t>& positions) {
+  for (const auto position : positions) {
+    const auto low = index & ((1ULL << position) - 1);
+    index = ((index >> position) << (position + 1)) | low;
+  }
+  return index;
+}
+
+/**
+ * @brief Load an amplitude of a dense state vector.
+ * @param amplitude The amplitude to load.
+ * @return The amplitude as a complex number.
+ */
+Amplitude load(const Complex& amplitude) {
+  return {amplitude.real, amplitude.imaginary};
+}
+
+/**
+ * @brief Store a complex number as an amplitude of a dense state vector.
+ * @param target The amplitude to overwrite.
+ * @param value The value to store.
+ */
+void store(Complex& target, const Amplitude& value) {
+  target.real = value.real();
+  target.imaginary = value.imag();
+}
+
+/**
+ * @brief Apply a gate with a single target to a dense state vector.
+ * @param amplitudes The amplitudes of the state vector.
+ * @param gate The gate to apply.
+ * @param positions The target and control qubits in ascending order.
+ */
+void applySingleTargetGate(const Span<Complex>& amplitudes,
+                           const DenseGate& gate,
+                           const std::vector<size_t>& positions) {
+  const auto offset = 1ULL << gate.targets.front();
+  const auto m00 = gate.matrix[0];
+  const auto m01 = gate.matrix[1];
+  const auto m10 = gate.matrix[2];
+  const auto m11 = gate.matrix[3];
+  forEachIndex(amplitudes.size() >> positions.size(),
+               amplitudes.size() >= PARALLEL_DENSE_MIN_AMPLITUDES,
+               [&](size_t block) {
+                 const auto base =
+                     insertZeroBits(block, positions) | gate.controlValue;
+                 const auto a0 = load(amplitudes[base]);
+                 const auto a1 = load(amplitudes[base | offset]);
+                 store(amplitudes[base], (m00 * a0) + (m01 * a1));
+                 store(amplitudes[base | offset], (m10 * a0) + (m11 * a1));
+               });
+}
+
+} // namespace
+
+DenseGate makeDenseGate(const qc::Operation& op, dd::Package& package) {
+  const auto& targets = op.getTargets();
+  if (targets.size() > MAX_DENSE_GATE_TARGETS) {
+    throw std::invalid_argument(
+        "The dense backend does not support gates with more than " +
+        std::to_string(MAX_DENSE_GATE_TARGETS) + " targets.");
+  }
+  DenseGate gate;
+  gate.targets.assign(targets.begin(), targets.end());
+  for (const auto& control : op.getControls()) {
+    const auto bit = 1ULL << control.qubit;
+    gate.controlMask |= bit;
+    if (control.type == qc::Control::Type::Pos) {
+      gate.controlValue |= bit;
+    }
+  }
+
+  // The operation is moved to the lowest qubits of the package and stripped
+  // of its controls. The upper left block of its matrix then is the matrix of
+  // the gate on its targets.
+  auto local = op.clone();
+  local->clearControls();
+  qc::Targets localTargets(targets.size());
+  std::iota(localTargets.begin(), localTargets.end(), 0);
+  local->setTargets(localTargets);
+  const auto matrix = dd::getDD(*local, package).getMatrix(package.qubits());
+
+  const auto dimension = 1ULL << targets.size();
+  gate.matrix.reserve(dimension * dimension);
+  for (size_t row = 0; row < dimension; row++) {
+    for (size_t column = 0; column < dimension; column++) {
+      gate.matrix.push_back(matrix[row][column]);
+    }
+  }
+  return gate;
+}
+
+DenseGate invertDenseGate(const DenseGate& gate) {
+  auto inverse = gate;
+  const auto dimension = 1ULL << gate.targets.size();
+  for (size_t row = 0; row < dimension; row++) {
+    for (size_t column = 0; column < dimension; column++) {
+      inverse.matrix[(row * dimension) + column] =
+          std::conj(gate.matrix[(column * dimension) + row]);
+    }
+  }
+  return inverse;
+}
+
+void applyDenseGate(const Span<Complex>& amplitudes, const DenseGate& gate) {
+  std::vector<size_t> positions = gate.targets;
+  for (size_t qubit = 0; (gate.controlMask >> qubit) != 0; qubit++) {
+    if (((gate.controlMask >> qubit) & 1U) != 0) {
+      positions.push_back(qubit);
+    }
+  }
+  std::ranges::sort(positions);
+
+  if (gate.targets.size() == 1) {
+    applySingleTargetGate(amplitudes, gate, positions);
+    return;
+  }
+
+  // The offsets of the amplitudes of a block, relative to the amplitude in
+  // which all targets are 0.
+  const auto dimension = 1ULL << gate.targets.size();
+  std::array<size_t, 1ULL << MAX_DENSE_GATE_TARGETS> offsets{};
+  for (size_t local = 0; local < dimension; local++) {
+    for (size_t i = 0; i < gate.targets.size(); i++) {
+      if (((local >> i) & 1U) != 0) {
+        offsets.at(local) |= 1ULL << gate.targets[i];
+      }
+    }
+  }
+  forEachIndex(
+      amplitudes.size() >> positions.size(),
+      amplitudes.size() >= PARALLEL_DENSE_MIN_AMPLITUDES, [&](size_t block) {
+        const auto base = insertZeroBits(block, positions) | gate.controlValue;
+        std::array<Amplitude, 1ULL << MAX_DENSE_GATE_TARGETS> input{};
+        for (size_t local = 0; local < dimension; local++) {
+          input.at(local) = load(amplitudes[base | offsets.at(local)]);
+        }
+        for (size_t row = 0; row < dimension; row++) {
+          Amplitude sum = 0;
+          for (size_t column = 0; column < dimension; column++) {
+            sum += gate.matrix[(row * dimension) + column] * input.at(column);
+          }
+          store(amplitudes[base | offsets.at(row)], sum);
+        }
+      });
+}
+
+std::pair<double, double>
+getDenseQubitProbabilities(const Span<const Complex>& amplitudes,
+                           size_t qubit) {
+  const auto mask = 1ULL << qubit;
+  const auto count = static_cast<std::int64_t>(amplitudes.size());
+  [[maybe_unused]] const auto parallel =
+      amplitudes.size() >= PARALLEL_DENSE_MIN_AMPLITUDES;
+  double pZero = 0;
+  double pOne = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : pZero, pOne)           \
+    if (parallel)
+#endif
+  for (std::int64_t i = 0; i < count; i++) {
+    const auto& amplitude = amplitudes[static_cast<size_t>(i)];
+    const auto probability = (amplitude.real * amplitude.real) +
+                             (amplitude.imaginary * amplitude.imaginary);
+    if ((static_cast<size_t>(i) & mask) != 0) {
+      pOne += probability;
+    } else {
+      pZero += probability;
+    }
+  }
+  return {pZero, pOne};
+}
+
+void collapseDenseQubit(const Span<Complex>& amplitudes, size_t qubit,
+                        double probability, bool measureZero) {
+  const auto mask = 1ULL << qubit;
+  const auto kept = measureZero ? 0ULL : mask;
+  const auto scale = 1.0 / std::sqrt(probability);
+  forEachIndex(amplitudes.size(),
+               amplitudes.size() >= PARALLEL_DENSE_MIN_AMPLITUDES,
+               [&](size_t i) {
+                 auto& amplitude = amplitudes[i];
+                 if ((i & mask) == kept) {
+                   amplitude.real *= scale;
+                   amplitude.imaginary *= scale;
+                 } else {
+                   amplitude = {0, 0};
+                 }
+               });
+}
+
+bool hasMultipleDenseOutcomes(const Span<const Complex>& amplitudes,
+                              const std::vector<size_t>& qubits) {
+  if (qubits.empty()) {
+    return false;
+  }
+  size_t mask = 0;
+  for (const auto qubit : qubits) {
+    mask |= 1ULL << qubit;
+  }
+  bool found = false;
+  size_t outcome = 0;
+  for (size_t i = 0; i < amplitudes.size(); i++) {
+    if (std::abs(load(amplitudes[i])) <= SUPPORT_TOLERANCE) {
+      continue;
+    }
+    if (!found) {
+      found = true;
+      outcome = i & mask;
+    } else if ((i & mask) != outcome) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::pair<size_t, Complex>>
+findDenseAmplitudesAbove(const Span<const Complex>& amplitudes,
+                         double threshold, size_t maxCount) {
+  std::vector<std::pair<size_t, Complex>> result;
+  for (size_t i = 0; i < amplitudes.size() && result.size() < maxCount; i++) {
+    if (std::abs(load(amplitudes[i])) > threshold) {
+      result.emplace_back(i, amplitudes[i]);
+    }
+  }
+  return result;
+}
+
+std::vector<std::pair<size_t, Complex>>
+findLargestDenseAmplitudes(const Span<const Complex>& amplitudes, size_t k) {
+  if (k == 0) {
+    return {};
+  }
+  using Candidate = std::pair<double, size_t>;
+  // The queue keeps the best `k` candidates found so far, with the worst of
+  // them on top.
+  const auto better = [](const Candidate& a, const Candidate& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  std::priority_queue<Candidate, std::vector<Candidate>, decltype(better)>
+      best(better);
+  for (size_t i = 0; i < amplitudes.size(); i++) {
+    const auto magnitude = std::abs(load(amplitudes[i]));
+    if (magnitude == 0) {
+      continue;
+    }
+    if (best.size() < k) {
+      best.emplace(magnitude, i);
+    } else if (better({magnitude, i}, best.top())) {
+      best.pop();
+      best.emplace(magnitude, i);
+    }
+  }
+  std::vector<std::pair<size_t, Complex>> result(best.size());
+  for (auto it = result.rbegin(); it != result.rend(); ++it) {
+    *it = {best.top().second, amplitudes[best.top().second]};
+    best.pop();
+  }
+  return result;
+}
+
+} // namespace mqt::debugger
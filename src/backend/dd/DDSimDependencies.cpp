@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimDependencies.cpp
+ * @brief Implementation of DDSimDependencies.hpp
+ */
+
+#include "backend/dd/DDSimDependencies.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+void DDSimDependencyIndex::build(
+    const std::vector<std::vector<size_t>>& dependencies,
+    std::vector<size_t> scopes,
+    const std::map<size_t, std::set<size_t>>& callers) {
+  offsets.clear();
+  edges.clear();
+  offsets.reserve(dependencies.size() + 1);
+  for (const auto& direct : dependencies) {
+    offsets.push_back(edges.size());
+    edges.insert(edges.end(), direct.begin(), direct.end());
+  }
+  offsets.push_back(edges.size());
+
+  this->scopes = std::move(scopes);
+  this->callers.clear();
+  for (const auto& [definition, calls] : callers) {
+    this->callers.emplace(definition,
+                          std::vector<size_t>(calls.begin(), calls.end()));
+  }
+}
+
+size_t DDSimDependencyIndex::size() const { return scopes.size(); }
+
+std::vector<size_t>
+DDSimDependencyIndex::getDependencies(size_t instruction,
+                                      bool includeCallers) const {
+  if (instruction >= size()) {
+    return {};
+  }
+  const auto unknownCallers =
+      includeCallers ? getUnknownCallers(instruction) : std::set<size_t>{};
+
+  std::vector<uint64_t> visited((size() + 63) / 64);
+  const auto visit = [&visited](size_t index) {
+    const auto mask = 1ULL << (index % 64);
+    if ((visited[index / 64] & mask) != 0) {
+      return false;
+    }
+    visited[index / 64] |= mask;
+    return true;
+  };
+
+  std::vector<size_t> result;
+  std::vector<size_t> toVisit{instruction};
+  visit(instruction);
+  while (!toVisit.empty()) {
+    const auto current = toVisit.back();
+    toVisit.pop_back();
+    result.push_back(current);
+
+    for (auto i = offsets[current]; i < offsets[current + 1]; i++) {
+      if (visit(edges[i])) {
+        toVisit.push_back(edges[i]);
+      }
+    }
+
+    // The first instruction of a gate whose callers are unknown also depends
+    // on all of its callers.
+    if (current == 0 || !unknownCallers.contains(current - 1)) {
+      continue;
+    }
+    const auto found = callers.find(current - 1);
+    if (found == callers.end()) {
+      continue;
+    }
+    for (const auto caller : found->second) {
+      if (visit(caller)) {
+        toVisit.push_back(caller);
+      }
+    }
+  }
+  return result;
+}
+
+std::set<size_t>
+DDSimDependencyIndex::getUnknownCallers(size_t instruction) const {
+  std::set<size_t> unknownCallers;
+  std::vector<size_t> toVisit{scopes[instruction]};
+  while (!toVisit.empty()) {
+    const auto definition = toVisit.back();
+    toVisit.pop_back();
+    if (definition == -1ULL || !unknownCallers.insert(definition).second) {
+      continue;
+    }
+    const auto found = callers.find(definition);
+    if (found == callers.end()) {
+      continue;
+    }
+    for (const auto caller : found->second) {
+      toVisit.push_back(scopes[caller]);
+    }
+  }
+  return unknownCallers;
+}
+
+} // namespace mqt::debugger
@@ -16,15 +16,23 @@
 #include "backend/dd/DDSimDiagnostics.hpp"
 
 #include "backend/dd/DDSimDebug.hpp"
+#include "backend/dd/DDSimDense.hpp"
 #include "backend/diagnostics.h"
 #include "common.h"
 #include "common/ComplexMathematics.hpp"
+#include "common/DensityMatrix.hpp"
 #include "common/Span.hpp"
 #include "common/parsing/AssertionParsing.hpp"
 #include "common/parsing/AssertionTools.hpp"
 #include "common/parsing/CodePreprocessing.hpp"
+#include "common/parsing/Utils.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Package.hpp"
+#include "ir/operations/Control.hpp"
+#include "ir/operations/Operation.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -72,301 +80,68 @@ bool* toBoolArray(uint8_t* array) {
 }
 
 /**
- * @brief Get the return instruction of the given instruction's scope.
- *
- * This should only be executed if we know a return instruction exists.
- * @param state The simulation state.
- * @param instruction The instruction to start the search from.
- * @return The index of the return instruction.
- */
-size_t findReturn(DDSimulationState* state, size_t instruction) {
-  size_t current = instruction;
-  while (state->instructionTypes[current] != RETURN) {
-    current++;
-  }
-  return current;
-}
-
-/**
- * @brief Iterate over a function call when computing data dependencies.
- *
- * When a function call is added to the `toVisit` set during the search for data
- * dependencies, this function also tries to find possible dependencies inside
- * the called function. This can lead to recursive calls of this function.
- * @param ddsim The simulation state.
- * @param current The index of the call for which to find dependencies.
- * @param qubitIndex The index of the qubit in the call's argument list.
- * @param visited The set of already visited instructions.
- * @param toVisit The set of instructions to visit next.
- */
-void visitCall(DDSimulationState* ddsim, size_t current, size_t qubitIndex,
-               std::set<size_t>& visited, std::set<size_t>& toVisit) {
-  const auto gateStart = ddsim->successorInstructions[current];
-  const auto gateDefinition = gateStart - 1;
-  const std::string stringToSearch =
-      ddsim->targetQubits[gateDefinition][qubitIndex];
-  auto checkInstruction = findReturn(ddsim, gateStart);
-  while (checkInstruction >= gateStart) {
-    const auto found =
-        std::find(ddsim->targetQubits[checkInstruction].begin(),
-                  ddsim->targetQubits[checkInstruction].end(), stringToSearch);
-    if (ddsim->instructionTypes[checkInstruction] != RETURN &&
-        found != ddsim->targetQubits[checkInstruction].end()) {
-      if (!visited.contains(checkInstruction)) {
-        toVisit.insert(checkInstruction);
-      }
-      if (ddsim->instructionTypes[checkInstruction] == CALL) {
-        const auto position =
-            std::distance(ddsim->targetQubits[checkInstruction].begin(), found);
-        visitCall(ddsim, checkInstruction, static_cast<size_t>(position),
-                  visited, toVisit);
-      }
-      break;
-    }
-    if (checkInstruction == 0) {
-      break;
-    }
-    checkInstruction--;
-  }
-}
-
-/**
- * @brief Get the set of custom gate definitions for which the caller is
- * unknown.
- *
- * This is used when searching data dependencies with the `includeCallers` flag
- * set to `true`.
- * @param ddsim The simulation state.
- * @param instruction The index of the function definition to search the callers
- * for.
- * @return A set of function definitions whose callers are unknown.
- */
-std::set<size_t> getUnknownCallers(DDSimulationState* ddsim,
-                                   size_t instruction) {
-  std::set<size_t> unknownCallers;
-
-  std::set<size_t> toVisit{};
-  std::set<size_t> visited{};
-
-  while (true) {
-    instruction--;
-    if (ddsim->functionDefinitions.contains(instruction)) {
-      unknownCallers.insert(instruction);
-      for (const auto caller : ddsim->functionCallers[instruction]) {
-        if (!visited.contains(caller)) {
-          toVisit.insert(caller);
-        }
-      }
-    }
-
-    if (instruction == 0 || ddsim->instructionTypes[instruction] == RETURN ||
-        ddsim->functionDefinitions.contains(instruction)) {
-      if (toVisit.empty()) {
-        break;
-      }
-
-      instruction = *toVisit.begin();
-      toVisit.erase(instruction);
-      visited.insert(instruction);
-    }
-  }
-
-  return unknownCallers;
-}
-
-/**
- * @brief Get the interactions tree of the given qubit at runtime.
- *
- * At runtime, we can store precisely what qubits are used by each instruction,
- * so we have more specific details than at static time.
- * @param ddd The dd diagnostics instance.
- * @param qubit The qubit to find the interaction tree for.
- * @return A set of edges between qubits on the interaction tree and the
- * instruction they were taken from.
+ * @brief The probability below which a control is considered to never be
+ * satisfied.
  */
-std::set<std::tuple<size_t, size_t, size_t>>
-getInteractionTreeAtRuntime(DDDiagnostics* ddd, size_t qubit) {
-  auto* ddsim = ddd->simulationState;
-  std::set<size_t> interactions;
-  std::set<std::tuple<size_t, size_t, size_t>> tree;
-  interactions.insert(qubit);
-  bool found = true;
-
-  while (found) {
-    found = false;
-
-    for (size_t i = 0; i < ddsim->instructionTypes.size(); i++) {
-      if (ddsim->instructionTypes[i] != SIMULATE) {
-        continue;
-      }
-      if (!ddd->actualQubits.contains(i)) {
-        continue;
-      }
-
-      auto& actualQubits = ddd->actualQubits[i];
-      for (const auto& actualQubitVector : actualQubits) {
-        if (!std::ranges::none_of(actualQubitVector,
-                                  [&interactions](size_t elem) {
-                                    return interactions.contains(elem);
-                                  })) {
-          for (size_t target1 = 0; target1 < actualQubitVector.size();
-               target1++) {
-            const auto& target = actualQubitVector[target1];
-            if (!interactions.contains(target)) {
-              found = true;
-            }
-            for (size_t target2 = 1; target2 < actualQubitVector.size();
-                 target2++) {
-              const auto& secondTarget = actualQubitVector[target2];
-              tree.insert({target, secondTarget, i});
-              tree.insert({secondTarget, target, i});
-
-              if (!interactions.contains(secondTarget)) {
-                found = true;
-              }
-              interactions.insert(secondTarget);
-            }
-            interactions.insert(target);
-          }
-        }
-      }
-    }
-  }
-
-  return tree;
-}
+constexpr double ZERO_CONTROL_TOLERANCE = 1e-12;
 
 /**
- * @brief Get interactions of the given qubit at runtime.
- *
- * At runtime, we can store precisely what qubits are used by each instruction,
- * so we have more specific details than at static time.
- * @param ddd The dd diagnostics instance.
- * @param qubit The qubit to find interactions for.
- * @return A set of qubits that interact with the given qubit.
+ * @brief Check whether some controls of an operation have not been observed
+ * to be satisfied yet.
+ * @param diagnostics The diagnostics instance to query.
+ * @param instruction The instruction that applies the operation.
+ * @param op The controlled operation.
+ * @return True if at least one control still has to be checked.
  */
-std::set<size_t> getInteractionsAtRuntime(DDDiagnostics* ddd, size_t qubit) {
-  const auto tree = getInteractionTreeAtRuntime(ddd, qubit);
-  std::set<size_t> interactions{qubit};
-  for (const auto& pair : tree) {
-    interactions.insert(std::get<0>(pair));
-    interactions.insert(std::get<1>(pair));
-  }
-  return interactions;
+bool hasUndecidedControls(DDDiagnostics* diagnostics, size_t instruction,
+                          const qc::Operation& op) {
+  const auto& controls = op.getControls();
+  if (controls.empty()) {
+    return false;
+  }
+  const auto found = diagnostics->nonZeroControls.find(instruction);
+  if (found == diagnostics->nonZeroControls.end()) {
+    return true;
+  }
+  return std::ranges::any_of(controls, [&found](const qc::Control& control) {
+    return !found->second.contains(control.qubit);
+  });
 }
 
 /**
- * @brief Check if the given qubit is always zero in the given statevector.
+ * @brief Check the controls of an operation in the state it is applied to.
  *
- * If the `checkOne` flag is set to `true`, the function checks if the qubit is
- * always one instead.
- * @param sv The statevector to check.
- * @param qubit The qubit to check.
- * @param checkOne If true, the function checks if the qubit is always one.
- * @return True if the qubit is always zero (or one), false otherwise.
+ * The probability of each control being satisfied is computed from the
+ * single-qubit marginal of the state, without expanding the decision diagram
+ * into a statevector.
+ * @param diagnostics The diagnostics instance to update.
+ * @param instruction The instruction that applies the operation.
+ * @param op The controlled operation.
+ * @param probabilities Computes the probabilities of measuring 0 and 1 on a
+ * qubit of the state the operation is applied to.
  */
-bool isAlwaysZero(const Statevector& sv, size_t qubit, bool checkOne = false) {
-  const auto epsilon = 1e-10;
-
-  const Span<Complex> amplitudes(sv.amplitudes, sv.numStates);
-
-  for (size_t i = 0; i < sv.numStates; i++) {
-    if (((i & (1ULL << qubit)) == 0ULL && !checkOne) ||
-        ((i & (1ULL << qubit)) != 0ULL && checkOne)) {
+template <typename Probabilities>
+void checkControls(DDDiagnostics* diagnostics, size_t instruction,
+                   const qc::Operation& op,
+                   const Probabilities& probabilities) {
+  auto& nonZero = diagnostics->nonZeroControls[instruction];
+  for (const auto& control : op.getControls()) {
+    const auto qubit = control.qubit;
+    if (nonZero.contains(qubit)) {
       continue;
     }
-    if (amplitudes[i].real > epsilon || amplitudes[i].real < -epsilon ||
-        amplitudes[i].imaginary > epsilon ||
-        amplitudes[i].imaginary < -epsilon) {
-      return false;
-    }
-  }
-
-  return true;
-}
-
-/**
- * @brief Finds a unique path between two qubits in the given graph, if it
- * exists.
- *
- * If no such path exists, returns an empty vector.
- *
- * @param graph The graph to search in as a set of triples (start, end,
- * instruction).
- * @param start The starting vertex.
- * @param end The ending vertex.
- * @return The unique path between the two vertices, if it exists.
- */
-std::vector<std::tuple<size_t, size_t, size_t>>
-findUniquePath(const std::set<std::tuple<size_t, size_t, size_t>>& graph,
-               size_t start, size_t end) {
-  std::set<size_t> visited;
-  std::vector<size_t> toVisit;
-
-  std::map<size_t, std::pair<size_t, size_t>> predecessors;
-  std::set<size_t> multiplePredecessors;
-
-  toVisit.push_back(start);
-  while (!toVisit.empty()) {
-    auto current = *toVisit.begin();
-    toVisit.erase(toVisit.begin());
-    visited.insert(current);
-    if (current == end) {
-      break;
-    }
-
-    for (const auto& edge : graph) {
-      size_t other = 0;
-      const size_t instruction = std::get<2>(edge);
-      if (std::get<0>(edge) == current) {
-        other = std::get<1>(edge);
-      } else if (std::get<1>(edge) == current) {
-        other = std::get<0>(edge);
-      } else {
-        continue;
-      }
-      if (other == current) {
-        // Fail-safe in case this ever comes up.
-        continue;
-      }
-
-      if (predecessors.contains(current) &&
-          predecessors[current].first == other &&
-          predecessors[current].second == instruction) {
-        // This is the edge we came from, so we don't want to go back.
-        continue;
-      }
-
-      if (predecessors.contains(other)) {
-        if (predecessors[other].second != instruction) {
-          multiplePredecessors.insert(other);
-        }
-      } else {
-        predecessors.insert({other, {current, instruction}});
-      }
-      if (visited.contains(other)) {
-        continue;
-      }
-      if (std::ranges::find(toVisit, other) == toVisit.end()) {
-        toVisit.push_back(other);
-      }
+    const auto [pZero, pOne] = probabilities(qubit);
+    const auto pSatisfied =
+        control.type == qc::Control::Type::Pos ? pOne : pZero;
+    if (pSatisfied <= ZERO_CONTROL_TOLERANCE) {
+      diagnostics->zeroControls[instruction].insert(qubit);
+    } else {
+      nonZero.insert(qubit);
     }
   }
-
-  if (!predecessors.contains(end)) {
-    return {};
+  if (nonZero.empty()) {
+    diagnostics->nonZeroControls.erase(instruction);
   }
-  std::vector<std::tuple<size_t, size_t, size_t>> path;
-  size_t current = end;
-  while (current != start) {
-    if (multiplePredecessors.contains(current)) {
-      return {};
-    }
-    path.emplace_back(predecessors[current].first, current,
-                      predecessors[current].second);
-    current = predecessors[current].first;
-  }
-  return path;
 }
 
 /**
@@ -401,12 +176,11 @@ void suggestBasedOnFailedEntanglementAssertion(
   bool first = true;
   for (const auto& actualQubits : actualQubitVector) {
     std::set<std::tuple<size_t, size_t, size_t>> addingInteractions;
-    const auto interactionGraph =
-        getInteractionTreeAtRuntime(self, actualQubits[1]);
     const auto baseQubit = actualQubits[0];
     const auto targetQubit = actualQubits[1];
 
-    const auto path = findUniquePath(interactionGraph, baseQubit, targetQubit);
+    const auto path =
+        self->interactions.findUniquePath(baseQubit, targetQubit);
 
     for (const auto& edge : path) {
       const auto from = std::get<0>(edge);
@@ -459,16 +233,18 @@ void suggestSplitEqualityAssertion(
     const StatevectorEqualityAssertion* assertion) {
   const auto& sv = assertion->getTargetStatevector();
 
-  const auto densityMatrix = toDensityMatrix(sv);
-
+  auto& scratch = self->simulationState->subStateScratch;
   std::vector<size_t> separableQubits;
+  std::vector<std::vector<Complex>> extractedAmplitudes;
   for (size_t i = 0; i < sv.numQubits; i++) {
     if (i == sv.numQubits - 1 && separableQubits.size() == i) {
       // Leave at least one element in remaining.
       break;
     }
-    if (partialTraceIsPure(sv, {i})) {
+    auto decomposition = getSchmidtDecomposition(sv, {i}, scratch);
+    if (isSeparable(decomposition)) {
       separableQubits.push_back(i);
+      extractedAmplitudes.push_back(std::move(decomposition.subState));
     }
   }
 
@@ -483,14 +259,12 @@ void suggestSplitEqualityAssertion(
     }
   }
 
-  std::vector<std::vector<Complex>> extractedAmplitudes;
   std::vector<std::vector<std::string>> targetQubits;
   for (const size_t qb : separableQubits) {
-    extractedAmplitudes.push_back(getSubStateVectorAmplitudes(sv, {qb}));
     targetQubits.push_back({assertion->getTargetQubits()[qb]});
   }
   extractedAmplitudes.push_back(
-      getSubStateVectorAmplitudes(sv, remainingQubits));
+      getSubStateVectorAmplitudes(sv, remainingQubits, scratch));
   std::vector<std::string> remainingQubitNames;
   std::ranges::transform(
       remainingQubits, std::back_inserter(remainingQubitNames),
@@ -540,6 +314,106 @@ void suggestSplitEqualityAssertion(
     }
   }
 }
+
+/**
+ * @brief The latest instructions in a scope of the program that assertions
+ * cannot be moved over.
+ *
+ * All positions are stored as the index of the instruction following the
+ * barrier, which is the earliest position an assertion can be moved to.
+ */
+struct MovementBarriers {
+  /**
+   * @brief The first instruction of the scope.
+   */
+  size_t start = 0;
+  /**
+   * @brief The latest barrier for all assertions of each type.
+   */
+  std::array<size_t, ASSERTION_TYPE_COUNT> all{};
+  /**
+   * @brief The latest barrier on each single qubit for each assertion type.
+   */
+  std::array<std::map<std::string, size_t>, ASSERTION_TYPE_COUNT> qubits;
+  /**
+   * @brief The latest barrier on each full register for each assertion type.
+   */
+  std::array<std::map<std::string, size_t>, ASSERTION_TYPE_COUNT> registers;
+  /**
+   * @brief The declaration of each register.
+   */
+  std::map<std::string, size_t> declarations;
+};
+
+/**
+ * @brief Record an instruction as a barrier for the assertions it does not
+ * commute with.
+ * @param barriers The barriers of the instruction's scope.
+ * @param instruction The instruction to record.
+ * @param info The commutation information of the instruction.
+ * @param index The index of the instruction.
+ */
+void recordMovementBarrier(MovementBarriers& barriers,
+                           const Instruction& instruction,
+                           const CommutationInfo& info, size_t index) {
+  const auto position = index + 1;
+  switch (info.kind) {
+  case CommutationKind::Always:
+    return;
+  case CommutationKind::Never:
+    barriers.all.fill(position);
+    return;
+  case CommutationKind::Declaration:
+    barriers.declarations[info.declaredRegister] = position;
+    return;
+  case CommutationKind::Untargeted:
+    for (size_t type = 0; type < ASSERTION_TYPE_COUNT; type++) {
+      if (!info.commutes.at(type)) {
+        barriers.all.at(type) = position;
+      }
+    }
+    return;
+  case CommutationKind::Targeted:
+    for (size_t type = 0; type < ASSERTION_TYPE_COUNT; type++) {
+      if (info.commutes.at(type)) {
+        continue;
+      }
+      for (const auto& target : instruction.targets) {
+        auto& latest = target.find('[') != std::string::npos
+                           ? barriers.qubits.at(type)
+                           : barriers.registers.at(type);
+        latest[target] = position;
+      }
+    }
+    return;
+  }
+}
+
+/**
+ * @brief Find the earliest position an assertion can be moved to.
+ * @param barriers The barriers of the assertion's scope up to the assertion.
+ * @param assertion The assertion to move.
+ * @return The index of the earliest instruction the assertion can be moved to.
+ */
+size_t findEarliestPosition(const MovementBarriers& barriers,
+                            const Assertion& assertion) {
+  const auto type = static_cast<size_t>(assertion.getType());
+  auto earliest = std::max(barriers.start, barriers.all.at(type));
+  const auto update = [&earliest](const std::map<std::string, size_t>& latest,
+                                  const std::string& key) {
+    const auto found = latest.find(key);
+    if (found != latest.end()) {
+      earliest = std::max(earliest, found->second);
+    }
+  };
+  for (const auto& target : assertion.getTargetQubits()) {
+    const auto registerName = variableBaseName(target);
+    update(barriers.qubits.at(type), target);
+    update(barriers.registers.at(type), registerName);
+    update(barriers.declarations, registerName);
+  }
+  return earliest;
+}
 } // namespace
 
 Result createDDDiagnostics(DDDiagnostics* self, DDSimulationState* state) {
@@ -549,7 +423,11 @@ Result createDDDiagnostics(DDDiagnostics* self, DDSimulationState* state) {
   self->interface.getNumQubits = dddiagnosticsGetNumQubits;
   self->interface.getInstructionCount = dddiagnosticsGetInstructionCount;
   self->interface.getInteractions = dddiagnosticsGetInteractions;
+  self->interface.getInteractionComponents =
+      dddiagnosticsGetInteractionComponents;
   self->interface.getDataDependencies = dddiagnosticsGetDataDependencies;
+  self->interface.getDataDependenciesBatch =
+      dddiagnosticsGetDataDependenciesBatch;
   self->interface.getZeroControlInstructions =
       dddiagnosticsGetZeroControlInstructions;
   self->interface.potentialErrorCauses = dddiagnosticsPotentialErrorCauses;
@@ -581,7 +459,11 @@ Result dddiagnosticsInit(Diagnostics* self) {
   auto* ddd = toDDDiagnostics(self);
   ddd->zeroControls.clear();
   ddd->nonZeroControls.clear();
+  ddd->lazyZeroControls = false;
+  ddd->pendingControlChecks.clear();
+  ddd->numPendingControlStates = 0;
   ddd->actualQubits.clear();
+  ddd->interactions.clear();
   return OK;
 }
 
@@ -590,45 +472,38 @@ Result dddiagnosticsGetDataDependencies(Diagnostics* self, size_t instruction,
                                         bool* instructions) {
   auto* ddd = toDDDiagnostics(self);
   auto* ddsim = ddd->simulationState;
-  const Span<bool> isDependency(
-      instructions, ddsim->interface.getInstructionCount(&ddsim->interface));
-  std::set<size_t> toVisit{instruction};
-  std::set<size_t> visited;
-
-  // Stores all functions whose callers are unknown (because analysis started
-  // inside them)
-  const std::set<size_t> unknownCallers =
-      includeCallers ? getUnknownCallers(ddsim, instruction)
-                     : std::set<size_t>{};
-
-  while (!toVisit.empty()) {
-    auto current = *toVisit.begin();
-    isDependency[current] = true;
-    toVisit.erase(toVisit.begin());
-    visited.insert(current);
-
-    for (auto dep : ddsim->dataDependencies[current]) {
-      const auto depInstruction = dep.first;
-      if (ddsim->instructionTypes[depInstruction] == NOP) {
-        continue; // We don't want variable declarations as dependencies.
-      }
-      if (!visited.contains(depInstruction)) {
-        toVisit.insert(depInstruction);
-      }
-      if (ddsim->instructionTypes[depInstruction] == CALL) {
-        visitCall(ddsim, depInstruction, dep.second, visited, toVisit);
-      }
-    }
+  const auto& index = ddsim->program->dependencies;
+  if (instruction >= index.size()) {
+    return ERROR;
+  }
+  const Span<bool> isDependency(instructions, index.size());
+  for (const auto dependency :
+       index.getDependencies(instruction, includeCallers)) {
+    isDependency[dependency] = true;
+  }
+  return OK;
+}
 
-    if (unknownCallers.contains(current - 1)) {
-      for (auto caller : ddsim->functionCallers[current - 1]) {
-        if (!visited.contains(caller)) {
-          toVisit.insert(caller);
-        }
-      }
+Result dddiagnosticsGetDataDependenciesBatch(Diagnostics* self,
+                                             const size_t* instructions,
+                                             size_t count, bool includeCallers,
+                                             bool* dependencies) {
+  auto* ddd = toDDDiagnostics(self);
+  auto* ddsim = ddd->simulationState;
+  const auto& index = ddsim->program->dependencies;
+  const Span<const size_t> queries(instructions, count);
+  for (size_t i = 0; i < count; i++) {
+    if (queries[i] >= index.size()) {
+      return ERROR;
+    }
+  }
+  const Span<bool> isDependency(dependencies, count * index.size());
+  for (size_t i = 0; i < count; i++) {
+    for (const auto dependency :
+         index.getDependencies(queries[i], includeCallers)) {
+      isDependency[(i * index.size()) + dependency] = true;
     }
   }
-
   return OK;
 }
 
@@ -636,46 +511,35 @@ Result dddiagnosticsGetInteractions(Diagnostics* self, size_t beforeInstruction,
                                     size_t qubit, bool* qubitsAreInteracting) {
   auto* ddd = toDDDiagnostics(self);
   auto* ddsim = ddd->simulationState;
-  std::set<size_t> interactions;
-  interactions.insert(qubit);
-  bool found = true;
-
-  while (found) {
-    found = false;
-    for (auto i = beforeInstruction - 1; i < beforeInstruction; i--) {
-      if (std::ranges::find(ddsim->functionDefinitions, i) !=
-          ddsim->functionDefinitions.end()) {
-        break;
-      }
-      if (ddsim->instructionTypes[i] != SIMULATE &&
-          ddsim->instructionTypes[i] != CALL) {
-        continue;
-      }
+  const auto numQubits = ddsim->interface.getNumQubits(&ddsim->interface);
+  if (qubit >= numQubits) {
+    return ERROR;
+  }
 
-      auto targets = getTargetVariables(ddsim, i);
-      std::set<size_t> targetQubits;
-      for (const auto& target : targets) {
-        targetQubits.insert(variableToQubitAt(ddsim, target, i).first);
-      }
-      if (!std::ranges::none_of(targetQubits, [&interactions](size_t elem) {
-            return interactions.contains(elem);
-          })) {
-        for (const auto& target : targetQubits) {
-          if (!interactions.contains(target)) {
-            found = true;
-          }
-          interactions.insert(target);
-        }
-      }
+  const auto components =
+      ddsim->program->interactions.getComponents(beforeInstruction, numQubits);
+  const auto qubits = Span<bool>(qubitsAreInteracting, numQubits);
+  for (size_t i = 0; i < numQubits; i++) {
+    if (components[i] == components[qubit]) {
+      qubits[i] = true;
     }
   }
 
-  const auto qubits = Span<bool>(
-      qubitsAreInteracting, ddsim->interface.getNumQubits(&ddsim->interface));
-  for (auto interaction : interactions) {
-    qubits[interaction] = true;
-  }
+  return OK;
+}
 
+Result dddiagnosticsGetInteractionComponents(Diagnostics* self,
+                                             size_t beforeInstruction,
+                                             size_t* components) {
+  auto* ddd = toDDDiagnostics(self);
+  auto* ddsim = ddd->simulationState;
+  const auto numQubits = ddsim->interface.getNumQubits(&ddsim->interface);
+  const auto found =
+      ddsim->program->interactions.getComponents(beforeInstruction, numQubits);
+  const auto output = Span<size_t>(components, numQubits);
+  for (size_t i = 0; i < numQubits; i++) {
+    output[i] = found[i];
+  }
   return OK;
 }
 
@@ -689,7 +553,8 @@ size_t dddiagnosticsPotentialErrorCauses(Diagnostics* self, ErrorCause* output,
   if (assertion == -1ULL) {
     return 0;
   }
-  const auto& assertionInstruction = ddsim->assertionInstructions[assertion];
+  const auto& assertionInstruction =
+      ddsim->program->assertionInstructions.at(assertion);
   size_t index = 0;
 
   if (assertionInstruction->getType() == AssertionType::Entanglement) {
@@ -712,25 +577,13 @@ size_t tryFindMissingInteraction(DDDiagnostics* diagnostics,
 
   auto targets = assertion->getTargetQubits();
   auto outputs = Span(output, count);
-  std::vector<size_t> targetQubits(targets.size());
+  const auto targetQubits = resolveTargetQubits(state, instruction);
   size_t index = 0;
 
-  std::ranges::transform(targets, targetQubits.begin(),
-                         [&state](const std::string& target) {
-                           return variableToQubit(state, target);
-                         });
-
-  std::map<size_t, std::set<size_t>> allInteractions;
-
-  for (size_t i = 0; i < targets.size(); i++) {
-    allInteractions.insert(
-        {targetQubits[i],
-         getInteractionsAtRuntime(diagnostics, targetQubits[i])});
-  }
-
   for (size_t i = 0; i < targets.size(); i++) {
     for (size_t j = i + 1; j < targets.size(); j++) {
-      if (!allInteractions[targetQubits[i]].contains(targetQubits[j])) {
+      if (!diagnostics->interactions.interact(targetQubits[i],
+                                              targetQubits[j])) {
         outputs[index].type = ErrorCauseType::MissingInteraction;
         outputs[index].instruction = instruction;
         index++;
@@ -749,6 +602,7 @@ size_t tryFindZeroControls(DDDiagnostics* diagnostics, size_t instruction,
   if (count == 0) {
     return 0;
   }
+  dddiagnosticsEvaluatePendingControls(diagnostics);
 
   std::vector<uint8_t> dependencies(
       diagnostics->interface.getInstructionCount(&diagnostics->interface));
@@ -785,6 +639,7 @@ size_t tryFindZeroControls(DDDiagnostics* diagnostics, size_t instruction,
 Result dddiagnosticsGetZeroControlInstructions(Diagnostics* self,
                                                bool* instructions) {
   auto* ddd = toDDDiagnostics(self);
+  dddiagnosticsEvaluatePendingControls(ddd);
   const Span<bool> instructionSpan(instructions,
                                    dddiagnosticsGetInstructionCount(self));
   for (size_t i = 0; i < dddiagnosticsGetInstructionCount(self); i++) {
@@ -798,54 +653,74 @@ Result dddiagnosticsGetZeroControlInstructions(Diagnostics* self,
 void dddiagnosticsOnStepForward(DDDiagnostics* diagnostics,
                                 size_t instruction) {
   auto* ddsim = diagnostics->simulationState;
-  const auto targets = getTargetVariables(ddsim, instruction);
 
   // Add actual qubits to tracker.
-  if (ddsim->instructionTypes[instruction] == SIMULATE ||
-      ddsim->instructionTypes[instruction] == CALL ||
-      ddsim->instructionTypes[instruction] == ASSERTION) {
-    std::vector<size_t> targetQubits(targets.size());
-    std::ranges::transform(targets, targetQubits.begin(),
-                           [&ddsim](const std::string& target) {
-                             return variableToQubit(ddsim, target);
-                           });
-    if (!diagnostics->actualQubits.contains(instruction)) {
-      diagnostics->actualQubits[instruction] = std::set<std::vector<size_t>>();
+  if (ddsim->program->instructionTypes[instruction] == SIMULATE ||
+      ddsim->program->instructionTypes[instruction] == CALL ||
+      ddsim->program->instructionTypes[instruction] == ASSERTION) {
+    const auto targets = resolveTargetQubits(ddsim, instruction);
+    const auto inserted =
+        diagnostics->actualQubits[instruction].insert(targets).second;
+    if (inserted &&
+        ddsim->program->instructionTypes[instruction] == SIMULATE) {
+      diagnostics->interactions.addInteraction(instruction, targets);
     }
-    diagnostics->actualQubits[instruction].insert(targetQubits);
   }
 
   // Check for zero controls.
-  if (ddsim->instructionTypes[instruction] != SIMULATE) {
+  if (ddsim->program->instructionTypes[instruction] != SIMULATE) {
+    return;
+  }
+  const auto& op = **ddsim->iterator;
+  if (!hasUndecidedControls(diagnostics, instruction, op)) {
     return;
   }
-  const auto numQubits =
-      diagnostics->interface.getNumQubits(&diagnostics->interface);
-  if (numQubits > 16) {
+  const auto& state = ddsim->simulationState;
+  if (!diagnostics->lazyZeroControls ||
+      ddsim->backend == SimulationBackend::Dense) {
+    // The marginals of the current state are memoized until it changes. The
+    // dense backend does not keep decision diagrams of its states, so its
+    // controls are always checked right away.
+    checkControls(diagnostics, instruction, op, [ddsim](qc::Qubit qubit) {
+      return getQubitProbabilities(ddsim, qubit);
+    });
     return;
   }
-  const auto& op = (*ddsim->iterator);
-  const auto& controls = op->getControls();
+  auto& pending = diagnostics->pendingControlChecks[instruction];
+  pending.operation = &op;
+  if (pending.states.emplace(state.p, state).second) {
+    ddsim->dd->incRef(state);
+    diagnostics->numPendingControlStates++;
+  }
+  if (diagnostics->numPendingControlStates >= MAX_PENDING_CONTROL_STATES) {
+    dddiagnosticsEvaluatePendingControls(diagnostics);
+  }
+}
 
-  std::vector<Complex> amplitudes(2ULL << numQubits);
-  Statevector sv{numQubits, 2ULL << numQubits, amplitudes.data()};
-  ddsim->interface.getStateVectorFull(&ddsim->interface, &sv);
+bool dddiagnosticsNeedsControlCheck(DDDiagnostics* diagnostics,
+                                    size_t instruction) {
+  const auto* ddsim = diagnostics->simulationState;
+  return ddsim->program->instructionTypes[instruction] == SIMULATE &&
+         hasUndecidedControls(diagnostics, instruction, **ddsim->iterator);
+}
 
-  for (const auto& control : controls) {
-    const auto pos = control.type == qc::Control::Type::Pos;
-    const auto qubit = control.qubit;
-    if (isAlwaysZero(sv, qubit, !pos)) {
-      if (!diagnostics->zeroControls.contains(instruction)) {
-        diagnostics->zeroControls[instruction] = std::set<size_t>();
+void dddiagnosticsEvaluatePendingControls(DDDiagnostics* diagnostics) {
+  auto& package = *diagnostics->simulationState->dd;
+  for (const auto& [instruction, pending] :
+       diagnostics->pendingControlChecks) {
+    for (const auto& [node, state] : pending.states) {
+      if (hasUndecidedControls(diagnostics, instruction, *pending.operation)) {
+        checkControls(diagnostics, instruction, *pending.operation,
+                      [&state](qc::Qubit qubit) {
+                        return dd::Package::determineMeasurementProbabilities(
+                            state, static_cast<dd::Qubit>(qubit));
+                      });
       }
-      diagnostics->zeroControls[instruction].insert(qubit);
-    } else {
-      if (!diagnostics->nonZeroControls.contains(instruction)) {
-        diagnostics->nonZeroControls[instruction] = std::set<size_t>();
-      }
-      diagnostics->nonZeroControls[instruction].insert(qubit);
+      package.decRef(state);
     }
   }
+  diagnostics->pendingControlChecks.clear();
+  diagnostics->numPendingControlStates = 0;
 }
 
 size_t dddiagnosticsSuggestAssertionMovements(Diagnostics* self,
@@ -853,17 +728,18 @@ size_t dddiagnosticsSuggestAssertionMovements(Diagnostics* self,
                                               size_t* suggestedPositions,
                                               size_t count) {
   DDDiagnostics* diagnostics = toDDDiagnostics(self);
+  const auto& assertionsToMove =
+      diagnostics->simulationState->program->assertionsToMove;
   if (count == 0) {
-    return diagnostics->assertionsToMove.size();
+    return assertionsToMove.size();
   }
-  const size_t max = count < diagnostics->assertionsToMove.size()
-                         ? count
-                         : diagnostics->assertionsToMove.size();
+  const size_t max =
+      count < assertionsToMove.size() ? count : assertionsToMove.size();
   const Span<size_t> original(originalPositions, count);
   const Span<size_t> suggested(suggestedPositions, count);
   for (size_t i = 0; i < max; i++) {
-    original[i] = diagnostics->assertionsToMove[i].first;
-    suggested[i] = diagnostics->assertionsToMove[i].second;
+    original[i] = assertionsToMove[i].first;
+    suggested[i] = assertionsToMove[i].second;
   }
   return max;
 }
@@ -945,44 +821,45 @@ size_t dddiagnosticsSuggestNewAssertions(Diagnostics* self,
   return index;
 }
 
-void dddiagnosticsOnCodePreprocessing(
-    DDDiagnostics* diagnostics, const std::vector<Instruction>& instructions) {
+std::vector<std::pair<size_t, size_t>>
+findAssertionsToMove(const std::vector<Instruction>& instructions,
+                     const std::vector<CommutationInfo>& commutation) {
+  std::vector<std::pair<size_t, size_t>> assertionsToMove;
+  MovementBarriers global;
+  MovementBarriers gate;
+  auto* scope = &global;
   for (size_t i = 0; i < instructions.size(); i++) {
     const auto& instruction = instructions[i];
-    if (instruction.assertion == nullptr) {
+    if (instruction.isFunctionDefinition) {
+      // Assertions cannot be moved out of the custom gate they are in.
+      gate = MovementBarriers{};
+      gate.start = i + 1;
+      scope = &gate;
       continue;
     }
-
-    size_t lowestSwap = i;
-
-    const auto& assertion = instruction.assertion;
-    size_t j = i - 1;
-    while (j != -1ULL) {
-      if (instructions[j].isFunctionDefinition) {
-        break;
-      }
-      if (instructions[j].code == "RETURN") {
-        while (j > 0 && !instructions[j].isFunctionDefinition) {
-          j--;
-        }
-      }
-      if (!doesCommute(assertion, instructions[j])) {
-        break;
-      }
-      lowestSwap = j;
-      j--;
+    if (instruction.code == "RETURN") {
+      // Assertions in the global scope can be moved over custom gate
+      // definitions as a whole.
+      scope = &global;
+      continue;
     }
-
-    if (i != lowestSwap) {
-      diagnostics->assertionsToMove.emplace_back(i, lowestSwap);
+    if (instruction.assertion != nullptr) {
+      const auto earliest =
+          findEarliestPosition(*scope, *instruction.assertion);
+      if (earliest != i) {
+        assertionsToMove.emplace_back(i, earliest);
+      }
+      continue;
     }
+    recordMovementBarrier(*scope, instruction, commutation[i], i);
   }
+  return assertionsToMove;
 }
 
 void dddiagnosticsOnFailedAssertion(DDDiagnostics* diagnostics,
                                     size_t instruction) {
   auto* ddsim = diagnostics->simulationState;
-  const auto& assertion = ddsim->assertionInstructions[instruction];
+  const auto& assertion = ddsim->program->assertionInstructions.at(instruction);
   if (assertion->getType() == AssertionType::Entanglement) {
     const auto* entAssertion =
         dynamic_cast<EntanglementAssertion*>(assertion.get());
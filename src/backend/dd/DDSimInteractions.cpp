@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimInteractions.cpp
+ * @brief Implementation of DDSimInteractions.hpp
+ */
+
+#include "backend/dd/DDSimInteractions.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+void DDSimInteractionTracker::addInteraction(
+    size_t instruction, const std::vector<size_t>& qubits) {
+  if (qubits.size() < 2) {
+    // A single qubit does not interact with anything.
+    return;
+  }
+  for (size_t i = 1; i < qubits.size(); i++) {
+    unite(qubits[0], qubits[i]);
+  }
+  interactions[findRoot(qubits[0])].emplace_back(instruction, qubits);
+}
+
+bool DDSimInteractionTracker::interact(size_t first, size_t second) {
+  return first == second || findRoot(first) == findRoot(second);
+}
+
+std::set<std::tuple<size_t, size_t, size_t>>
+DDSimInteractionTracker::getInteractionTree(size_t qubit) {
+  std::set<std::tuple<size_t, size_t, size_t>> tree;
+  for (const auto& [instruction, qubits] : interactions[findRoot(qubit)]) {
+    for (const auto target : qubits) {
+      for (size_t i = 1; i < qubits.size(); i++) {
+        tree.insert({target, qubits[i], instruction});
+        tree.insert({qubits[i], target, instruction});
+      }
+    }
+  }
+  return tree;
+}
+
+std::vector<std::tuple<size_t, size_t, size_t>>
+DDSimInteractionTracker::findUniquePath(size_t start, size_t end) {
+  if (start == end || !interact(start, end)) {
+    return {};
+  }
+
+  // Edges are visited in the order of the sorted graph, so that the search
+  // always finds the same predecessors.
+  std::map<size_t, std::vector<std::pair<size_t, size_t>>> adjacency;
+  for (const auto& [from, to, instruction] : getInteractionTree(end)) {
+    if (from == to) {
+      continue;
+    }
+    adjacency[from].emplace_back(to, instruction);
+    adjacency[to].emplace_back(from, instruction);
+  }
+
+  std::map<size_t, std::pair<size_t, size_t>> predecessors;
+  std::set<size_t> multiplePredecessors;
+  std::set<size_t> enqueued{start};
+  std::deque<size_t> toVisit{start};
+  while (!toVisit.empty()) {
+    const auto current = toVisit.front();
+    toVisit.pop_front();
+    if (current == end) {
+      break;
+    }
+
+    const auto cameFrom = predecessors.find(current);
+    for (const auto& [other, instruction] : adjacency[current]) {
+      if (cameFrom != predecessors.end() && cameFrom->second.first == other &&
+          cameFrom->second.second == instruction) {
+        // This is the edge we came from, so we don't want to go back.
+        continue;
+      }
+
+      const auto known = predecessors.find(other);
+      if (known == predecessors.end()) {
+        predecessors.insert({other, {current, instruction}});
+      } else if (known->second.second != instruction) {
+        multiplePredecessors.insert(other);
+      }
+      if (enqueued.insert(other).second) {
+        toVisit.push_back(other);
+      }
+    }
+  }
+
+  if (!predecessors.contains(end)) {
+    return {};
+  }
+  std::vector<std::tuple<size_t, size_t, size_t>> path;
+  size_t current = end;
+  while (current != start) {
+    if (multiplePredecessors.contains(current)) {
+      return {};
+    }
+    const auto& [previous, instruction] = predecessors.at(current);
+    path.emplace_back(previous, current, instruction);
+    current = previous;
+  }
+  return path;
+}
+
+void DDSimInteractionTracker::clear() {
+  parents.clear();
+  sizes.clear();
+  interactions.clear();
+}
+
+size_t DDSimInteractionTracker::findRoot(size_t qubit) {
+  while (parents.size() <= qubit) {
+    parents.push_back(parents.size());
+    sizes.push_back(1);
+    interactions.emplace_back();
+  }
+  auto root = qubit;
+  while (parents[root] != root) {
+    root = parents[root];
+  }
+  while (parents[qubit] != root) {
+    const auto next = parents[qubit];
+    parents[qubit] = root;
+    qubit = next;
+  }
+  return root;
+}
+
+void DDSimInteractionTracker::unite(size_t first, size_t second) {
+  auto rootFirst = findRoot(first);
+  auto rootSecond = findRoot(second);
+  if (rootFirst == rootSecond) {
+    return;
+  }
+  if (sizes[rootFirst] < sizes[rootSecond]) {
+    std::swap(rootFirst, rootSecond);
+  }
+  parents[rootSecond] = rootFirst;
+  sizes[rootFirst] += sizes[rootSecond];
+
+  auto& kept = interactions[rootFirst];
+  auto& merged = interactions[rootSecond];
+  if (kept.size() < merged.size()) {
+    std::swap(kept, merged);
+  }
+  kept.insert(kept.end(), std::make_move_iterator(merged.begin()),
+              std::make_move_iterator(merged.end()));
+  merged.clear();
+  merged.shrink_to_fit();
+}
+
+void DDSimInteractionIndex::beginScope(size_t instruction) {
+  scopes.push_back({.start = instruction, .parents = {}, .linkedAt = {},
+                    .sizes = {}});
+}
+
+void DDSimInteractionIndex::addInteraction(size_t instruction,
+                                           const std::vector<size_t>& qubits) {
+  if (qubits.size() < 2) {
+    return;
+  }
+  if (scopes.empty()) {
+    beginScope(0);
+  }
+  auto& scope = scopes.back();
+  const auto highest = *std::ranges::max_element(qubits);
+  while (scope.parents.size() <= highest) {
+    scope.parents.push_back(scope.parents.size());
+    scope.linkedAt.push_back(-1ULL);
+    scope.sizes.push_back(1);
+  }
+
+  for (size_t i = 1; i < qubits.size(); i++) {
+    auto first = findRoot(scope, -1ULL, qubits[0]);
+    auto second = findRoot(scope, -1ULL, qubits[i]);
+    if (first == second) {
+      continue;
+    }
+    if (scope.sizes[first] < scope.sizes[second]) {
+      std::swap(first, second);
+    }
+    scope.parents[second] = first;
+    scope.linkedAt[second] = instruction;
+    scope.sizes[first] += scope.sizes[second];
+  }
+}
+
+bool DDSimInteractionIndex::interact(size_t beforeInstruction, size_t first,
+                                     size_t second) const {
+  if (first == second) {
+    return true;
+  }
+  const auto* scope = findScope(beforeInstruction);
+  return scope != nullptr && findRoot(*scope, beforeInstruction, first) ==
+                                 findRoot(*scope, beforeInstruction, second);
+}
+
+std::vector<size_t>
+DDSimInteractionIndex::getComponents(size_t beforeInstruction,
+                                     size_t numQubits) const {
+  std::vector<size_t> components(numQubits);
+  const auto* scope = findScope(beforeInstruction);
+  if (scope == nullptr) {
+    for (size_t qubit = 0; qubit < numQubits; qubit++) {
+      components[qubit] = qubit;
+    }
+    return components;
+  }
+
+  // Qubits are visited in ascending order, so the first qubit found for each
+  // root is the smallest one of its component.
+  std::vector<size_t> smallest(std::max(numQubits, scope->parents.size()),
+                               -1ULL);
+  for (size_t qubit = 0; qubit < numQubits; qubit++) {
+    const auto root = findRoot(*scope, beforeInstruction, qubit);
+    if (smallest[root] == -1ULL) {
+      smallest[root] = qubit;
+    }
+    components[qubit] = smallest[root];
+  }
+  return components;
+}
+
+void DDSimInteractionIndex::clear() { scopes.clear(); }
+
+const DDSimInteractionIndex::Scope*
+DDSimInteractionIndex::findScope(size_t beforeInstruction) const {
+  const auto found = std::ranges::upper_bound(
+      scopes, beforeInstruction, {}, [](const Scope& scope) {
+        return scope.start;
+      });
+  if (found == scopes.begin()) {
+    return nullptr;
+  }
+  return &*std::prev(found);
+}
+
+size_t DDSimInteractionIndex::findRoot(const Scope& scope,
+                                       size_t beforeInstruction, size_t qubit) {
+  if (qubit >= scope.parents.size()) {
+    return qubit;
+  }
+  // Children are always linked before their parents, so the first link that
+  // is too recent ends the search.
+  while (scope.parents[qubit] != qubit &&
+         scope.linkedAt[qubit] < beforeInstruction) {
+    qubit = scope.parents[qubit];
+  }
+  return qubit;
+}
+
+} // namespace mqt::debugger
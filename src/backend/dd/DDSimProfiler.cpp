@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimProfiler.cpp
+ * @brief Implementation of DDSimProfiler.hpp
+ */
+
+#include "backend/dd/DDSimProfiler.hpp"
+
+#include "backend/dd/DDSimTraversal.hpp"
+#include "backend/debug.h"
+#include "dd/Package.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace mqt::debugger {
+
+DDSimProfiler::Scope::Scope(DDSimProfiler& profiler, size_t instruction,
+                            ProfilePhase phase, const dd::VectorDD& state) {
+  if (profiler.enabled) {
+    begin(profiler, instruction, phase, state);
+  }
+}
+
+DDSimProfiler::Scope::Scope(DDSimProfiler& profiler, ProfilePhase phase,
+                            const dd::VectorDD& state) {
+  if (profiler.enabled && profiler.activeInstruction != -1ULL) {
+    begin(profiler, profiler.activeInstruction, phase, state);
+  }
+}
+
+DDSimProfiler::Scope::~Scope() {
+  if (profiler == nullptr) {
+    return;
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  auto& counters = profiler->at(instruction, phase);
+  counters.seconds += elapsed.count();
+  counters.nodesAfter += countNodes(*state);
+  profiler->activeInstruction = outerInstruction;
+  profiler->activePhase = outerPhase;
+}
+
+void DDSimProfiler::Scope::begin(DDSimProfiler& target,
+                                 size_t measuredInstruction,
+                                 ProfilePhase measuredPhase,
+                                 const dd::VectorDD& measuredState) {
+  profiler = &target;
+  state = &measuredState;
+  instruction = measuredInstruction;
+  phase = measuredPhase;
+  outerInstruction = target.activeInstruction;
+  outerPhase = target.activePhase;
+  target.activeInstruction = instruction;
+  target.activePhase = phase;
+
+  auto& counters = target.at(instruction, phase);
+  counters.calls++;
+  counters.nodesBefore += countNodes(*state);
+  // The clock is started last, so that counting nodes is not measured.
+  start = std::chrono::steady_clock::now();
+}
+
+void DDSimProfiler::setEnabled(bool enable) {
+  if (enable) {
+    counters.clear();
+  }
+  enabled = enable;
+}
+
+bool DDSimProfiler::isEnabled() const { return enabled; }
+
+void DDSimProfiler::recordDenseBytes(size_t bytes) {
+  if (!enabled || activeInstruction == -1ULL) {
+    return;
+  }
+  at(activeInstruction, activePhase).denseBytes += bytes;
+}
+
+std::vector<ProfileEntry> DDSimProfiler::getEntries() const {
+  std::vector<ProfileEntry> entries;
+  for (size_t instruction = 0; instruction < counters.size(); instruction++) {
+    for (size_t phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+      const auto& c = counters[instruction][phase];
+      if (c.calls == 0) {
+        continue;
+      }
+      entries.push_back({.instruction = instruction,
+                         .phase = static_cast<ProfilePhase>(phase),
+                         .calls = c.calls,
+                         .seconds = c.seconds,
+                         .nodesBefore = c.nodesBefore,
+                         .nodesAfter = c.nodesAfter,
+                         .denseBytes = c.denseBytes});
+    }
+  }
+  return entries;
+}
+
+DDSimProfiler::Counters& DDSimProfiler::at(size_t instruction,
+                                           ProfilePhase phase) {
+  if (instruction >= counters.size()) {
+    counters.resize(instruction + 1);
+  }
+  return counters[instruction][static_cast<size_t>(phase)];
+}
+
+} // namespace mqt::debugger
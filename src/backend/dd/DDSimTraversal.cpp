@@ -0,0 +1,792 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file DDSimTraversal.cpp
+ * @brief Implementation of DDSimTraversal.hpp
+ */
+
+#include "backend/dd/DDSimTraversal.hpp"
+
+#include "common.h"
+#include "common/DensityMatrix.hpp"
+#include "common/Span.hpp"
+#include "dd/Complex.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+#include "dd/StateGeneration.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+namespace {
+
+using Amplitude = std::complex<dd::fp>;
+
+/**
+ * @brief The lowest DD level whose sub-diagrams are memoized during export.
+ *
+ * Blocks below this level are so small that copying them is not cheaper than
+ * expanding them again.
+ */
+constexpr dd::Qubit MEMO_MIN_LEVEL = 3;
+
+/**
+ * @brief A sub-diagram whose amplitudes still have to be written.
+ */
+struct ExportTask {
+  /**
+   * @brief The root node of the sub-diagram.
+   */
+  const dd::vNode* node;
+  /**
+   * @brief The accumulated weight of the path leading to the node.
+   */
+  Amplitude weight;
+  /**
+   * @brief The index of the first amplitude represented by the sub-diagram.
+   */
+  size_t offset;
+};
+
+/**
+ * @brief Writes the amplitudes of sub-diagrams into a dense buffer.
+ *
+ * Each exporter keeps track of the blocks it has already written, so that
+ * shared sub-diagrams can be copied instead of being traversed again.
+ */
+class StateVectorExporter {
+public:
+  /**
+   * @brief Constructs a new exporter writing into the given buffer.
+   * @param output The buffer to write to. It is expected to be zeroed.
+   */
+  explicit StateVectorExporter(const Span<Complex>& output) : output(output) {}
+
+  /**
+   * @brief Writes all amplitudes of the given sub-diagram.
+   * @param node The root node of the sub-diagram.
+   * @param weight The accumulated weight of the path leading to the node.
+   * @param offset The index of the first amplitude represented by the node.
+   */
+  void exportNode(const dd::vNode* node, const Amplitude& weight,
+                  size_t offset) {
+    const auto level = static_cast<size_t>(node->v);
+    if (node->v >= MEMO_MIN_LEVEL) {
+      const auto found = written.find(node);
+      if (found != written.end()) {
+        const auto& [source, sourceWeight] = found->second;
+        copyScaled(source, offset, 2ULL << level, weight / sourceWeight);
+        return;
+      }
+      written.emplace(node, std::make_pair(offset, weight));
+    }
+
+    for (size_t i = 0; i < dd::RADIX; i++) {
+      const auto& edge = node->e.at(i);
+      if (edge.w.exactlyZero()) {
+        continue;
+      }
+      const auto childWeight = weight * static_cast<Amplitude>(edge.w);
+      const auto childOffset = offset + (i << level);
+      if (edge.isTerminal()) {
+        output[childOffset] = {childWeight.real(), childWeight.imag()};
+        continue;
+      }
+      exportNode(edge.p, childWeight, childOffset);
+    }
+  }
+
+private:
+  /**
+   * @brief Fills a block of the output with a scaled copy of another block.
+   * @param source The index of the first amplitude of the source block.
+   * @param target The index of the first amplitude of the target block.
+   * @param size The number of amplitudes in the block.
+   * @param factor The factor to scale the amplitudes with.
+   */
+  void copyScaled(size_t source, size_t target, size_t size,
+                  const Amplitude& factor) const {
+    const auto factorReal = factor.real();
+    const auto factorImag = factor.imag();
+    for (size_t k = 0; k < size; k++) {
+      const auto& from = output[source + k];
+      output[target + k] = {
+          .real = (from.real * factorReal) - (from.imaginary * factorImag),
+          .imaginary =
+              (from.real * factorImag) + (from.imaginary * factorReal)};
+    }
+  }
+
+  /**
+   * @brief The buffer to write to.
+   */
+  Span<Complex> output;
+
+  /**
+   * @brief Maps each already written node to the offset and weight it was
+   * written with.
+   */
+  std::unordered_map<const dd::vNode*, std::pair<size_t, Amplitude>> written;
+};
+
+/**
+ * @brief Split the given task into independent tasks for its children.
+ *
+ * Children that are terminals are written to the output directly.
+ * @param task The task to split.
+ * @param output The buffer to write terminal amplitudes to.
+ * @param next The vector to add the new tasks to.
+ */
+void splitTask(const ExportTask& task, const Span<Complex>& output,
+               std::vector<ExportTask>& next) {
+  const auto level = static_cast<size_t>(task.node->v);
+  for (size_t i = 0; i < dd::RADIX; i++) {
+    const auto& edge = task.node->e.at(i);
+    if (edge.w.exactlyZero()) {
+      continue;
+    }
+    const auto childWeight = task.weight * static_cast<Amplitude>(edge.w);
+    const auto childOffset = task.offset + (i << level);
+    if (edge.isTerminal()) {
+      output[childOffset] = {childWeight.real(), childWeight.imag()};
+      continue;
+    }
+    next.push_back({edge.p, childWeight, childOffset});
+  }
+}
+
+/**
+ * @brief The bitstrings on the target qubits that a sub-diagram can produce.
+ */
+struct MarginalSupport {
+  /**
+   * @brief Whether the sub-diagram produces more than one bitstring.
+   */
+  bool multiple = false;
+  /**
+   * @brief The only bitstring produced by the sub-diagram, indexed by target.
+   *
+   * Only meaningful if `multiple` is false.
+   */
+  std::vector<bool> pattern;
+};
+
+/**
+ * @brief Computes the marginal support of vector DDs on a set of target qubits.
+ *
+ * Results are memoized per node, so that shared sub-diagrams are only
+ * evaluated once.
+ */
+class SupportChecker {
+public:
+  /**
+   * @brief Constructs a new checker for the given target qubits.
+   * @param numQubits The number of qubits represented by the DDs to check.
+   * @param qubits The indices of the target qubits.
+   */
+  SupportChecker(size_t numQubits, const std::vector<size_t>& qubits)
+      : numTargets(qubits.size()), targetIndex(numQubits, -1),
+        lowestTarget(numQubits) {
+    for (size_t i = 0; i < qubits.size(); i++) {
+      targetIndex[qubits[i]] = static_cast<int64_t>(i);
+      lowestTarget = std::min(lowestTarget, qubits[i]);
+    }
+  }
+
+  /**
+   * @brief Computes the marginal support of the given sub-diagram.
+   * @param node The root node of the sub-diagram.
+   * @return The marginal support of the sub-diagram.
+   */
+  const MarginalSupport& supportOf(const dd::vNode* node) {
+    const auto found = memo.find(node);
+    if (found != memo.end()) {
+      return found->second;
+    }
+
+    const auto level = static_cast<size_t>(node->v);
+    MarginalSupport support;
+    bool first = true;
+    for (size_t i = 0; i < dd::RADIX; i++) {
+      const auto& edge = node->e.at(i);
+      if (std::abs(static_cast<Amplitude>(edge.w)) <= SUPPORT_TOLERANCE) {
+        continue;
+      }
+      std::vector<bool> pattern(numTargets, false);
+      // Sub-diagrams below the lowest target can only produce the bitstring
+      // that has already been fixed above them.
+      if (!edge.isTerminal() &&
+          static_cast<size_t>(edge.p->v) >= lowestTarget) {
+        const auto& child = supportOf(edge.p);
+        if (child.multiple) {
+          support.multiple = true;
+          break;
+        }
+        pattern = child.pattern;
+      }
+      if (targetIndex[level] >= 0) {
+        pattern[static_cast<size_t>(targetIndex[level])] = i == 1;
+      }
+      if (first) {
+        support.pattern = std::move(pattern);
+        first = false;
+      } else if (pattern != support.pattern) {
+        support.multiple = true;
+        break;
+      }
+    }
+    return memo.emplace(node, std::move(support)).first->second;
+  }
+
+private:
+  /**
+   * @brief The number of target qubits.
+   */
+  size_t numTargets;
+  /**
+   * @brief Maps each qubit to its position among the targets, or -1.
+   */
+  std::vector<int64_t> targetIndex;
+  /**
+   * @brief The index of the lowest target qubit.
+   */
+  size_t lowestTarget;
+  /**
+   * @brief The already computed support of each visited node.
+   */
+  std::unordered_map<const dd::vNode*, MarginalSupport> memo;
+};
+
+/**
+ * @brief Computes the largest magnitude of the amplitudes below each node of a
+ * vector DD.
+ *
+ * Results are memoized per node, so that shared sub-diagrams are only
+ * evaluated once.
+ */
+class MaximumMagnitudes {
+public:
+  /**
+   * @brief Computes the largest magnitude of the amplitudes below a node,
+   * ignoring the weights of the edges leading to it.
+   * @param node The node to compute the magnitude for.
+   * @return The largest magnitude.
+   */
+  double of(const dd::vNode* node) {
+    const auto found = memo.find(node);
+    if (found != memo.end()) {
+      return found->second;
+    }
+    double maximum = 0;
+    for (const auto& edge : node->e) {
+      if (edge.w.exactlyZero()) {
+        continue;
+      }
+      const auto weight = std::abs(static_cast<Amplitude>(edge.w));
+      maximum = std::max(maximum, edge.isTerminal() ? weight
+                                                    : weight * of(edge.p));
+    }
+    return memo.emplace(node, maximum).first->second;
+  }
+
+private:
+  /**
+   * @brief The already computed magnitude of each visited node.
+   */
+  std::unordered_map<const dd::vNode*, double> memo;
+};
+
+/**
+ * @brief Computes the reduced density matrix of two qubits for the
+ * sub-diagrams below pairs of nodes of a vector DD.
+ *
+ * For a pair of nodes, the entry in row `r` and column `c` sums the products
+ * of the amplitudes of the first node with bitstring `r` on the kept qubits
+ * and the conjugated amplitudes of the second node with bitstring `c`, over
+ * all assignments of the traced-out qubits. Results are memoized per pair, so
+ * that shared sub-diagrams are only evaluated once.
+ */
+class TwoQubitReducer {
+public:
+  /**
+   * @brief The entries of a 4x4 matrix in row-major order.
+   */
+  using Block = std::array<Amplitude, 16>;
+
+  /**
+   * @brief Construct a new reducer.
+   * @param lowQubit The index of the kept qubit that becomes the least
+   * significant bit.
+   * @param highQubit The index of the kept qubit that becomes the most
+   * significant bit.
+   */
+  TwoQubitReducer(size_t lowQubit, size_t highQubit)
+      : lowQubit(lowQubit), highQubit(highQubit) {}
+
+  /**
+   * @brief Computes the matrix for a pair of nodes on the same level, ignoring
+   * the weights of the edges leading to them.
+   * @param row The node whose amplitudes select the row.
+   * @param col The node whose conjugated amplitudes select the column.
+   * @return The matrix.
+   */
+  const Block& of(const dd::vNode* row, const dd::vNode* col) {
+    const auto key = std::make_pair(row, col);
+    const auto found = memo.find(key);
+    if (found != memo.end()) {
+      return found->second;
+    }
+    const auto level = static_cast<size_t>(row->v);
+    const size_t bit = level == lowQubit ? 1 : level == highQubit ? 2 : 0;
+    Block block{};
+    for (size_t i = 0; i < dd::RADIX; i++) {
+      for (size_t j = 0; j < dd::RADIX; j++) {
+        // Traced-out qubits have to take the same value in rows and columns.
+        if (bit == 0 && i != j) {
+          continue;
+        }
+        const auto& rowEdge = row->e.at(i);
+        const auto& colEdge = col->e.at(j);
+        if (rowEdge.w.exactlyZero() || colEdge.w.exactlyZero()) {
+          continue;
+        }
+        const auto weight = static_cast<Amplitude>(rowEdge.w) *
+                            std::conj(static_cast<Amplitude>(colEdge.w));
+        const auto rowBit = i == 1 ? bit : 0;
+        const auto colBit = j == 1 ? bit : 0;
+        if (rowEdge.isTerminal()) {
+          block.at((rowBit * 4) + colBit) += weight;
+          continue;
+        }
+        const auto& child = of(rowEdge.p, colEdge.p);
+        for (size_t r = 0; r < 4; r++) {
+          for (size_t c = 0; c < 4; c++) {
+            block.at(((r | rowBit) * 4) + (c | colBit)) +=
+                weight * child.at((r * 4) + c);
+          }
+        }
+      }
+    }
+    return memo.emplace(key, block).first->second;
+  }
+
+private:
+  /**
+   * @brief The index of the kept qubit that becomes the least significant bit.
+   */
+  size_t lowQubit;
+  /**
+   * @brief The index of the kept qubit that becomes the most significant bit.
+   */
+  size_t highQubit;
+  /**
+   * @brief The already computed matrix of each visited pair of nodes.
+   */
+  std::map<std::pair<const dd::vNode*, const dd::vNode*>, Block> memo;
+};
+
+/**
+ * @brief Collects the amplitudes of a sub-diagram whose magnitude exceeds a
+ * threshold in ascending order of their indices.
+ * @param node The root node of the sub-diagram.
+ * @param weight The accumulated weight of the path leading to the node.
+ * @param offset The index of the first amplitude represented by the node.
+ * @param threshold The magnitude an amplitude has to exceed.
+ * @param maxCount The maximum number of amplitudes to collect in total.
+ * @param magnitudes The largest magnitudes below each node.
+ * @param result The vector to add the amplitudes to.
+ */
+void collectAmplitudesAbove(const dd::vNode* node, const Amplitude& weight,
+                            size_t offset, double threshold, size_t maxCount,
+                            MaximumMagnitudes& magnitudes,
+                            std::vector<std::pair<size_t, Complex>>& result) {
+  const auto level = static_cast<size_t>(node->v);
+  for (size_t i = 0; i < dd::RADIX && result.size() < maxCount; i++) {
+    const auto& edge = node->e.at(i);
+    if (edge.w.exactlyZero()) {
+      continue;
+    }
+    const auto childWeight = weight * static_cast<Amplitude>(edge.w);
+    const auto childOffset = offset + (i << level);
+    if (edge.isTerminal()) {
+      if (std::abs(childWeight) > threshold) {
+        result.emplace_back(childOffset,
+                            Complex{childWeight.real(), childWeight.imag()});
+      }
+      continue;
+    }
+    if (std::abs(childWeight) * magnitudes.of(edge.p) > threshold) {
+      collectAmplitudesAbove(edge.p, childWeight, childOffset, threshold,
+                             maxCount, magnitudes, result);
+    }
+  }
+}
+
+/**
+ * @brief A branch of a vector DD that may contain one of the largest
+ * amplitudes.
+ */
+struct AmplitudeCandidate {
+  /**
+   * @brief The largest magnitude of the amplitudes in the branch.
+   */
+  double bound;
+  /**
+   * @brief The index of the first amplitude represented by the branch.
+   */
+  size_t offset;
+  /**
+   * @brief The root node of the branch, or nullptr if the branch is a single
+   * amplitude.
+   */
+  const dd::vNode* node;
+  /**
+   * @brief The accumulated weight of the path leading to the branch.
+   */
+  Amplitude weight;
+
+  /**
+   * @brief Orders candidates such that the one with the largest bound, and
+   * then the smallest offset, is expanded first.
+   * @param other The candidate to compare to.
+   * @return True if this candidate is expanded after the other one.
+   */
+  bool operator<(const AmplitudeCandidate& other) const {
+    if (bound != other.bound) {
+      return bound < other.bound;
+    }
+    return offset > other.offset;
+  }
+};
+
+/**
+ * @brief Find the only node at the given level that is reachable from a node
+ * through edges with a non-zero weight.
+ * @param node The node to start at.
+ * @param level The level to find the node at. Must not be above the level of
+ * `node`.
+ * @return The node, or nullptr if multiple nodes or a terminal are reachable
+ * at that level.
+ */
+dd::vNode* findUniqueNode(dd::vNode* node, size_t level) {
+  std::unordered_set<dd::vNode*> frontier{node};
+  for (auto current = static_cast<size_t>(node->v); current > level;
+       current--) {
+    std::unordered_set<dd::vNode*> next;
+    for (const auto* parent : frontier) {
+      for (const auto& edge : parent->e) {
+        if (edge.w.exactlyZero()) {
+          continue;
+        }
+        if (edge.isTerminal() ||
+            static_cast<size_t>(edge.p->v) != current - 1) {
+          return nullptr;
+        }
+        next.insert(edge.p);
+      }
+    }
+    frontier = std::move(next);
+  }
+  return frontier.size() == 1 ? *frontier.begin() : nullptr;
+}
+
+/**
+ * @brief Compute the norm of a vector DD.
+ * @param dd The package the vector DD belongs to.
+ * @param edge The vector DD.
+ * @return The norm of the vector.
+ */
+double computeNorm(dd::Package& dd, const dd::vEdge& edge) {
+  return std::sqrt(
+      std::abs(static_cast<Amplitude>(dd.innerProduct(edge, edge))));
+}
+
+/**
+ * @brief Writes the amplitudes of a sub-diagram that fall into an index range.
+ * @param node The root node of the sub-diagram.
+ * @param weight The accumulated weight of the path leading to the node.
+ * @param offset The index of the first amplitude represented by the node.
+ * @param start The index of the first amplitude of the range.
+ * @param output The buffer representing the range. It is expected to be
+ * zeroed.
+ */
+void exportNodeRange(const dd::vNode* node, const Amplitude& weight,
+                     size_t offset, size_t start,
+                     const Span<Complex>& output) {
+  const auto level = static_cast<size_t>(node->v);
+  const auto end = start + output.size();
+  for (size_t i = 0; i < dd::RADIX; i++) {
+    const auto& edge = node->e.at(i);
+    const auto childOffset = offset + (i << level);
+    const auto childEnd = childOffset + (1ULL << level);
+    if (edge.w.exactlyZero() || childEnd <= start || childOffset >= end) {
+      continue;
+    }
+    const auto childWeight = weight * static_cast<Amplitude>(edge.w);
+    if (edge.isTerminal()) {
+      output[childOffset - start] = {childWeight.real(), childWeight.imag()};
+      continue;
+    }
+    exportNodeRange(edge.p, childWeight, childOffset, start, output);
+  }
+}
+
+} // namespace
+
+void exportStateVector(const dd::VectorDD& state, size_t numQubits,
+                       const Span<Complex>& output, size_t maxThreads) {
+  std::fill_n(output.data(), 1ULL << numQubits, Complex{0, 0});
+  if (state.w.exactlyZero()) {
+    return;
+  }
+
+  const auto rootWeight = static_cast<Amplitude>(state.w);
+  if (state.isTerminal()) {
+    output[0] = {rootWeight.real(), rootWeight.imag()};
+    return;
+  }
+
+  if (maxThreads == 0) {
+    maxThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  if (maxThreads == 1 || numQubits < PARALLEL_EXPORT_MIN_QUBITS) {
+    StateVectorExporter exporter(output);
+    exporter.exportNode(state.p, rootWeight, 0);
+    return;
+  }
+
+  // Expand the top levels until there are enough disjoint index ranges to
+  // distribute among the threads.
+  std::vector<ExportTask> tasks{{state.p, rootWeight, 0}};
+  while (!tasks.empty() && tasks.size() < maxThreads) {
+    std::vector<ExportTask> next;
+    for (const auto& task : tasks) {
+      splitTask(task, output, next);
+    }
+    tasks = std::move(next);
+  }
+
+  const auto numThreads = std::min(maxThreads, tasks.size());
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads);
+  for (size_t t = 0; t < numThreads; t++) {
+    workers.emplace_back([&tasks, &output, t, numThreads]() {
+      StateVectorExporter exporter(output);
+      for (size_t i = t; i < tasks.size(); i += numThreads) {
+        exporter.exportNode(tasks[i].node, tasks[i].weight, tasks[i].offset);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void exportStateVectorRange(const dd::VectorDD& state, size_t start,
+                            const Span<Complex>& output) {
+  std::fill_n(output.data(), output.size(), Complex{0, 0});
+  if (output.size() == 0 || state.w.exactlyZero()) {
+    return;
+  }
+  const auto rootWeight = static_cast<Amplitude>(state.w);
+  if (state.isTerminal()) {
+    if (start == 0) {
+      output[0] = {rootWeight.real(), rootWeight.imag()};
+    }
+    return;
+  }
+  exportNodeRange(state.p, rootWeight, 0, start, output);
+}
+
+size_t countNodes(const dd::VectorDD& state) {
+  if (state.isTerminal()) {
+    return 0;
+  }
+  std::unordered_set<const dd::vNode*> visited{state.p};
+  std::vector<const dd::vNode*> pending{state.p};
+  while (!pending.empty()) {
+    const auto* node = pending.back();
+    pending.pop_back();
+    for (const auto& edge : node->e) {
+      if (!edge.isTerminal() && visited.insert(edge.p).second) {
+        pending.push_back(edge.p);
+      }
+    }
+  }
+  return visited.size();
+}
+
+bool hasMultipleOutcomes(const dd::VectorDD& state, size_t numQubits,
+                         const std::vector<size_t>& qubits) {
+  if (qubits.empty() || state.isTerminal() ||
+      std::abs(static_cast<Amplitude>(state.w)) <= SUPPORT_TOLERANCE) {
+    return false;
+  }
+  SupportChecker checker(numQubits, qubits);
+  return checker.supportOf(state.p).multiple;
+}
+
+DensityMatrix computeTwoQubitDensityMatrix(const dd::VectorDD& state,
+                                          size_t qubit1, size_t qubit2) {
+  DensityMatrix reduced(4);
+  if (state.isTerminal() || state.w.exactlyZero()) {
+    return reduced;
+  }
+  TwoQubitReducer reducer(std::min(qubit1, qubit2), std::max(qubit1, qubit2));
+  const auto& block = reducer.of(state.p, state.p);
+  const auto norm = std::norm(static_cast<Amplitude>(state.w));
+  for (size_t row = 0; row < 4; row++) {
+    for (size_t col = 0; col < 4; col++) {
+      const auto entry = norm * block.at((row * 4) + col);
+      reduced(row, col) = {entry.real(), entry.imag()};
+    }
+  }
+  return reduced;
+}
+
+std::vector<std::pair<size_t, Complex>>
+findAmplitudesAbove(const dd::VectorDD& state, double threshold,
+                    size_t maxCount) {
+  std::vector<std::pair<size_t, Complex>> result;
+  if (maxCount == 0 || state.w.exactlyZero()) {
+    return result;
+  }
+  const auto rootWeight = static_cast<Amplitude>(state.w);
+  if (state.isTerminal()) {
+    if (std::abs(rootWeight) > threshold) {
+      result.emplace_back(0, Complex{rootWeight.real(), rootWeight.imag()});
+    }
+    return result;
+  }
+  MaximumMagnitudes magnitudes;
+  if (std::abs(rootWeight) * magnitudes.of(state.p) > threshold) {
+    collectAmplitudesAbove(state.p, rootWeight, 0, threshold, maxCount,
+                           magnitudes, result);
+  }
+  return result;
+}
+
+std::vector<std::pair<size_t, Complex>>
+findLargestAmplitudes(const dd::VectorDD& state, size_t k) {
+  std::vector<std::pair<size_t, Complex>> result;
+  if (k == 0 || state.w.exactlyZero()) {
+    return result;
+  }
+  const auto rootWeight = static_cast<Amplitude>(state.w);
+  if (state.isTerminal()) {
+    result.emplace_back(0, Complex{rootWeight.real(), rootWeight.imag()});
+    return result;
+  }
+
+  // Each bound is exact, since the largest amplitude below a node is reached
+  // by at least one path. Amplitudes are therefore popped in descending order.
+  MaximumMagnitudes magnitudes;
+  std::priority_queue<AmplitudeCandidate> candidates;
+  candidates.push({.bound = std::abs(rootWeight) * magnitudes.of(state.p),
+                   .offset = 0,
+                   .node = state.p,
+                   .weight = rootWeight});
+  while (!candidates.empty() && result.size() < k) {
+    const auto candidate = candidates.top();
+    candidates.pop();
+    if (candidate.node == nullptr) {
+      result.emplace_back(candidate.offset, Complex{candidate.weight.real(),
+                                                    candidate.weight.imag()});
+      continue;
+    }
+    const auto level = static_cast<size_t>(candidate.node->v);
+    for (size_t i = 0; i < dd::RADIX; i++) {
+      const auto& edge = candidate.node->e.at(i);
+      if (edge.w.exactlyZero()) {
+        continue;
+      }
+      const auto weight = candidate.weight * static_cast<Amplitude>(edge.w);
+      const auto offset = candidate.offset + (i << level);
+      const auto* child = edge.isTerminal() ? nullptr : edge.p;
+      const auto bound = std::abs(weight) *
+                         (child == nullptr ? 1. : magnitudes.of(child));
+      if (bound > 0) {
+        candidates.push({.bound = bound,
+                         .offset = offset,
+                         .node = child,
+                         .weight = weight});
+      }
+    }
+  }
+  return result;
+}
+
+std::optional<double>
+computeSubStateSimilarity(dd::Package& dd, const dd::VectorDD& state,
+                          size_t numQubits, const std::vector<size_t>& qubits,
+                          const Statevector& target) {
+  if (qubits.empty() || target.numQubits != qubits.size() ||
+      state.isTerminal() || state.w.exactlyZero() ||
+      static_cast<size_t>(state.p->v) + 1 != numQubits) {
+    return std::nullopt;
+  }
+  auto sorted = qubits;
+  std::ranges::sort(sorted);
+  const auto low = sorted.front();
+  const auto high = sorted.back();
+  if (high - low + 1 != sorted.size() ||
+      std::ranges::adjacent_find(sorted) != sorted.end()) {
+    return std::nullopt;
+  }
+
+  auto* upper = findUniqueNode(state.p, high);
+  if (upper == nullptr) {
+    return std::nullopt;
+  }
+  const dd::vEdge block{upper, dd::Complex::one()};
+
+  dd::CVec amplitudes;
+  amplitudes.reserve(target.numStates);
+  for (size_t i = 0; i < target.numStates; i++) {
+    amplitudes.emplace_back(target.amplitudes[i].real,
+                            target.amplitudes[i].imaginary);
+  }
+  auto reference = dd::makeStateFromVector(amplitudes, dd);
+  auto normalization = computeNorm(dd, block);
+
+  // The qubits below the block are in the same state for all paths, so the
+  // reference is completed with that state to match the levels of the block.
+  if (low > 0) {
+    auto* lower = findUniqueNode(upper, low - 1);
+    if (lower == nullptr) {
+      return std::nullopt;
+    }
+    const dd::vEdge rest{lower, dd::Complex::one()};
+    reference = dd.kronecker(reference, rest, low);
+    normalization *= computeNorm(dd, rest);
+  }
+
+  const auto overlap =
+      std::abs(static_cast<Amplitude>(dd.innerProduct(reference, block)));
+  return overlap / normalization;
+}
+
+} // namespace mqt::debugger
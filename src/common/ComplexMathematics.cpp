@@ -17,11 +17,15 @@
 
 #include "Eigen/src/Eigenvalues/ComplexEigenSolver.h"
 #include "common.h"
+#include "common/DensityMatrix.hpp"
 #include "common/Span.hpp"
 
 #include <Eigen/Dense>
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <stdexcept>
 #include <string>
@@ -33,79 +37,62 @@ namespace mqt::debugger {
 namespace {
 
 /**
- * @brief Compute the trace of the square of a given matrix.
- *
- * This is done so that we don't have to compute the entire square of the
- * matrix.
- * @param matrix The matrix to compute the trace of the square of.
- * @return The computed trace of the square.
+ * @brief Build a bit mask with the bits at the given indices set.
+ * @param bits The indices of the bits to set.
+ * @return The computed mask.
  */
-Complex getTraceOfSquare(const std::vector<std::vector<Complex>>& matrix) {
-  Complex runningSum{0, 0};
-  for (size_t i = 0; i < matrix.size(); i++) {
-    for (size_t k = 0; k < matrix.size(); k++) {
-      runningSum = complexAddition(
-          runningSum, complexMultiplication(matrix[i][k], matrix[k][i]));
-    }
+size_t getBitMask(const std::vector<size_t>& bits) {
+  size_t mask = 0;
+  for (const auto bit : bits) {
+    mask |= 1ULL << bit;
   }
-  return runningSum;
+  return mask;
 }
 
 /**
- * @brief Split a given number into two numbers partitioned by the bits at the
- * given indices.
+ * @brief Compute the positions of all numbers that only use the bits of a mask.
  *
- * Starts by extracting the bits at the given indices of its binary
- * representation. Then, the extracted and non-extracted parts are converted
- * into two new numbers.
- * @param number The number to split.
- * @param n The number of bits in the binary representation.
- * @param bits The indices of the bits to extract.
- * @return The two new numbers, partitioned by the extracted bits.
+ * Entry `k` of the result is the number obtained by depositing the bits of `k`
+ * into the set bits of the mask, starting from the least significant one. The
+ * entries are enumerated by incrementing only the masked bits, so no per-bit
+ * work is required.
+ * @param mask The mask to deposit the bits into.
+ * @return The deposited value of each number in [0, 2^popcount(mask)).
  */
-std::pair<size_t, size_t> splitBitString(size_t number, size_t n,
-                                         const std::vector<size_t>& bits) {
-  size_t lenFirst = 0;
-  size_t lenSecond = 0;
-
-  size_t first = 0;
-  size_t second = 0;
-
-  for (size_t index = 0; index < n; index++) {
-    if (std::ranges::find(bits, index) != bits.end()) {
-      first |= (number & 1) << lenFirst;
-      lenFirst++;
-    } else {
-      second |= (number & 1) << lenSecond;
-      lenSecond++;
-    }
-    number >>= 1;
+std::vector<size_t> getDepositedIndices(size_t mask) {
+  std::vector<size_t> indices(1ULL << std::popcount(mask));
+  size_t index = 0;
+  for (auto& entry : indices) {
+    entry = index;
+    index = ((index | ~mask) + 1) & mask;
   }
-  return {first, second};
+  return indices;
 }
 
 /**
  * @brief Compute the partial trace of a given matrix.
+ *
+ * Only the entries whose traced out parts match are visited, so the cost is
+ * O(2^n * 4^k) for k kept qubits instead of O(4^n).
  * @param matrix The matrix to compute the partial trace of.
  * @param indicesToTraceOut The indices of the qubits to trace out.
  * @param nQubits The total number of qubits.
  * @return The computed partial trace.
  */
-std::vector<std::vector<Complex>>
-getPartialTrace(const std::vector<std::vector<Complex>>& matrix,
-                const std::vector<size_t>& indicesToTraceOut, size_t nQubits) {
-  const auto traceSize = 1ULL << (nQubits - indicesToTraceOut.size());
-  std::vector<std::vector<Complex>> traceMatrix(
-      traceSize, std::vector<Complex>(traceSize, {0, 0}));
-  for (size_t i = 0; i < matrix.size(); i++) {
-    for (size_t j = 0; j < matrix.size(); j++) {
-      const auto split1 = splitBitString(i, nQubits, indicesToTraceOut);
-      const auto split2 = splitBitString(j, nQubits, indicesToTraceOut);
-      if (split1.first != split2.first) {
-        continue;
+DensityMatrix getPartialTrace(const DensityMatrix& matrix,
+                              const std::vector<size_t>& indicesToTraceOut,
+                              size_t nQubits) {
+  const auto tracedMask = getBitMask(indicesToTraceOut);
+  const auto kept = getDepositedIndices(((1ULL << nQubits) - 1) & ~tracedMask);
+  const auto traced = getDepositedIndices(tracedMask);
+  DensityMatrix traceMatrix(kept.size());
+  for (const auto offset : traced) {
+    for (size_t row = 0; row < kept.size(); row++) {
+      for (size_t col = 0; col < kept.size(); col++) {
+        traceMatrix(row, col) =
+            complexAddition(traceMatrix(row, col),
+                            matrix(offset | kept[row], offset | kept[col]));
       }
-      traceMatrix[split1.second][split2.second] = complexAddition(
-          traceMatrix[split1.second][split2.second], matrix[i][j]);
     }
   }
   return traceMatrix;
@@ -116,10 +103,9 @@ getPartialTrace(const std::vector<std::vector<Complex>>& matrix,
  * @param matrix The matrix to compute the entropy of.
  * @return The computed entropy.
  */
-double getEntropy(const std::vector<std::vector<Complex>>& matrix) {
-  const auto mat = toEigenMatrix(matrix);
-
-  const Eigen::ComplexEigenSolver<Eigen::MatrixXcd> solver(mat); // NOLINT
+double getEntropy(const DensityMatrix& matrix) {
+  const Eigen::ComplexEigenSolver<Eigen::MatrixXcd> solver( // NOLINT
+      matrix.asEigen());
   const auto& eigenvalues = solver.eigenvalues();
   double entropy = 0;
   for (const auto val : eigenvalues) {
@@ -145,7 +131,7 @@ double getEntropy(const std::vector<std::vector<Complex>>& matrix) {
  * @param matrix The density matrix to compute the shared information of.
  * @return The computed shared information.
  */
-double getSharedInformation(const std::vector<std::vector<Complex>>& matrix) {
+double getSharedInformation(const DensityMatrix& matrix) {
   const auto p0 = getPartialTrace(matrix, {1}, 2);
   const auto p1 = getPartialTrace(matrix, {0}, 2);
   return getEntropy(p0) + getEntropy(p1) - getEntropy(matrix);
@@ -184,9 +170,10 @@ Complex complexMultiplication(const Complex& c1, const Complex& c2) {
 
 Complex complexConjugate(const Complex& c) { return {c.real, -c.imaginary}; }
 
-bool areQubitsEntangled(std::vector<std::vector<Complex>>& densityMatrix,
-                        size_t qubit1, size_t qubit2) {
-  const auto numQubits = static_cast<size_t>(std::log2(densityMatrix.size()));
+bool areQubitsEntangled(const DensityMatrix& densityMatrix, size_t qubit1,
+                        size_t qubit2) {
+  const auto numQubits =
+      static_cast<size_t>(std::log2(densityMatrix.dimension()));
   if (numQubits == 2) {
     return getSharedInformation(densityMatrix) > 0;
   }
@@ -201,111 +188,174 @@ bool areQubitsEntangled(std::vector<std::vector<Complex>>& densityMatrix,
   return getSharedInformation(partialTrace) > 0;
 }
 
-std::vector<std::vector<Complex>> toDensityMatrix(const Statevector& sv) {
+bool areQubitsEntangled(const Statevector& sv, size_t qubit1, size_t qubit2) {
+  const auto reduced = getTwoQubitDensityMatrix(sv, qubit1, qubit2);
+  return getSharedInformation(reduced) > 0;
+}
+
+DensityMatrix getTwoQubitDensityMatrix(const Statevector& sv, size_t qubit1,
+                                       size_t qubit2) {
+  const auto lowMask = 1ULL << std::min(qubit1, qubit2);
+  const auto highMask = 1ULL << std::max(qubit1, qubit2);
   const Span<Complex> amplitudes(sv.amplitudes, sv.numStates);
-  std::vector<std::vector<Complex>> densityMatrix(
-      sv.numStates, std::vector<Complex>(sv.numStates, {0, 0}));
-  for (size_t i = 0; i < sv.numStates; i++) {
-    for (size_t j = 0; j < sv.numStates; j++) {
-      densityMatrix[i][j] =
-          complexMultiplication(amplitudes[i], complexConjugate(amplitudes[j]));
+  DensityMatrix reduced(4);
+  for (size_t base = 0; base < sv.numStates; base++) {
+    if ((base & (lowMask | highMask)) != 0) {
+      continue;
+    }
+    const std::array<Complex, 4> local{amplitudes[base],
+                                       amplitudes[base | lowMask],
+                                       amplitudes[base | highMask],
+                                       amplitudes[base | lowMask | highMask]};
+    for (size_t row = 0; row < 4; row++) {
+      for (size_t col = 0; col < 4; col++) {
+        const auto product = complexMultiplication(
+            local.at(row), complexConjugate(local.at(col)));
+        reduced(row, col) = complexAddition(reduced(row, col), product);
+      }
     }
   }
+  return reduced;
+}
 
+DensityMatrix toDensityMatrix(const Statevector& sv) {
+  const auto amplitudes = asEigenVector(sv.amplitudes, sv.numStates);
+  DensityMatrix densityMatrix(sv.numStates);
+  densityMatrix.asEigen().noalias() = amplitudes * amplitudes.adjoint();
   return densityMatrix;
 }
 
 bool partialTraceIsPure(const Statevector& sv,
                         const std::vector<size_t>& traceOut) {
-  const auto traceMatrix = getPartialTraceFromStateVector(sv, traceOut);
-  const auto trace = getTraceOfSquare(traceMatrix);
-  const double epsilon = 0.0001;
-  return trace.imaginary < epsilon && trace.imaginary > -epsilon &&
-         (trace.real - 1) < epsilon && (trace.real - 1) > -epsilon;
+  AmplitudeBuffer scratch;
+  return partialTraceIsPure(sv, traceOut, scratch);
 }
 
-std::vector<std::vector<Complex>>
+bool partialTraceIsPure(const Statevector& sv,
+                        const std::vector<size_t>& traceOut,
+                        AmplitudeBuffer& scratch) {
+  // Both sides of a bipartition share the same Schmidt coefficients, so the
+  // traced out qubits can be kept instead.
+  return isSeparable(getSchmidtDecomposition(sv, traceOut, scratch));
+}
+
+DensityMatrix
 getPartialTraceFromStateVector(const Statevector& sv,
                                const std::vector<size_t>& traceOut) {
-  const auto traceSize = 1ULL << (sv.numQubits - traceOut.size());
+  const auto tracedMask = getBitMask(traceOut);
+  const auto kept =
+      getDepositedIndices(((1ULL << sv.numQubits) - 1) & ~tracedMask);
+  const auto traced = getDepositedIndices(tracedMask);
   const Span<Complex> amplitudes(sv.amplitudes, sv.numStates);
-  std::vector<std::vector<Complex>> traceMatrix(
-      traceSize, std::vector<Complex>(traceSize, {0, 0}));
-  for (size_t i = 0; i < sv.numStates; i++) {
-    for (size_t j = 0; j < sv.numStates; j++) {
-      const auto split1 = splitBitString(i, sv.numQubits, traceOut);
-      const auto split2 = splitBitString(j, sv.numQubits, traceOut);
-      if (split1.first != split2.first) {
-        continue;
-      }
-      const auto product = complexMultiplication(amplitudes[i], amplitudes[j]);
-      const auto row = split1.second;
-      const auto col = split2.second;
-      traceMatrix[row][col] = complexAddition(traceMatrix[row][col], product);
+  DensityMatrix traceMatrix(kept.size());
+  auto result = traceMatrix.asEigen();
+
+  // For each assignment of the traced out qubits, add the outer product of the
+  // matching amplitudes. The result is hermitian, so only the upper triangle
+  // is accumulated.
+  EigenAmplitudes local(static_cast<Eigen::Index>(kept.size()));
+  for (const auto offset : traced) {
+    for (size_t row = 0; row < kept.size(); row++) {
+      const auto& amplitude = amplitudes[offset | kept[row]];
+      local(static_cast<Eigen::Index>(row)) = {amplitude.real,
+                                               amplitude.imaginary};
+    }
+    if (local.isZero(0)) {
+      continue;
     }
+    result.selfadjointView<Eigen::Upper>().rankUpdate(local);
   }
-  return traceMatrix;
-}
-
-Eigen::MatrixXcd // NOLINT
-toEigenMatrix(const std::vector<std::vector<Complex>>& matrix) {
-  Eigen::MatrixXcd mat(static_cast<int64_t>(matrix.size()),  // NOLINT
-                       static_cast<int64_t>(matrix.size())); // NOLINT
-  for (size_t i = 0; i < matrix.size(); i++) {
-    for (size_t j = 0; j < matrix.size(); j++) {
-      mat(static_cast<int64_t>(i), static_cast<int64_t>(j)) = {
-          matrix[i][j].real, matrix[i][j].imaginary};
+  for (size_t row = 0; row < kept.size(); row++) {
+    for (size_t col = 0; col < row; col++) {
+      traceMatrix(row, col) = complexConjugate(traceMatrix(col, row));
     }
   }
-  return mat;
+  return traceMatrix;
 }
 
 double complexMagnitude(Complex& c) {
   return std::sqrt((c.real * c.real) + (c.imaginary * c.imaginary));
 }
 
-std::vector<Complex>
-getSubStateVectorAmplitudes(const Statevector& sv,
-                            const std::vector<size_t>& qubits) {
-  std::vector<size_t> otherQubits;
-  for (size_t i = 0; i < sv.numQubits; i++) {
-    if (std::ranges::find(qubits, i) == qubits.end()) {
-      otherQubits.push_back(i);
+SchmidtDecomposition getSchmidtDecomposition(const Statevector& sv,
+                                             const std::vector<size_t>& qubits,
+                                             AmplitudeBuffer& scratch) {
+  const auto keptMask = getBitMask(qubits);
+  const auto kept = getDepositedIndices(keptMask);
+  const auto traced =
+      getDepositedIndices(((1ULL << sv.numQubits) - 1) & ~keptMask);
+
+  // If the kept qubits are the least significant ones, the amplitudes already
+  // form the reshaped matrix in column-major order.
+  const Complex* data = sv.amplitudes;
+  if (keptMask != kept.size() - 1) {
+    scratch.resize(kept.size() * traced.size());
+    for (size_t col = 0; col < traced.size(); col++) {
+      for (size_t row = 0; row < kept.size(); row++) {
+        scratch[(col * kept.size()) + row] =
+            sv.amplitudes[traced[col] | kept[row]];
+      }
     }
+    data = scratch.data();
   }
-
-  const auto traced = getPartialTraceFromStateVector(sv, otherQubits);
-
-  // Create Eigen3 Matrix
-  const auto mat = toEigenMatrix(traced);
-
-  const Eigen::ComplexEigenSolver<Eigen::MatrixXcd> solver(mat); // NOLINT
-
-  const auto& vectors = solver.eigenvectors();
-  const auto& values = solver.eigenvalues();
-  const auto epsilon = 0.0001;
-  int index = -1;
-  for (int i = 0; i < values.size(); i++) {
-    if (values[i].imag() < -epsilon || values[i].imag() > epsilon) {
-      continue;
-    }
-    if (values[i].real() - 1 < -epsilon || values[i].real() - 1 > epsilon) {
-      continue;
+  const Eigen::Map<const Eigen::MatrixXcd> matrix(
+      reinterpret_cast<const std::complex<double>*>(data), // NOLINT
+      static_cast<Eigen::Index>(kept.size()),
+      static_cast<Eigen::Index>(traced.size()));
+  const Eigen::BDCSVD<Eigen::MatrixXcd, Eigen::ComputeThinU> svd(matrix);
+
+  SchmidtDecomposition decomposition;
+  const auto& values = svd.singularValues();
+  decomposition.coefficients.assign(values.begin(), values.end());
+
+  // Singular vectors are only unique up to a global phase, which is fixed by
+  // the first amplitude of maximal magnitude.
+  const auto vector = svd.matrixU().col(0);
+  const auto epsilon = 1e-8;
+  Eigen::Index pivot = 0;
+  for (Eigen::Index i = 1; i < vector.size(); i++) {
+    if (std::abs(vector(i)) > std::abs(vector(pivot)) + epsilon) {
+      pivot = i;
     }
-    index = i;
   }
+  const auto phase = std::abs(vector(pivot)) > 0
+                         ? std::conj(vector(pivot)) / std::abs(vector(pivot))
+                         : std::complex<double>{1, 0};
+  decomposition.subState.resize(kept.size());
+  for (size_t i = 0; i < kept.size(); i++) {
+    const auto amplitude = vector(static_cast<Eigen::Index>(i)) * phase;
+    decomposition.subState[i] = {.real = amplitude.real(),
+                                 .imaginary = amplitude.imag()};
+  }
+  return decomposition;
+}
 
-  if (index == -1) {
-    throw std::runtime_error("No valid index found");
+bool isSeparable(const SchmidtDecomposition& decomposition) {
+  double purity = 0;
+  for (const auto coefficient : decomposition.coefficients) {
+    const auto probability = coefficient * coefficient;
+    purity += probability * probability;
   }
+  const double epsilon = 0.0001;
+  return (purity - 1) < epsilon && (purity - 1) > -epsilon;
+}
 
-  std::vector<Complex> amplitudes(traced.size());
+std::vector<Complex>
+getSubStateVectorAmplitudes(const Statevector& sv,
+                            const std::vector<size_t>& qubits) {
+  AmplitudeBuffer scratch;
+  return getSubStateVectorAmplitudes(sv, qubits, scratch);
+}
 
-  for (size_t i = 0; i < traced.size(); i++) {
-    amplitudes[i] = {.real = vectors(static_cast<int>(i), index).real(),
-                     .imaginary = vectors(static_cast<int>(i), index).imag()};
+std::vector<Complex>
+getSubStateVectorAmplitudes(const Statevector& sv,
+                            const std::vector<size_t>& qubits,
+                            AmplitudeBuffer& scratch) {
+  auto decomposition = getSchmidtDecomposition(sv, qubits, scratch);
+  if (!isSeparable(decomposition)) {
+    throw std::runtime_error("Sub-state is entangled with other qubits");
   }
-  return amplitudes;
+  return std::move(decomposition.subState);
 }
 
 std::string complexToString(const Complex& c) {
@@ -320,20 +370,9 @@ std::string complexToString(const Complex& c) {
 }
 
 double dotProduct(const Statevector& sv1, const Statevector& sv2) {
-  double resultReal = 0;
-  double resultImag = 0;
-
-  const Span<Complex> amplitudes1(sv1.amplitudes, sv1.numStates);
-  const Span<Complex> amplitudes2(sv2.amplitudes, sv2.numStates);
-
-  for (size_t i = 0; i < sv1.numStates; i++) {
-    resultReal += amplitudes1[i].real * amplitudes2[i].real +
-                  amplitudes1[i].imaginary * amplitudes2[i].imaginary;
-    resultImag += -1 * amplitudes1[i].real * amplitudes2[i].imaginary +
-                  amplitudes1[i].imaginary * amplitudes2[i].real;
-  }
-  Complex result{resultReal, resultImag};
-  return complexMagnitude(result);
+  const auto amplitudes1 = asEigenVector(sv1.amplitudes, sv1.numStates);
+  const auto amplitudes2 = asEigenVector(sv2.amplitudes, sv2.numStates);
+  return std::abs(amplitudes2.dot(amplitudes1));
 }
 
 } // namespace mqt::debugger
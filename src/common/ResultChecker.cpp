@@ -0,0 +1,766 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file ResultChecker.cpp
+ * @brief Implementation of ResultChecker.hpp
+ */
+
+#include "common/ResultChecker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mqt::debugger {
+
+namespace {
+
+/**
+ * @brief The maximum number of iterations used to evaluate the incomplete
+ * gamma function.
+ */
+constexpr size_t GAMMA_MAX_ITERATIONS = 1000;
+
+/**
+ * @brief The relative precision up to which the incomplete gamma function is
+ * evaluated.
+ */
+constexpr double GAMMA_EPSILON = 1e-15;
+
+/**
+ * @brief The number of samples distributions are scaled to before they are
+ * compared.
+ */
+constexpr double SCALED_SAMPLES = 100.0;
+
+/**
+ * @brief The tolerance below which a statistic or p-value counts as zero.
+ */
+constexpr double ZERO_TOLERANCE = 1e-8;
+
+/**
+ * @brief Reads a JSON list of results from a stream buffer in a single pass.
+ *
+ * Only the subset of JSON that can describe results is accepted: a list of
+ * objects whose values are numbers, strings, or booleans.
+ */
+class ResultReader {
+public:
+  /**
+   * @brief Create a new reader for the given stream buffer.
+   * @param buffer The stream buffer to read from.
+   */
+  explicit ResultReader(std::streambuf* buffer) : buffer(buffer) {}
+
+  /**
+   * @brief Skip any whitespace and peek at the next character.
+   * @return The next character, or EOF if the stream ended.
+   */
+  int peek() {
+    auto c = buffer->sgetc();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+      c = buffer->snextc();
+    }
+    return c;
+  }
+
+  /**
+   * @brief Consume the next non-whitespace character if it is the expected
+   * one.
+   * @param expected The expected character.
+   * @return True if the character was consumed, false otherwise.
+   */
+  bool consume(char expected) {
+    if (peek() != expected) {
+      return false;
+    }
+    buffer->sbumpc();
+    return true;
+  }
+
+  /**
+   * @brief Consume the next non-whitespace character, which must be the
+   * expected one.
+   * @param expected The expected character.
+   */
+  void expect(char expected) {
+    if (!consume(expected)) {
+      fail(std::string("expected '") + expected + "'");
+    }
+  }
+
+  /**
+   * @brief Read a JSON string.
+   * @param output The string to store the decoded characters in.
+   */
+  void readString(std::string& output) {
+    expect('"');
+    output.clear();
+    while (true) {
+      const auto c = buffer->sbumpc();
+      if (c == EOF) {
+        fail("unterminated string");
+      }
+      if (c == '"') {
+        return;
+      }
+      if (c != '\\') {
+        output.push_back(static_cast<char>(c));
+        continue;
+      }
+      const auto escaped = buffer->sbumpc();
+      switch (escaped) {
+      case '"':
+      case '\\':
+      case '/':
+        output.push_back(static_cast<char>(escaped));
+        break;
+      case 'b':
+        output.push_back('\b');
+        break;
+      case 'f':
+        output.push_back('\f');
+        break;
+      case 'n':
+        output.push_back('\n');
+        break;
+      case 'r':
+        output.push_back('\r');
+        break;
+      case 't':
+        output.push_back('\t');
+        break;
+      case 'u':
+        appendCodePoint(readCodePoint(), output);
+        break;
+      default:
+        fail("invalid escape sequence");
+      }
+    }
+  }
+
+  /**
+   * @brief Read a value of a result and check whether its integer part is
+   * non-zero.
+   * @return True if the value is non-zero, false otherwise.
+   */
+  bool readNonZeroValue() {
+    const auto c = peek();
+    if (c == '"') {
+      readString(scratch);
+      return parseIntegerString(scratch);
+    }
+    if (c == 't') {
+      expectWord("true");
+      return true;
+    }
+    if (c == 'f') {
+      expectWord("false");
+      return false;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+      scratch.clear();
+      auto next = buffer->sgetc();
+      while (next == '-' || next == '+' || next == '.' || next == 'e' ||
+             next == 'E' || (next >= '0' && next <= '9')) {
+        scratch.push_back(static_cast<char>(next));
+        next = buffer->snextc();
+      }
+      char* end = nullptr;
+      const auto value = std::strtod(scratch.c_str(), &end);
+      if (end != scratch.c_str() + scratch.size()) {
+        fail("invalid number");
+      }
+      // Python's `int` truncates towards zero.
+      return std::abs(value) >= 1.0;
+    }
+    fail("values of results must be numbers, strings, or booleans");
+  }
+
+  /**
+   * @brief Throw an error describing a malformed input.
+   * @param message The description of the problem.
+   */
+  [[noreturn]] static void fail(const std::string& message) {
+    throw std::invalid_argument("Invalid result file: " + message + ".");
+  }
+
+private:
+  /**
+   * @brief Consume a keyword, which must follow in the stream.
+   * @param word The keyword.
+   */
+  void expectWord(const char* word) {
+    for (const auto* c = word; *c != '\0'; c++) {
+      if (buffer->sbumpc() != *c) {
+        fail(std::string("expected '") + word + "'");
+      }
+    }
+  }
+
+  /**
+   * @brief Read the four hexadecimal digits of a unicode escape sequence.
+   * @return The encoded UTF-16 code unit.
+   */
+  uint32_t readCodeUnit() {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+      const auto c = buffer->sbumpc();
+      value <<= 4U;
+      if (c >= '0' && c <= '9') {
+        value |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        value |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        value |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        fail("invalid unicode escape sequence");
+      }
+    }
+    return value;
+  }
+
+  /**
+   * @brief Read a unicode escape sequence, combining surrogate pairs.
+   * @return The encoded code point.
+   */
+  uint32_t readCodePoint() {
+    const auto high = readCodeUnit();
+    if (high < 0xD800 || high > 0xDBFF) {
+      return high;
+    }
+    if (buffer->sbumpc() != '\\' || buffer->sbumpc() != 'u') {
+      fail("invalid surrogate pair");
+    }
+    const auto low = readCodeUnit();
+    if (low < 0xDC00 || low > 0xDFFF) {
+      fail("invalid surrogate pair");
+    }
+    return 0x10000 + ((high - 0xD800) << 10U) + (low - 0xDC00);
+  }
+
+  /**
+   * @brief Append a code point to a string in UTF-8 encoding.
+   * @param codePoint The code point to append.
+   * @param output The string to append to.
+   */
+  static void appendCodePoint(uint32_t codePoint, std::string& output) {
+    if (codePoint < 0x80) {
+      output.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+      output.push_back(static_cast<char>(0xC0 | (codePoint >> 6U)));
+      output.push_back(static_cast<char>(0x80 | (codePoint & 0x3FU)));
+    } else if (codePoint < 0x10000) {
+      output.push_back(static_cast<char>(0xE0 | (codePoint >> 12U)));
+      output.push_back(static_cast<char>(0x80 | ((codePoint >> 6U) & 0x3FU)));
+      output.push_back(static_cast<char>(0x80 | (codePoint & 0x3FU)));
+    } else {
+      output.push_back(static_cast<char>(0xF0 | (codePoint >> 18U)));
+      output.push_back(static_cast<char>(0x80 | ((codePoint >> 12U) & 0x3FU)));
+      output.push_back(static_cast<char>(0x80 | ((codePoint >> 6U) & 0x3FU)));
+      output.push_back(static_cast<char>(0x80 | (codePoint & 0x3FU)));
+    }
+  }
+
+  /**
+   * @brief Parse a string the same way Python's `int` would and check
+   * whether it is non-zero.
+   * @param text The string to parse.
+   * @return True if the parsed integer is non-zero, false otherwise.
+   */
+  static bool parseIntegerString(const std::string& text) {
+    const auto first = text.find_first_not_of(" \t\n\r\f\v");
+    const auto last = text.find_last_not_of(" \t\n\r\f\v");
+    if (first == std::string::npos) {
+      fail("invalid integer string");
+    }
+    auto start = first;
+    if (text[start] == '+' || text[start] == '-') {
+      start++;
+    }
+    if (start > last) {
+      fail("invalid integer string");
+    }
+    bool nonZero = false;
+    for (auto i = start; i <= last; i++) {
+      if (text[i] < '0' || text[i] > '9') {
+        fail("invalid integer string");
+      }
+      nonZero |= text[i] != '0';
+    }
+    return nonZero;
+  }
+
+  /**
+   * @brief The stream buffer to read from.
+   */
+  std::streambuf* buffer;
+
+  /**
+   * @brief Scratch space for values, reused between calls.
+   */
+  std::string scratch;
+};
+
+/**
+ * @brief Evaluate the regularized upper incomplete gamma function Q(a, x).
+ *
+ * The series expansion is used for small `x` and the continued fraction
+ * otherwise, as both converge quickly in their respective domain.
+ * @param a The shape parameter, which must be positive.
+ * @param x The argument, which must be positive.
+ * @return The value of Q(a, x).
+ */
+double regularizedUpperGamma(double a, double x) {
+  const auto logPrefactor = (-x) + (a * std::log(x)) - std::lgamma(a);
+  if (x < a + 1) {
+    auto term = 1.0 / a;
+    auto sum = term;
+    for (size_t n = 1; n < GAMMA_MAX_ITERATIONS; n++) {
+      term *= x / (a + static_cast<double>(n));
+      sum += term;
+      if (std::abs(term) < std::abs(sum) * GAMMA_EPSILON) {
+        break;
+      }
+    }
+    return 1.0 - (sum * std::exp(logPrefactor));
+  }
+
+  // Modified Lentz's method for the continued fraction.
+  constexpr auto tiny = std::numeric_limits<double>::min() / GAMMA_EPSILON;
+  auto b = x + 1 - a;
+  auto c = 1.0 / tiny;
+  auto d = 1.0 / b;
+  auto h = d;
+  for (size_t i = 1; i < GAMMA_MAX_ITERATIONS; i++) {
+    const auto n = static_cast<double>(i);
+    const auto an = -n * (n - a);
+    b += 2;
+    d = (an * d) + b;
+    if (std::abs(d) < tiny) {
+      d = tiny;
+    }
+    c = b + (an / c);
+    if (std::abs(c) < tiny) {
+      c = tiny;
+    }
+    d = 1.0 / d;
+    const auto delta = d * c;
+    h *= delta;
+    if (std::abs(delta - 1) < GAMMA_EPSILON) {
+      break;
+    }
+  }
+  return std::exp(logPrefactor) * h;
+}
+
+/**
+ * @brief Compute the survival function of the chi-squared distribution.
+ * @param x The value to evaluate the survival function at.
+ * @param degreesOfFreedom The degrees of freedom of the distribution.
+ * @return The probability of observing a value larger than `x`, or NaN if the
+ * degrees of freedom are not positive.
+ */
+double chiSquaredSurvival(double x, double degreesOfFreedom) {
+  if (!(degreesOfFreedom > 0) || std::isnan(x)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (x <= 0) {
+    return 1.0;
+  }
+  return regularizedUpperGamma(degreesOfFreedom / 2, x / 2);
+}
+
+/**
+ * @brief Remove the bins with an expected count of zero.
+ * @param observed The observed counts, filtered in place.
+ * @param expected The expected counts, filtered in place.
+ * @return False if a value was observed for a removed bin, true otherwise.
+ */
+bool filterOutZeros(std::vector<double>& observed,
+                    std::vector<double>& expected) {
+  size_t kept = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i] != 0) {
+      observed[kept] = observed[i];
+      expected[kept] = expected[i];
+      kept++;
+    } else if (observed[i] != 0) {
+      return false;
+    }
+  }
+  observed.resize(kept);
+  expected.resize(kept);
+  return true;
+}
+
+/**
+ * @brief Merge the smallest bins until all expected bins contain at least
+ * half of the average observed count, but never less than 5 samples.
+ *
+ * At least two bins are always kept.
+ * @param observed The observed counts, merged in place.
+ * @param expected The expected counts, merged in place.
+ */
+void mergeBins(std::vector<double>& observed, std::vector<double>& expected) {
+  const auto numBins = static_cast<double>(observed.size());
+  const auto maxObserved = *std::max_element(observed.begin(), observed.end());
+  const auto halfAverage = std::floor(std::floor(maxObserved / numBins) / 2);
+  const auto minSize = std::trunc(std::max(5.0, halfAverage));
+
+  std::vector<size_t> order(expected.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&expected](size_t a, size_t b) {
+    return expected[a] < expected[b];
+  });
+  std::vector<double> sortedObserved;
+  std::vector<double> sortedExpected;
+  sortedObserved.reserve(order.size());
+  sortedExpected.reserve(order.size());
+  for (const auto index : order) {
+    sortedObserved.push_back(observed[index]);
+    sortedExpected.push_back(expected[index]);
+  }
+
+  while (sortedExpected[0] < minSize && sortedExpected.size() > 2) {
+    const auto mergedExpected = sortedExpected[0] + sortedExpected[1];
+    const auto mergedObserved = sortedObserved[0] + sortedObserved[1];
+    sortedExpected.erase(sortedExpected.begin(), sortedExpected.begin() + 2);
+    sortedObserved.erase(sortedObserved.begin(), sortedObserved.begin() + 2);
+    const auto position =
+        std::upper_bound(sortedExpected.begin(), sortedExpected.end(),
+                         mergedExpected) -
+        sortedExpected.begin();
+    sortedExpected.insert(sortedExpected.begin() + position, mergedExpected);
+    sortedObserved.insert(sortedObserved.begin() + position, mergedObserved);
+  }
+  observed = std::move(sortedObserved);
+  expected = std::move(sortedExpected);
+}
+
+/**
+ * @brief Preprocess the expected counts according to the 'between'
+ * characteristic.
+ *
+ * If an observed count lies between the expected counts with and without
+ * noise, the observed count is used as reference. Otherwise, the closer of
+ * both expected counts is used and adjusted, so that the references sum up
+ * to the number of observed samples.
+ * @param observed The observed counts.
+ * @param expectedNoNoise The expected counts without noise.
+ * @param expectedNoise The expected counts with noise.
+ * @return The preprocessed expected counts.
+ */
+std::vector<double>
+preprocessBetweenCharacteristic(const std::vector<double>& observed,
+                                const std::vector<double>& expectedNoNoise,
+                                const std::vector<double>& expectedNoise) {
+  std::vector<double> references(observed.size());
+  std::vector<bool> kept(observed.size());
+  size_t numKept = 0;
+  double diff = 0;
+  for (size_t i = 0; i < observed.size(); i++) {
+    const auto o = observed[i];
+    const auto e1 = expectedNoNoise[i];
+    const auto e2 = expectedNoise[i];
+    if ((e2 < e1 && o > e2 && o < e1) || (e2 > e1 && o < e2 && o > e1)) {
+      references[i] = o;
+    } else {
+      references[i] = std::abs(o - e1) < std::abs(o - e2) ? e1 : e2;
+      kept[i] = true;
+      numKept++;
+    }
+    diff += o - references[i];
+  }
+  if (numKept > 0) {
+    const auto dt = diff / static_cast<double>(numKept);
+    for (size_t i = 0; i < references.size(); i++) {
+      if (kept[i]) {
+        references[i] += dt;
+      }
+    }
+  }
+  return references;
+}
+
+} // namespace
+
+ResultCounts
+loadResultCounts(std::istream& input,
+                 const std::vector<std::vector<std::string>>& registers) {
+  ResultCounts result;
+  result.offsets.reserve(registers.size() + 1);
+  result.offsets.push_back(0);
+  // The register and bit each variable is counted for.
+  std::unordered_map<std::string, std::pair<size_t, size_t>> lookup;
+  for (size_t r = 0; r < registers.size(); r++) {
+    const auto& variables = registers[r];
+    if (variables.size() >= std::numeric_limits<size_t>::digits) {
+      throw std::invalid_argument("Assertion registers may contain at most " +
+                                  std::to_string(
+                                      std::numeric_limits<size_t>::digits - 1) +
+                                  " variables.");
+    }
+    for (size_t bit = 0; bit < variables.size(); bit++) {
+      lookup.try_emplace(variables[bit], r, bit);
+    }
+    result.offsets.push_back(result.offsets.back() +
+                             (1ULL << variables.size()));
+  }
+  result.counts.resize(result.offsets.back());
+
+  ResultReader reader(input.rdbuf());
+  std::vector<size_t> indices(registers.size());
+  std::string key;
+  reader.expect('[');
+  if (!reader.consume(']')) {
+    do {
+      std::fill(indices.begin(), indices.end(), 0);
+      reader.expect('{');
+      if (!reader.consume('}')) {
+        do {
+          reader.readString(key);
+          reader.expect(':');
+          const auto nonZero = reader.readNonZeroValue();
+          if (!nonZero) {
+            continue;
+          }
+          const auto found = lookup.find(key);
+          if (found != lookup.end()) {
+            indices[found->second.first] |= 1ULL << found->second.second;
+          }
+        } while (reader.consume(','));
+        reader.expect('}');
+      }
+      for (size_t r = 0; r < indices.size(); r++) {
+        result.counts[result.offsets[r] + indices[r]]++;
+      }
+      result.numSamples++;
+    } while (reader.consume(','));
+    reader.expect(']');
+  }
+  if (reader.peek() != EOF) {
+    ResultReader::fail("unexpected data after the list of results");
+  }
+  return result;
+}
+
+std::vector<double> parseExpectedProbabilities(const std::string& assertion) {
+  if (!assertion.starts_with("{")) {
+    throw std::invalid_argument("Invalid assertion '" + assertion + "'.");
+  }
+  const auto end = assertion.find('}');
+  const auto list = assertion.substr(1, end == std::string::npos
+                                            ? std::string::npos
+                                            : end - 1);
+  std::vector<double> probabilities;
+  size_t start = 0;
+  while (true) {
+    const auto separator = list.find(',', start);
+    const auto entry = list.substr(start, separator == std::string::npos
+                                              ? std::string::npos
+                                              : separator - start);
+    char* parsedEnd = nullptr;
+    const auto value = std::strtod(entry.c_str(), &parsedEnd);
+    const std::string rest(parsedEnd);
+    if (parsedEnd == entry.c_str() ||
+        rest.find_first_not_of(" \t\n\r\f\v") != std::string::npos) {
+      throw std::invalid_argument("Invalid expected value '" + entry +
+                                  "' in assertion.");
+    }
+    probabilities.push_back(value);
+    if (separator == std::string::npos) {
+      break;
+    }
+    start = separator + 1;
+  }
+  const auto magnitude =
+      std::accumulate(probabilities.begin(), probabilities.end(), 0.0);
+  for (auto& p : probabilities) {
+    p /= magnitude;
+  }
+  return probabilities;
+}
+
+std::pair<double, double>
+checkPowerDivergence(const std::vector<double>& observed,
+                     const std::vector<double>& expected, double power) {
+  auto filteredObserved = observed;
+  auto filteredExpected = expected;
+  filteredObserved.resize(std::min(observed.size(), expected.size()));
+  filteredExpected.resize(filteredObserved.size());
+  if (!filterOutZeros(filteredObserved, filteredExpected) ||
+      filteredObserved.empty()) {
+    return {0.0, 0.0};
+  }
+  mergeBins(filteredObserved, filteredExpected);
+
+  double statistic = 0;
+  for (size_t i = 0; i < filteredObserved.size(); i++) {
+    const auto o = filteredObserved[i];
+    statistic += o * (std::pow(o / filteredExpected[i], power) - 1);
+  }
+  statistic *= 2 / (power * (power + 1));
+
+  const auto degreesOfFreedom =
+      static_cast<double>(filteredObserved.size()) - 1;
+  return {statistic, chiSquaredSurvival(statistic, degreesOfFreedom)};
+}
+
+bool distributionEqualUnderNoise(
+    const std::vector<size_t>& distribution,
+    const std::vector<double>& expectedProbabilities, size_t numSamples,
+    double expectedSuccessProbability, double pValue, bool scale) {
+  std::vector<double> observed(distribution.begin(), distribution.end());
+  auto samples = static_cast<double>(numSamples);
+  if (scale) {
+    const auto factor = SCALED_SAMPLES / samples;
+    for (auto& o : observed) {
+      o *= factor;
+    }
+    samples = SCALED_SAMPLES;
+  }
+
+  const auto numBins = static_cast<double>(expectedProbabilities.size());
+  std::vector<double> expectedNoise;
+  std::vector<double> expectedNoNoise;
+  expectedNoise.reserve(expectedProbabilities.size());
+  expectedNoNoise.reserve(expectedProbabilities.size());
+  for (const auto p : expectedProbabilities) {
+    const auto withNoise = (expectedSuccessProbability * p) +
+                           ((1 - expectedSuccessProbability) / numBins);
+    expectedNoise.push_back(withNoise * samples);
+    expectedNoNoise.push_back(p * samples);
+  }
+  const auto size = std::min(observed.size(), expectedNoise.size());
+  observed.resize(size);
+  expectedNoise.resize(size);
+  expectedNoNoise.resize(size);
+
+  const auto preprocessed =
+      preprocessBetweenCharacteristic(observed, expectedNoNoise, expectedNoise);
+  const auto [statistic, p] = checkPowerDivergence(observed, preprocessed);
+  if (std::abs(p) <= ZERO_TOLERANCE && std::abs(statistic) <= ZERO_TOLERANCE) {
+    return false;
+  }
+  return p > pValue;
+}
+
+bool checkAssertionResult(const std::string& assertion,
+                          const std::vector<size_t>& distribution,
+                          size_t numSamples, double expectedSuccessProbability,
+                          double pValue) {
+  if (numSamples == 0) {
+    throw std::invalid_argument("Cannot check an assertion without samples.");
+  }
+  if (distribution.empty()) {
+    throw std::invalid_argument("Cannot check an empty distribution.");
+  }
+  if (assertion.starts_with("{superposition}")) {
+    const auto highest =
+        static_cast<double>(
+            *std::max_element(distribution.begin(), distribution.end())) /
+        static_cast<double>(numSamples);
+    return (highest - ((1 - expectedSuccessProbability) /
+                       static_cast<double>(distribution.size()))) <
+           expectedSuccessProbability;
+  }
+  if (assertion.starts_with("{zero}")) {
+    std::vector<double> expected(distribution.size(), 0.0);
+    expected[0] = 1.0;
+    return distributionEqualUnderNoise(distribution, expected, numSamples,
+                                       expectedSuccessProbability);
+  }
+  const auto expected = parseExpectedProbabilities(assertion);
+  return distributionEqualUnderNoise(distribution, expected, numSamples,
+                                     expectedSuccessProbability, pValue);
+}
+
+std::vector<bool>
+checkResults(std::istream& input,
+             const std::vector<std::vector<std::string>>& registers,
+             const std::vector<std::string>& assertions,
+             double expectedSuccessProbability, double pValue,
+             size_t maxThreads) {
+  if (registers.size() != assertions.size()) {
+    throw std::invalid_argument(
+        "Each assertion requires exactly one register.");
+  }
+  const auto counts = loadResultCounts(input, registers);
+
+  // `std::vector<bool>` cannot be written concurrently, so the results are
+  // collected as bytes first.
+  std::vector<char> results(assertions.size());
+  const auto checkOne = [&](size_t i) {
+    const std::vector<size_t> distribution(
+        counts.counts.begin() + static_cast<std::ptrdiff_t>(counts.offsets[i]),
+        counts.counts.begin() +
+            static_cast<std::ptrdiff_t>(counts.offsets[i + 1]));
+    results[i] = static_cast<char>(
+        checkAssertionResult(assertions[i], distribution, counts.numSamples,
+                             expectedSuccessProbability, pValue));
+  };
+
+  if (maxThreads == 0) {
+    maxThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  const auto numThreads = std::min(maxThreads, assertions.size());
+  if (numThreads <= 1) {
+    for (size_t i = 0; i < assertions.size(); i++) {
+      checkOne(i);
+    }
+  } else {
+    // Assertions differ in size, so they are handed out one at a time.
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (size_t t = 0; t < numThreads; t++) {
+      workers.emplace_back([&]() {
+        for (auto i = next++; i < assertions.size() && !failed; i = next++) {
+          try {
+            checkOne(i);
+          } catch (...) {
+            // Only the first exception is kept. All other workers stop at
+            // their next assertion.
+            if (!failed.exchange(true)) {
+              error = std::current_exception();
+            }
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return {results.begin(), results.end()};
+}
+
+} // namespace mqt::debugger
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file ShotEstimator.cpp
+ * @brief Implementation of ShotEstimator.hpp
+ */
+
+#include "common/ShotEstimator.hpp"
+
+#include "common/ResultChecker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mqt::debugger {
+
+namespace {
+
+/**
+ * @brief The number of samples per outcome that candidates are multiples of.
+ */
+constexpr size_t SAMPLES_PER_OUTCOME = 5;
+
+/**
+ * @brief Derive the seed of the generator of one trial.
+ *
+ * The seeds are mixed with the SplitMix64 finalizer, so that the generators
+ * of neighbouring trials are uncorrelated.
+ * @param seed The seed of the estimation.
+ * @param trial The index of the trial.
+ * @return The seed of the trial.
+ */
+uint64_t getTrialSeed(uint64_t seed, size_t trial) {
+  auto z = seed + ((trial + 1) * 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+/**
+ * @brief The smallest mode of binomial distributions for which the BTRD
+ * algorithm is used instead of inversion.
+ */
+constexpr uint64_t BTRD_MIN_MODE = 11;
+
+/**
+ * @brief The largest distance from the mode for which BTRD evaluates the
+ * ratio of probabilities explicitly.
+ */
+constexpr uint64_t BTRD_EXPLICIT_LIMIT = 15;
+
+/**
+ * @brief Draw a uniformly distributed number in [0, 1).
+ *
+ * Unlike `std::uniform_real_distribution`, the result only depends on the
+ * generator, so that estimations are reproducible on all platforms.
+ * @param generator The random number generator to use.
+ * @return The drawn number.
+ */
+double sampleUniform(std::mt19937_64& generator) {
+  constexpr auto scale = 1.0 / static_cast<double>(1ULL << 53U);
+  return static_cast<double>(generator() >> 11U) * scale;
+}
+
+/**
+ * @brief Compute the error of Stirling's approximation of log(k!).
+ * @param k The argument.
+ * @return The difference between log(k!) and its Stirling approximation.
+ */
+double stirlingCorrection(uint64_t k) {
+  static constexpr std::array<double, 10> TABLE = {
+      0.08106146679532726, 0.04134069595540929, 0.02767792568499834,
+      0.02079067210376509, 0.01664469118982119, 0.01387612882307075,
+      0.01189670994589177, 0.01041126526197209, 0.009255462182712733,
+      0.008330563433362871};
+  if (k < TABLE.size()) {
+    return TABLE.at(k);
+  }
+  const auto inverse = 1.0 / (static_cast<double>(k) + 1);
+  const auto inverseSquared = inverse * inverse;
+  return ((1.0 / 12) - (((1.0 / 360) - (inverseSquared / 1260)) *
+                        inverseSquared)) *
+         inverse;
+}
+
+/**
+ * @brief Draw a binomially distributed number.
+ *
+ * Small means are sampled by inversion, larger ones with the BTRD algorithm
+ * by Hörmann, so the cost does not grow with the number of trials. Unlike
+ * `std::binomial_distribution`, the result only depends on the generator.
+ * @param n The number of trials.
+ * @param p The success probability of each trial.
+ * @param generator The random number generator to use.
+ * @return The number of successes.
+ */
+uint64_t sampleBinomial(uint64_t n, double p, std::mt19937_64& generator) {
+  if (n == 0 || p <= 0) {
+    return 0;
+  }
+  if (p >= 1) {
+    return n;
+  }
+  if (p > 0.5) {
+    return n - sampleBinomial(n, 1 - p, generator);
+  }
+
+  const auto nd = static_cast<double>(n);
+  const auto q = 1 - p;
+  const auto mode = static_cast<uint64_t>(std::floor((nd + 1) * p));
+  if (mode < BTRD_MIN_MODE) {
+    const auto s = p / q;
+    const auto a = (nd + 1) * s;
+    while (true) {
+      auto r = std::exp(nd * std::log1p(-p));
+      auto u = sampleUniform(generator);
+      uint64_t x = 0;
+      while (u > r && x <= n) {
+        u -= r;
+        x++;
+        r *= (a / static_cast<double>(x)) - s;
+      }
+      // Rounding may let the search run past the last outcome.
+      if (x <= n) {
+        return x;
+      }
+    }
+  }
+
+  const auto r = p / q;
+  const auto nr = (nd + 1) * r;
+  const auto npq = nd * p * q;
+  const auto sqrtNpq = std::sqrt(npq);
+  const auto b = 1.15 + (2.53 * sqrtNpq);
+  const auto a = -0.0873 + (0.0248 * b) + (0.01 * p);
+  const auto c = (nd * p) + 0.5;
+  const auto alpha = (2.83 + (5.1 / b)) * sqrtNpq;
+  const auto vr = 0.92 - (4.2 / b);
+  const auto urvr = 0.86 * vr;
+  const auto m = static_cast<double>(mode);
+
+  while (true) {
+    auto v = sampleUniform(generator);
+    double u = 0;
+    if (v <= urvr) {
+      u = (v / vr) - 0.43;
+      return static_cast<uint64_t>(
+          std::floor((((2 * a) / (0.5 - std::abs(u))) + b) * u + c));
+    }
+    if (v >= vr) {
+      u = sampleUniform(generator) - 0.5;
+    } else {
+      u = (v / vr) - 0.93;
+      u = (u < 0 ? -0.5 : 0.5) - u;
+      v = sampleUniform(generator) * vr;
+    }
+    const auto us = 0.5 - std::abs(u);
+    const auto kd = std::floor((((2 * a) / us) + b) * u + c);
+    if (kd < 0 || kd > nd) {
+      continue;
+    }
+    const auto k = static_cast<uint64_t>(kd);
+    v = v * alpha / ((a / (us * us)) + b);
+    const auto km = k > mode ? k - mode : mode - k;
+
+    if (km <= BTRD_EXPLICIT_LIMIT) {
+      // Evaluate the ratio f(k) / f(mode) by its recurrence.
+      double f = 1;
+      if (mode < k) {
+        for (auto i = mode + 1; i <= k; i++) {
+          f *= (nr / static_cast<double>(i)) - r;
+        }
+      } else if (mode > k) {
+        for (auto i = k + 1; i <= mode; i++) {
+          v *= (nr / static_cast<double>(i)) - r;
+        }
+      }
+      if (v <= f) {
+        return k;
+      }
+      continue;
+    }
+
+    // Squeeze with bounds of the log ratio before evaluating it exactly.
+    v = std::log(v);
+    const auto kmd = static_cast<double>(km);
+    const auto rho =
+        (kmd / npq) * (((((kmd / 3) + 0.625) * kmd) + (1.0 / 6)) / npq + 0.5);
+    const auto t = -(kmd * kmd) / (2 * npq);
+    if (v < t - rho) {
+      return k;
+    }
+    if (v > t + rho) {
+      continue;
+    }
+    const auto nm = nd - m + 1;
+    const auto h = ((m + 0.5) * std::log((m + 1) / (r * nm))) +
+                   stirlingCorrection(mode) + stirlingCorrection(n - mode);
+    const auto nk = nd - kd + 1;
+    if (v <= h + ((nd + 1) * std::log(nm / nk)) +
+                 ((kd + 0.5) * std::log(nk * r / (kd + 1))) -
+                 stirlingCorrection(k) - stirlingCorrection(n - k)) {
+      return k;
+    }
+  }
+}
+
+/**
+ * @brief Draw the outcomes of several shots from a distribution at once.
+ *
+ * The counts follow a multinomial distribution and are drawn as a sequence of
+ * binomial distributions, so the cost does not depend on the number of shots.
+ * @param probabilities The probabilities of all outcomes.
+ * @param numSamples The number of shots.
+ * @param generator The random number generator to use.
+ * @param counts The vector to store the counts of all outcomes in.
+ */
+void sampleMultinomial(const std::vector<double>& probabilities,
+                       size_t numSamples, std::mt19937_64& generator,
+                       std::vector<size_t>& counts) {
+  auto remainingSamples = static_cast<uint64_t>(numSamples);
+  auto remainingProbability = 1.0;
+  for (size_t i = 0; i < probabilities.size(); i++) {
+    if (remainingSamples == 0 || i == probabilities.size() - 1) {
+      counts[i] = remainingSamples;
+      remainingSamples = 0;
+      continue;
+    }
+    const auto p =
+        remainingProbability > 0
+            ? std::clamp(probabilities[i] / remainingProbability, 0.0, 1.0)
+            : 1.0;
+    counts[i] = sampleBinomial(remainingSamples, p, generator);
+    remainingSamples -= counts[i];
+    remainingProbability -= probabilities[i];
+  }
+}
+
+/**
+ * @brief Determine the share of trials that accept an assertion for a given
+ * number of shots.
+ * @param assertion The assertion to check.
+ * @param probabilities The expected distribution under noise to sample from.
+ * @param numSamples The number of shots per trial.
+ * @param expectedSuccessProbability The expected success probability of the
+ * program.
+ * @param settings The settings of the estimation.
+ * @return The share of accepting trials.
+ */
+double getAccuracy(const std::string& assertion,
+                   const std::vector<double>& probabilities, size_t numSamples,
+                   double expectedSuccessProbability,
+                   const ShotEstimationSettings& settings) {
+  std::atomic<size_t> correct{0};
+  std::atomic<bool> failed{false};
+  const auto runTrials = [&](size_t first, size_t stride) {
+    std::vector<size_t> counts(probabilities.size());
+    size_t localCorrect = 0;
+    for (auto trial = first; trial < settings.numTrials && !failed;
+         trial += stride) {
+      // Each trial uses the same seed for all candidates, which reduces the
+      // noise between the accuracies of different candidates.
+      std::mt19937_64 generator(getTrialSeed(settings.seed, trial));
+      sampleMultinomial(probabilities, numSamples, generator, counts);
+      if (checkAssertionResult(assertion, counts, numSamples,
+                               expectedSuccessProbability, settings.pValue)) {
+        localCorrect++;
+      }
+    }
+    correct += localCorrect;
+  };
+
+  auto maxThreads = settings.maxThreads;
+  if (maxThreads == 0) {
+    maxThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  const auto numThreads = std::min(maxThreads, settings.numTrials);
+  if (numThreads <= 1) {
+    runTrials(0, 1);
+  } else {
+    std::exception_ptr error;
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (size_t t = 0; t < numThreads; t++) {
+      workers.emplace_back([&, t]() {
+        try {
+          runTrials(t, numThreads);
+        } catch (...) {
+          // Only the first exception is kept. All other workers stop at
+          // their next trial.
+          if (!failed.exchange(true)) {
+            error = std::current_exception();
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return static_cast<double>(correct) /
+         static_cast<double>(settings.numTrials);
+}
+
+} // namespace
+
+size_t ShotEstimator::estimate(const std::string& assertion,
+                               double expectedSuccessProbability,
+                               const ShotEstimationSettings& settings) {
+  const auto open = assertion.find('(');
+  const auto close = assertion.find(')', open);
+  const auto braces = assertion.find('{', close);
+  if (open == std::string::npos || close == std::string::npos ||
+      braces == std::string::npos) {
+    throw std::invalid_argument("Invalid assertion '" + assertion + "'.");
+  }
+  if (settings.numTrials == 0) {
+    throw std::invalid_argument("At least one trial is required.");
+  }
+  const auto variables = assertion.substr(open, close - open);
+  const auto numVariables =
+      static_cast<size_t>(std::count(variables.begin(), variables.end(), ',')) +
+      1;
+  const auto checked = assertion.substr(braces);
+
+  const CacheKey key{checked,
+                     numVariables,
+                     expectedSuccessProbability,
+                     settings.pValue,
+                     settings.numTrials,
+                     settings.accuracy,
+                     settings.seed};
+  {
+    const std::lock_guard lock(mutex);
+    const auto found = cache.find(key);
+    if (found != cache.end()) {
+      return found->second;
+    }
+  }
+
+  std::vector<double> expected;
+  if (checked.starts_with("{zero}") ||
+      checked.starts_with("{superposition}")) {
+    if (numVariables >= std::numeric_limits<size_t>::digits) {
+      throw std::invalid_argument("Assertion '" + assertion +
+                                  "' contains too many variables.");
+    }
+    const auto numOutcomes = 1ULL << numVariables;
+    if (checked.starts_with("{zero}")) {
+      expected.resize(numOutcomes, 0.0);
+      expected[0] = 1.0;
+    } else {
+      // Superposition assertions should detect any superposition, but here
+      // only the uniform one is considered.
+      expected.resize(numOutcomes, 1.0 / static_cast<double>(numOutcomes));
+    }
+  } else {
+    expected = parseExpectedProbabilities(checked);
+  }
+
+  const auto numOutcomes = static_cast<double>(expected.size());
+  for (auto& p : expected) {
+    p = (expectedSuccessProbability * p) +
+        ((1 - expectedSuccessProbability) / numOutcomes);
+  }
+
+  const auto step = expected.size() * SAMPLES_PER_OUTCOME;
+  const auto passes = [&](size_t multiple) {
+    return getAccuracy(checked, expected, multiple * step,
+                       expectedSuccessProbability,
+                       settings) >= settings.accuracy;
+  };
+
+  // Double the number of shots until the accuracy is reached, then bisect
+  // the last interval for the smallest sufficient multiple of the step.
+  size_t lower = 0;
+  size_t upper = 1;
+  while (!passes(upper)) {
+    lower = upper;
+    upper *= 2;
+    if (upper * step > MAX_ESTIMATED_SHOTS) {
+      throw std::runtime_error("The accuracy for assertion '" + assertion +
+                               "' cannot be reached with at most " +
+                               std::to_string(MAX_ESTIMATED_SHOTS) +
+                               " shots.");
+    }
+  }
+  while (upper - lower > 1) {
+    const auto middle = lower + ((upper - lower) / 2);
+    if (passes(middle)) {
+      upper = middle;
+    } else {
+      lower = middle;
+    }
+  }
+  const auto result = upper * step;
+
+  const std::lock_guard lock(mutex);
+  cache.emplace(key, result);
+  return result;
+}
+
+void ShotEstimator::clearCache() {
+  const std::lock_guard lock(mutex);
+  cache.clear();
+}
+
+size_t ShotEstimator::getCacheSize() {
+  const std::lock_guard lock(mutex);
+  return cache.size();
+}
+
+} // namespace mqt::debugger
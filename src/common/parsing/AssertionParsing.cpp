@@ -308,24 +308,13 @@ bool StatevectorEqualityAssertion::implies(
                                                   target));
                  });
 
-  const Span<Complex> sv(getTargetStatevector().amplitudes,
-                         getTargetStatevector().numStates);
-
-  std::vector<std::vector<Complex>> densityMatrix(
-      sv.size(), std::vector<Complex>(sv.size(), {0, 0}));
-  for (size_t i = 0; i < sv.size(); i++) {
-    for (size_t j = 0; j < sv.size(); j++) {
-      densityMatrix[i][j] =
-          complexMultiplication(sv[i], complexConjugate(sv[j]));
-    }
-  }
-
-  for (const auto i : indexList) {
-    for (const auto j : indexList) {
-      if (i == j) {
+  const auto& sv = getTargetStatevector();
+  for (size_t i = 0; i < indexList.size(); i++) {
+    for (size_t j = i + 1; j < indexList.size(); j++) {
+      if (indexList[i] == indexList[j]) {
         continue;
       }
-      if (!areQubitsEntangled(densityMatrix, i, j)) {
+      if (!areQubitsEntangled(sv, indexList[i], indexList[j])) {
         return false;
       }
     }
@@ -15,180 +15,79 @@
 #include "common/parsing/Utils.hpp"
 
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <vector>
 
 namespace mqt::debugger {
 
-#define YES(expression)                                                        \
-  (expression) ? CommutationResult::Commutes : CommutationResult::Unknown;
-#define NO(expression)                                                         \
-  (expression) ? CommutationResult::DoesNotCommute : CommutationResult::Unknown;
-
 namespace {
 
-//------------------------------------------------------------------------------
-// General rules
-//------------------------------------------------------------------------------
-
-// Barrier instructions will not remove or create entanglement or superposition
-static COMMUTATION_RULE_GENERAL(BARRIER, YES(instructionName == "barrier"));
-
-//------------------------------------------------------------------------------
-// Entanglement rules
-//------------------------------------------------------------------------------
-
-// 1-qubit gates will not remove or create entanglement
-static COMMUTATION_RULE_ENT(TWO_OR_MORE_TARGETS, YES(arguments.size() < 2));
-
-//------------------------------------------------------------------------------
-// Superposition rules
-//------------------------------------------------------------------------------
-
-// Pauli-Instructions will not remove or create superposition
-static COMMUTATION_RULE_SUP(PAULI_INVARIANT, YES(instructionName == "x" ||
-                                                 instructionName == "y" ||
-                                                 instructionName == "z"));
-
-// `S` and `T` gates will not remove or create superposition
-static COMMUTATION_RULE_SUP(OTHER_1Q_GATE_INVARIANTS,
-                            YES(instructionName == "s" ||
-                                instructionName == "t" ||
-                                instructionName == "sdg" ||
-                                instructionName == "tdg"));
-
-//------------------------------------------------------------------------------
-
-const std::vector<std::function<CommutationResult(
-    const Assertion*, const std::string&, const std::vector<std::string>&)>>
-    GENERAL_COMMUTATION_RULES = {
-        BARRIER,
-};
-
-const std::vector<std::function<CommutationResult(
-    const EntanglementAssertion*, const std::string&,
-    const std::vector<std::string>&)>>
-    ENTANGLEMENT_COMMUTATION_RULES = {
-        TWO_OR_MORE_TARGETS,
-};
-
-const std::vector<std::function<CommutationResult(
-    const SuperpositionAssertion*, const std::string&,
-    const std::vector<std::string>&)>>
-    SUPERPOSITION_COMMUTATION_RULES = {
-        PAULI_INVARIANT,
-        OTHER_1Q_GATE_INVARIANTS,
-};
-
 /**
- * @brief Check if an entanglement assertion commutes with an instruction.
- * @param assertion The assertion to check.
- * @param instructionName The name of the instruction to check.
- * @param targets The targets of the instruction.
- * @return True if the assertion commutes with the instruction, false otherwise.
+ * @brief Check for each assertion type whether an operation commutes with the
+ * assertions of that type whose targets it acts on.
+ * @param operation The operation in string form.
+ * @return Whether the operation commutes, indexed by assertion type.
  */
-bool doesCommuteEnt(const EntanglementAssertion* assertion,
-                    const std::string& instructionName,
-                    const std::vector<std::string>& targets) {
-  for (const auto& rule : ENTANGLEMENT_COMMUTATION_RULES) {
-    const auto result = rule(assertion, instructionName, targets);
-    if (result != CommutationResult::Unknown) {
-      return result == CommutationResult::Commutes;
-    }
+std::array<bool, ASSERTION_TYPE_COUNT>
+getOperationCommutation(const std::string& operation) {
+  const auto targetCount = parseParameters(operation).size();
+  const auto kind = getGateKind(splitString(trim(operation), ' ')[0]);
+  std::array<bool, ASSERTION_TYPE_COUNT> commutes{};
+  for (size_t type = 0; type < ASSERTION_TYPE_COUNT; type++) {
+    commutes.at(type) =
+        doesGateCommute(kind, targetCount, static_cast<AssertionType>(type));
   }
-  return false;
-}
-
-/**
- * @brief Check if a superposition assertion commutes with an instruction.
- * @param assertion The assertion to check.
- * @param instructionName The name of the instruction to check.
- * @param targets The targets of the instruction.
- * @return True if the assertion commutes with the instruction, false otherwise.
- */
-bool doesCommuteSup(const SuperpositionAssertion* assertion,
-                    const std::string& instructionName,
-                    const std::vector<std::string>& targets) {
-  for (const auto& rule : SUPERPOSITION_COMMUTATION_RULES) {
-    const auto result = rule(assertion, instructionName, targets);
-    if (result != CommutationResult::Unknown) {
-      return result == CommutationResult::Commutes;
-    }
-  }
-  return false;
+  return commutes;
 }
 
 /**
- * @brief Check if a general assertion commutes with an instruction.
+ * @brief Check whether an instruction acts on any target of an assertion.
  * @param assertion The assertion to check.
- * @param instruction The instruction to check in string form.
- * @return True if the assertion commutes with the instruction, false otherwise.
+ * @param instruction The instruction to check.
+ * @return True if the instruction shares a target with the assertion.
  */
-bool doesCommute(const std::unique_ptr<Assertion>& assertion,
-                 const std::string& instruction) {
-  const auto targets = parseParameters(instruction);
-  const auto instructionName = splitString(trim(instruction), ' ')[0];
-  for (const auto& rule : GENERAL_COMMUTATION_RULES) {
-    const auto result = rule(assertion.get(), instructionName, targets);
-    if (result != CommutationResult::Unknown) {
-      return result == CommutationResult::Commutes;
-    }
-  }
-
-  if (assertion->getType() == AssertionType::Entanglement) {
-    const auto* entAssertion =
-        dynamic_cast<EntanglementAssertion*>(assertion.get());
-    const auto result = doesCommuteEnt(entAssertion, instructionName, targets);
-    return result;
-  }
-  if (assertion->getType() == AssertionType::Superposition) {
-    const auto* supAssertion =
-        dynamic_cast<SuperpositionAssertion*>(assertion.get());
-    const auto result = doesCommuteSup(supAssertion, instructionName, targets);
-    return result;
-  }
-  if (assertion->getType() == AssertionType::CircuitEquality ||
-      assertion->getType() == AssertionType::StatevectorEquality) {
-    // Equality assertions are not commutative with dependent operations, as any
-    // dependent operation will (likely) change the state of the qubits.
-    return false;
-  }
-  return false;
+bool sharesTarget(const Assertion& assertion, const Instruction& instruction) {
+  const auto& instructionTargets = instruction.targets;
+  return std::ranges::any_of(
+      assertion.getTargetQubits(), [&instructionTargets](const auto& target) {
+        return std::ranges::any_of(
+            instructionTargets, [&target](const std::string& instrTarget) {
+              return (instrTarget.find('[') != std::string::npos &&
+                      instrTarget == target) ||
+                     (instrTarget.find('[') == std::string::npos &&
+                      variableBaseName(target) == instrTarget);
+            });
+      });
 }
 
 } // namespace
 
-bool doesCommute(const std::unique_ptr<Assertion>& assertion,
-                 const Instruction& instruction) {
+CommutationInfo getCommutationInfo(const Instruction& instruction) {
   const auto& code = instruction.code;
   if (instruction.assertion != nullptr) {
-    return true; // Allow lifting over other assertions so a stuck assertion
-                 // above will not also fixate all assertions below it.
+    // Allow lifting over other assertions so a stuck assertion above will not
+    // also fixate all assertions below it.
+    return {.kind = CommutationKind::Always, .commutes = {},
+            .declaredRegister = {}};
   }
   if (instruction.isFunctionDefinition) {
-    return true; // Order of function definitions does not matter.
+    // Order of function definitions does not matter.
+    return {.kind = CommutationKind::Always, .commutes = {},
+            .declaredRegister = {}};
   }
   if (isVariableDeclaration(code)) {
     // Order of unrelated variable declarations does not matter.
-    const auto targets = parseParameters(code);
-    const auto registerName = variableBaseName(targets[0]);
-    return std::none_of(assertion->getTargetQubits().begin(),
-                        assertion->getTargetQubits().end(),
-                        [&registerName](const auto& target) {
-                          return registerName == variableBaseName(target);
-                        });
-  }
-  if (isMeasurement(code)) {
-    return false; // Assertions should never be moved above measurements.
-                  // [UNLESS measurement and assertion targets are not
-                  // entangled, but this cannot be checked in advance.]
+    return {.kind = CommutationKind::Declaration, .commutes = {},
+            .declaredRegister = variableBaseName(parseParameters(code)[0])};
   }
-  if (isReset(code)) {
-    return false; // Assertions should never be moved above resets. [UNLESS
-                  // measurement and assertion targets are not entangled, but
-                  // this cannot be checked in advance.]
+  if (isMeasurement(code) || isReset(code)) {
+    // Assertions should never be moved above measurements or resets. [UNLESS
+    // measurement and assertion targets are not entangled, but this cannot be
+    // checked in advance.]
+    return {.kind = CommutationKind::Never, .commutes = {},
+            .declaredRegister = {}};
   }
   if (isClassicControlledGate(code)) {
     // For classic-controlled gates, the classical parts do not matter, so we
@@ -197,29 +96,51 @@ bool doesCommute(const std::unique_ptr<Assertion>& assertion,
     // requires
     //       issue https://github.com/munich-quantum-toolkit/debugger/issues/29
     //       to first be resolved in that situation.
-    const auto c = parseClassicControlledGate(code).operations;
-    return std::ranges::all_of(c, [&assertion](const auto& operation) {
-      return doesCommute(assertion, operation);
-    });
+    CommutationInfo info{.kind = CommutationKind::Untargeted,
+                         .commutes = {},
+                         .declaredRegister = {}};
+    info.commutes.fill(true);
+    for (const auto& operation : parseClassicControlledGate(code).operations) {
+      const auto commutes = getOperationCommutation(operation);
+      for (size_t type = 0; type < ASSERTION_TYPE_COUNT; type++) {
+        info.commutes.at(type) = info.commutes.at(type) && commutes.at(type);
+      }
+    }
+    return info;
   }
 
-  const auto& assertionTargets = assertion->getTargetQubits();
-  const auto& instructionTargets = instruction.targets;
-  if (std::ranges::none_of(
-          assertionTargets, [&instructionTargets](const auto& target) {
-            return std::ranges::any_of(
-                instructionTargets, [&target](const std::string& instrTarget) {
-                  return (instrTarget.find('[') != std::string::npos &&
-                          instrTarget == target) ||
-                         (instrTarget.find('[') == std::string::npos &&
-                          variableBaseName(target) == instrTarget);
-                });
-          })) {
-    return true; // If the assertion does not target any of the qubits in the
-                 // instruction, the order does not matter.
+  return {.kind = CommutationKind::Targeted,
+          .commutes = getOperationCommutation(code),
+          .declaredRegister = {}};
+}
+
+bool doesCommute(const Assertion& assertion, const Instruction& instruction,
+                 const CommutationInfo& info) {
+  const auto type = static_cast<size_t>(assertion.getType());
+  switch (info.kind) {
+  case CommutationKind::Always:
+    return true;
+  case CommutationKind::Never:
+    return false;
+  case CommutationKind::Declaration:
+    return std::ranges::none_of(assertion.getTargetQubits(),
+                                [&info](const auto& target) {
+                                  return info.declaredRegister ==
+                                         variableBaseName(target);
+                                });
+  case CommutationKind::Untargeted:
+    return info.commutes.at(type);
+  case CommutationKind::Targeted:
+    // If the assertion does not target any of the qubits in the instruction,
+    // the order does not matter.
+    return info.commutes.at(type) || !sharesTarget(assertion, instruction);
   }
+  return false;
+}
 
-  return doesCommute(assertion, instruction.code);
+bool doesCommute(const std::unique_ptr<Assertion>& assertion,
+                 const Instruction& instruction) {
+  return doesCommute(*assertion, instruction, getCommutationInfo(instruction));
 }
 
 } // namespace mqt::debugger
@@ -23,13 +23,16 @@
 #include <cctype>
 #include <cstddef>
 #include <exception>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -210,18 +213,22 @@ void validateTargets(const std::string& code, size_t instructionStart,
 /**
  * @brief Sweep a given code string for blocks and replace them with a unique
  * identifier.
+ *
+ * The code is scanned once and the result is assembled from the parts between
+ * the blocks, so that the cost is linear in the length of the code.
  * @param code The code to sweep.
  * @param blocks A map to store the blocks and their respective identifiers in.
  * @return The code with the blocks replaced by their identifiers.
  */
-std::string sweepBlocks(const std::string& code,
+std::string sweepBlocks(std::string_view code,
                         std::map<std::string, std::string>& blocks) {
-  std::string result = code;
+  std::string result;
+  result.reserve(code.size());
+  size_t copied = 0;
   size_t start = 0;
   int level = 0;
-  size_t pos = 0;
-  while (pos < result.size()) {
-    auto c = result[pos];
+  for (size_t pos = 0; pos < code.size(); pos++) {
+    const auto c = code[pos];
     if (c == '{') {
       if (level == 0) {
         start = pos;
@@ -230,16 +237,17 @@ std::string sweepBlocks(const std::string& code,
     } else if (c == '}') {
       level--;
       if (level == 0) {
-        const std::string block = result.substr(start + 1, pos - 1 - start);
-        const std::string blockName =
+        std::string blockName =
             "$__block" + std::to_string(blocks.size()) + "$;";
-        blocks[blockName] = block;
-        result.replace(start, pos + 1 - start, blockName);
-        pos = start;
+        result.append(code.substr(copied, start - copied));
+        result.append(blockName);
+        blocks.emplace(std::move(blockName),
+                       code.substr(start + 1, pos - 1 - start));
+        copied = pos + 1;
       }
     }
-    pos++;
   }
+  result.append(code.substr(copied));
   return result;
 }
 
@@ -249,21 +257,18 @@ std::string sweepBlocks(const std::string& code,
  * @param code The code to sweep.
  * @return The code with the comments replaced by whitespace.
  */
-std::string removeComments(const std::string& code) {
-  std::string result = code;
-  for (size_t pos = 0; pos < result.size(); pos++) {
-    auto nextComment = result.find("//", pos);
-    if (nextComment == std::string::npos) {
-      break;
-    }
-    auto commentEnd = result.find('\n', nextComment);
+std::string removeComments(std::string code) {
+  size_t pos = 0;
+  while ((pos = code.find("//", pos)) != std::string::npos) {
+    auto commentEnd = code.find('\n', pos);
     if (commentEnd == std::string::npos) {
-      commentEnd = result.size();
+      commentEnd = code.size();
     }
-    const std::string spaces(commentEnd - nextComment, ' ');
-    result.replace(nextComment, commentEnd - nextComment, spaces);
+    std::fill(code.begin() + static_cast<std::ptrdiff_t>(pos),
+              code.begin() + static_cast<std::ptrdiff_t>(commentEnd), ' ');
+    pos = commentEnd;
   }
-  return result;
+  return code;
 }
 
 /**
@@ -295,22 +300,133 @@ FunctionDefinition parseFunctionDefinition(const std::string& signature) {
 
 /**
  * @brief Sweep a given code string for function names.
+ *
+ * Only the instructions that define a function are copied for parsing.
  * @param code The code to sweep.
  * @return A vector containing the function names.
  */
-std::vector<std::string> sweepFunctionNames(const std::string& code) {
+std::vector<std::string> sweepFunctionNames(std::string_view code) {
   std::vector<std::string> result;
-  const std::vector<char> delimiters{';', '}'};
-  const auto instructions = splitString(code, delimiters);
-  for (const auto& instruction : instructions) {
-    if (isFunctionDefinition(instruction)) {
-      const auto f = parseFunctionDefinition(instruction);
+  size_t pos = 0;
+  while (pos <= code.size()) {
+    const auto end = code.find_first_of(";}", pos);
+    const auto instruction = code.substr(
+        pos, end == std::string_view::npos ? end : end - pos);
+    if (trimView(instruction).starts_with("gate ")) {
+      const auto f = parseFunctionDefinition(std::string(instruction));
       result.push_back(f.name);
     }
+    if (end == std::string_view::npos) {
+      break;
+    }
+    pos = end + 1;
+  }
+  return result;
+}
+
+/**
+ * @brief Indexes the instructions of a scope by the variables they use.
+ *
+ * This allows the search for data dependencies to skip all instructions that
+ * do not use any of the variables it looks for.
+ */
+struct VariableUsageIndex {
+  /**
+   * @brief Maps register elements, e.g., `q[0]`, to the instructions using
+   * them.
+   */
+  std::map<std::string, std::vector<size_t>> elements;
+  /**
+   * @brief Maps names used without an index, e.g., full registers, to the
+   * instructions using them.
+   */
+  std::map<std::string, std::vector<size_t>> registers;
+  /**
+   * @brief Maps names to the instructions using them with or without an index.
+   */
+  std::map<std::string, std::vector<size_t>> bases;
+};
+
+/**
+ * @brief Build the usage index for the variable usages of a scope.
+ * @param variableUsages Maps instruction indices to the variables they use.
+ * @return The usage index. For each variable, the instructions are sorted in
+ * ascending order.
+ */
+VariableUsageIndex indexVariableUsages(
+    const std::map<size_t, std::vector<std::string>>& variableUsages) {
+  VariableUsageIndex index;
+  const auto add = [](std::vector<size_t>& instructions, size_t instruction) {
+    if (instructions.empty() || instructions.back() != instruction) {
+      instructions.push_back(instruction);
+    }
+  };
+  for (const auto& [instruction, variables] : variableUsages) {
+    for (const auto& variable : variables) {
+      const auto open = variable.find('[');
+      if (open == std::string::npos) {
+        add(index.registers[variable], instruction);
+        add(index.bases[variable], instruction);
+      } else {
+        add(index.elements[variable], instruction);
+        add(index.bases[variable.substr(0, open)], instruction);
+      }
+    }
+  }
+  return index;
+}
+
+/**
+ * @brief Get the instructions that use a variable equal to the given one in
+ * the sense of `variablesEqual`.
+ *
+ * The result consists of up to two sorted lists that together contain all
+ * such instructions.
+ * @param index The usage index of the scope.
+ * @param variable The variable to look for.
+ * @return The lists of instructions that use the variable.
+ */
+std::vector<const std::vector<size_t>*>
+findVariableUsages(const VariableUsageIndex& index,
+                   const std::string& variable) {
+  std::vector<const std::vector<size_t>*> result;
+  const auto add = [&result](const std::map<std::string, std::vector<size_t>>&
+                                 map,
+                             const std::string& key) {
+    const auto found = map.find(key);
+    if (found != map.end()) {
+      result.push_back(&found->second);
+    }
+  };
+  const auto open = variable.find('[');
+  if (open == std::string::npos) {
+    add(index.bases, variable);
+  } else {
+    add(index.elements, variable);
+    add(index.registers, variable.substr(0, open));
   }
   return result;
 }
 
+/**
+ * @brief The instructions of a sorted list that still have to be visited by a
+ * backwards search.
+ */
+struct UsageCursor {
+  /**
+   * @brief The variable whose usages are visited.
+   */
+  const std::string* variable;
+  /**
+   * @brief The first instruction of the list that may be visited.
+   */
+  std::vector<size_t>::const_iterator begin;
+  /**
+   * @brief The position after the next instruction to visit.
+   */
+  std::vector<size_t>::const_iterator end;
+};
+
 /**
  * @brief Unfold the targets of assertions that otherwise target full registers.
  *
@@ -363,20 +479,20 @@ Instruction::Instruction(size_t inputLineNumber, std::string inputCode,
       isFunctionDefinition(isFuncDef), block(std::move(inputBlock)) {}
 
 bool isFunctionDefinition(const std::string& line) {
-  return trim(line).starts_with("gate ");
+  return trimView(line).starts_with("gate ");
 }
 
 bool isReset(const std::string& line) {
-  return trim(line).starts_with("reset ");
+  return trimView(line).starts_with("reset ");
 }
 
 bool isBarrier(const std::string& line) {
-  return trim(line).starts_with("barrier ") ||
-         trim(line).starts_with("barrier;");
+  const auto trimmed = trimView(line);
+  return trimmed.starts_with("barrier ") || trimmed.starts_with("barrier;");
 }
 
 bool isClassicControlledGate(const std::string& line) {
-  return trim(line).starts_with("if") &&
+  return trimView(line).starts_with("if") &&
          (line.find('(') != std::string::npos) &&
          (line.find(')') != std::string::npos);
 }
@@ -475,7 +591,8 @@ bool isMeasurement(const std::string& line) {
 }
 
 bool isVariableDeclaration(const std::string& line) {
-  return trim(line).starts_with("creg ") || trim(line).starts_with("qreg ");
+  const auto trimmed = trimView(line);
+  return trimmed.starts_with("creg ") || trimmed.starts_with("qreg ");
 }
 
 std::vector<std::string> parseParameters(const std::string& instruction) {
@@ -534,13 +651,15 @@ std::vector<std::string> parseParameters(const std::string& instruction) {
 std::vector<Instruction> preprocessCode(const std::string& code,
                                         std::string& processedCode) {
   std::map<std::string, size_t> definedRegisters;
-  return preprocessCode(code, 0, 0, {}, definedRegisters, {}, processedCode);
+  const std::set<std::string> functionNames;
+  return preprocessCode(code, 0, 0, functionNames, definedRegisters, {},
+                        processedCode);
 }
 
 std::vector<Instruction>
 preprocessCode(const std::string& code, size_t startIndex,
                size_t initialCodeOffset,
-               const std::vector<std::string>& allFunctionNames,
+               const std::set<std::string>& allFunctionNames,
                std::map<std::string, size_t>& definedRegisters,
                const std::vector<std::string>& shadowedRegisters,
                std::string& processedCode) {
@@ -552,10 +671,19 @@ preprocessCode(const std::string& code, size_t startIndex,
 
   processedCode = removeComments(code);
   const std::string blocksRemoved = sweepBlocks(processedCode, blocks);
-  std::vector<std::string> functionNames = sweepFunctionNames(processedCode);
-  for (const auto& name : allFunctionNames) {
-    functionNames.push_back(name);
+
+  // Blocks rarely define functions themselves, so the names of the enclosing
+  // scope are only copied if this scope adds new ones.
+  const auto scopeFunctionNames = sweepFunctionNames(processedCode);
+  std::set<std::string> extendedFunctionNames;
+  const auto* functionNamesPtr = &allFunctionNames;
+  if (!scopeFunctionNames.empty()) {
+    extendedFunctionNames = allFunctionNames;
+    extendedFunctionNames.insert(scopeFunctionNames.begin(),
+                                 scopeFunctionNames.end());
+    functionNamesPtr = &extendedFunctionNames;
   }
+  const auto& functionNames = *functionNamesPtr;
 
   std::vector<Instruction> instructions;
 
@@ -585,13 +713,13 @@ preprocessCode(const std::string& code, size_t startIndex,
     if (blockPos != std::string::npos) {
       const auto endPos = line.find('$', blockPos + 1) + 1;
       const auto blockName = line.substr(blockPos, endPos - blockPos + 1);
-      const auto blockContent = blocks[blockName];
+      auto& blockContent = blocks[blockName];
 
       // in the actual code, the current instruction is longer, because we
       // replaced the block with its name. Also, we add +2 because the block
       // also had `{` and `}`, which is not included in `blockContent`.
       blocksOffset += blockContent.size() + 2 - blockName.size();
-      block.code = blockContent;
+      block.code = std::move(blockContent);
       block.valid = true;
       line.replace(blockPos, endPos - blockPos + 1, "");
     }
@@ -669,8 +797,7 @@ preprocessCode(const std::string& code, size_t startIndex,
 
     bool isFunctionCall = false;
     std::string calledFunction;
-    if (!tokens.empty() &&
-        std::ranges::find(functionNames, tokens[0]) != functionNames.end()) {
+    if (!tokens.empty() && functionNames.contains(tokens[0])) {
       isFunctionCall = true;
       calledFunction = tokens[0];
     }
@@ -694,21 +821,58 @@ preprocessCode(const std::string& code, size_t startIndex,
                                 isFunctionCall, calledFunction, false, false,
                                 block);
 
-      variableUsages.insert({i, parseParameters(line)});
+      variableUsages.insert({i, targets});
     }
 
     i++;
     pos = end + 1;
   }
 
+  // Dependencies are searched backwards from each instruction. Only the
+  // instructions that use one of its variables can contribute, so the search
+  // visits just these, in descending order, instead of every preceding
+  // instruction.
+  const auto usageIndex = indexVariableUsages(variableUsages);
+  std::vector<UsageCursor> cursors;
   for (auto& instr : instructions) {
     auto vars = parseParameters(instr.code);
-    size_t idx = instr.lineNumber - 1;
-    while (instr.lineNumber != 0 && !vars.empty() &&
-           (instr.lineNumber < instructions.size() ||
-            idx > instr.lineNumber - instructions.size())) {
+    if (instr.lineNumber == 0) {
+      vars.clear();
+    }
+    const size_t first = instr.lineNumber >= instructions.size()
+                             ? instr.lineNumber - instructions.size() + 1
+                             : 0;
+    // `vars` shrinks during the search, so the cursors refer to a copy.
+    const auto searched = vars;
+    cursors.clear();
+    for (const auto& var : searched) {
+      for (const auto* usages : findVariableUsages(usageIndex, var)) {
+        cursors.push_back({.variable = &var,
+                           .begin = std::ranges::lower_bound(*usages, first),
+                           .end = std::ranges::lower_bound(*usages,
+                                                           instr.lineNumber)});
+      }
+    }
+    while (!vars.empty()) {
+      // Variables that have been found cannot lead to further dependencies.
+      std::erase_if(cursors, [&vars](const UsageCursor& cursor) {
+        return cursor.begin == cursor.end ||
+               std::ranges::find(vars, *cursor.variable) == vars.end();
+      });
+      if (cursors.empty()) {
+        break;
+      }
+      size_t idx = 0;
+      for (const auto& cursor : cursors) {
+        idx = std::max(idx, *std::prev(cursor.end));
+      }
+      for (auto& cursor : cursors) {
+        if (*std::prev(cursor.end) == idx) {
+          cursor.end--;
+        }
+      }
       size_t foundIndex = 0;
-      for (const auto& var : variableUsages[idx]) {
+      for (const auto& var : variableUsages.at(idx)) {
         const auto found = std::ranges::find_if(
             vars, [&var](const auto& v) { return variablesEqual(v, var); });
         if (found != vars.end()) {
@@ -717,10 +881,6 @@ preprocessCode(const std::string& code, size_t startIndex,
         }
         foundIndex++;
       }
-      if (idx - 1 == instr.lineNumber - instructions.size() || idx == 0) {
-        break;
-      }
-      idx--;
     }
     if (instr.isFunctionCall) {
       instr.successorIndex = functionFirstLine[instr.calledFunction];
@@ -20,15 +20,19 @@
 #include <cstddef>
 #include <ranges>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace mqt::debugger {
 
-std::string trim(const std::string& str) {
-  auto start = std::ranges::find_if_not(str, ::isspace);
-  auto end = std::ranges::find_if_not(std::ranges::reverse_view(str), ::isspace)
-                 .base();
-  return (start < end) ? std::string(start, end) : std::string();
+std::string trim(const std::string& str) { return std::string(trimView(str)); }
+
+std::string_view trimView(std::string_view str) {
+  const auto isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
+  const auto start = std::ranges::find_if_not(str, isSpace);
+  const auto end =
+      std::ranges::find_if_not(std::ranges::reverse_view(str), isSpace).base();
+  return (start < end) ? std::string_view(start, end) : std::string_view();
 }
 
 std::vector<std::string> splitString(const std::string& text, char delimiter,
@@ -54,20 +54,21 @@ void clearScreen() {
 }
 
 /**
- * @brief Get all possible bit strings for a given number of qubits.
+ * @brief Get the bit string representing a basis state.
+ *
+ * The most significant bit corresponds to the qubit with the highest index.
+ * @param index The index of the basis state.
  * @param numQubits The number of qubits.
- * @return The list of bit strings.
+ * @return The bit string.
  */
-std::vector<std::string> getBitStrings(size_t numQubits) {
-  std::vector<std::string> bitStrings;
-  for (size_t i = 0; i < (1ULL << numQubits); i++) {
-    std::string bitString;
-    for (size_t j = 0; j < numQubits; j++) {
-      bitString.insert(bitString.begin(), (i & (1 << j)) > 0 ? '1' : '0');
+std::string toBitString(size_t index, size_t numQubits) {
+  std::string bitString(numQubits, '0');
+  for (size_t j = 0; j < numQubits; j++) {
+    if ((index & (1ULL << j)) != 0) {
+      bitString[numQubits - j - 1] = '1';
     }
-    bitStrings.push_back(bitString);
   }
-  return bitStrings;
+  return bitString;
 }
 
 } // namespace
@@ -321,11 +322,18 @@ void CliFrontEnd::printState(SimulationState* state, size_t inspecting,
   std::cout << "\n";
 
   if (!codeOnly) {
-    const auto bitStrings = getBitStrings(state->getNumQubits(state));
-    Complex c;
-    for (const auto& bitString : bitStrings) {
-      state->getAmplitudeBitstring(state, bitString.c_str(), &c);
-      std::cout << bitString << " " << c.real << "\t||\t";
+    // Only the non-zero amplitudes are printed, so the work depends on the
+    // structure of the state rather than on its size.
+    const auto numQubits = state->getNumQubits(state);
+    const auto numStates = 1ULL << numQubits;
+    std::vector<size_t> indices(numStates);
+    std::vector<Complex> amplitudes(numStates);
+    size_t count = 0;
+    state->getNonZeroAmplitudes(state, 0, numStates, indices.data(),
+                                amplitudes.data(), &count);
+    for (size_t i = 0; i < count; i++) {
+      std::cout << toBitString(indices[i], numQubits) << " "
+                << amplitudes[i].real << "\t||\t";
     }
     std::cout << "\n";
   }
@@ -10,6 +10,7 @@
 
 from __future__ import annotations
 
+import io
 import json
 import locale
 import os
@@ -242,17 +243,60 @@ def test_start_compilation_raises_on_load_error(tmp_path: Path, monkeypatch: pyt
         check.start_compilation(invalid_code, output_dir)
 
 
+def test_compile_slice_operations() -> None:
+    """Test that slices compiled into operations match the slices compiled into code."""
+    state = dbg.create_ddsim_simulation_state()
+    try:
+        state.load_code("qreg q[2];\nh q[0];\ncx q[0], q[1];\nassert-eq 0.9, q[0], q[1] { 0.707, 0, 0, 0.707 }\n")
+        settings = dbg.CompilationSettings(opt=0)
+        slices = dbg.compile_slice_operations(state, settings)
+        codes = state.compile_slices(settings)
+        assert len(slices) == len(codes) == 1
+
+        (assertions, num_qubits, num_clbits, operations) = slices[0]
+        assert assertions == [line.removeprefix("// ASSERT: ") for line in codes[0].splitlines() if "ASSERT" in line]
+        assert (num_qubits, num_clbits) == (2, 2)
+        assert operations == [
+            ("h", [], [0], [], []),
+            ("x", [0], [1], [], []),
+            ("measure", [], [0], [], [0]),
+            ("measure", [], [1], [], [1]),
+        ]
+    finally:
+        dbg.destroy_ddsim_simulation_state(state)
+
+
 def test_sample_estimate(compiled_slice_1: str) -> None:
     """Test the estimation of required shots.
 
     Args:
         compiled_slice_1 (str): The compiled program slice code.
     """
-    random.seed(12345)
-    n = check.estimate_required_shots(compiled_slice_1, CALIBRATION)
+    # The native estimator does not use Python's `random` module, so its own seed is pinned instead.
+    n = check.estimate_required_shots(compiled_slice_1, CALIBRATION, seed=0)
     assert n == 100
 
 
+def test_sample_estimate_is_cached(compiled_slice_1: str) -> None:
+    """Test that shot estimates are reproducible and cached per assertion and calibration.
+
+    Args:
+        compiled_slice_1 (str): The compiled program slice code.
+    """
+    estimator = dbg.ShotEstimator()
+    assertion = run_preparation.extract_assertions_from_code(compiled_slice_1)[0]
+    esp = CALIBRATION.get_expected_success_probability(compiled_slice_1)
+    n = estimator.estimate(assertion, esp, num_trials=200, seed=7)
+    assert estimator.get_cache_size() == 1
+    assert estimator.estimate(assertion, esp, num_trials=200, seed=7, max_threads=1) == n
+    assert estimator.get_cache_size() == 1
+    estimator.estimate(assertion, esp / 2, num_trials=200, seed=7)
+    assert estimator.get_cache_size() == 2
+    estimator.clear_cache()
+    assert estimator.get_cache_size() == 0
+    assert estimator.estimate(assertion, esp, num_trials=200, seed=7, max_threads=1) == n
+
+
 def check_dir_contents_and_delete(directory: Path, expected: dict[str, str]) -> None:
     """Check the contents of a directory against expected values.
 
@@ -459,7 +503,6 @@ def test_main_shots(monkeypatch: pytest.MonkeyPatch, capsys: pytest.CaptureFixtu
         monkeypatch (pytest.MonkeyPatch): Monkeypatch fixture for testing.
         capsys (pytest.CaptureFixture): Capture fixture for testing.
     """
-    random.seed(12345)
     monkeypatch.setattr(
         sys,
         "argv",
@@ -475,6 +518,8 @@ def test_main_shots(monkeypatch: pytest.MonkeyPatch, capsys: pytest.CaptureFixtu
             "100",
             "--accuracy",
             "0.9",
+            "--seed",
+            "0",
         ],
     )
     runtime_check.main()
@@ -482,7 +527,7 @@ def test_main_shots(monkeypatch: pytest.MonkeyPatch, capsys: pytest.CaptureFixtu
     match = re.match(r"^Estimated required shots: (\d+)$", out)
     assert match is not None, f"Output did not match expected format: {out}"
     shots = int(match.group(1))
-    assert shots == 180, f"Expected 100 shots, but got {shots}."
+    assert shots == 180, f"Expected 180 shots, but got {shots}."
 
 
 def test_contribution_equal_under_noise_big_difference() -> None:
@@ -497,3 +542,36 @@ def test_check_power_divergence_zeros() -> None:
     statistic, p = result_checker.check_power_divergence([99, 1, 0, 0], [100, 0, 0, 0])
     assert statistic == pytest.approx(0.0, abs=1e-8)
     assert p == pytest.approx(0.0, abs=1e-8)
+
+
+def test_native_assertion_checks_match_python() -> None:
+    """Test that the native assertion checks agree with the Python implementation."""
+    rng = random.Random(42)
+    assertions = ["{superposition}", "{zero}", "{0.5,0,0,0.5}", "{0.25,0.25,0.25,0.25}"]
+    for _ in range(200):
+        assertion = rng.choice(assertions)
+        distribution = [rng.randint(0, 100) for _ in range(4)]
+        distribution[0] += 1
+        num_samples = sum(distribution)
+        esp = rng.uniform(0.5, 1.0)
+        assert dbg.check_assertion_result(assertion, distribution, num_samples, esp) == result_checker.check_assertion(
+            assertion, distribution, num_samples, esp
+        ), f"Mismatch for {assertion} with {distribution} and {esp}."
+
+
+def test_load_result_counts(tmp_path: Path) -> None:
+    """Test that results are streamed and binned natively from paths and file objects."""
+    path = tmp_path / "results.json"
+    path.write_text(json.dumps([{"a": 1, "b": 0, "c": 1}, {"a": 1, "b": 1, "c": 0}, {"a": 0, "b": 0, "c": 1}]))
+    distributions = [("a", "b"), ("c",)]
+    expected = {("a", "b"): [1, 1, 0, 1], ("c",): [1, 2]}
+
+    result = result_checker.Result.load(path, distributions)
+    assert result.num_samples == 3
+    assert result.distribution == expected
+
+    with path.open("r") as f:
+        assert result_checker.Result.load(f, distributions).distribution == expected
+
+    with pytest.raises(ValueError, match="Invalid result file"):
+        dbg.load_result_counts(io.StringIO('[{"a": null}]'), distributions)
@@ -18,6 +18,7 @@ import math
 from pathlib import Path
 from typing import TYPE_CHECKING, cast
 
+import numpy as np
 import pytest
 
 import mqt.debugger
@@ -151,6 +152,25 @@ def test_run_all(simulation_instance: str, request: pytest.FixtureRequest) -> No
     assert failures == (2 if state_id == 0 else 0)
 
 
+@pytest.mark.usefixtures("simulation_state_cleanup")
+@pytest.mark.parametrize(
+    "simulation_instance",
+    ["simulation_instance_ghz", "simulation_instance_jumps", "simulation_instance_classical"],
+)
+def test_run_all_async(simulation_instance: str, request: pytest.FixtureRequest) -> None:
+    """Tests the `run_all_async()` method."""
+    (simulation_state, state_id) = load_fixture(request, simulation_instance)
+    progress: list[tuple[int, int]] = []
+    simulation_state.run_all_async(lambda instruction, failures: progress.append((instruction, failures)))
+    failures = simulation_state.wait_for_simulation()
+    assert not simulation_state.is_simulation_running()
+    assert failures == (2 if state_id == 0 else 0)
+    assert simulation_state.is_finished()
+    assert progress[-1] == (simulation_state.get_current_instruction(), failures)
+    with pytest.raises(RuntimeError):
+        simulation_state.wait_for_simulation()
+
+
 @pytest.mark.usefixtures("simulation_state_cleanup")
 @pytest.mark.parametrize("simulation_instance", ["simulation_instance_ghz", "simulation_instance_jumps"])
 def test_run_backward(simulation_instance: str, request: pytest.FixtureRequest) -> None:
@@ -233,6 +253,142 @@ def test_access_state(simulation_instance_jumps: SimulationInstance) -> None:
     assert abs(c.real) < 1e-6
 
 
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_access_state_array(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests the array-based quantum-state-access methods."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+
+    expected = np.zeros(8, dtype=np.complex128)
+    expected[0] = expected[7] = 1 / (2**0.5)
+
+    array = np.asarray(simulation_state.get_state_vector_full_array())
+    assert array.dtype == np.complex128
+    assert np.allclose(array, expected)
+
+    out = np.zeros(8, dtype=np.complex128)
+    result = np.asarray(simulation_state.get_state_vector_full_array(out))
+    assert np.shares_memory(result, out)
+    assert np.allclose(out, expected)
+
+    sv = simulation_state.get_state_vector_full()
+    assert np.allclose(np.asarray(sv.array), expected)
+
+    sub = np.asarray(simulation_state.get_state_vector_sub_array([0, 1, 2]))
+    assert np.allclose(sub, expected)
+
+    with pytest.raises(ValueError, match="exactly 8 amplitudes"):
+        simulation_state.get_state_vector_full_array(np.zeros(4, dtype=np.complex128))
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_access_state_range(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests the paged quantum-state-access method."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+
+    page = simulation_state.get_state_vector_range(6, 2)
+    assert page.num_states == 2
+    assert np.allclose(np.asarray(page.array), [0, 1 / (2**0.5)])
+
+    with pytest.raises(RuntimeError):
+        simulation_state.get_state_vector_range(7, 2)
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_dense_memory_budget(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests configuring and reporting the dense-memory budget."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+
+    mqt.debugger.set_dense_memory_budget(simulation_state, 0)
+    with pytest.raises(RuntimeError):
+        simulation_state.get_state_vector_sub([1, 0, 2])
+
+    mqt.debugger.set_dense_memory_budget(simulation_state, 1 << 20)
+    simulation_state.get_state_vector_sub([1, 0, 2])
+    (current, peak) = mqt.debugger.get_dense_memory_usage(simulation_state)
+    assert 0 < current <= peak <= 1 << 20
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_fast_run(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests that fast-run mode produces the same state and stops as single steps."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+    expected_instruction = simulation_state.get_current_instruction()
+    expected = simulation_state.get_state_vector_full()
+
+    simulation_state.reset_simulation()
+    mqt.debugger.set_fast_run(simulation_state, True)
+    simulation_state.run_simulation()
+    assert simulation_state.get_current_instruction() == expected_instruction
+    actual = simulation_state.get_state_vector_full()
+    for a, b in zip(actual.amplitudes, expected.amplitudes, strict=True):
+        assert a.real == pytest.approx(b.real)
+        assert a.imaginary == pytest.approx(b.imaginary)
+
+    simulation_state.run_simulation_backward()
+    assert simulation_state.get_current_instruction() == 0
+    mqt.debugger.set_fast_run(simulation_state, False)
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_profile(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests collecting profiling counters through the bindings."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+    assert simulation_state.get_profile() == []
+
+    simulation_state.set_profiling_enabled(True)
+    simulation_state.reset_simulation()
+    simulation_state.run_simulation()
+    profile = simulation_state.get_profile()
+    assert any(entry.phase == mqt.debugger.ProfilePhase.ProfileSimulation for entry in profile)
+    assert all(entry.calls > 0 and entry.seconds >= 0 for entry in profile)
+    assert [entry.instruction for entry in profile] == sorted(entry.instruction for entry in profile)
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_state_delta(simulation_instance_classical: SimulationInstance) -> None:
+    """Tests reporting the changes of the state through the bindings."""
+    (simulation_state, _state_id) = simulation_instance_classical
+    first = simulation_state.get_state_delta(max_amplitudes=16)
+    assert first.complete
+    assert [variable.name for variable in first.changed_variables] == ["c[0]", "c[1]", "c[2]"]
+    assert [index for (index, _) in first.changed_amplitudes] == [0]
+    assert first.stack_trace == [simulation_state.get_current_instruction()]
+
+    unchanged = simulation_state.get_state_delta(first.version, max_amplitudes=16)
+    assert not unchanged.complete
+    assert unchanged.changed_variables == []
+    assert unchanged.changed_amplitudes == []
+
+    while simulation_state.get_current_instruction() != 4:
+        simulation_state.step_forward()
+    delta = simulation_state.get_state_delta(unchanged.version, max_amplitudes=16)
+    assert delta.current_instruction == 4
+    assert delta.changed_variables == []
+    assert [index for (index, _) in delta.changed_amplitudes] == [0, 1]
+    assert simulation_state.get_state_delta(unchanged.version).complete
+
+
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_sparse_amplitudes(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests the sparse and top-k amplitude queries."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    simulation_state.run_simulation()
+
+    non_zero = simulation_state.get_non_zero_amplitudes(0.0, 8)
+    assert [index for (index, _) in non_zero] == [0, 7]
+    assert all(abs(amplitude.real - 1 / (2**0.5)) < 1e-6 for (_, amplitude) in non_zero)
+    assert [index for (index, _) in simulation_state.get_non_zero_amplitudes(0.0, 1)] == [0]
+    assert simulation_state.get_non_zero_amplitudes(0.8, 8) == []
+
+    top = simulation_state.get_top_k_amplitudes(1)
+    assert [index for (index, _) in top] == [0]
+
+
 @pytest.mark.usefixtures("simulation_state_cleanup")
 def test_change_amplitude_value(simulation_instance_ghz: SimulationInstance) -> None:
     """Tests manipulating amplitudes through the bindings."""
@@ -328,6 +484,18 @@ def test_get_state_vector_sub(simulation_instance_classical: SimulationInstance)
     assert sv.amplitudes[0].real == 1 or sv.amplitudes[-1].real == 1
 
 
+@pytest.mark.usefixtures("simulation_state_cleanup")
+def test_get_state_vector_sub_unordered(simulation_instance_classical: SimulationInstance) -> None:
+    """Tests the `get_state_vector_sub()` method with qubits that are not in ascending order."""
+    (simulation_state, _state_id) = simulation_instance_classical
+    simulation_state.set_breakpoint(170)
+    simulation_state.run_simulation()
+    assert simulation_state.get_current_instruction() == 10
+    sv = simulation_state.get_state_vector_sub([1, 0, 2])
+    assert len(sv.amplitudes) == 8
+    assert sv.amplitudes[0].real == 1 or sv.amplitudes[-1].real == 1
+
+
 @pytest.mark.usefixtures("simulation_state_cleanup")
 def test_classical_get(simulation_instance_classical: SimulationInstance) -> None:
     """Tests the classical-state-access methods."""
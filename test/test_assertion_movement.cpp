@@ -338,4 +338,32 @@ TEST_F(AssertionMovementTest, DontMoveOutsideOfCustomGate) {
   checkMovements(expected);
 }
 
+/**
+ * @test Test that multiple assertions in different scopes of the same program
+ * are moved independently of each other.
+ */
+TEST_F(AssertionMovementTest, MoveAssertionsInMultipleScopes) {
+  loadCode(3, 3, R"(
+  h q[0];
+  h q[2];
+  gate first a, b {
+    cx a, b;
+    x a;
+    assert-ent a, b;
+  }
+  cx q[0], q[1];
+  gate second t {
+    h t;
+    assert-sup t;
+  }
+  x q[0];
+  assert-ent q[0], q[1];
+  assert-sup q[2];
+  )");
+
+  const std::set<std::pair<size_t, size_t>> expected({{5, 4}, {13, 8},
+                                                      {14, 2}});
+  checkMovements(expected);
+}
+
 } // namespace mqt::debugger::test
@@ -157,6 +157,41 @@ TEST_F(ProjectiveMeasurementsCompilationTest, ProjectiveSubstateAssertion) {
                    preamble);
 }
 
+/**
+ * @brief Tests that the circuit of an equality assertion is inverted before
+ * the measurements if it contains gates that are not self-inverse.
+ */
+TEST_F(ProjectiveMeasurementsCompilationTest, ProjectiveNonSelfInverseGates) {
+  loadCode("qreg q[1];\n"
+           "h q[0];\n"
+           "s q[0];\n"
+           "t q[0];\n"
+           "assert-eq q[0] { "
+           "qreg p[1];\n"
+           "h p[0];\n"
+           "s p[0];\n"
+           "t p[0];\n"
+           "}\n");
+
+  PreambleVector preamble;
+  preamble.emplace_back(std::make_unique<ProjPreambleEntry>(SV{"test_q0"}));
+
+  checkCompilation(makeSettings(/*opt=*/0, /*slice=*/0),
+                   "qreg q[1];\n"
+                   "h q[0];\n"
+                   "s q[0];\n"
+                   "t q[0];\n"
+                   "creg test_q0[1];\n"
+                   "tdg q[0];\n"
+                   "sdg q[0];\n"
+                   "h q[0];\n"
+                   "measure q[0] -> test_q0[0];\n"
+                   "h q[0];\n"
+                   "s q[0];\n"
+                   "t q[0];\n",
+                   preamble);
+}
+
 /**
  * @brief Tests the compilation of multiple equality assertions using
  * projective measurements and no optimization.
@@ -14,12 +14,21 @@
  * assertion programs using statistical slices.
  */
 
+#include "backend/dd/DDSimDebug.hpp"
 #include "common_fixtures.hpp"
+#include "ir/Definitions.hpp"
+#include "ir/operations/NonUnitaryOperation.hpp"
+#include "ir/operations/OpType.hpp"
 #include "utils_test.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <gtest/gtest.h>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace mqt::debugger::test {
@@ -831,4 +840,194 @@ TEST_F(StatisticalSlicesCompilationTest,
   checkNoCompilation(makeSettings(2, 2));
 }
 
+/**
+ * @brief Tests that compiling all slices at once yields the same code as
+ * compiling each slice individually.
+ */
+TEST_F(StatisticalSlicesCompilationTest, StatisticalCompileAllSlices) {
+  loadCode("qreg q[2];\n"
+           "x q[0];\n"
+           "assert-eq q[0] { 0, 1 }\n"
+           "assert-sup q[1];\n"
+           "h q[0];\n"
+           "assert-sup q[0];\n"
+           "assert-sup q[0];\n");
+
+  const std::array<size_t, 3> expectedSlices{4, 3, 2};
+  for (uint8_t opt = 0; opt < expectedSlices.size(); opt++) {
+    size_t numSlices = 0;
+    const auto size = state->compileSlices(state, nullptr, nullptr, &numSlices,
+                                           makeSettings(opt, 0));
+    ASSERT_EQ(numSlices, expectedSlices.at(opt));
+    std::vector<char> buffer(size);
+    std::vector<size_t> offsets(numSlices);
+    ASSERT_EQ(state->compileSlices(state, buffer.data(), offsets.data(),
+                                   nullptr, makeSettings(opt, 0)),
+              size);
+
+    for (size_t i = 0; i < numSlices; i++) {
+      const auto settings = makeSettings(opt, i);
+      const auto sliceSize = state->compile(state, nullptr, settings);
+      ASSERT_GT(sliceSize, 0);
+      std::vector<char> slice(sliceSize);
+      state->compile(state, slice.data(), settings);
+      ASSERT_EQ(std::string(buffer.data() + offsets[i]),
+                std::string(slice.data()));
+    }
+    checkNoCompilation(makeSettings(opt, numSlices));
+  }
+}
+
+/**
+ * @brief The type, qubits, and classical bits of an operation, with control
+ * qubits preceding target qubits.
+ */
+using OperationSignature =
+    std::tuple<qc::OpType, std::vector<qc::Qubit>, std::vector<qc::Bit>>;
+
+/**
+ * @brief Get the signatures of all operations of a circuit.
+ * @param circuit The circuit to describe.
+ * @return The signature of each operation.
+ */
+std::vector<OperationSignature>
+getSignatures(const qc::QuantumComputation& circuit) {
+  std::vector<OperationSignature> signatures;
+  for (const auto& op : circuit) {
+    std::vector<qc::Qubit> qubits;
+    for (const auto& control : op->getControls()) {
+      qubits.push_back(control.qubit);
+    }
+    qubits.insert(qubits.end(), op->getTargets().begin(),
+                  op->getTargets().end());
+    std::vector<qc::Bit> bits;
+    if (op->getType() == qc::Measure) {
+      const auto& classics =
+          dynamic_cast<const qc::NonUnitaryOperation&>(*op).getClassics();
+      bits.assign(classics.begin(), classics.end());
+    }
+    signatures.emplace_back(op->getType(), std::move(qubits), std::move(bits));
+  }
+  return signatures;
+}
+
+/**
+ * @brief Tests that slices compiled into circuits are built from the imported
+ * program, with the measurements inserted where the assertions were.
+ */
+TEST_F(StatisticalSlicesCompilationTest, StatisticalCompileSliceCircuits) {
+  loadCode("qreg q[2];\n"
+           "gate bell a, b {\n"
+           "  h a;\n"
+           "  cx a, b;\n"
+           "}\n"
+           "x q[0];\n"
+           "assert-eq q[0] { 0, 1 }\n"
+           "bell q[0], q[1];\n"
+           "assert-eq q[0], q[1] { qreg p[2]; h p[0]; cx p[0], p[1]; }\n"
+           "h q[1];\n"
+           "assert-sup q[1];\n");
+
+  const auto slices = ddsimCompileSliceCircuits(&ddState, makeSettings(0, 0));
+  ASSERT_EQ(slices.size(), 3);
+
+  ASSERT_EQ(slices[0].assertions, SV{"(test_q0) {0,1} 1"});
+  ASSERT_EQ(slices[0].circuit.getNqubits(), 2);
+  ASSERT_EQ(slices[0].circuit.getNcbits(), 1);
+  ASSERT_EQ(getSignatures(slices[0].circuit),
+            (std::vector<OperationSignature>{{qc::X, {0}, {}},
+                                             {qc::Measure, {0}, {0}}}));
+
+  ASSERT_EQ(slices[1].assertions, SV{"(test_q0,test_q1) {zero}"});
+  ASSERT_EQ(slices[1].circuit.getNcbits(), 2);
+  ASSERT_EQ(getSignatures(slices[1].circuit),
+            (std::vector<OperationSignature>{{qc::X, {0}, {}},
+                                             {qc::H, {0}, {}},
+                                             {qc::X, {0, 1}, {}},
+                                             {qc::X, {0, 1}, {}},
+                                             {qc::H, {0}, {}},
+                                             {qc::Measure, {0}, {0}},
+                                             {qc::Measure, {1}, {1}},
+                                             {qc::H, {0}, {}},
+                                             {qc::X, {0, 1}, {}}}));
+
+  ASSERT_EQ(slices[2].assertions, SV{"(test_q1) {superposition}"});
+  ASSERT_EQ(getSignatures(slices[2].circuit),
+            (std::vector<OperationSignature>{{qc::X, {0}, {}},
+                                             {qc::H, {0}, {}},
+                                             {qc::X, {0, 1}, {}},
+                                             {qc::H, {1}, {}},
+                                             {qc::Measure, {1}, {0}}}));
+}
+
+/**
+ * @brief Tests that the circuit of an equality assertion is inverted before
+ * the measurements of a slice if it contains gates that are not self-inverse.
+ */
+TEST_F(StatisticalSlicesCompilationTest,
+       StatisticalSliceCircuitsInvertAssertionCircuits) {
+  loadCode("qreg q[1];\n"
+           "h q[0];\n"
+           "t q[0];\n"
+           "rx(0.3) q[0];\n"
+           "assert-eq q[0] { qreg p[1]; h p[0]; t p[0]; rx(0.3) p[0]; }\n");
+
+  const auto slices = ddsimCompileSliceCircuits(&ddState, makeSettings(0, 0));
+  ASSERT_EQ(slices.size(), 1);
+  ASSERT_EQ(slices[0].assertions, SV{"(test_q0) {zero}"});
+  ASSERT_EQ(getSignatures(slices[0].circuit),
+            (std::vector<OperationSignature>{{qc::H, {0}, {}},
+                                             {qc::T, {0}, {}},
+                                             {qc::RX, {0}, {}},
+                                             {qc::RX, {0}, {}},
+                                             {qc::Tdg, {0}, {}},
+                                             {qc::H, {0}, {}},
+                                             {qc::Measure, {0}, {0}},
+                                             {qc::H, {0}, {}},
+                                             {qc::T, {0}, {}},
+                                             {qc::RX, {0}, {}}}));
+  const auto& circuit = slices[0].circuit;
+  ASSERT_DOUBLE_EQ(circuit.at(2)->getParameter().front(), 0.3);
+  ASSERT_DOUBLE_EQ(circuit.at(3)->getParameter().front(), -0.3);
+  ASSERT_DOUBLE_EQ(circuit.at(9)->getParameter().front(), 0.3);
+}
+
+/**
+ * @brief Tests that slices compiled into circuits match the assertions of the
+ * slices compiled into code for all optimization levels.
+ */
+TEST_F(StatisticalSlicesCompilationTest,
+       StatisticalSliceCircuitsMatchCompiledCode) {
+  loadCode("qreg q[2];\n"
+           "x q[0];\n"
+           "assert-eq q[0] { 0, 1 }\n"
+           "assert-sup q[1];\n"
+           "h q[0];\n"
+           "assert-sup q[0];\n"
+           "assert-sup q[0];\n");
+
+  for (uint8_t opt = 0; opt < 3; opt++) {
+    const auto slices =
+        ddsimCompileSliceCircuits(&ddState, makeSettings(opt, 0));
+    size_t numSlices = 0;
+    state->compileSlices(state, nullptr, nullptr, &numSlices,
+                         makeSettings(opt, 0));
+    ASSERT_EQ(slices.size(), numSlices);
+
+    for (size_t i = 0; i < numSlices; i++) {
+      const auto settings = makeSettings(opt, i);
+      std::vector<char> code(state->compile(state, nullptr, settings));
+      state->compile(state, code.data(), settings);
+      std::stringstream ss{std::string(code.data())};
+      SV expected;
+      for (std::string line; std::getline(ss, line);) {
+        if (line.starts_with("// ASSERT: ")) {
+          expected.push_back(line.substr(11));
+        }
+      }
+      ASSERT_EQ(slices[i].assertions, expected);
+    }
+  }
+}
+
 } // namespace mqt::debugger::test
@@ -17,15 +17,22 @@
  * are not covered by the other tests.
  */
 
+#include "backend/dd/DDSimDebug.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
 #include "common_fixtures.hpp"
 #include "utils_test.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <future>
 #include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace mqt::debugger::test {
 
@@ -95,6 +102,35 @@ TEST_F(CustomCodeTest, IfElseOperationMulti) {
   ASSERT_TRUE(complexEquality(amplitudes[2], 1, 0.0));
 }
 
+/**
+ * @test Test classically controlled operations on a register whose bits are
+ * stored in different words.
+ */
+TEST_F(CustomCodeTest, IfElseOperationAcrossWords) {
+  loadCode(3, 1,
+           "creg pad[62];"
+           "creg r[2];"
+           "x q[0];"
+           "x q[1];"
+           "measure q[0] -> r[0];"
+           "measure q[1] -> r[1];"
+           "if(r==3) x q[2];"
+           "if(r[1]==0) z q[2];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  Variable bit;
+  ASSERT_EQ(state->getClassicalVariable(state, "r[1]", &bit), OK);
+  ASSERT_TRUE(classicalEquals(bit, true));
+  ASSERT_EQ(state->getClassicalVariable(state, "pad[61]", &bit), OK);
+  ASSERT_TRUE(classicalEquals(bit, false));
+  ASSERT_EQ(state->getNumClassicalVariables(state), 65);
+
+  std::array<Complex, 8> amplitudes{};
+  Statevector sv{3, 8, amplitudes.data()};
+  state->getStateVectorFull(state, &sv);
+  ASSERT_TRUE(complexEquality(amplitudes[7], 1, 0.0));
+}
+
 /**
  * @test Test the `reset` instruction.
  */
@@ -556,4 +592,814 @@ TEST_F(CustomCodeTest, PaperExampleGrover) {
   ASSERT_EQ(state->isFinished(state), true);
 }
 
+/**
+ * @test Test entanglement assertions on pairs of non-adjacent qubits with
+ * complex amplitudes, where the reduced density matrices are computed directly
+ * from the state vector.
+ */
+TEST_F(CustomCodeTest, EntanglementOnComplexSubsystems) {
+  loadCode(4, 0,
+           "h q[0]; cx q[0], q[3]; s q[3]; t q[0]; h q[1];"
+           "assert-ent q[0], q[3];"
+           "assert-ent q[3], q[0];"
+           "assert-ent q[0], q[1], q[3];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 9);
+
+  size_t errors = 0;
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runAll(state, &errors), OK);
+  ASSERT_EQ(errors, 1);
+}
+
+/**
+ * @test Test superposition assertions on a wide GHZ state, which are evaluated
+ * on the decision diagram without expanding the full state vector.
+ */
+TEST_F(CustomCodeTest, SuperpositionOnWideState) {
+  std::string code = "h q[0];";
+  for (size_t i = 1; i < 40; i++) {
+    code += "cx q[0], q[" + std::to_string(i) + "];";
+  }
+  code += "assert-sup q[39];"
+          "assert-sup q[0], q[20];"
+          "assert-sup q[40];";
+  loadCode(41, 0, code.c_str());
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 44);
+}
+
+/**
+ * @test Test statevector equality assertions on a sub-register whose reduced
+ * density matrix has complex entries.
+ */
+TEST_F(CustomCodeTest, EqualityOnComplexSubRegister) {
+  loadCode(3, 0,
+           "h q[0]; s q[0]; h q[2]; x q[1];"
+           "assert-eq 0.9999, q[0], q[2] { 0.5, 0.5i, 0.5, 0.5i };"
+           "assert-eq 0.9999, q[0] { 0.707107, 0.707107 };");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 7);
+}
+
+/**
+ * @test Test that the reference states of circuit equality assertions are
+ * only simulated once and discarded when new code is loaded.
+ */
+TEST_F(CustomCodeTest, CircuitEqualityReferenceCache) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "assert-eq q[0], q[1] { qreg q[2]; h q[1]; cx q[1], q[0]; }"
+           "x q[0];"
+           "x q[0];"
+           "assert-eq q[0], q[1] { qreg q[2]; h q[1]; cx q[1], q[0]; }");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(ddState.referenceStates.size(), 1);
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(ddState.referenceStates.size(), 1);
+
+  loadCode(2, 0,
+           "h q[0];"
+           "assert-eq q[0], q[1] { qreg q[2]; h q[1]; cx q[1], q[0]; }");
+  ASSERT_TRUE(ddState.referenceStates.empty());
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 1);
+}
+
+/**
+ * @test Test stepping back over measurements, which restores the state from a
+ * checkpoint and reuses the recorded outcome when stepping forward again.
+ */
+TEST_F(CustomCodeTest, StepBackOverMeasurement) {
+  loadCode(2, 1,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "measure q[0] -> c[0];"
+           "x q[1];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  Variable measured;
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &measured), OK);
+
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 4);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 0, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+  ASSERT_EQ(state->getAmplitudeIndex(state, 3, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+
+  ASSERT_EQ(state->runSimulationBackward(state), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+  ASSERT_FALSE(state->canStepBackward(state));
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  Variable replayed;
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &replayed), OK);
+  ASSERT_EQ(replayed.value.boolValue, measured.value.boolValue);
+}
+
+/**
+ * @test Test rewinding to earlier steps when checkpoints are evicted because
+ * of the memory budget, so that steps have to be replayed.
+ */
+TEST_F(CustomCodeTest, RewindWithEvictedCheckpoints) {
+  ddState.checkpoints.setInterval(1);
+  ddState.checkpoints.setMemoryBudget(0, *ddState.dd);
+  loadCode(2, 1,
+           "h q[0];"
+           "measure q[0] -> c[0];"
+           "cx q[0], q[1];"
+           "x q[0];"
+           "h q[1];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(ddState.checkpoints.size(), 1);
+  Variable measured;
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &measured), OK);
+  const size_t expected = measured.value.boolValue ? 2 : 1;
+
+  ASSERT_EQ(ddsimRewindToStep(&ddState, 6), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 6);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, expected, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+
+  ASSERT_EQ(ddsimRewindToStep(&ddState, 3), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 3);
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+  ASSERT_EQ(ddsimRewindToStep(&ddState, 4), ERROR);
+}
+
+/**
+ * @test Test that the matrix DDs of operations are cached when stepping back
+ * and forth, and that the cache is cleared when new code is loaded.
+ */
+TEST_F(CustomCodeTest, GateDDCache) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];");
+  ASSERT_TRUE(ddState.gateCache.empty());
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(ddState.gateCache.size(), 2);
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(ddState.gateCache.size(), 2);
+
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 3, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+
+  loadCode(1, 0, "x q[0];");
+  ASSERT_TRUE(ddState.gateCache.empty());
+}
+
+/**
+ * @test Test that fast-run mode fuses gates between stop points without
+ * breaking breakpoints, assertions or stepping back.
+ */
+TEST_F(CustomCodeTest, FastRunFusesGates) {
+  loadCode(3, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "x q[2];"
+           "assert-ent q[0], q[1];"
+           "z q[2];"
+           "h q[2];"
+           "x q[0];");
+  ddState.fastRun = true;
+  ddState.instructionFlags[7] |= BREAKPOINT;
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_FALSE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 7);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+
+  std::array<Complex, 8> amplitudes{};
+  Statevector sv{3, 8, amplitudes.data()};
+  state->getStateVectorFull(state, &sv);
+  ASSERT_TRUE(complexEquality(amplitudes[1], -0.5, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[2], -0.5, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[5], 0.5, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[6], 0.5, 0.0));
+
+  while (state->canStepBackward(state)) {
+    ASSERT_EQ(state->stepBackward(state), OK);
+  }
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+  state->getStateVectorFull(state, &sv);
+  ASSERT_TRUE(complexEquality(amplitudes[0], 1.0, 0.0));
+}
+
+/**
+ * @test Test that garbage is collected according to the configured policy.
+ */
+TEST_F(CustomCodeTest, GarbageCollectionPolicy) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "z q[1];");
+  ddState.gcPolicy.mode = GarbageCollectionMode::EveryNSteps;
+  ddState.gcPolicy.interval = 2;
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(ddState.stepsSinceGarbageCollection, 1);
+
+  ddState.gcPolicy.mode = GarbageCollectionMode::WhenPaused;
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(ddState.stepsSinceGarbageCollection, 2);
+  ASSERT_EQ(state->runSimulationBackward(state), OK);
+  ASSERT_EQ(ddState.stepsSinceGarbageCollection, 0);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(ddState.stepsSinceGarbageCollection, 0);
+
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 3, &result), OK);
+  ASSERT_TRUE(complexEquality(result, -0.707, 0.0));
+}
+
+/**
+ * @test Test that zero controls are detected on states that are too wide to be
+ * expanded into a statevector.
+ */
+TEST_F(CustomCodeTest, ZeroControlsOnWideState) {
+  loadCode(24, 0,
+           "h q[0];"
+           "cx q[23], q[1];"
+           "cx q[0], q[2];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  std::array<bool, 5> zeroControls{};
+  diagnostics->getZeroControlInstructions(diagnostics, zeroControls.data());
+  for (size_t i = 0; i < zeroControls.size(); i++) {
+    ASSERT_EQ(zeroControls.at(i), i == 3);
+  }
+}
+
+/**
+ * @test Test that targets inside nested custom gates are resolved through the
+ * arguments of each call on the call stack.
+ */
+TEST_F(CustomCodeTest, NestedCallQubitResolution) {
+  loadCode(3, 0,
+           "gate inner a, b { cx a, b; assert-ent a, b; }"
+           "gate outer x, y { h y; inner y, x; }"
+           "outer q[2], q[0];"
+           "assert-ent q[0], q[2];"
+           "assert-sup q[1];");
+  size_t errors = 0;
+  ASSERT_EQ(state->runAll(state, &errors), OK);
+  ASSERT_EQ(errors, 1);
+
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 5, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+}
+
+/**
+ * @test Test sampling multiple shots, which splits the shots at each
+ * measurement and is reproducible for a fixed seed.
+ */
+TEST_F(CustomCodeTest, SampleShots) {
+  loadCode(2, 3,
+           "h q[0];"
+           "measure q[0] -> c[0];"
+           "cx q[0], q[1];"
+           "measure q[1] -> c[1];"
+           "x q[1];"
+           "measure q[1] -> c[2];");
+  std::array<size_t, 4> outcomes{};
+  std::array<size_t, 4> counts{};
+  size_t numOutcomes = 0;
+  ASSERT_EQ(state->sampleShots(state, 1000, 42, outcomes.data(), counts.data(),
+                               outcomes.size(), &numOutcomes),
+            OK);
+  ASSERT_EQ(numOutcomes, 2);
+  ASSERT_EQ(outcomes[0], 0b100);
+  ASSERT_EQ(outcomes[1], 0b011);
+  ASSERT_EQ(counts[0] + counts[1], 1000);
+  ASSERT_GT(counts[0], 400);
+  ASSERT_GT(counts[1], 400);
+
+  // Sampling does not advance the simulation itself.
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+
+  std::array<size_t, 4> repeatedOutcomes{};
+  std::array<size_t, 4> repeatedCounts{};
+  ASSERT_EQ(state->sampleShots(state, 1000, 42, repeatedOutcomes.data(),
+                               repeatedCounts.data(), repeatedOutcomes.size(),
+                               &numOutcomes),
+            OK);
+  ASSERT_EQ(repeatedOutcomes, outcomes);
+  ASSERT_EQ(repeatedCounts, counts);
+
+  ASSERT_EQ(state->sampleShots(state, 1000, 42, outcomes.data(), counts.data(),
+                               1, &numOutcomes),
+            ERROR);
+  ASSERT_EQ(numOutcomes, 2);
+}
+
+/**
+ * @test Test that seeding the simulation makes measurement outcomes
+ * reproducible.
+ */
+TEST_F(CustomCodeTest, SeededMeasurements) {
+  loadCode(4, 4,
+           "h q[0]; h q[1]; h q[2]; h q[3];"
+           "measure q[0] -> c[0]; measure q[1] -> c[1];"
+           "measure q[2] -> c[2]; measure q[3] -> c[3];");
+  ASSERT_EQ(state->setSeed(state, 7), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  std::array<bool, 4> first{};
+  for (size_t i = 0; i < first.size(); i++) {
+    Variable bit;
+    const auto name = "c[" + std::to_string(i) + "]";
+    ASSERT_EQ(state->getClassicalVariable(state, name.c_str(), &bit), OK);
+    first.at(i) = bit.value.boolValue;
+  }
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->setSeed(state, 7), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  for (size_t i = 0; i < first.size(); i++) {
+    Variable bit;
+    const auto name = "c[" + std::to_string(i) + "]";
+    ASSERT_EQ(state->getClassicalVariable(state, name.c_str(), &bit), OK);
+    ASSERT_EQ(bit.value.boolValue, first.at(i));
+  }
+}
+
+/**
+ * @test Test that multiple simulation states can share a loaded program and
+ * execute it concurrently and independently.
+ */
+TEST_F(CustomCodeTest, SharedProgramAcrossThreads) {
+  loadCode(3, 0,
+           "gate bell a, b { h a; cx a, b; }"
+           "bell q[0], q[1];"
+           "x q[2];"
+           "assert-ent q[0], q[1];");
+
+  constexpr size_t numWorkers = 4;
+  std::vector<std::unique_ptr<DDSimulationState>> workers;
+  for (size_t i = 0; i < numWorkers; i++) {
+    workers.push_back(std::make_unique<DDSimulationState>());
+    ASSERT_EQ(createDDSimulationState(workers.back().get()), OK);
+    ASSERT_EQ(ddsimLoadProgram(workers.back().get(), ddState.program), OK);
+    ASSERT_EQ(workers.back()->program, ddState.program);
+  }
+
+  // Breakpoints belong to each state, not to the shared program.
+  size_t breakpoint = 0;
+  ASSERT_EQ(workers[0]->interface.setBreakpoint(&workers[0]->interface,
+                                                fullCode.find("x q[2]"),
+                                                &breakpoint),
+            OK);
+  ASSERT_FALSE(hasInstructionFlag(&ddState, breakpoint, BREAKPOINT));
+  ASSERT_EQ(workers[0]->interface.clearBreakpoints(&workers[0]->interface),
+            OK);
+
+  std::vector<size_t> failedAssertions(numWorkers, -1ULL);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < numWorkers; i++) {
+    threads.emplace_back([&workers, &failedAssertions, i]() {
+      auto* worker = &workers[i]->interface;
+      worker->runAll(worker, &failedAssertions[i]);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < numWorkers; i++) {
+    auto* worker = &workers[i]->interface;
+    ASSERT_EQ(failedAssertions[i], 0);
+    ASSERT_TRUE(worker->isFinished(worker));
+    Complex result;
+    ASSERT_EQ(worker->getAmplitudeBitstring(worker, "111", &result), OK);
+    ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+    destroyDDSimulationState(workers[i].get());
+  }
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+}
+
+/**
+ * @test Test that reloading edited code keeps the executed part of the
+ * simulation if it is not affected by the edit.
+ */
+TEST_F(CustomCodeTest, ReloadCodeKeepsExecutedPrefix) {
+  loadCode(2, 1,
+           "h q[0];"
+           "measure q[0] -> c[0];"
+           "x q[1];"
+           "z q[1];");
+  forwardTo(2);
+  ASSERT_EQ(ddState.previousInstructionStack.size(), 4);
+  Variable measured;
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &measured), OK);
+  const size_t outcome = measured.value.boolValue ? 1 : 0;
+
+  // Invalid code is rejected without affecting the simulation.
+  const auto invalid = addBoilerplate(2, 1, "x f[0];", "");
+  ASSERT_NE(state->reloadCode(state, invalid.c_str()).status, LOAD_OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 4);
+
+  const auto edited = addBoilerplate(2, 1,
+                                     "h q[0];"
+                                     "measure q[0] -> c[0];"
+                                     "x q[1];"
+                                     "x q[1];",
+                                     "");
+  ASSERT_EQ(state->reloadCode(state, edited.c_str()).status, LOAD_OK);
+  ASSERT_EQ(ddState.program->code, edited);
+  ASSERT_EQ(ddState.previousInstructionStack.size(), 4);
+  ASSERT_EQ(state->getCurrentInstruction(state), 4);
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &measured), OK);
+  ASSERT_EQ(measured.value.boolValue ? 1 : 0, outcome);
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, outcome, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+
+  // Stepping back over the kept measurement uses the kept checkpoints.
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_EQ(state->stepBackward(state), OK);
+  }
+  ASSERT_EQ(state->getCurrentInstruction(state), 3);
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &measured), OK);
+  ASSERT_FALSE(measured.value.boolValue);
+
+  // Editing an executed instruction restarts the simulation.
+  const auto restarted = addBoilerplate(2, 1,
+                                        "x q[0];"
+                                        "measure q[0] -> c[0];"
+                                        "x q[1];"
+                                        "x q[1];",
+                                        "");
+  ASSERT_EQ(state->reloadCode(state, restarted.c_str()).status, LOAD_OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+  ASSERT_TRUE(ddState.previousInstructionStack.empty());
+}
+
+/**
+ * @test Test that missing interactions are found between two otherwise wide
+ * groups of interacting qubits.
+ */
+TEST_F(CustomCodeTest, MissingInteractionBetweenWideGroups) {
+  std::string code = "h q[0]; h q[8];";
+  for (size_t i = 0; i < 7; i++) {
+    code += "cx q[" + std::to_string(i) + "], q[" + std::to_string(i + 1) +
+            "];";
+    code += "cx q[" + std::to_string(i + 8) + "], q[" +
+            std::to_string(i + 9) + "];";
+  }
+  code += "assert-ent q[0], q[7];"
+          "assert-ent q[0], q[15];";
+  loadCode(16, 0, code.c_str());
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 19);
+
+  auto* diagnosis = state->getDiagnostics(state);
+  std::array<ErrorCause, 10> causes{};
+  ASSERT_EQ(
+      diagnosis->potentialErrorCauses(diagnosis, causes.data(), causes.size()),
+      1);
+  ASSERT_EQ(causes[0].type, MissingInteraction);
+  ASSERT_EQ(causes[0].instruction, 19);
+}
+
+/**
+ * @test Test statevector equality assertions on separable blocks of a wide
+ * state, which are evaluated on the decision diagram without expanding the
+ * full state vector.
+ */
+TEST_F(CustomCodeTest, EqualityOnWideState) {
+  loadCode(30, 0,
+           "h q[14];"
+           "cx q[14], q[15];"
+           "x q[29];"
+           "assert-eq 0.9999, q[15], q[14] { 0.707107, 0, 0, 0.707107 }"
+           "assert-eq 0.9999, q[29] { 0, 1 }"
+           "assert-eq 0.9999, q[28], q[29] { 1, 0, 0, 0 }");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 7);
+}
+
+/**
+ * @test Test that sub-states are extracted for qubits that are not the least
+ * significant ones and for permutations of the full register.
+ */
+TEST_F(CustomCodeTest, SubStateOfHigherQubits) {
+  loadCode(3, 0,
+           "x q[0];"
+           "h q[1];"
+           "cx q[1], q[2];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  std::array<Complex, 4> amplitudes{};
+  Statevector sv{2, 4, amplitudes.data()};
+  std::array<size_t, 2> qubits = {2, 1};
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), OK);
+  ASSERT_TRUE(complexEquality(amplitudes[0], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[1], 0.0, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[2], 0.0, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[3], 0.707, 0.0));
+
+  qubits = {0, 2};
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), ERROR);
+
+  std::array<Complex, 8> fullAmplitudes{};
+  Statevector full{3, 8, fullAmplitudes.data()};
+  const std::array<size_t, 3> allQubits = {2, 0, 1};
+  ASSERT_EQ(state->getStateVectorSub(state, 3, allQubits.data(), &full), OK);
+  ASSERT_TRUE(complexEquality(fullAmplitudes[1], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(fullAmplitudes[7], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(fullAmplitudes[0], 0.0, 0.0));
+}
+
+/**
+ * @test Test that profiling counters are only collected while profiling is
+ * enabled and are attributed to the correct instructions and phases.
+ */
+TEST_F(CustomCodeTest, ProfileInstructions) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "assert-ent q[0], q[1];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  size_t numEntries = 1;
+  ASSERT_EQ(state->getProfile(state, nullptr, 0, &numEntries), OK);
+  ASSERT_EQ(numEntries, 0);
+
+  ASSERT_EQ(state->setProfilingEnabled(state, true), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(state->getProfile(state, nullptr, 0, &numEntries), ERROR);
+  std::vector<ProfileEntry> entries(numEntries);
+  ASSERT_EQ(state->getProfile(state, entries.data(), entries.size(),
+                              &numEntries),
+            OK);
+
+  const auto find = [&entries](size_t instruction, ProfilePhase phase) {
+    return std::ranges::find_if(entries, [&](const ProfileEntry& entry) {
+      return entry.instruction == instruction && entry.phase == phase;
+    });
+  };
+  const auto cx = find(3, ProfileSimulation);
+  ASSERT_NE(cx, entries.end());
+  ASSERT_EQ(cx->calls, 1);
+  ASSERT_EQ(cx->nodesBefore, 2);
+  ASSERT_EQ(cx->nodesAfter, 3);
+  ASSERT_GE(cx->seconds, 0.0);
+  ASSERT_NE(find(4, ProfileAssertion), entries.end());
+  ASSERT_EQ(find(4, ProfileSimulation), entries.end());
+  const auto densification = find(4, ProfileDensification);
+  ASSERT_NE(densification, entries.end());
+  ASSERT_EQ(densification->denseBytes, 4 * sizeof(Complex));
+
+  ASSERT_EQ(state->setProfilingEnabled(state, false), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  std::vector<ProfileEntry> unchanged(entries.size());
+  ASSERT_EQ(state->getProfile(state, unchanged.data(), unchanged.size(),
+                              &numEntries),
+            OK);
+  ASSERT_EQ(numEntries, entries.size());
+  ASSERT_EQ(unchanged[0].calls, entries[0].calls);
+}
+
+/**
+ * @test Test that asynchronous runs report their progress and produce the same
+ * result as synchronous runs.
+ */
+TEST_F(CustomCodeTest, AsyncRunAll) {
+  loadCode(2, 0,
+           "h q[0];"
+           "assert-ent q[0], q[1];"
+           "cx q[0], q[1];"
+           "assert-sup q[0], q[1];");
+  struct Progress {
+    std::promise<void> released;
+    std::shared_future<void> release = released.get_future().share();
+    size_t reports = 0;
+    size_t instruction = 0;
+    size_t failedAssertions = 0;
+  } progress;
+  const auto onProgress = [](void* userData, size_t instruction,
+                             size_t failedAssertions) {
+    auto* p = static_cast<Progress*>(userData);
+    p->release.wait();
+    p->reports++;
+    p->instruction = instruction;
+    p->failedAssertions = failedAssertions;
+  };
+
+  ASSERT_EQ(state->waitForSimulation(state, nullptr), ERROR);
+  ASSERT_EQ(state->runAllAsync(state, onProgress, &progress), OK);
+  // The final report blocks until it is released, so the run is in progress.
+  ASSERT_TRUE(state->isSimulationRunning(state));
+  ASSERT_EQ(state->runAllAsync(state, nullptr, nullptr), ERROR);
+  ASSERT_EQ(state->runSimulationAsync(state, nullptr, nullptr), ERROR);
+  progress.released.set_value();
+
+  size_t numErrors = 0;
+  ASSERT_EQ(state->waitForSimulation(state, &numErrors), OK);
+  ASSERT_FALSE(state->isSimulationRunning(state));
+  ASSERT_EQ(numErrors, 1);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_GE(progress.reports, 1);
+  ASSERT_EQ(progress.instruction, state->getCurrentInstruction(state));
+  ASSERT_EQ(progress.failedAssertions, 1);
+  ASSERT_EQ(state->waitForSimulation(state, &numErrors), ERROR);
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulationAsync(state, nullptr, nullptr), OK);
+  ASSERT_EQ(state->waitForSimulation(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 1);
+  ASSERT_TRUE(state->didAssertionFail(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 3);
+}
+
+/**
+ * @test Test that pausing the simulation cancels an asynchronous run.
+ */
+TEST_F(CustomCodeTest, PauseCancelsAsyncRun) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];");
+  // Pausing before the run starts stops it before the first instruction.
+  ASSERT_EQ(state->pauseSimulation(state), OK);
+  ASSERT_EQ(state->runAllAsync(state, nullptr, nullptr), OK);
+  size_t numErrors = 1;
+  ASSERT_EQ(state->waitForSimulation(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(state->getCurrentInstruction(state), 0);
+  ASSERT_FALSE(state->isFinished(state));
+
+  ASSERT_EQ(state->runAllAsync(state, nullptr, nullptr), OK);
+  ASSERT_EQ(state->waitForSimulation(state, &numErrors), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_EQ(state->runSimulationAsync(state, nullptr, nullptr), ERROR);
+}
+
+/**
+ * @test Test that operations that exceed the dense-memory budget avoid dense
+ * buffers where possible and fail otherwise.
+ */
+TEST_F(CustomCodeTest, DenseMemoryBudget) {
+  loadCode(3, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "h q[2];"
+           "assert-ent q[0], q[1];"
+           "assert-ent q[0], q[2];");
+  ddState.denseMemoryBudget = 0;
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 1);
+  ASSERT_EQ(ddsimGetDenseMemoryUsage(&ddState).peak, 0);
+
+  std::array<Complex, 4> amplitudes{};
+  Statevector sv{2, 4, amplitudes.data()};
+  const std::array<size_t, 2> qubits = {0, 1};
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), ERROR);
+
+  ddState.denseMemoryBudget = DEFAULT_DENSE_MEMORY_BUDGET;
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), OK);
+  ASSERT_TRUE(complexEquality(amplitudes[0], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[3], 0.707, 0.0));
+  const auto usage = ddsimGetDenseMemoryUsage(&ddState);
+  // The scratch buffer of the sub-state is kept for later calls.
+  ASSERT_GE(usage.current, 8 * sizeof(Complex));
+  ASSERT_GE(usage.peak, usage.current);
+  ASSERT_EQ(usage.budget, DEFAULT_DENSE_MEMORY_BUDGET);
+
+  // Amplitudes are edited on the decision diagram without dense buffers.
+  ddState.denseMemoryBudget = 0;
+  const Complex value{0, 0};
+  ASSERT_EQ(state->changeAmplitudeValue(state, "000", &value), OK);
+  ASSERT_EQ(ddsimGetDenseMemoryUsage(&ddState).peak, usage.peak);
+}
+
+/**
+ * @test Test that views of the state are shared by consecutive assertions and
+ * queries until the state changes.
+ */
+TEST_F(CustomCodeTest, StateViewsAreMemoizedUntilStateChanges) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "assert-ent q[0], q[1];"
+           "assert-ent q[1], q[0];");
+  ASSERT_EQ(state->setProfilingEnabled(state, true), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  size_t numEntries = 0;
+  state->getProfile(state, nullptr, 0, &numEntries);
+  std::vector<ProfileEntry> entries(numEntries);
+  ASSERT_EQ(state->getProfile(state, entries.data(), entries.size(),
+                              &numEntries),
+            OK);
+  const auto densifications = std::ranges::count_if(
+      entries, [](const ProfileEntry& entry) {
+        return entry.phase == ProfileDensification;
+      });
+  ASSERT_EQ(densifications, 1);
+
+  const auto version = ddState.stateVersion;
+  ASSERT_EQ(ddState.stateViews.stateVector.size(), 4);
+  ASSERT_EQ(ddState.stateViews.twoQubitDensityMatrices.size(), 1);
+  std::array<Complex, 4> amplitudes{};
+  Statevector sv{2, 4, amplitudes.data()};
+  ASSERT_EQ(state->getStateVectorFull(state, &sv), OK);
+  ASSERT_TRUE(complexEquality(amplitudes[3], 0.707, 0.0));
+  const std::array<size_t, 2> qubits = {1, 0};
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), OK);
+  ASSERT_EQ(state->getStateVectorSub(state, 2, qubits.data(), &sv), OK);
+  ASSERT_EQ(ddState.stateViews.subStates.size(), 1);
+  ASSERT_EQ(ddState.stateVersion, version);
+
+  // Stepping back over an assertion keeps the state and its views.
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(ddState.stateVersion, version);
+  ASSERT_EQ(ddState.stateViews.stateVector.size(), 4);
+
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_NE(ddState.stateVersion, version);
+  ASSERT_TRUE(ddState.stateViews.stateVector.empty());
+  ASSERT_TRUE(ddState.stateViews.subStates.empty());
+  ASSERT_EQ(state->getStateVectorFull(state, &sv), OK);
+  ASSERT_TRUE(complexEquality(amplitudes[1], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[3], 0.0, 0.0));
+
+  const auto changed = ddState.stateVersion;
+  const Complex value{1, 0};
+  ASSERT_EQ(state->changeAmplitudeValue(state, "00", &value), OK);
+  ASSERT_NE(ddState.stateVersion, changed);
+  ASSERT_EQ(state->getStateVectorFull(state, &sv), OK);
+  ASSERT_TRUE(complexEquality(amplitudes[0], 1.0, 0.0));
+}
+
+/**
+ * @test Test that entanglement assertions on states that are too large to be
+ * expanded are checked on the DD.
+ */
+TEST_F(CustomCodeTest, EntanglementAssertionOnWideState) {
+  constexpr size_t numQubits = 40;
+  std::string code = "h q[0];";
+  for (size_t i = 1; i < numQubits; i++) {
+    code += "cx q[0], q[" + std::to_string(i) + "];";
+  }
+  code += "assert-ent q[0], q[39];";
+  loadCode(numQubits, 0, code.c_str());
+  size_t numErrors = 1;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+}
+
+/**
+ * @test Test that amplitudes of states that are too large to be expanded can
+ * be changed.
+ */
+TEST_F(CustomCodeTest, ChangeAmplitudeValueOnWideState) {
+  constexpr size_t numQubits = 40;
+  loadCode(numQubits, 0, "h q[0];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  const std::string zero(numQubits, '0');
+  const Complex value{0.6, 0};
+  ASSERT_EQ(state->changeAmplitudeValue(state, zero.c_str(), &value), OK);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 0, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.6, 0.0));
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.8, 0.0));
+
+  // Amplitudes outside of the support can be set as well.
+  auto top = zero;
+  top.front() = '1';
+  const Complex imaginary{0, 0.6};
+  ASSERT_EQ(state->changeAmplitudeValue(state, top.c_str(), &imaginary), OK);
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1ULL << (numQubits - 1), &result),
+            OK);
+  ASSERT_TRUE(complexEquality(result, 0.0, 0.6));
+  ASSERT_EQ(state->getAmplitudeIndex(state, 0, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.48, 0.0));
+  ASSERT_EQ(ddsimGetDenseMemoryUsage(&ddState).peak, 0);
+}
+
 } // namespace mqt::debugger::test
@@ -16,15 +16,19 @@
  * vector.
  */
 
+#include "backend/dd/DDSimTraversal.hpp"
 #include "backend/debug.h"
 #include "common.h"
+#include "common/Span.hpp"
 #include "common_fixtures.hpp"
 #include "utils_test.hpp"
 
 #include <array>
 #include <cstddef>
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace mqt::debugger::test {
@@ -43,6 +47,11 @@ class DataRetrievalTest : public LoadFromFileFixture {
   }
 };
 
+/**
+ * @brief Fixture for testing the bulk export of state vectors on custom code.
+ */
+class StateVectorExportTest : public CustomCodeFixture {};
+
 /**
  * @test Test the correctness of `getNumQubits` method of the debugging
  * interface.r
@@ -280,6 +289,83 @@ TEST_F(DataRetrievalTest, ChangeClassicalVariableNullValue) {
   ASSERT_EQ(state->changeClassicalVariableValue(state, "c[0]", nullptr), ERROR);
 }
 
+/**
+ * @test Test that `getStateDelta` reports the complete state first and only
+ * the changes afterwards.
+ */
+TEST_F(DataRetrievalTest, StateDeltaReportsChanges) {
+  std::array<Variable, 4> variables{};
+  std::array<size_t, 2> stack{};
+  std::array<size_t, 4> indices{};
+  std::array<Complex, 4> amplitudes{};
+  StateDelta delta{};
+  delta.changedVariables = variables.data();
+  delta.maxChangedVariables = variables.size();
+  delta.stackTrace = stack.data();
+  delta.maxStackDepth = stack.size();
+  delta.amplitudeTolerance = 1e-9;
+  delta.amplitudeIndices = indices.data();
+  delta.amplitudes = amplitudes.data();
+  delta.maxAmplitudes = indices.size();
+
+  ASSERT_EQ(state->getStateDelta(state, 0, &delta), OK);
+  ASSERT_TRUE(delta.complete);
+  ASSERT_TRUE(delta.amplitudesComplete);
+  ASSERT_EQ(delta.numChangedVariables, 4);
+  ASSERT_EQ(delta.numAmplitudes, 1);
+  ASSERT_EQ(indices[0], 0);
+  ASSERT_EQ(delta.stackDepth, 1);
+  ASSERT_EQ(stack[0], state->getCurrentInstruction(state));
+
+  const auto first = delta.version;
+  ASSERT_EQ(state->getStateDelta(state, first, &delta), OK);
+  ASSERT_NE(delta.version, first);
+  ASSERT_FALSE(delta.complete);
+  ASSERT_FALSE(delta.amplitudesComplete);
+  ASSERT_EQ(delta.numChangedVariables, 0);
+  ASSERT_EQ(delta.numAmplitudes, 0);
+
+  forwardTo(7);
+  ASSERT_EQ(state->getStateDelta(state, delta.version, &delta), OK);
+  ASSERT_FALSE(delta.complete);
+  ASSERT_EQ(delta.currentInstruction, 7);
+  ASSERT_EQ(delta.numChangedVariables, 2);
+  ASSERT_STREQ(variables[0].name, "c[0]");
+  ASSERT_STREQ(variables[1].name, "c[1]");
+  ASSERT_TRUE(variables[0].value.boolValue && variables[1].value.boolValue);
+  ASSERT_EQ(delta.numAmplitudes, 2);
+  ASSERT_EQ(indices[0], 0);
+  ASSERT_EQ(indices[1], 3);
+  ASSERT_TRUE(complexEquality(amplitudes[1], 1.0, 0.0));
+
+  // Versions other than the latest one yield the complete state again.
+  ASSERT_EQ(state->getStateDelta(state, first, &delta), OK);
+  ASSERT_TRUE(delta.complete);
+  ASSERT_EQ(delta.numChangedVariables, 4);
+}
+
+/**
+ * @test Test that `getStateDelta` fails without consuming the version if the
+ * buffer of the classical variables is too small.
+ */
+TEST_F(DataRetrievalTest, StateDeltaRejectsSmallBuffer) {
+  std::array<Variable, 4> variables{};
+  StateDelta delta{};
+  ASSERT_EQ(state->getStateDelta(state, 0, &delta), OK);
+  const auto version = delta.version;
+
+  forwardTo(7);
+  delta.changedVariables = variables.data();
+  delta.maxChangedVariables = 1;
+  ASSERT_EQ(state->getStateDelta(state, version, &delta), ERROR);
+  ASSERT_EQ(delta.numChangedVariables, 2);
+
+  delta.maxChangedVariables = variables.size();
+  ASSERT_EQ(state->getStateDelta(state, version, &delta), OK);
+  ASSERT_FALSE(delta.complete);
+  ASSERT_EQ(delta.numChangedVariables, 2);
+}
+
 /**
  * @test Test that amplitudes can be updated and the remaining state is
  * rescaled.
@@ -335,4 +421,158 @@ TEST_F(DataRetrievalTest, ChangeAmplitudeValueRejectsSubNormalizedVacuum) {
   ASSERT_EQ(state->changeAmplitudeValue(state, "0000", nullptr), ERROR);
 }
 
+/**
+ * @test Test that the bulk state vector export matches the amplitudes
+ * retrieved individually, both for the sequential and the multi-threaded path.
+ */
+TEST_F(StateVectorExportTest, MatchesIndividualAmplitudes) {
+  constexpr size_t numQubits = PARALLEL_EXPORT_MIN_QUBITS + 1;
+  std::stringstream code;
+  for (size_t i = 0; i < numQubits; i++) {
+    code << "h q[" << i << "];\n";
+  }
+  code << "cx q[0], q[" << numQubits - 1 << "];\n";
+  code << "t q[3];\n";
+  code << "ry(0.3) q[5];\n";
+  code << "cz q[2], q[9];\n";
+  loadCode(numQubits, 1, code.str().c_str());
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  const size_t numStates = 1ULL << numQubits;
+  std::vector<Complex> parallel(numStates);
+  Statevector sv{numQubits, numStates, parallel.data()};
+  ASSERT_EQ(state->getStateVectorFull(state, &sv), OK);
+
+  std::vector<Complex> sequential(numStates);
+  exportStateVector(ddState.simulationState, numQubits,
+                    Span<Complex>(sequential.data(), numStates), 1);
+
+  std::vector<Complex> forced(numStates);
+  exportStateVector(ddState.simulationState, numQubits,
+                    Span<Complex>(forced.data(), numStates), 4);
+
+  constexpr double tolerance = 1e-9;
+  Complex expected;
+  for (size_t i = 0; i < numStates; i++) {
+    ASSERT_EQ(state->getAmplitudeIndex(state, i, &expected), OK);
+    for (const auto* actual : {&parallel[i], &sequential[i], &forced[i]}) {
+      ASSERT_NEAR(actual->real, expected.real, tolerance)
+          << "Failed for index " << i;
+      ASSERT_NEAR(actual->imaginary, expected.imaginary, tolerance)
+          << "Failed for index " << i;
+    }
+  }
+}
+
+/**
+ * @test Test that `getStateVectorFull` rejects buffers that are too small.
+ */
+TEST_F(StateVectorExportTest, RejectsSmallBuffer) {
+  loadCode(3, 1, "h q[0];");
+  std::array<Complex, 4> amplitudes{};
+  Statevector sv{2, 4, amplitudes.data()};
+  ASSERT_EQ(state->getStateVectorFull(state, &sv), ERROR);
+}
+
+/**
+ * @test Test that `getNonZeroAmplitudes` and `getTopKAmplitudes` only report
+ * the amplitudes that are present in a GHZ state on many qubits.
+ */
+TEST_F(StateVectorExportTest, SparseAmplitudesOfGhzState) {
+  constexpr size_t numQubits = 40;
+  std::stringstream code;
+  code << "h q[0];\n";
+  for (size_t i = 1; i < numQubits; i++) {
+    code << "cx q[0], q[" << i << "];\n";
+  }
+  loadCode(numQubits, 1, code.str().c_str());
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  constexpr size_t capacity = 4;
+  std::array<size_t, capacity> indices{};
+  std::array<Complex, capacity> amplitudes{};
+  size_t count = 0;
+  ASSERT_EQ(state->getNonZeroAmplitudes(state, 0, capacity, indices.data(),
+                                        amplitudes.data(), &count),
+            OK);
+  ASSERT_EQ(count, 2);
+  ASSERT_EQ(indices[0], 0);
+  ASSERT_EQ(indices[1], (1ULL << numQubits) - 1);
+  ASSERT_TRUE(complexEquality(amplitudes[0], 0.707, 0.0));
+  ASSERT_TRUE(complexEquality(amplitudes[1], 0.707, 0.0));
+
+  ASSERT_EQ(state->getNonZeroAmplitudes(state, 0.8, capacity, indices.data(),
+                                        amplitudes.data(), &count),
+            OK);
+  ASSERT_EQ(count, 0);
+
+  ASSERT_EQ(state->getTopKAmplitudes(state, 1, indices.data(),
+                                     amplitudes.data(), &count),
+            OK);
+  ASSERT_EQ(count, 1);
+  ASSERT_EQ(indices[0], 0);
+}
+
+/**
+ * @test Test that `getTopKAmplitudes` orders the amplitudes by magnitude.
+ */
+TEST_F(StateVectorExportTest, TopKAmplitudesAreOrderedByMagnitude) {
+  loadCode(2, 1, "ry(0.4) q[0];\nry(2.6) q[1];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  std::array<size_t, 4> indices{};
+  std::array<Complex, 4> amplitudes{};
+  size_t count = 0;
+  ASSERT_EQ(state->getTopKAmplitudes(state, 4, indices.data(),
+                                     amplitudes.data(), &count),
+            OK);
+  ASSERT_EQ(count, 4);
+  ASSERT_EQ(indices[0], 2);
+  ASSERT_EQ(indices[1], 0);
+  ASSERT_EQ(indices[2], 3);
+  ASSERT_EQ(indices[3], 1);
+}
+
+/**
+ * @test Test that `getStateVectorRange` returns the same amplitudes as the
+ * individual accessors for ranges crossing sub-diagram boundaries.
+ */
+TEST_F(StateVectorExportTest, RangeMatchesIndividualAmplitudes) {
+  constexpr size_t numQubits = 6;
+  loadCode(numQubits, 1,
+           "h q[0];\nh q[2];\ncx q[2], q[5];\nt q[2];\nry(0.3) q[4];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+
+  constexpr double tolerance = 1e-9;
+  for (const auto& [start, count] :
+       std::vector<std::pair<size_t, size_t>>{{0, 64}, {5, 17}, {31, 2},
+                                              {63, 1}, {12, 0}}) {
+    std::vector<Complex> amplitudes(count + 1);
+    Statevector sv{numQubits, count, amplitudes.data()};
+    ASSERT_EQ(state->getStateVectorRange(state, start, count, &sv), OK);
+    Complex expected;
+    for (size_t i = 0; i < count; i++) {
+      ASSERT_EQ(state->getAmplitudeIndex(state, start + i, &expected), OK);
+      ASSERT_NEAR(amplitudes[i].real, expected.real, tolerance)
+          << "Failed for index " << start + i;
+      ASSERT_NEAR(amplitudes[i].imaginary, expected.imaginary, tolerance)
+          << "Failed for index " << start + i;
+    }
+  }
+}
+
+/**
+ * @test Test that `getStateVectorRange` rejects ranges exceeding the state
+ * vector or the buffer.
+ */
+TEST_F(StateVectorExportTest, RangeRejectsInvalidRanges) {
+  loadCode(3, 1, "h q[0];");
+  std::array<Complex, 4> amplitudes{};
+  Statevector sv{3, 4, amplitudes.data()};
+  ASSERT_EQ(state->getStateVectorRange(state, 6, 4, &sv), ERROR);
+  ASSERT_EQ(state->getStateVectorRange(state, 9, 0, &sv), ERROR);
+  ASSERT_EQ(state->getStateVectorRange(state, 0, 8, &sv), ERROR);
+  ASSERT_EQ(state->getStateVectorRange(state, 4, 4, &sv), OK);
+}
+
 } // namespace mqt::debugger::test
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file test_dense_backend.cpp
+ * @brief Test that the dense backend behaves like the decision diagram
+ * backend.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/dd/DDSimDense.hpp"
+#include "backend/debug.h"
+#include "common.h"
+#include "utils_test.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace mqt::debugger::test {
+
+/**
+ * @brief Fixture that runs the same code on both backends.
+ *
+ * The fixture creates one DDSimulationState per backend and provides methods
+ * to compare their states.
+ */
+class DenseBackendTest : public testing::TestWithParam<std::string> {
+protected:
+  void SetUp() override {
+    createDDSimulationState(&ddState);
+    createDDSimulationState(&denseState, SimulationBackend::Dense);
+    dd = &ddState.interface;
+    dense = &denseState.interface;
+    // Measurements draw the same outcomes if both states use the same seed.
+    dd->setSeed(dd, 7);
+    dense->setSeed(dense, 7);
+  }
+
+  void TearDown() override {
+    destroyDDSimulationState(&ddState);
+    destroyDDSimulationState(&denseState);
+  }
+
+  /**
+   * @brief The DDSimulationState using the decision diagram backend.
+   */
+  DDSimulationState ddState{};
+  /**
+   * @brief The DDSimulationState using the dense backend.
+   */
+  DDSimulationState denseState{};
+  /**
+   * @brief A reference to the interface of the decision diagram state.
+   */
+  SimulationState* dd = nullptr;
+  /**
+   * @brief A reference to the interface of the dense state.
+   */
+  SimulationState* dense = nullptr;
+
+  /**
+   * @brief Load the given code into both states.
+   * @param code The code to load.
+   */
+  void loadCode(const std::string& code) {
+    ASSERT_EQ(dd->loadCode(dd, code.c_str()).status, OK);
+    ASSERT_EQ(dense->loadCode(dense, code.c_str()).status, OK);
+  }
+
+  /**
+   * @brief Check that both states are at the same instruction and have the
+   * same state vector.
+   */
+  void assertStatesEqual() {
+    ASSERT_EQ(dd->getCurrentInstruction(dd),
+              dense->getCurrentInstruction(dense));
+    ASSERT_EQ(dd->didAssertionFail(dd), dense->didAssertionFail(dense));
+
+    const auto numQubits = dd->getNumQubits(dd);
+    ASSERT_EQ(dense->getNumQubits(dense), numQubits);
+    const size_t numStates = 1ULL << numQubits;
+    std::vector<Complex> expected(numStates);
+    std::vector<Complex> actual(numStates);
+    Statevector ddVector{numQubits, numStates, expected.data()};
+    Statevector denseVector{numQubits, numStates, actual.data()};
+    ASSERT_EQ(dd->getStateVectorFull(dd, &ddVector), OK);
+    ASSERT_EQ(dense->getStateVectorFull(dense, &denseVector), OK);
+    for (size_t i = 0; i < numStates; i++) {
+      ASSERT_NEAR(actual[i].real, expected[i].real, 1e-6);
+      ASSERT_NEAR(actual[i].imaginary, expected[i].imaginary, 1e-6);
+    }
+  }
+
+  /**
+   * @brief Step both states forward until the end of the program, and then
+   * back to the start, comparing them after every step.
+   */
+  void assertSameTrajectory() {
+    assertStatesEqual();
+    while (!dd->isFinished(dd)) {
+      ASSERT_EQ(dd->stepForward(dd), OK);
+      ASSERT_EQ(dense->stepForward(dense), OK);
+      assertStatesEqual();
+    }
+    ASSERT_TRUE(dense->isFinished(dense));
+    while (dd->canStepBackward(dd)) {
+      ASSERT_TRUE(dense->canStepBackward(dense));
+      ASSERT_EQ(dd->stepBackward(dd), OK);
+      ASSERT_EQ(dense->stepBackward(dense), OK);
+      assertStatesEqual();
+    }
+    ASSERT_FALSE(dense->canStepBackward(dense));
+  }
+};
+
+/**
+ * @test Test that both backends pass through the same states for the
+ * circuits used by the other tests.
+ */
+TEST_P(DenseBackendTest, SameTrajectoryForCircuits) {
+  loadCode(readFromCircuitsPath(GetParam()));
+  assertSameTrajectory();
+}
+
+/**
+ * @test Test that both backends agree on gates with several targets, several
+ * controls, and parameters.
+ */
+TEST_F(DenseBackendTest, SameTrajectoryForGates) {
+  loadCode("qreg q[4];\n"
+           "h q[0];\n"
+           "ry(0.3) q[1];\n"
+           "cx q[0], q[2];\n"
+           "swap q[1], q[3];\n"
+           "ccx q[0], q[1], q[3];\n"
+           "crz(1.2) q[2], q[0];\n"
+           "rxx(0.7) q[3], q[1];\n"
+           "cswap q[2], q[0], q[3];\n"
+           "u3(0.1, 0.2, 0.3) q[2];\n"
+           "cp(0.5) q[1], q[2];\n"
+           "assert-sup q[0], q[1];\n"
+           "assert-ent q[0], q[2];\n");
+  assertSameTrajectory();
+}
+
+/**
+ * @test Test that the dense backend rejects programs with too many qubits.
+ */
+TEST_F(DenseBackendTest, RejectsLargePrograms) {
+  const auto code = "qreg q[" + std::to_string(MAX_DENSE_BACKEND_QUBITS + 1) +
+                    "];\nh q[0];\n";
+  ASSERT_EQ(dd->loadCode(dd, code.c_str()).status, OK);
+  ASSERT_NE(dense->loadCode(dense, code.c_str()).status, OK);
+}
+
+INSTANTIATE_TEST_SUITE_P(StringParams, DenseBackendTest,
+                         ::testing::Values("classical-storage",
+                                           "complex-jumps",
+                                           "failing-assertions",
+                                           "runtime-interaction"));
+
+} // namespace mqt::debugger::test
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file test_density_matrix.cpp
+ * @brief Test the aligned storage of amplitudes and density matrices.
+ */
+#include "common.h"
+#include "common/ComplexMathematics.hpp"
+#include "common/DensityMatrix.hpp"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace mqt::debugger::test {
+
+namespace {
+/**
+ * @brief Check whether a pointer is aligned to `BUFFER_ALIGNMENT` bytes.
+ * @param pointer The pointer to check.
+ * @return True if the pointer is aligned, false otherwise.
+ */
+bool isAligned(const void* pointer) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<uintptr_t>(pointer) % BUFFER_ALIGNMENT == 0;
+}
+} // namespace
+
+/**
+ * @test Test that all allocations of the aligned allocator are aligned to
+ * `BUFFER_ALIGNMENT` bytes, independent of the element type and count.
+ */
+TEST(DensityMatrixTest, AllocatorAlignsAllocations) {
+  AlignedAllocator<Complex> allocator;
+  for (const size_t count : {1, 3, 4, 17, 1024}) {
+    auto* pointer = allocator.allocate(count);
+    ASSERT_TRUE(isAligned(pointer)) << count;
+    allocator.deallocate(pointer, count);
+  }
+
+  AlignedAllocator<char> rebound(allocator);
+  auto* bytes = rebound.allocate(1);
+  ASSERT_TRUE(isAligned(bytes));
+  rebound.deallocate(bytes, 1);
+  ASSERT_TRUE(allocator == rebound);
+}
+
+/**
+ * @test Test that amplitude buffers are zero-filled, keep their amplitudes
+ * when resized, and stay aligned when they are reallocated.
+ */
+TEST(DensityMatrixTest, AmplitudeBufferResizeZeroFills) {
+  AmplitudeBuffer buffer(4);
+  ASSERT_TRUE(isAligned(buffer.data()));
+  for (const auto& amplitude : buffer) {
+    ASSERT_EQ(amplitude.real, 0);
+    ASSERT_EQ(amplitude.imaginary, 0);
+  }
+
+  buffer[3] = {.real = 0.5, .imaginary = -0.5};
+  buffer.resize(1024);
+  ASSERT_TRUE(isAligned(buffer.data()));
+  ASSERT_EQ(buffer[3].real, 0.5);
+  ASSERT_EQ(buffer[3].imaginary, -0.5);
+  for (size_t i = 4; i < buffer.size(); i++) {
+    ASSERT_EQ(buffer[i].real, 0);
+    ASSERT_EQ(buffer[i].imaginary, 0);
+  }
+}
+
+/**
+ * @test Test that density matrices store their entries in row-major order,
+ * using the density matrix of (|00> + i|11>) / sqrt(2).
+ */
+TEST(DensityMatrixTest, TwoQubitLayout) {
+  const auto amplitude = 1 / std::sqrt(2.0);
+  std::array<Complex, 4> amplitudes{};
+  amplitudes[0] = {.real = amplitude, .imaginary = 0};
+  amplitudes[3] = {.real = 0, .imaginary = amplitude};
+  const Statevector sv{
+      .numQubits = 2, .numStates = 4, .amplitudes = amplitudes.data()};
+  const auto rho = toDensityMatrix(sv);
+  ASSERT_EQ(rho.dimension(), 4);
+
+  // Only the corners of the matrix are non-zero:
+  // rho = 1/2 * [[1, 0, 0, -i], [0, 0, 0, 0], [0, 0, 0, 0], [i, 0, 0, 1]].
+  const auto* first = &rho(0, 0);
+  for (size_t row = 0; row < 4; row++) {
+    for (size_t col = 0; col < 4; col++) {
+      const auto& entry = rho(row, col);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      ASSERT_EQ(&entry, first + (row * 4) + col);
+      const auto corner = (row == 0 || row == 3) && (col == 0 || col == 3);
+      const auto expectedReal = corner && row == col ? 0.5 : 0.0;
+      const auto expectedImaginary =
+          corner && row != col ? (row == 3 ? 0.5 : -0.5) : 0.0;
+      ASSERT_NEAR(entry.real, expectedReal, 1e-12) << row << ", " << col;
+      ASSERT_NEAR(entry.imaginary, expectedImaginary, 1e-12)
+          << row << ", " << col;
+    }
+  }
+  ASSERT_TRUE(isAligned(first));
+}
+
+/**
+ * @test Test that the Eigen3 views of density matrices and amplitudes alias
+ * the underlying storage instead of copying it.
+ */
+TEST(DensityMatrixTest, EigenViewsAlias) {
+  DensityMatrix matrix(2);
+  auto view = matrix.asEigen();
+  ASSERT_EQ(static_cast<const void*>(view.data()),
+            static_cast<const void*>(&matrix(0, 0)));
+
+  view(0, 1) = {0.25, -0.75};
+  ASSERT_EQ(matrix(0, 1).real, 0.25);
+  ASSERT_EQ(matrix(0, 1).imaginary, -0.75);
+  matrix(1, 0) = {.real = 1, .imaginary = 2};
+  ASSERT_EQ(view(1, 0), std::complex<double>(1, 2));
+
+  const auto& constMatrix = matrix;
+  ASSERT_EQ(static_cast<const void*>(constMatrix.asEigen().data()),
+            static_cast<const void*>(&matrix(0, 0)));
+
+  AmplitudeBuffer amplitudes(2);
+  const auto vector = asEigenVector(amplitudes.data(), amplitudes.size());
+  ASSERT_EQ(static_cast<const void*>(vector.data()),
+            static_cast<const void*>(amplitudes.data()));
+  amplitudes[1] = {.real = 3, .imaginary = 4};
+  ASSERT_EQ(vector(1), std::complex<double>(3, 4));
+}
+
+} // namespace mqt::debugger::test
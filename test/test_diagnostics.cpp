@@ -13,11 +13,15 @@
  * @brief Test the functionality of the diagnostics module.
  */
 
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/dd/DDSimDiagnostics.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
 #include "common_fixtures.hpp"
+#include "utils_test.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -217,6 +221,127 @@ TEST_F(DiagnosticsTest, ZeroControlsWithJumps) {
   }
 }
 
+/**
+ * @test Test that zero controls are found in lazy mode, where controls are only
+ * checked once they are queried.
+ */
+TEST_F(DiagnosticsTest, LazyZeroControlsWithJumps) {
+  loadFromFile("zero-controls-with-jumps");
+  ddState.diagnostics.lazyZeroControls = true;
+  state->runSimulation(state);
+  ASSERT_FALSE(ddState.diagnostics.pendingControlChecks.empty());
+  std::array<bool, 13> zeroControls{};
+  diagnostics->getZeroControlInstructions(diagnostics, zeroControls.data());
+  ASSERT_TRUE(ddState.diagnostics.pendingControlChecks.empty());
+  for (size_t i = 0; i < zeroControls.size(); i++) {
+    ASSERT_FALSE(zeroControls.at(i) ^ (i == 3 || i == 12));
+  }
+}
+
+/**
+ * @test Test that lazy mode only keeps a bounded number of states alive, even
+ * if many controlled instructions are executed repeatedly.
+ */
+TEST_F(DiagnosticsTest, LazyZeroControlsBoundPendingStates) {
+  std::string code = "qreg q[2];\nh q[0];\n";
+  for (size_t i = 0; i < 2 * MAX_PENDING_CONTROL_STATES; i++) {
+    code += "ry(0.1) q[1];\ncx q[0], q[1];\n";
+  }
+  ASSERT_EQ(state->loadCode(state, code.c_str()).status, LOAD_OK);
+  ddState.diagnostics.lazyZeroControls = true;
+
+  for (size_t run = 0; run < 2; run++) {
+    while (!state->isFinished(state)) {
+      ASSERT_EQ(state->stepForward(state), OK);
+      ASSERT_LE(ddState.diagnostics.numPendingControlStates,
+                MAX_PENDING_CONTROL_STATES);
+    }
+    while (state->canStepBackward(state)) {
+      ASSERT_EQ(state->stepBackward(state), OK);
+    }
+  }
+
+  std::vector<uint8_t> zeroControls(state->getInstructionCount(state));
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  diagnostics->getZeroControlInstructions(
+      diagnostics, reinterpret_cast<bool*>(zeroControls.data()));
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  ASSERT_EQ(ddState.diagnostics.numPendingControlStates, 0);
+  ASSERT_TRUE(std::ranges::none_of(
+      zeroControls, [](uint8_t zero) { return zero != 0; }));
+}
+
+/**
+ * @test Test that fast-run mode collects the same diagnostics as stepping over
+ * each instruction individually.
+ */
+TEST_F(DiagnosticsTest, FastRunCollectsSameDiagnostics) {
+  for (const auto* name :
+       {"failing-assertions", "failing-assertions-missing-interaction",
+        "failing-assertions-multiple-zero-controls", "zero-controls-with-jumps",
+        "runtime-interaction", "diagnose-with-jumps"}) {
+    loadFromFile(name);
+    DDSimulationState stepState;
+    createDDSimulationState(&stepState);
+    auto* stepped = &stepState.interface;
+    auto* steppedDiagnostics = stepped->getDiagnostics(stepped);
+    const auto code = readFromCircuitsPath(name);
+    ASSERT_EQ(stepped->loadCode(stepped, code.c_str()).status, LOAD_OK);
+    ddState.fastRun = true;
+
+    while (!state->isFinished(state)) {
+      ASSERT_EQ(state->runSimulation(state), OK) << name;
+      ASSERT_EQ(stepped->runSimulation(stepped), OK) << name;
+      ASSERT_EQ(state->getCurrentInstruction(state),
+                stepped->getCurrentInstruction(stepped))
+          << name;
+      std::array<ErrorCause, 10> causes{};
+      std::array<ErrorCause, 10> steppedCauses{};
+      const auto numCauses =
+          diagnostics->potentialErrorCauses(diagnostics, causes.data(), 10);
+      ASSERT_EQ(numCauses, steppedDiagnostics->potentialErrorCauses(
+                               steppedDiagnostics, steppedCauses.data(), 10))
+          << name;
+      for (size_t i = 0; i < numCauses; i++) {
+        ASSERT_EQ(causes.at(i).type, steppedCauses.at(i).type) << name;
+        ASSERT_EQ(causes.at(i).instruction, steppedCauses.at(i).instruction)
+            << name;
+      }
+    }
+
+    const auto numInstructions = state->getInstructionCount(state);
+    std::vector<uint8_t> zeroControls(numInstructions);
+    std::vector<uint8_t> steppedZeroControls(numInstructions);
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    diagnostics->getZeroControlInstructions(
+        diagnostics, reinterpret_cast<bool*>(zeroControls.data()));
+    steppedDiagnostics->getZeroControlInstructions(
+        steppedDiagnostics,
+        reinterpret_cast<bool*>(steppedZeroControls.data()));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    ASSERT_EQ(zeroControls, steppedZeroControls) << name;
+
+    const auto numQubits = state->getNumQubits(state);
+    for (size_t qubit = 0; qubit < numQubits; qubit++) {
+      std::vector<uint8_t> interactions(numQubits);
+      std::vector<uint8_t> steppedInteractions(numQubits);
+      // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+      diagnostics->getInteractions(
+          diagnostics, numInstructions, qubit,
+          reinterpret_cast<bool*>(interactions.data()));
+      steppedDiagnostics->getInteractions(
+          steppedDiagnostics, numInstructions, qubit,
+          reinterpret_cast<bool*>(steppedInteractions.data()));
+      // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+      ASSERT_EQ(interactions, steppedInteractions) << name;
+    }
+    ASSERT_EQ(ddState.diagnostics.actualQubits,
+              stepState.diagnostics.actualQubits)
+        << name;
+    destroyDDSimulationState(&stepState);
+  }
+}
+
 /**
  * @test Test the correctness of the `getDataDependencies` method of the
  * diagnostics interface in the presence of jumps.
@@ -324,4 +449,91 @@ TEST_F(DiagnosticsTest, RuntimeInteractions) {
   ASSERT_EQ(errors[0].instruction, 6);
 }
 
+/**
+ * @test Test that the interaction groups of all qubits retrieved at once match
+ * the interactions of each individual qubit.
+ */
+TEST_F(DiagnosticsTest, InteractionComponents) {
+  loadFromFile("diagnose-with-jumps");
+  const auto numQubits = state->getNumQubits(state);
+
+  std::vector<size_t> components(numQubits);
+  ASSERT_EQ(diagnostics->getInteractionComponents(diagnostics, 18,
+                                                  components.data()),
+            OK);
+  ASSERT_EQ(components, (std::vector<size_t>{0, 0, 0, 3}));
+
+  for (size_t instruction = 0;
+       instruction <= state->getInstructionCount(state); instruction++) {
+    ASSERT_EQ(diagnostics->getInteractionComponents(diagnostics, instruction,
+                                                    components.data()),
+              OK);
+    for (size_t qubit = 0; qubit < numQubits; qubit++) {
+      std::vector<uint8_t> interactions(numQubits, 0);
+      // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+      ASSERT_EQ(diagnostics->getInteractions(
+                    diagnostics, instruction, qubit,
+                    reinterpret_cast<bool*>(interactions.data())),
+                OK);
+      // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+      for (size_t other = 0; other < numQubits; other++) {
+        ASSERT_EQ(interactions[other] != 0,
+                  components[other] == components[qubit])
+            << "Failed for instruction " << instruction << " qubit " << qubit
+            << " and qubit " << other;
+      }
+    }
+  }
+}
+
+/**
+ * @test Test that the data dependencies retrieved for several instructions at
+ * once match the data dependencies of each individual instruction.
+ */
+TEST_F(DiagnosticsTest, DataDependenciesBatch) {
+  loadFromFile("diagnose-with-jumps");
+  const auto count = state->getInstructionCount(state);
+  std::vector<size_t> instructions(count);
+  for (size_t i = 0; i < count; i++) {
+    instructions[i] = i;
+  }
+
+  for (const auto includeCallers : {false, true}) {
+    std::vector<uint8_t> batch(count * count, 0);
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    ASSERT_EQ(diagnostics->getDataDependenciesBatch(
+                  diagnostics, instructions.data(), count, includeCallers,
+                  reinterpret_cast<bool*>(batch.data())),
+              OK);
+    for (size_t i = 0; i < count; i++) {
+      std::vector<uint8_t> single(count, 0);
+      ASSERT_EQ(diagnostics->getDataDependencies(
+                    diagnostics, i, includeCallers,
+                    reinterpret_cast<bool*>(single.data())),
+                OK);
+      ASSERT_TRUE(std::equal(single.begin(), single.end(),
+                             batch.begin() + static_cast<ptrdiff_t>(i * count)))
+          << "Failed for instruction " << i;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  // Instruction 10 is inside `level_three_a`, which is called from
+  // `level_two` and, through it, from `level_one`.
+  std::vector<uint8_t> dependencies(count, 0);
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  ASSERT_EQ(
+      diagnostics->getDataDependencies(
+          diagnostics, 10, true, reinterpret_cast<bool*>(dependencies.data())),
+      OK);
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  std::set<size_t> dependenciesSet;
+  for (size_t i = 0; i < count; i++) {
+    if (dependencies[i] != 0) {
+      dependenciesSet.insert(i);
+    }
+  }
+  ASSERT_EQ(dependenciesSet, (std::set<size_t>{1, 2, 5, 6, 7, 10, 13, 16, 17}));
+}
+
 } // namespace mqt::debugger::test
@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace mqt::debugger::test {
 
@@ -180,4 +181,37 @@ TEST_F(ParsingTest, BadFunctionCall) {
   ASSERT_THROW(preprocessCode(input2, output), ParsingError);
 }
 
+/**
+ * @test Test that data dependencies are found in long programs.
+ *
+ * The dependencies of the last instructions lie just before them, while the
+ * full register usage depends on every preceding usage of the register.
+ */
+TEST_F(ParsingTest, DataDependenciesInLongProgram) {
+  constexpr size_t repetitions = 1000;
+  std::string input = "qreg q[3]; // declaration\n";
+  for (size_t i = 0; i < repetitions; i++) {
+    input += "x q[0]; // comment\n";
+  }
+  input += "h q[1]; barrier q; cx q[1], q[2];";
+  std::string output;
+  const auto instructions = preprocessCode(input, output);
+  ASSERT_EQ(instructions.size(), repetitions + 4);
+  ASSERT_EQ(output.size(), input.size());
+  ASSERT_EQ(output.find("//"), std::string::npos);
+
+  const auto& single = instructions[repetitions + 1];
+  ASSERT_TRUE(single.dataDependencies.empty());
+  const auto& barrier = instructions[repetitions + 2];
+  ASSERT_EQ(barrier.dataDependencies.size(), repetitions + 2);
+  ASSERT_EQ(barrier.dataDependencies.front(),
+            std::make_pair(repetitions + 1, size_t{0}));
+  ASSERT_EQ(barrier.dataDependencies.back(),
+            std::make_pair(size_t{0}, size_t{0}));
+  const auto& cx = instructions[repetitions + 3];
+  ASSERT_EQ(cx.dataDependencies.size(), 2);
+  ASSERT_EQ(cx.dataDependencies[0], std::make_pair(repetitions + 2, size_t{0}));
+  ASSERT_EQ(cx.dataDependencies[1], std::make_pair(repetitions + 1, size_t{0}));
+}
+
 } // namespace mqt::debugger::test
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file test_result_checker.cpp
+ * @brief Test the native checking of results of compiled programs.
+ */
+#include "common/ResultChecker.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mqt::debugger::test {
+
+/**
+ * @test Test that results are binned into the first register containing each
+ * variable, with values interpreted like Python's `int`.
+ */
+TEST(ResultCheckerTest, LoadResultCounts) {
+  std::istringstream input(R"([
+    {"a": 1, "b": "0", "c": true, "unused": 1},
+    {"a": 0, "b": 1.0, "c": false},
+    {"a": "1", "b": 1, "c": 0.5}
+  ])");
+  const auto counts = loadResultCounts(input, {{"a", "b"}, {"c", "a"}});
+  ASSERT_EQ(counts.numSamples, 3);
+  ASSERT_EQ(counts.offsets, (std::vector<size_t>{0, 4, 8}));
+  ASSERT_EQ(counts.counts, (std::vector<size_t>{0, 1, 1, 1, 2, 1, 0, 0}));
+}
+
+/**
+ * @test Test that malformed result files are rejected.
+ */
+TEST(ResultCheckerTest, LoadResultCountsRejectsInvalidInput) {
+  for (const std::string text :
+       {"[1]", R"([{"a": 1}] [])", R"([{"a": null}])", R"([{"a": "x"}])",
+        R"([{"a": 1})"}) {
+    std::istringstream input(text);
+    ASSERT_THROW(loadResultCounts(input, {{"a"}}), std::invalid_argument)
+        << text;
+  }
+}
+
+/**
+ * @test Test the power divergence statistic and its p-value against
+ * reference values.
+ */
+TEST(ResultCheckerTest, PowerDivergence) {
+  const auto [statistic, p] =
+      checkPowerDivergence({30, 20, 25, 25}, {25, 25, 25, 25});
+  ASSERT_NEAR(statistic, 2.0029942079, 1e-9);
+  ASSERT_NEAR(p, 0.5717854780, 1e-9);
+
+  const auto [mergedStatistic, mergedP] =
+      checkPowerDivergence({10, 20, 30, 40}, {25, 25, 25, 25});
+  ASSERT_NEAR(mergedStatistic, 20.2695121563, 1e-9);
+  ASSERT_NEAR(mergedP, 0.0001492521, 1e-9);
+
+  const auto [zeroStatistic, zeroP] =
+      checkPowerDivergence({99, 1, 0, 0}, {100, 0, 0, 0});
+  ASSERT_EQ(zeroStatistic, 0.0);
+  ASSERT_EQ(zeroP, 0.0);
+}
+
+/**
+ * @test Test that distributions are compared under the expected noise.
+ */
+TEST(ResultCheckerTest, DistributionEqualUnderNoise) {
+  ASSERT_FALSE(distributionEqualUnderNoise({100, 0, 0, 100}, {0, 0.5, 0.5, 0},
+                                           200, 1.0, 0.05, false));
+  ASSERT_TRUE(distributionEqualUnderNoise({480, 10, 15, 495},
+                                          {0.5, 0, 0, 0.5}, 1000, 0.9));
+  ASSERT_FALSE(distributionEqualUnderNoise({250, 250, 250, 250},
+                                           {0.5, 0, 0, 0.5}, 1000, 0.9));
+}
+
+/**
+ * @test Test that all kinds of assertions are checked against a results file
+ * in parallel.
+ */
+TEST(ResultCheckerTest, CheckResults) {
+  std::stringstream input;
+  input << "[";
+  for (size_t i = 0; i < 1000; i++) {
+    const auto bell = (i % 2 == 0) ? 1 : 0;
+    const auto plus = (i % 3 == 0) ? 1 : 0;
+    const auto noise = (i % 40 == 0) ? 1 : 0;
+    input << (i == 0 ? "" : ",") << R"({"q0": )" << bell << R"(, "q1": )"
+          << bell << R"(, "p": )" << plus << R"(, "z0": )" << noise
+          << R"(, "z1": 0})";
+  }
+  input << "]";
+
+  const auto results =
+      checkResults(input, {{"q0", "q1"}, {"q0", "q1"}, {"p"}, {"z0", "z1"}},
+                   {"{0.5,0,0,0.5} 0.9", "{0,0.5,0.5,0} 0.9",
+                    "{superposition}", "{zero}"},
+                   0.95, 0.05, 4);
+  // The second register only receives the variables not counted already, so
+  // it never observes any outcome but zero.
+  ASSERT_EQ(results, (std::vector<bool>{true, false, true, true}));
+}
+
+/**
+ * @test Test that invalid assertions are reported.
+ */
+TEST(ResultCheckerTest, CheckResultsRejectsInvalidAssertions) {
+  std::istringstream input(R"([{"a": 1}])");
+  ASSERT_THROW(checkResults(input, {{"a"}}, {"{0.5,x}"}, 0.9),
+               std::invalid_argument);
+  std::istringstream empty("[]");
+  ASSERT_THROW(checkResults(empty, {{"a"}}, {"{zero}"}, 0.9),
+               std::invalid_argument);
+}
+
+/**
+ * @test Test that an exception thrown while checking assertions in parallel is
+ * rethrown with its original type once all workers have stopped.
+ */
+TEST(ResultCheckerTest, CheckResultsRethrowsFromWorkers) {
+  std::istringstream input(R"([{"a": 1, "b": 0, "c": 1, "d": 0},
+                              {"a": 0, "b": 1, "c": 0, "d": 1}])");
+  ASSERT_THROW(checkResults(input, {{"a"}, {"b"}, {"c"}, {"d"}},
+                            {"{superposition}", "{0.5,0.5}", "{0.5,x}",
+                             "{superposition}"},
+                            0.9, 0.05, 4),
+               std::invalid_argument);
+}
+
+} // namespace mqt::debugger::test
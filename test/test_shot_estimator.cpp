@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 - 2026 Chair for Design Automation, TUM
+ * Copyright (c) 2025 - 2026 Munich Quantum Software Company GmbH
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Licensed under the MIT License
+ */
+
+/**
+ * @file test_shot_estimator.cpp
+ * @brief Test the estimation of the number of shots required to check
+ * assertions.
+ */
+#include "common/ShotEstimator.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace mqt::debugger::test {
+
+/**
+ * @test Test that estimates are multiples of five samples per outcome and
+ * grow when less noise is tolerated.
+ */
+TEST(ShotEstimatorTest, EstimateRequiredShots) {
+  ShotEstimator estimator;
+  const auto bell = estimator.estimate(
+      "(a,b) {0.5,0,0,0.5} 0.9", 0.6561,
+      {.pValue = 0.05, .numTrials = 200, .accuracy = 0.95, .seed = 1});
+  ASSERT_GT(bell, 0);
+  ASSERT_EQ(bell % 20, 0);
+
+  const auto zero = estimator.estimate("(a,b,c) {zero}", 0.9,
+                                       {.numTrials = 200, .seed = 1});
+  ASSERT_EQ(zero % 40, 0);
+
+  const auto superposition = estimator.estimate(
+      "(a) {superposition}", 0.9, {.numTrials = 200, .seed = 1});
+  ASSERT_EQ(superposition % 10, 0);
+}
+
+/**
+ * @test Test that estimates are independent of the number of threads and
+ * cached per assertion and settings.
+ */
+TEST(ShotEstimatorTest, EstimatesAreReproducibleAndCached) {
+  const auto* assertion = "(a,b) {0.5,0,0,0.5} 0.9";
+  ShotEstimator estimator;
+  const auto parallel = estimator.estimate(
+      assertion, 0.8, {.numTrials = 300, .seed = 5, .maxThreads = 4});
+  ASSERT_EQ(estimator.getCacheSize(), 1);
+
+  ShotEstimator sequential;
+  ASSERT_EQ(sequential.estimate(assertion, 0.8,
+                                {.numTrials = 300, .seed = 5, .maxThreads = 1}),
+            parallel);
+
+  // The number of threads is not part of the cache key.
+  ASSERT_EQ(estimator.estimate(assertion, 0.8, {.numTrials = 300, .seed = 5}),
+            parallel);
+  ASSERT_EQ(estimator.getCacheSize(), 1);
+  estimator.estimate(assertion, 0.7, {.numTrials = 300, .seed = 5});
+  ASSERT_EQ(estimator.getCacheSize(), 2);
+
+  estimator.clearCache();
+  ASSERT_EQ(estimator.getCacheSize(), 0);
+}
+
+/**
+ * @test Test that invalid assertions are reported.
+ */
+TEST(ShotEstimatorTest, RejectsInvalidAssertions) {
+  ShotEstimator estimator;
+  ASSERT_THROW(estimator.estimate("{zero}", 0.9), std::invalid_argument);
+  ASSERT_THROW(estimator.estimate("(a) {0.5,x}", 0.9), std::invalid_argument);
+  ASSERT_THROW(estimator.estimate("(a) {zero}", 0.9, {.numTrials = 0}),
+               std::invalid_argument);
+}
+
+} // namespace mqt::debugger::test